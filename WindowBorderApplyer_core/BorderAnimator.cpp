@@ -0,0 +1,157 @@
+﻿#include "BorderAnimator.h"
+
+#include <algorithm>
+
+EasingTable::EasingTable() noexcept
+{
+	for (size_t i = 0; i <= Steps; ++i)
+	{
+		const double t = static_cast<double>(i) / Steps;
+		const double eased = t < 0.5 ? 4.0 * t * t * t : 1.0 - (2.0 - 2.0 * t) * (2.0 - 2.0 * t) * (2.0 - 2.0 * t) / 2.0;
+		weights[i] = static_cast<uint16_t>(eased * One + 0.5);
+	}
+}
+
+const EasingTable& EasingTable::Shared() noexcept
+{
+	static const EasingTable table;
+	return table;
+}
+
+uint32_t BlendColor(uint32_t from, uint32_t to, uint32_t weight) noexcept
+{
+	uint32_t blended = 0;
+	for (uint32_t shift = 0; shift < 24; shift += 8)
+	{
+		const int32_t a = static_cast<int32_t>((from >> shift) & 0xFF);
+		const int32_t b = static_cast<int32_t>((to >> shift) & 0xFF);
+		const int32_t channel = a + (((b - a) * static_cast<int32_t>(weight) + 128) >> 8);
+		blended |= static_cast<uint32_t>(channel) << shift;
+	}
+	return blended;
+}
+
+BorderAnimator::BorderAnimator(const BorderAnimationOptions& options) : options(options), easing(EasingTable::Shared())
+{
+	// 0 이면 Tick 이 "움직이는 것 없음" 과 구분되지 않음
+	this->options.frameIntervalUs = std::max<uint64_t>(options.frameIntervalUs, 1);
+}
+
+BorderAnimator::Animation& BorderAnimator::Start(uint32_t node, uint64_t nowUs)
+{
+	if (slots.size() <= node)
+		slots.resize(static_cast<size_t>(node) + 1, 0);
+
+	// 쉬고 있었으면 첫 프레임은 한 프레임 뒤. 이미 움직이는 노드가 있으면 그 프레임에 맞춤
+	if (animations.empty())
+		nextFrameUs = nowUs + options.frameIntervalUs;
+
+	if (slots[node] == 0)
+	{
+		animations.push_back(Animation{});
+		slots[node] = static_cast<uint32_t>(animations.size());
+	}
+	else
+		stats.cancelled++;
+
+	Animation& animation = animations[slots[node] - 1];
+	animation.node = node;
+	animation.startUs = nowUs;
+	stats.active = animations.size();
+	stats.maxActive = std::max(stats.maxActive, stats.active);
+	return animation;
+}
+
+void BorderAnimator::Fade(uint32_t node, uint32_t from, uint32_t to, uint64_t nowUs)
+{
+	uint32_t current = from;
+	CurrentColor(node, current);
+	if (!FadeEnabled() || current == to)
+	{
+		Cancel(node);
+		return;
+	}
+
+	Animation& animation = Start(node, nowUs);
+	animation.kind = Kind::Fade;
+	animation.from = current;
+	animation.to = to;
+	animation.durationUs = options.fadeUs;
+	animation.shown = current;
+	stats.fades++;
+}
+
+void BorderAnimator::Pulse(uint32_t node, uint32_t base, uint64_t nowUs)
+{
+	if (!PulseEnabled())
+		return;
+
+	// 색을 바꾸는 중이면 바꾼 뒤의 색으로 돌아옴
+	uint32_t current = base;
+	if (IsAnimating(node))
+	{
+		CurrentColor(node, current);
+		base = animations[slots[node] - 1].to;
+	}
+
+	Animation& animation = Start(node, nowUs);
+	animation.kind = Kind::Pulse;
+	animation.from = options.pulseColor;
+	animation.to = base;
+	animation.durationUs = options.pulseUs * options.pulseCount;
+	animation.shown = current;
+	stats.pulses++;
+}
+
+void BorderAnimator::Cancel(uint32_t node) noexcept
+{
+	if (!IsAnimating(node))
+		return;
+
+	RemoveAt(slots[node] - 1);
+	stats.cancelled++;
+	stats.active = animations.size();
+}
+
+void BorderAnimator::Clear() noexcept
+{
+	animations.clear();
+	slots.clear();
+	stats.active = 0;
+}
+
+bool BorderAnimator::CurrentColor(uint32_t node, uint32_t& color) const noexcept
+{
+	if (!IsAnimating(node))
+		return false;
+	color = animations[slots[node] - 1].shown;
+	return true;
+}
+
+void BorderAnimator::RemoveAt(size_t index) noexcept
+{
+	slots[animations[index].node] = 0;
+	if (index + 1 != animations.size())
+	{
+		animations[index] = animations.back();
+		slots[animations[index].node] = static_cast<uint32_t>(index + 1);
+	}
+	animations.pop_back();
+}
+
+uint32_t BorderAnimator::Evaluate(const Animation& animation, uint64_t nowUs) const noexcept
+{
+	const uint64_t elapsed = nowUs - animation.startUs;
+	if (animation.kind == Kind::Fade)
+	{
+		const uint32_t progress = static_cast<uint32_t>((elapsed << 16) / animation.durationUs);
+		return BlendColor(animation.from, animation.to, easing.Weight(progress));
+	}
+
+	// 깜빡임 한 번: 앞 절반은 base -> pulseColor, 뒤 절반은 되돌아옴
+	const uint64_t phase = elapsed % options.pulseUs;
+	const uint64_t half = std::max<uint64_t>(options.pulseUs / 2, 1);
+	const uint64_t rising = phase < half ? phase : options.pulseUs - phase;
+	const uint32_t progress = static_cast<uint32_t>(std::min<uint64_t>((rising << 16) / half, 65536));
+	return BlendColor(animation.to, animation.from, easing.Weight(progress));
+}
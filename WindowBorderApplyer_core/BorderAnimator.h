@@ -0,0 +1,179 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// <summary> 테두리 애니메이션 설정. 시간이 0 인 애니메이션은 쓰지 않습니다 </summary>
+struct BorderAnimationOptions
+{
+	// 보이는 테두리의 색이 바뀔 때 (스타일 변경 등) 이전 색에서 이어서 바꾸는 시간. 0 이면 바로 바꿈
+	uint64_t fadeUs = 0;
+	// 포커스를 받은 테두리를 pulseColor 쪽으로 깜빡이는 한 번의 길이와 횟수. 0 이면 깜빡이지 않음
+	uint64_t pulseUs = 0;
+	uint32_t pulseCount = 2;
+	// COLORREF (0x00BBGGRR)
+	uint32_t pulseColor = 0x00FFFFFF;
+	// 애니메이션이 있는 동안의 프레임 간격
+	uint64_t frameIntervalUs = 16000;
+};
+
+struct AnimationStats
+{
+	uint64_t fades = 0;
+	uint64_t pulses = 0;
+	// 끝까지 재생한 애니메이션 (중간에 다른 애니메이션으로 바뀌거나 취소된 것 제외)
+	uint64_t finished = 0;
+	uint64_t cancelled = 0;
+	// 애니메이션을 계산한 프레임과, 프레임마다 계산한 애니메이션 수의 합
+	uint64_t frames = 0;
+	uint64_t evaluated = 0;
+	// 색이 바뀌어 다시 그린 횟수 (이징 표에서 같은 색이 나오면 그리지 않음)
+	uint64_t applied = 0;
+	size_t active = 0;
+	size_t maxActive = 0;
+};
+
+/// <summary>
+/// 이징 곡선 (ease-in-out cubic) 을 미리 계산한 표. 진행률 0~65536 을 가중치 0~256 으로 바꿉니다.
+/// 프레임마다 곡선을 계산하지 않고 표에서 두 값 사이를 선형 보간합니다
+/// </summary>
+class EasingTable
+{
+public:
+	static constexpr size_t Steps = 256;
+	static constexpr uint32_t One = 256;
+
+	EasingTable() noexcept;
+
+	/// <summary> progress 는 0~65536 (1/65536 단위). 결과는 0~256 </summary>
+	uint32_t Weight(uint32_t progress) const noexcept
+	{
+		if (progress >= 65536)
+			return One;
+		const uint32_t index = progress >> 8;
+		const uint32_t fraction = progress & 0xFF;
+		return (weights[index] * (256 - fraction) + weights[index + 1] * fraction + 128) >> 8;
+	}
+
+	/// <summary> 모든 애니메이션이 함께 쓰는 표 </summary>
+	static const EasingTable& Shared() noexcept;
+
+private:
+	std::array<uint16_t, Steps + 1> weights{};
+};
+
+/// <summary> 두 COLORREF 를 채널마다 weight / 256 만큼 섞습니다 </summary>
+uint32_t BlendColor(uint32_t from, uint32_t to, uint32_t weight) noexcept;
+
+/// <summary>
+/// 테두리 색 애니메이션 (색 이어 바꾸기, 포커스 깜빡임) 의 스케줄러. 노드 번호는 장면 (BorderScene) 의 번호입니다.
+/// 움직이는 테두리만 프레임마다 계산하고, 아무것도 움직이지 않으면 Tick 이 0 을 반환해 깨어날 필요가 없습니다.
+/// 한 스레드 (표시 스레드) 에서만 사용해야 합니다
+/// </summary>
+class BorderAnimator
+{
+public:
+	explicit BorderAnimator(const BorderAnimationOptions& options = {});
+
+	const BorderAnimationOptions& Options() const noexcept { return options; }
+	bool FadeEnabled() const noexcept { return options.fadeUs != 0; }
+	bool PulseEnabled() const noexcept { return options.pulseUs != 0 && options.pulseCount != 0; }
+
+	/// <summary> node 의 색을 from 에서 to 로 이어서 바꿉니다. 이미 움직이는 중이면 지금 보이는 색에서 시작 </summary>
+	void Fade(uint32_t node, uint32_t from, uint32_t to, uint64_t nowUs);
+	/// <summary> node 를 base 색에서 pulseColor 쪽으로 깜빡였다가 base 로 돌아옵니다 </summary>
+	void Pulse(uint32_t node, uint32_t base, uint64_t nowUs);
+	/// <summary> 애니메이션을 멈춥니다 (노드를 숨기거나 파괴할 때). 마지막 색은 그리지 않음 </summary>
+	void Cancel(uint32_t node) noexcept;
+	void Clear() noexcept;
+
+	bool IsAnimating(uint32_t node) const noexcept { return node < slots.size() && slots[node] != 0; }
+	/// <summary> 움직이는 노드면 지금 보여야 하는 색 (다른 변경을 반영할 때 색만 덮어씀) </summary>
+	bool CurrentColor(uint32_t node, uint32_t& color) const noexcept;
+
+	size_t Size() const noexcept { return animations.size(); }
+	/// <summary> 다음 프레임 시각 (us). 움직이는 것이 없으면 0 </summary>
+	uint64_t NextFrameUs() const noexcept { return animations.empty() ? 0 : nextFrameUs; }
+
+	/// <summary>
+	/// nowUs 가 다음 프레임 시각이 되었으면 움직이는 노드를 계산해 색이 바뀐 노드만 apply(node, color) 로 알리고,
+	/// 끝난 애니메이션은 마지막 색을 알린 뒤 뺍니다. 다음 프레임까지 남은 시간 (us, 최소 1) 을 반환하며 움직이는 것이 없으면 0
+	/// </summary>
+	template <typename Apply>
+	uint64_t Tick(uint64_t nowUs, Apply&& apply);
+
+	const AnimationStats& Stats() const noexcept { return stats; }
+
+private:
+	enum class Kind : uint8_t
+	{
+		Fade,
+		Pulse,
+	};
+
+	struct Animation
+	{
+		uint32_t node = 0;
+		Kind kind = Kind::Fade;
+		uint32_t from = 0;
+		// Fade 는 최종 색, Pulse 는 돌아올 색
+		uint32_t to = 0;
+		uint64_t startUs = 0;
+		uint64_t durationUs = 0;
+		// 마지막으로 알린 색
+		uint32_t shown = 0;
+	};
+
+	BorderAnimationOptions options;
+	const EasingTable& easing;
+	std::vector<Animation> animations{};
+	// 노드 번호 -> animations 의 위치 + 1 (0 이면 없음)
+	std::vector<uint32_t> slots{};
+	uint64_t nextFrameUs = 0;
+	AnimationStats stats{};
+
+	Animation& Start(uint32_t node, uint64_t nowUs);
+	void RemoveAt(size_t index) noexcept;
+	uint32_t Evaluate(const Animation& animation, uint64_t nowUs) const noexcept;
+};
+
+template <typename Apply>
+uint64_t BorderAnimator::Tick(uint64_t nowUs, Apply&& apply)
+{
+	if (animations.empty())
+		return 0;
+	if (nowUs < nextFrameUs)
+		return nextFrameUs - nowUs;
+
+	stats.frames++;
+	stats.evaluated += animations.size();
+	for (size_t i = 0; i < animations.size();)
+	{
+		Animation& animation = animations[i];
+		const bool done = nowUs - animation.startUs >= animation.durationUs;
+		const uint32_t color = done ? animation.to : Evaluate(animation, nowUs);
+		if (color != animation.shown)
+		{
+			animation.shown = color;
+			stats.applied++;
+			apply(animation.node, color);
+		}
+
+		if (done)
+		{
+			stats.finished++;
+			// 빈자리에 마지막 것을 옮겨 오므로 i 는 그대로
+			RemoveAt(i);
+		}
+		else
+			++i;
+	}
+	stats.active = animations.size();
+
+	if (animations.empty())
+		return 0;
+	nextFrameUs = nowUs + options.frameIntervalUs;
+	return options.frameIntervalUs;
+}
@@ -0,0 +1,301 @@
+﻿#include "BorderCompositor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "BorderRaster.h"
+
+namespace
+{
+	/// <summary> a 에서 b 를 뺀 나머지 (최대 네 조각) 를 out 에 덧붙임 </summary>
+	void SubtractRect(const WindowRect& a, const WindowRect& b, std::vector<WindowRect>& out)
+	{
+		if (a.IsEmpty())
+			return;
+		if (!a.Intersects(b))
+		{
+			out.push_back(a);
+			return;
+		}
+
+		const int32_t top = std::max(a.top, b.top);
+		const int32_t bottom = std::min(a.bottom, b.bottom);
+		if (b.top > a.top)
+			out.push_back(WindowRect{ a.left, a.top, a.right, b.top });
+		if (b.bottom < a.bottom)
+			out.push_back(WindowRect{ a.left, b.bottom, a.right, a.bottom });
+		if (b.left > a.left)
+			out.push_back(WindowRect{ a.left, top, b.left, bottom });
+		if (b.right < a.right)
+			out.push_back(WindowRect{ b.right, top, a.right, bottom });
+	}
+
+	/// <summary> 컴포지터의 테두리 하나. 그리기는 Compose 에서 모아서 함 </summary>
+	class CompositedOverlay : public BorderOverlay
+	{
+	public:
+		CompositedOverlay(BorderCompositor& compositor, uint32_t border) : compositor(compositor), border(border) {}
+
+		~CompositedOverlay() override { compositor.Remove(border); }
+
+		bool Present(const BorderVisual& visual) override
+		{
+			compositor.Update(border, visual);
+			return true;
+		}
+
+		void Hide() override { compositor.Hide(border); }
+		void Raise() override { compositor.Raise(border); }
+
+	private:
+		BorderCompositor& compositor;
+		uint32_t border;
+	};
+}
+
+BorderCompositor::BorderCompositor(SurfaceFactory surfaceFactory) : surfaceFactory(std::move(surfaceFactory))
+{
+}
+
+void BorderCompositor::SetMonitors(const std::vector<MonitorArea>& areas)
+{
+	monitors.clear();
+	for (const MonitorArea& area : areas)
+	{
+		Monitor monitor{};
+		monitor.area = area;
+		monitor.surface = surfaceFactory(area);
+		if (!monitor.surface)
+			continue;
+
+		monitor.dirty = area.area;
+		monitors.push_back(std::move(monitor));
+	}
+}
+
+uint32_t BorderCompositor::Add(WindowHandle target)
+{
+	const uint32_t border = nextBorder++;
+	borders.Emplace(border, Border{ target, BorderVisual{}, false });
+	stacking.push_back(border);
+	return border;
+}
+
+void BorderCompositor::Update(uint32_t border, const BorderVisual& visual)
+{
+	Border* entry = borders.Find(border);
+	if (!entry || (entry->shown && entry->visual == visual))
+		return;
+
+	// 옮긴 경우 이전 자리와 새 자리를 모두 다시 그림
+	if (entry->shown)
+		Invalidate(entry->visual.bounds);
+	Invalidate(visual.bounds);
+	entry->visual = visual;
+	entry->shown = true;
+}
+
+void BorderCompositor::Hide(uint32_t border)
+{
+	Border* entry = borders.Find(border);
+	if (!entry || !entry->shown)
+		return;
+
+	Invalidate(entry->visual.bounds);
+	entry->shown = false;
+}
+
+void BorderCompositor::Raise(uint32_t border)
+{
+	auto found = std::find(stacking.begin(), stacking.end(), border);
+	if (found == stacking.end() || found + 1 == stacking.end())
+		return;
+
+	stacking.erase(found);
+	stacking.push_back(border);
+	if (const Border* entry = borders.Find(border); entry && entry->shown)
+		Invalidate(entry->visual.bounds);
+}
+
+void BorderCompositor::Remove(uint32_t border)
+{
+	Hide(border);
+	borders.Erase(border);
+	stacking.erase(std::remove(stacking.begin(), stacking.end(), border), stacking.end());
+}
+
+size_t BorderCompositor::Compose()
+{
+	size_t presented = 0;
+	for (Monitor& monitor : monitors)
+	{
+		if (monitor.dirty.IsEmpty())
+			continue;
+
+		ComposeMonitor(monitor);
+		presented++;
+	}
+
+	if (presented != 0)
+		stats.frames++;
+	return presented;
+}
+
+CompositorStats BorderCompositor::Stats() const noexcept
+{
+	CompositorStats snapshot = stats;
+	snapshot.borders = borders.Size();
+	snapshot.surfaces = monitors.size();
+	snapshot.surfaceBytes = 0;
+	for (const Monitor& monitor : monitors)
+		snapshot.surfaceBytes += static_cast<uint64_t>(monitor.surface->Width()) * static_cast<uint64_t>(monitor.surface->Height()) * sizeof(uint32_t);
+	return snapshot;
+}
+
+void BorderCompositor::Invalidate(const WindowRect& rect) noexcept
+{
+	// 여러 모니터에 걸친 테두리는 걸친 모니터마다 표시
+	for (Monitor& monitor : monitors)
+		monitor.dirty = monitor.dirty.Union(rect.Intersect(monitor.area.area));
+}
+
+void BorderCompositor::PushOccluder(const WindowRect& rect, const WindowRect& dirty)
+{
+	const WindowRect clipped = rect.Intersect(dirty);
+	if (!clipped.IsEmpty())
+		occluders.push_back(clipped);
+}
+
+void BorderCompositor::ComposeMonitor(Monitor& monitor)
+{
+	const WindowRect& area = monitor.area.area;
+	const WindowRect dirty = monitor.dirty;
+	monitor.dirty = WindowRect{};
+
+	uint32_t* pixels = monitor.surface->Pixels();
+	const size_t stride = static_cast<size_t>(monitor.surface->Width());
+	const auto fill = [&](const WindowRect& rect, uint32_t pixel)
+		{
+			FillPixels(pixels, stride, rect.Intersect(dirty).Offset(-area.left, -area.top), pixel);
+		};
+
+	fill(dirty, 0);
+
+	// 위 창부터: 띠에서 위에 있는 창 (프레임과 띠) 이 덮는 부분을 빼고 남은 조각만 그림. 겹쳐 그리는 픽셀이 없으므로
+	// 창이 많이 겹쳐도 쓰는 픽셀은 보이는 띠뿐
+	occluders.clear();
+	cornerOccluders.clear();
+	for (auto it = stacking.rbegin(); it != stacking.rend(); ++it)
+	{
+		const Border* entry = borders.Find(*it);
+		if (!entry->shown || !entry->visual.bounds.Intersects(dirty))
+			continue;
+
+		WindowRect strips[4];
+		BorderStrips(entry->visual, strips);
+		// 둥근 테두리는 곧은 변 네 띠와 모서리 네 정사각형. 모서리도 띠처럼 가려진 부분을 빼고 캐시한 덮임으로 채움
+		RoundedBorderParts rounded{};
+		const bool isRounded = MakeRoundedBorderParts(entry->visual, rounded);
+		const size_t partCount = isRounded ? 8 : 4;
+		const uint32_t pixel = BorderPixel(entry->visual.color, entry->visual.alpha);
+		for (size_t part = 0; part < partCount; ++part)
+		{
+			const WindowRect& rect = part < 4 ? (isRounded ? rounded.spans[part] : strips[part]) : rounded.corners[part - 4];
+			pieces.assign(1, rect.Intersect(dirty));
+			for (size_t i = 0; i < occluders.size() && !pieces.empty(); ++i)
+			{
+				remaining.clear();
+				for (const WindowRect& piece : pieces)
+					SubtractRect(piece, occluders[i], remaining);
+				pieces.swap(remaining);
+			}
+
+			// 위 창의 둥근 모서리에 닿지 않은 곧은 변 조각은 그대로 채움. 모서리와 위 창의 모서리 밑은 픽셀마다 덮임을 곱해 더함
+			// (덮임 0 은 건드리지 않으므로 위 창의 안티앨리어싱 가장자리 밑으로 아래 창이 섞여 보임)
+			for (const WindowRect& piece : pieces)
+			{
+				touching.clear();
+				for (const CornerSquare& above : cornerOccluders)
+				{
+					if (above.square.Intersects(piece))
+						touching.push_back(CornerSquare{ above.square.Offset(-area.left, -area.top), above.corner, above.mask });
+				}
+
+				if (part < 4 && touching.empty())
+				{
+					fill(piece, pixel);
+					continue;
+				}
+
+				const CornerSquare own{ rect.Offset(-area.left, -area.top), part - 4, rounded.mask };
+				AddCoveredPixels(pixels, stride, piece.Offset(-area.left, -area.top), pixel, part < 4 ? nullptr : &own, touching.data(), touching.size());
+			}
+		}
+		stats.bordersDrawn++;
+
+		// 둥근 테두리는 모서리 정사각형을 사각형 가림에서 빼고 원호 밖이 보이도록 따로 둠. 정사각형 안에서는 안쪽 원호 안
+		// (창과, 띠와 프레임 사이의 틈) 을 모두 가린 것으로 봄
+		const auto occlude = [&](const WindowRect& rect)
+			{
+				if (!isRounded)
+				{
+					PushOccluder(rect, dirty);
+					return;
+				}
+
+				pieces.assign(1, rect);
+				for (const WindowRect& corner : rounded.corners)
+				{
+					remaining.clear();
+					for (const WindowRect& piece : pieces)
+						SubtractRect(piece, corner, remaining);
+					pieces.swap(remaining);
+				}
+				for (const WindowRect& piece : pieces)
+					PushOccluder(piece, dirty);
+			};
+
+		// 아래 창은 위 창의 프레임뿐 아니라 위 창의 띠에도 가려짐. 띠가 프레임까지 닿으면 (보통의 경우) 둘을 합친 사각형 하나로
+		const BorderVisual& visual = entry->visual;
+		if (visual.MinEdgeThickness() + 1 >= visual.margin)
+		{
+			occlude(WindowRect{ visual.bounds.left + 1, visual.bounds.top + 1, visual.bounds.right - 1, visual.bounds.bottom - 1 });
+		}
+		else
+		{
+			occlude(visual.TargetFrame());
+			for (const WindowRect& strip : strips)
+				occlude(strip);
+		}
+
+		if (isRounded)
+		{
+			for (size_t corner = 0; corner < 4; ++corner)
+			{
+				if (rounded.corners[corner].Intersects(dirty))
+					cornerOccluders.push_back(CornerSquare{ rounded.corners[corner], corner, rounded.mask });
+			}
+		}
+	}
+
+	monitor.surface->Present(dirty.Offset(-area.left, -area.top));
+	stats.presents++;
+	stats.composedPixels += static_cast<uint64_t>(dirty.Area());
+}
+
+std::unique_ptr<BorderOverlay> CompositedWindowSystem::CreateOverlay(WindowHandle target, const BorderStyle&, const BorderVisual& visual)
+{
+	auto overlay = std::make_unique<CompositedOverlay>(compositor, compositor.Add(target));
+	overlay->Present(visual);
+	return overlay;
+}
+
+std::unique_ptr<BorderOverlay> CompositedWindowSystem::BeginOverlay(WindowHandle target, const BorderStyle&, const BorderVisual&)
+{
+	return std::make_unique<CompositedOverlay>(compositor, compositor.Add(target));
+}
+
+bool CompositedWindowSystem::FinishOverlay(BorderOverlay& overlay, const BorderVisual& visual)
+{
+	return overlay.Present(visual);
+}
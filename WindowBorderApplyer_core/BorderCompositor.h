@@ -0,0 +1,183 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "BorderLayout.h"
+#include "BorderRaster.h"
+#include "HandleRegistry.h"
+#include "WindowSystem.h"
+#include "WindowSystemTypes.h"
+
+/// <summary> 모니터 하나의 화면 좌표 영역 </summary>
+struct MonitorArea
+{
+	MonitorHandle monitor = nullptr;
+	WindowRect area{};
+};
+
+/// <summary>
+/// 모니터 하나를 덮는 표면. 픽셀은 premultiplied BGRA 이고 위에서 아래로, 한 행은 Width() 픽셀입니다.
+/// Windows 에서는 클릭이 통과하는 레이어드 창 하나 (UpdateLayeredWindowIndirect), 테스트에서는 SoftwareSurface 입니다
+/// </summary>
+class MonitorSurface
+{
+public:
+	virtual ~MonitorSurface() = default;
+
+	virtual uint32_t* Pixels() noexcept = 0;
+	virtual int32_t Width() const noexcept = 0;
+	virtual int32_t Height() const noexcept = 0;
+	/// <summary> 표면 좌표의 dirty 영역만 화면에 반영합니다 </summary>
+	virtual bool Present(const WindowRect& dirty) = 0;
+};
+
+/// <summary> 메모리에만 있는 표면. 반영한 횟수와 픽셀 수를 셉니다 </summary>
+class SoftwareSurface : public MonitorSurface
+{
+public:
+	SoftwareSurface(int32_t width, int32_t height) :
+		width(width),
+		height(height),
+		pixels(static_cast<size_t>(width) * static_cast<size_t>(height), 0)
+	{
+	}
+
+	uint32_t* Pixels() noexcept override { return pixels.data(); }
+	int32_t Width() const noexcept override { return width; }
+	int32_t Height() const noexcept override { return height; }
+
+	bool Present(const WindowRect& dirty) override
+	{
+		presents++;
+		presentedPixels += static_cast<uint64_t>(dirty.Area());
+		return true;
+	}
+
+	uint32_t PixelAt(int32_t x, int32_t y) const noexcept { return pixels[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)]; }
+	uint64_t Presents() const noexcept { return presents; }
+	uint64_t PresentedPixels() const noexcept { return presentedPixels; }
+
+private:
+	int32_t width;
+	int32_t height;
+	std::vector<uint32_t> pixels;
+	uint64_t presents = 0;
+	uint64_t presentedPixels = 0;
+};
+
+struct CompositorStats
+{
+	// Compose 호출 중 다시 그린 모니터가 있었던 횟수
+	uint64_t frames = 0;
+	// 표면 반영 (모니터마다 프레임당 최대 한 번)
+	uint64_t presents = 0;
+	// 다시 그린 영역에 걸친 테두리를 그린 횟수
+	uint64_t bordersDrawn = 0;
+	// 다시 그린 영역의 픽셀 수
+	uint64_t composedPixels = 0;
+	size_t borders = 0;
+	size_t surfaces = 0;
+	// 모든 표면의 픽셀 메모리 (창 수와 무관)
+	uint64_t surfaceBytes = 0;
+};
+
+/// <summary>
+/// 모든 테두리를 모니터마다 표면 하나에 모아 그립니다. 테두리가 바뀌면 그 영역만 표시하고, Compose 에서 표시된 영역을
+/// 한 번에 다시 그린 뒤 모니터마다 한 번만 반영합니다. 테두리에서 위에 있는 창의 대상 프레임과 테두리가 덮는 부분을 빼고 그리므로
+/// 위에 있는 창 아래로 가려진 테두리는 보이지 않습니다. 반투명 테두리는 바탕화면하고만 섞입니다 (테두리가 없는 창은 모르므로 가리지 않음). 한 스레드에서만 사용해야 합니다.
+/// </summary>
+class BorderCompositor
+{
+public:
+	using SurfaceFactory = std::function<std::unique_ptr<MonitorSurface>(const MonitorArea&)>;
+
+	explicit BorderCompositor(SurfaceFactory surfaceFactory);
+
+	BorderCompositor(const BorderCompositor&) = delete;
+	BorderCompositor& operator=(const BorderCompositor&) = delete;
+
+	/// <summary> 모니터 구성을 바꿉니다. 표면을 모두 새로 만들고 다음 Compose 에서 전부 다시 그립니다 </summary>
+	void SetMonitors(const std::vector<MonitorArea>& monitors);
+
+	/// <summary> 숨긴 테두리를 추가하고 번호를 반환합니다. 맨 위 창의 테두리가 됩니다 </summary>
+	uint32_t Add(WindowHandle target);
+	/// <summary> 테두리를 visual 로 보이게 합니다 </summary>
+	void Update(uint32_t border, const BorderVisual& visual);
+	void Hide(uint32_t border);
+	/// <summary> 대상 창이 맨 위로 올라옴 (포그라운드) </summary>
+	void Raise(uint32_t border);
+	void Remove(uint32_t border);
+
+	/// <summary> 표시된 영역이 있는 모니터만 다시 그리고 반영합니다. 반영한 모니터 수를 반환합니다 </summary>
+	size_t Compose();
+
+	CompositorStats Stats() const noexcept;
+	/// <summary> 테스트 / 벤치마크용: i 번째 모니터의 표면 </summary>
+	MonitorSurface* Surface(size_t monitor) const noexcept { return monitor < monitors.size() ? monitors[monitor].surface.get() : nullptr; }
+
+private:
+	struct Border
+	{
+		WindowHandle target = nullptr;
+		BorderVisual visual{};
+		bool shown = false;
+	};
+
+	struct Monitor
+	{
+		MonitorArea area{};
+		std::unique_ptr<MonitorSurface> surface;
+		// 다음 Compose 에서 다시 그릴 영역 (화면 좌표)
+		WindowRect dirty{};
+	};
+
+	SurfaceFactory surfaceFactory;
+	HandleRegistry<uint32_t, Border> borders{};
+	// 아래 창부터 위 창 순서의 테두리 번호
+	std::vector<uint32_t> stacking{};
+	std::vector<Monitor> monitors{};
+	uint32_t nextBorder = 1;
+	CompositorStats stats{};
+	// Compose 중에만 쓰는 버퍼: 지금까지 본 (위에 있는) 창의 프레임과 띠 (둥근 모서리 정사각형은 빼고), 띠에서 가려지지 않은 조각
+	std::vector<WindowRect> occluders{};
+	// 위에 있는 창의 둥근 모서리 정사각형 (화면 좌표). 원호 밖으로만 아래 창이 보이므로 픽셀마다 가림. 조각 하나에 닿는 것 (표면 좌표)
+	std::vector<CornerSquare> cornerOccluders{};
+	std::vector<CornerSquare> touching{};
+	std::vector<WindowRect> pieces{};
+	std::vector<WindowRect> remaining{};
+
+	void Invalidate(const WindowRect& rect) noexcept;
+	void PushOccluder(const WindowRect& rect, const WindowRect& dirty);
+	void ComposeMonitor(Monitor& monitor);
+};
+
+/// <summary>
+/// 창 시스템 장식자: 조회는 그대로 넘기고, 오버레이는 창마다 만들지 않고 BorderCompositor 의 테두리로 만듭니다.
+/// 표시 단계가 명령 묶음을 실행한 뒤 (FlushOverlays) 모든 모니터를 한 번에 그립니다. 오버레이는 compositor 를 쓰는 스레드에서만 다뤄야 합니다
+/// </summary>
+class CompositedWindowSystem : public WindowSystem
+{
+public:
+	CompositedWindowSystem(WindowSystem& windowSystem, BorderCompositor& compositor) : windowSystem(windowSystem), compositor(compositor) {}
+
+	void EnumerateWindows(std::vector<WindowHandle>& windows) override { windowSystem.EnumerateWindows(windows); }
+	bool IsBorderCandidate(WindowHandle window) override { return windowSystem.IsBorderCandidate(window); }
+	bool GetFrameBounds(WindowHandle window, WindowRect& frame) override { return windowSystem.GetFrameBounds(window, frame); }
+	MonitorHandle GetMonitor(WindowHandle window, const WindowRect& frame) override { return windowSystem.GetMonitor(window, frame); }
+	uint32_t GetMonitorDpi(MonitorHandle monitor) override { return windowSystem.GetMonitorDpi(monitor); }
+	bool IsOnCurrentDesktop(WindowHandle window) override { return windowSystem.IsOnCurrentDesktop(window); }
+	WindowLiveness QueryLiveness(WindowHandle window) override { return windowSystem.QueryLiveness(window); }
+
+	std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) override;
+	/// <summary> 테두리 하나는 번호뿐이라 준비할 자원이 없음. Prepare 는 작업 스레드에서 불리므로 아무것도 건드리지 않음 </summary>
+	std::unique_ptr<BorderOverlay> BeginOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) override;
+	bool FinishOverlay(BorderOverlay& overlay, const BorderVisual& visual) override;
+	void FlushOverlays() override { compositor.Compose(); }
+
+private:
+	WindowSystem& windowSystem;
+	BorderCompositor& compositor;
+};
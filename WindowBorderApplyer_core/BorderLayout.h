@@ -0,0 +1,206 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "WindowSystemTypes.h"
+
+constexpr uint32_t DefaultDpi = 96;
+
+/// <summary> 모든 테두리에 공통으로 적용되는 설정 </summary>
+struct BorderStyle
+{
+	// COLORREF 와 같은 배치 (0x00BBGGRR)
+	uint32_t color = 0;
+	// 대상 창의 프레임 바깥으로 오버레이 창을 넓히는 폭 (픽셀, DPI 와 무관)
+	int32_t borderLength = 3;
+	// 96 DPI 기준 선 두께. 실제 두께는 DPI 에 비례
+	float thickness = 2.0f;
+	// 96 DPI 기준 바깥 모서리 반지름 (0 이면 직각). 실제 반지름은 DPI 에 비례
+	float cornerRadius = 0.0f;
+	// 테두리 불투명도 (255 = 불투명). 픽셀마다 알파를 쓰는 소프트웨어 그리기 / 공유 오버레이에서만 적용
+	uint8_t opacity = 255;
+	// 변마다 선 두께 (96 DPI 기준, 위 / 아래 / 왼쪽 / 오른쪽). 0 인 변은 thickness
+	std::array<float, 4> edgeThickness{};
+	// gradient 면 위쪽 color 에서 아래쪽 gradientColor 로 바뀌는 세로 그라데이션 (Direct2D 에서만. 소프트웨어 그리기는 color 로 채움)
+	uint32_t gradientColor = 0;
+	bool gradient = false;
+};
+
+/// <summary> 창 모서리 설정. DWM_WINDOW_CORNER_PREFERENCE (DWMWA_WINDOW_CORNER_PREFERENCE) 와 같은 값 </summary>
+enum class CornerPreference : uint32_t
+{
+	// 시스템 기본 (Windows 11 은 둥글게, 그 전은 직각)
+	Default = 0,
+	DoNotRound = 1,
+	Round = 2,
+	RoundSmall = 3,
+};
+
+/// <summary> 창 모서리의 반지름 (96 DPI 기준). systemRounds 면 Default 를 Round 로 봄 (Windows 11) </summary>
+constexpr float WindowCornerRadius(CornerPreference preference, bool systemRounds) noexcept
+{
+	switch (preference)
+	{
+	case CornerPreference::Round:
+		return 8.0f;
+	case CornerPreference::RoundSmall:
+		return 4.0f;
+	case CornerPreference::Default:
+		return systemRounds ? 8.0f : 0.0f;
+	default:
+		return 0.0f;
+	}
+}
+
+/// <summary> 창 모서리를 따라 도는 테두리의 바깥 반지름 (96 DPI 기준). 안쪽 원호가 창 모서리에 닿도록 선 두께만큼 크게 </summary>
+constexpr float BorderCornerRadius(float windowRadius, const BorderStyle& style) noexcept
+{
+	return windowRadius > 0.0f ? windowRadius + style.thickness : 0.0f;
+}
+
+/// <summary> 스타일 표 (BorderStyleTable) 의 번호 </summary>
+using StyleId = uint16_t;
+constexpr StyleId NoStyle = 0xFFFF;
+
+/// <summary> BorderStyle 을 한 DPI 로 해석한 값 (BorderVisual 에서 위치를 뺀 나머지). 스타일 표는 같은 값을 하나만 둡니다 </summary>
+struct ResolvedStyle
+{
+	uint32_t color = 0;
+	int32_t thickness = 0;
+	float cornerRadius = 0.0f;
+	int32_t margin = 0;
+	uint8_t alpha = 255;
+	bool gradient = false;
+	uint32_t gradientColor = 0;
+	std::array<int32_t, 4> edgeThickness{};
+	// 해석한 DPI. 스타일이 바뀌면 같은 DPI 로 다시 해석
+	uint32_t dpi = DefaultDpi;
+
+	bool operator==(const ResolvedStyle& other) const noexcept = default;
+};
+
+/// <summary> 선 두께와 모서리 반지름을 DPI 에 비례하게 맞춥니다 </summary>
+inline ResolvedStyle ResolveBorderStyle(const BorderStyle& style, uint32_t dpi) noexcept
+{
+	const float scale = static_cast<float>(dpi) / static_cast<float>(DefaultDpi);
+	ResolvedStyle resolved{};
+	resolved.color = style.color;
+	resolved.thickness = static_cast<int32_t>(style.thickness * scale);
+	resolved.cornerRadius = style.cornerRadius * scale;
+	resolved.margin = style.borderLength;
+	resolved.alpha = style.opacity;
+	resolved.gradient = style.gradient;
+	resolved.gradientColor = style.gradient ? style.gradientColor : 0;
+	for (size_t edge = 0; edge < style.edgeThickness.size(); ++edge)
+		resolved.edgeThickness[edge] = static_cast<int32_t>(style.edgeThickness[edge] * scale);
+	resolved.dpi = dpi;
+	return resolved;
+}
+
+/// <summary> 오버레이 창 하나를 그리는 데 필요한 값. 창 시스템 구현은 이 값만 보고 그립니다 </summary>
+struct BorderVisual
+{
+	// 오버레이 창의 화면 좌표
+	WindowRect bounds{};
+	uint32_t color = 0;
+	int32_t thickness = 0;
+	float cornerRadius = 0.0f;
+	// bounds 와 대상 창 프레임 사이의 폭 (BorderStyle::borderLength)
+	int32_t margin = 0;
+	uint8_t alpha = 255;
+	// 변마다 선 두께 (BorderStrips 의 띠 순서). 0 인 변은 thickness
+	std::array<int32_t, 4> edgeThickness{};
+	uint32_t gradientColor = 0;
+	bool gradient = false;
+	// 스타일 표에서 만든 값이면 그 번호 (비교에는 쓰지 않음)
+	StyleId style = NoStyle;
+
+	/// <summary> 위치를 뺀 나머지 (dpi 는 알 수 없어 0) </summary>
+	ResolvedStyle Style() const noexcept
+	{
+		return ResolvedStyle{ color, thickness, cornerRadius, margin, alpha, gradient, gradientColor, edgeThickness, 0 };
+	}
+
+	/// <summary> edge 번째 변 (위, 아래, 왼쪽, 오른쪽) 의 선 두께 </summary>
+	int32_t EdgeThickness(size_t edge) const noexcept { return edgeThickness[edge] != 0 ? edgeThickness[edge] : thickness; }
+	/// <summary> 두께가 thickness 와 다른 변이 있는지 </summary>
+	bool HasEdgeThickness() const noexcept
+	{
+		for (size_t edge = 0; edge < edgeThickness.size(); ++edge)
+		{
+			if (EdgeThickness(edge) != thickness)
+				return true;
+		}
+		return false;
+	}
+	/// <summary> 가장 얇은 변의 두께 </summary>
+	int32_t MinEdgeThickness() const noexcept
+	{
+		int32_t result = EdgeThickness(0);
+		for (size_t edge = 1; edge < edgeThickness.size(); ++edge)
+			result = EdgeThickness(edge) < result ? EdgeThickness(edge) : result;
+		return result;
+	}
+
+	/// <summary> 오버레이 창 안에서의 좌표 (0, 0 기준) </summary>
+	WindowRect LocalRect() const noexcept { return WindowRect{ 0, 0, bounds.Width(), bounds.Height() }; }
+	/// <summary> 대상 창의 프레임 사각형 (화면 좌표) </summary>
+	WindowRect TargetFrame() const noexcept
+	{
+		return WindowRect{ bounds.left + margin, bounds.top + margin, bounds.right - margin, bounds.bottom - margin };
+	}
+
+	/// <summary> 위치만 다르고 다시 그릴 필요가 없는지 </summary>
+	bool SameShape(const BorderVisual& other) const noexcept
+	{
+		return bounds.Width() == other.bounds.Width() && bounds.Height() == other.bounds.Height()
+			&& color == other.color && thickness == other.thickness && cornerRadius == other.cornerRadius && margin == other.margin && alpha == other.alpha
+			&& edgeThickness == other.edgeThickness && gradient == other.gradient && gradientColor == other.gradientColor;
+	}
+
+	bool operator==(const BorderVisual& other) const noexcept { return bounds == other.bounds && SameShape(other); }
+	bool operator!=(const BorderVisual& other) const noexcept { return !(*this == other); }
+};
+
+/// <summary> bounds 에 resolved 를 입힌 visual. id 는 resolved 의 스타일 표 번호 </summary>
+inline BorderVisual MakeBorderVisual(const WindowRect& bounds, const ResolvedStyle& resolved, StyleId id = NoStyle) noexcept
+{
+	BorderVisual visual{};
+	visual.bounds = bounds;
+	visual.color = resolved.color;
+	visual.thickness = resolved.thickness;
+	visual.cornerRadius = resolved.cornerRadius;
+	visual.margin = resolved.margin;
+	visual.alpha = resolved.alpha;
+	visual.edgeThickness = resolved.edgeThickness;
+	visual.gradientColor = resolved.gradientColor;
+	visual.gradient = resolved.gradient;
+	visual.style = id;
+	return visual;
+}
+
+/// <summary> 대상 창의 프레임 사각형을 margin 만큼 넓힌 오버레이 위치 </summary>
+inline WindowRect BorderBounds(const WindowRect& frame, int32_t margin) noexcept
+{
+	return WindowRect{ frame.left - margin, frame.top - margin, frame.right + margin, frame.bottom + margin };
+}
+
+/// <summary> 대상 창의 프레임 사각형과 DPI 로 오버레이 위치와 선 두께를 계산합니다 </summary>
+inline BorderVisual ComputeBorderVisual(const WindowRect& frame, uint32_t dpi, const BorderStyle& style) noexcept
+{
+	const ResolvedStyle resolved = ResolveBorderStyle(style, dpi);
+	return MakeBorderVisual(BorderBounds(frame, resolved.margin), resolved);
+}
+
+/// <summary> 테두리마다 기억하는 값: 위치와 스타일 번호뿐. 그릴 때 스타일 표 (BorderStyleTable::Expand) 로 BorderVisual 을 만듭니다 </summary>
+struct BorderPlacement
+{
+	// 오버레이 창의 화면 좌표
+	WindowRect bounds{};
+	StyleId style = NoStyle;
+
+	bool operator==(const BorderPlacement& other) const noexcept { return bounds == other.bounds && style == other.style; }
+	bool operator!=(const BorderPlacement& other) const noexcept { return !(*this == other); }
+};
@@ -0,0 +1,649 @@
+﻿#include "BorderPipeline.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace
+{
+	uint64_t NowUs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	std::chrono::steady_clock::time_point TimePointFromUs(uint64_t us)
+	{
+		return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::microseconds(us)));
+	}
+}
+
+/// <summary> 레이아웃 단계의 오버레이: 그리지 않고 표시 명령만 보냅니다 </summary>
+class BorderPipeline::DeferredOverlay : public BorderOverlay
+{
+public:
+	DeferredOverlay(BorderPipeline& pipeline, uint32_t id, WindowHandle target) : pipeline(pipeline), id(id), target(target) {}
+
+	~DeferredOverlay() override
+	{
+		pipeline.EnqueuePresent(PresentCommand{ PresentOp::Destroy, id, target });
+		// 명령은 순서대로 실행되므로 파괴 명령 뒤에 같은 번호를 다시 써도 됨
+		pipeline.freeOverlayIds.push_back(id);
+	}
+
+	bool Present(const BorderVisual& visual) override
+	{
+		pipeline.EnqueuePresent(PresentCommand{ PresentOp::Present, id, target, BorderPlacement{ visual.bounds, visual.style } });
+		return true;
+	}
+
+	void Hide() override
+	{
+		pipeline.EnqueuePresent(PresentCommand{ PresentOp::Hide, id, target });
+	}
+
+	void Raise() override
+	{
+		pipeline.EnqueuePresent(PresentCommand{ PresentOp::Raise, id, target });
+	}
+
+	void Focus() override
+	{
+		pipeline.EnqueuePresent(PresentCommand{ PresentOp::Focus, id, target });
+	}
+
+private:
+	BorderPipeline& pipeline;
+	uint32_t id;
+	WindowHandle target;
+};
+
+/// <summary> 레이아웃 단계의 창 시스템: 조회는 그대로 넘기고 오버레이 생성은 표시 단계로 미룹니다 </summary>
+class BorderPipeline::DeferredWindowSystem : public WindowSystem
+{
+public:
+	DeferredWindowSystem(BorderPipeline& pipeline, WindowSystem& windowSystem) : pipeline(pipeline), windowSystem(windowSystem) {}
+
+	void EnumerateWindows(std::vector<WindowHandle>& windows) override { windowSystem.EnumerateWindows(windows); }
+	bool IsBorderCandidate(WindowHandle window) override { return windowSystem.IsBorderCandidate(window); }
+	bool GetFrameBounds(WindowHandle window, WindowRect& frame) override { return windowSystem.GetFrameBounds(window, frame); }
+	MonitorHandle GetMonitor(WindowHandle window, const WindowRect& frame) override { return windowSystem.GetMonitor(window, frame); }
+	uint32_t GetMonitorDpi(MonitorHandle monitor) override { return windowSystem.GetMonitorDpi(monitor); }
+	bool IsOnCurrentDesktop(WindowHandle window) override { return windowSystem.IsOnCurrentDesktop(window); }
+	WindowLiveness QueryLiveness(WindowHandle window) override { return windowSystem.QueryLiveness(window); }
+
+	std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle target, const BorderStyle&, const BorderVisual& visual) override
+	{
+		// 실제 생성이 실패하면 표시 단계가 이 번호의 이후 명령을 무시함
+		const uint32_t id = pipeline.AllocateOverlayId();
+		pipeline.EnqueuePresent(PresentCommand{ PresentOp::Create, id, target, BorderPlacement{ visual.bounds, visual.style } });
+		return std::make_unique<DeferredOverlay>(pipeline, id, target);
+	}
+
+private:
+	BorderPipeline& pipeline;
+	WindowSystem& windowSystem;
+};
+
+void BorderPipeline::StageCounters::Record(uint64_t latencyUs, uint64_t depth) noexcept
+{
+	items.fetch_add(1, std::memory_order_relaxed);
+	totalLatencyUs.fetch_add(latencyUs, std::memory_order_relaxed);
+	if (latencyUs > maxLatencyUs.load(std::memory_order_relaxed))
+		maxLatencyUs.store(latencyUs, std::memory_order_relaxed);
+	if (depth > maxQueueDepth.load(std::memory_order_relaxed))
+		maxQueueDepth.store(depth, std::memory_order_relaxed);
+}
+
+PipelineStageStats BorderPipeline::StageCounters::Snapshot(uint64_t depth) const noexcept
+{
+	PipelineStageStats stats{};
+	stats.items = items.load(std::memory_order_relaxed);
+	stats.rejected = rejected.load(std::memory_order_relaxed);
+	stats.queueDepth = depth;
+	stats.maxQueueDepth = maxQueueDepth.load(std::memory_order_relaxed);
+	stats.totalLatencyUs = totalLatencyUs.load(std::memory_order_relaxed);
+	stats.maxLatencyUs = maxLatencyUs.load(std::memory_order_relaxed);
+	return stats;
+}
+
+BorderPipeline::BorderPipeline(WindowSystem& windowSystem, const BorderStyle& style, const PipelineOptions& options) :
+	windowSystem(windowSystem),
+	style(style),
+	options(options),
+	layoutWindowSystem(std::make_unique<DeferredWindowSystem>(*this, windowSystem)),
+	tracker(std::make_unique<BorderTracker>(*layoutWindowSystem, style, options.poll)),
+	ingestQueue(options.ingestCapacity),
+	presentQueue(options.presentCapacity),
+	scene(tracker->Styles()),
+	animator(options.animation)
+{
+	if (options.createWorkers > 0)
+		createPool = std::make_unique<WorkStealingPool>(options.createWorkers);
+}
+
+BorderPipeline::~BorderPipeline()
+{
+	Stop();
+
+	// 표시 스레드가 이미 끝났으므로 추적기가 보내는 파괴 명령은 버림
+	presentReleased.store(true, std::memory_order_release);
+	tracker.reset();
+}
+
+void BorderPipeline::Start(std::function<void()> presentReady, FrameCallback frameCallback)
+{
+	if (layoutThread.joinable())
+		return;
+
+	onPresentReady = std::move(presentReady);
+	onFrame = std::move(frameCallback);
+	stopping.store(false, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		accepting = true;
+	}
+	layoutThread = std::thread(&BorderPipeline::RunLayout, this);
+}
+
+void BorderPipeline::Stop()
+{
+	if (!layoutThread.joinable())
+		return;
+
+	stopping.store(true, std::memory_order_release);
+	Wake();
+	layoutThread.join();
+}
+
+bool BorderPipeline::Ingest(const Event& event) noexcept
+{
+	// 사전 필터를 가장 먼저: 캐럿, 커서, 자식 개체와 추적하지 않는 창의 이벤트는 큐에 넣지 않음. 추적 집합의 비트맵은
+	// 레이아웃 스레드가 바꾸는 대로 단어마다 원자적으로 게시되므로 잠그지 않고 읽음. 막 빠진 창은 거짓 양성이라 레이아웃 단계가 다시 확인
+	if (!event.hwnd || !tracker->MayAccept(event.event, event.hwnd, event.idObject, event.idChild))
+	{
+		filtered.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	if (!ingestQueue.TryPush(IngestedEvent{ event, NowUs() }))
+	{
+		// 놓친 이벤트를 알 수 없으므로 레이아웃 단계가 전체를 다시 맞춤
+		layoutCounters.rejected.fetch_add(1, std::memory_order_relaxed);
+		resyncRequested.store(true, std::memory_order_release);
+		Wake();
+		return false;
+	}
+
+	ingested.fetch_add(1, std::memory_order_relaxed);
+	Wake();
+	return true;
+}
+
+bool BorderPipeline::Post(LayoutCommand command)
+{
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		if (!accepting)
+			return false;
+		commands.push_back(std::move(command));
+	}
+	Wake();
+	return true;
+}
+
+bool BorderPipeline::SetStyle(const BorderStyle& style)
+{
+	return Post([style](BorderTracker& tracker) { tracker.SetStyle(style); });
+}
+
+void BorderPipeline::Wake() noexcept
+{
+	if (layoutSignal.exchange(1, std::memory_order_acq_rel) == 0)
+		layoutWakeup.release();
+}
+
+void BorderPipeline::RunLayout()
+{
+	uint64_t frameDeadlineUs = 0;
+	uint64_t pollDeadlineUs = 0;
+	for (;;)
+	{
+		// 대기 중인 프레임이 있으면 프레임 경계까지 잠. 없으면 깨울 때까지, 위치 확인 타이머가 있으면 그 시각까지
+		if (frameDeadlineUs != 0)
+		{
+			std::this_thread::sleep_until(TimePointFromUs(frameDeadlineUs));
+			// 자는 동안 쌓인 깨움은 이번에 함께 처리
+			while (layoutWakeup.try_acquire())
+			{
+			}
+		}
+		else if (pollDeadlineUs == 0)
+			layoutWakeup.acquire();
+		else if (!layoutWakeup.try_acquire_until(TimePointFromUs(pollDeadlineUs)))
+			pollWakeups.fetch_add(1, std::memory_order_relaxed);
+
+		layoutSignal.exchange(0, std::memory_order_acq_rel);
+		if (stopping.load(std::memory_order_acquire))
+		{
+			// 멈추기 전에 받은 작업은 실행 (정리 요청이나 결과를 기다리는 호출자가 있을 수 있음)
+			{
+				std::lock_guard<std::mutex> lock(commandMutex);
+				accepting = false;
+			}
+			RunCommands();
+			return;
+		}
+
+		RunCommands();
+
+		if (resyncRequested.exchange(false, std::memory_order_acq_rel))
+		{
+			resyncs.fetch_add(1, std::memory_order_relaxed);
+			tracker->RefreshBorders();
+			tracker->RefreshGeometry();
+		}
+		tracker->SyncDesktop();
+
+		frameDeadlineUs = DrainIngest(frameDeadlineUs);
+		if (frameDeadlineUs != 0 && NowUs() >= frameDeadlineUs)
+		{
+			tracker->Flush(NowUs());
+			frameDeadlineUs = 0;
+			frames.fetch_add(1, std::memory_order_relaxed);
+
+			if (onFrame)
+				onFrame(*tracker);
+		}
+
+		pollDeadlineUs = tracker->Poll(NowUs());
+	}
+}
+
+void BorderPipeline::RunCommands()
+{
+	std::vector<LayoutCommand> pending{};
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		pending.swap(commands);
+	}
+
+	for (auto& command : pending)
+		command(*tracker);
+}
+
+uint64_t BorderPipeline::DrainIngest(uint64_t frameDeadlineUs)
+{
+	IngestedEvent item{};
+	while (ingestQueue.TryPop(item))
+	{
+		const uint64_t nowUs = NowUs();
+		layoutCounters.Record(nowUs - item.ingestUs, ingestQueue.ApproxSize());
+
+		const Event& event = item.event;
+		if (!tracker->Accept(event.event, event.hwnd, event.idObject, event.idChild))
+			continue;
+
+		// 병합 대기열이 비어 있다가 채워졌으면 이 시점부터 한 프레임 뒤에 반영
+		if (tracker->PushEvent(event, nowUs) && frameDeadlineUs == 0)
+			frameDeadlineUs = nowUs + options.frameIntervalUs;
+	}
+	return frameDeadlineUs;
+}
+
+uint32_t BorderPipeline::AllocateOverlayId()
+{
+	if (!freeOverlayIds.empty())
+	{
+		const uint32_t id = freeOverlayIds.back();
+		freeOverlayIds.pop_back();
+		return id;
+	}
+	return nextOverlayId++;
+}
+
+void BorderPipeline::EnqueuePresent(const PresentCommand& command)
+{
+	if (presentReleased.load(std::memory_order_acquire))
+		return;
+
+	PresentCommand stamped = command;
+	stamped.enqueueUs = NowUs();
+
+	// 표시 단계가 밀리면 레이아웃 단계가 기다림 (수신 단계는 계속 큐에 넣음)
+	while (!presentQueue.TryPush(stamped))
+	{
+		if (presentReleased.load(std::memory_order_acquire))
+			return;
+
+		presentCounters.rejected.fetch_add(1, std::memory_order_relaxed);
+		if (onPresentReady)
+			onPresentReady();
+		std::this_thread::yield();
+	}
+
+	if (!presentSignaled.exchange(true, std::memory_order_acq_rel) && onPresentReady)
+		onPresentReady();
+}
+
+size_t BorderPipeline::PumpPresent()
+{
+	// 먼저 내려야 이후에 들어온 명령이 다시 깨움
+	presentSignaled.exchange(false, std::memory_order_acq_rel);
+
+	size_t executed = 0;
+	PresentCommand command{};
+	while (presentQueue.TryPop(command))
+	{
+		presentCounters.Record(NowUs() - command.enqueueUs, presentQueue.ApproxSize());
+		executed++;
+
+		if (command.op == PresentOp::Create)
+		{
+			// 보관 오버레이가 있으면 만들지 않고 다시 붙임
+			if (TryRebind(command))
+				continue;
+
+			if (pendingCreateIds.size() <= command.overlay)
+				pendingCreateIds.resize(static_cast<size_t>(command.overlay) + 1, 0);
+			pendingCreateIds[command.overlay] = 1;
+			pendingCreates.push_back(command);
+			continue;
+		}
+
+		if (IsPendingCreate(command.overlay))
+		{
+			// 만들기 전에 파괴하면 번호가 다시 쓰일 수 있으므로 모은 것을 먼저 만듦. 나머지는 만든 뒤에 실행
+			if (command.op != PresentOp::Destroy)
+			{
+				deferredCommands.push_back(command);
+				continue;
+			}
+			CreatePending();
+		}
+		ExecutePresent(command);
+	}
+
+	CreatePending();
+	CommitScene();
+	// 공유 오버레이는 여기서 명령 묶음 전체를 한 번에 그림
+	if (executed != 0)
+		windowSystem.FlushOverlays();
+	return executed;
+}
+
+bool BorderPipeline::IsPendingCreate(uint32_t overlay) const noexcept
+{
+	return overlay < pendingCreateIds.size() && pendingCreateIds[overlay] != 0;
+}
+
+void BorderPipeline::CreatePending()
+{
+	if (pendingCreates.empty())
+		return;
+
+	const uint64_t startUs = NowUs();
+	const size_t count = pendingCreates.size();
+	std::vector<std::unique_ptr<BorderOverlay>> created(count);
+	// 작업 스레드가 동시에 쓰므로 vector<bool> 대신 바이트 단위
+	std::vector<uint8_t> prepared(count, 0);
+
+	// 번호로 받은 스타일을 한 번만 펼침. 레코드는 번호를 보내기 전에 채워졌고 바뀌지 않음
+	const BorderStyleTable& styles = tracker->Styles();
+	std::vector<BorderVisual> visuals(count);
+	for (size_t i = 0; i < count; ++i)
+		visuals[i] = styles.Expand(pendingCreates[i].placement);
+
+	// 창 생성은 오버레이를 소유할 이 스레드에서
+	for (size_t i = 0; i < count; ++i)
+		created[i] = windowSystem.BeginOverlay(pendingCreates[i].target, style, visuals[i]);
+
+	// 장치 독립인 그리기 준비 (모양 계산, 소프트웨어 DIB) 는 작업 풀에 나눔. 렌더 타깃과 첫 그리기는 FinishOverlay 에서
+	const std::function<void(size_t)> prepare = [this, &created, &prepared, &visuals](size_t i)
+		{
+			prepared[i] = created[i] && windowSystem.PrepareOverlay(*created[i], visuals[i]);
+		};
+	if (createPool)
+		createPool->ParallelFor(count, prepare);
+	else
+	{
+		for (size_t i = 0; i < count; ++i)
+			prepare(i);
+	}
+
+	// z 순서와 표시는 다시 이 스레드에서. 실패한 오버레이는 created 와 함께 여기서 파괴
+	size_t succeeded = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		const PresentCommand& command = pendingCreates[i];
+		if (overlays.size() <= command.overlay)
+			overlays.resize(static_cast<size_t>(command.overlay) + 1);
+
+		if (prepared[i] && windowSystem.FinishOverlay(*created[i], visuals[i]))
+		{
+			overlays[command.overlay] = std::move(created[i]);
+			scene.Insert(command.overlay, command.placement);
+			succeeded++;
+		}
+		else
+			overlays[command.overlay] = nullptr;
+
+		pendingCreateIds[command.overlay] = 0;
+	}
+	pendingCreates.clear();
+
+	const uint64_t elapsedUs = NowUs() - startUs;
+	createBatches.fetch_add(1, std::memory_order_relaxed);
+	overlaysCreated.fetch_add(succeeded, std::memory_order_relaxed);
+	createUs.fetch_add(elapsedUs, std::memory_order_relaxed);
+	if (elapsedUs > maxCreateBatchUs.load(std::memory_order_relaxed))
+		maxCreateBatchUs.store(elapsedUs, std::memory_order_relaxed);
+
+	for (const PresentCommand& deferred : deferredCommands)
+		ExecutePresent(deferred);
+	deferredCommands.clear();
+}
+
+void BorderPipeline::ReleaseOverlays()
+{
+	PumpPresent();
+	presentReleased.store(true, std::memory_order_release);
+	scene.Clear();
+	animator.Clear();
+	overlays.clear();
+	parkedOverlays.clear();
+	pooledOverlays.store(0, std::memory_order_relaxed);
+	windowSystem.FlushOverlays();
+}
+
+uint64_t BorderPipeline::TrimOverlayPool()
+{
+	const uint64_t nowUs = NowUs();
+	while (!parkedOverlays.empty() && nowUs - parkedOverlays.front().parkedUs >= options.overlayPoolIdleUs)
+	{
+		parkedOverlays.pop_front();
+		poolTrims.fetch_add(1, std::memory_order_relaxed);
+	}
+	pooledOverlays.store(parkedOverlays.size(), std::memory_order_relaxed);
+
+	if (parkedOverlays.empty())
+		return 0;
+	return parkedOverlays.front().parkedUs + options.overlayPoolIdleUs - nowUs;
+}
+
+bool BorderPipeline::TryRebind(const PresentCommand& command)
+{
+	while (!parkedOverlays.empty())
+	{
+		std::unique_ptr<BorderOverlay> overlay = std::move(parkedOverlays.back().overlay);
+		parkedOverlays.pop_back();
+		pooledOverlays.store(parkedOverlays.size(), std::memory_order_relaxed);
+
+		// 다시 붙이지 못한 오버레이는 파괴하고 다음 것을 시도
+		if (!overlay->Rebind(command.target, tracker->Styles().Expand(command.placement)))
+			continue;
+
+		if (overlays.size() <= command.overlay)
+			overlays.resize(static_cast<size_t>(command.overlay) + 1);
+		overlays[command.overlay] = std::move(overlay);
+		scene.Insert(command.overlay, command.placement);
+		poolRebinds.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+	return false;
+}
+
+void BorderPipeline::ParkOrDestroy(std::unique_ptr<BorderOverlay> overlay)
+{
+	if (!overlay)
+		return;
+
+	// 상한에 닿았거나 보관할 수 없는 오버레이는 여기서 파괴
+	if (parkedOverlays.size() >= options.overlayPoolLimit || !overlay->Park())
+		return;
+
+	parkedOverlays.push_back(ParkedOverlay{ std::move(overlay), NowUs() });
+	poolParks.fetch_add(1, std::memory_order_relaxed);
+	pooledOverlays.store(parkedOverlays.size(), std::memory_order_relaxed);
+}
+
+void BorderPipeline::ExecutePresent(const PresentCommand& command)
+{
+	// 생성 명령은 CreatePending 이 처리
+	if (command.overlay >= overlays.size() || !overlays[command.overlay])
+		return;
+
+	// 표시 / 숨김은 장면에 기록만 하고 CommitScene 에서 노드마다 한 번 반영
+	switch (command.op)
+	{
+	case PresentOp::Present:
+		scene.Show(command.overlay, command.placement);
+		break;
+	case PresentOp::Hide:
+		scene.Hide(command.overlay);
+		break;
+	case PresentOp::Raise:
+		// 공유 오버레이의 쌓는 순서는 명령 순서대로 바로 바꾸고, 창마다 오버레이는 반영할 때 z 순서를 다시 맞춤
+		overlays[command.overlay]->Raise();
+		scene.Restack(command.overlay);
+		break;
+	case PresentOp::Focus:
+		// 이미 반영한 색에서 깜빡임 (숨겨져 있으면 다시 보일 때 깜빡이지 않음)
+		if (animator.PulseEnabled() && scene.IsShown(command.overlay))
+			animator.Pulse(command.overlay, tracker->Styles().Get(scene.Committed(command.overlay).style).color, NowUs());
+		break;
+	case PresentOp::Destroy:
+		scene.Remove(command.overlay);
+		animator.Cancel(command.overlay);
+		ParkOrDestroy(std::move(overlays[command.overlay]));
+		break;
+	default:
+		break;
+	}
+}
+
+void BorderPipeline::CommitScene()
+{
+	const uint64_t nowUs = NowUs();
+	scene.Commit([this, nowUs](uint32_t overlay, const BorderVisual& visual, uint8_t dirty)
+		{
+			if (!overlays[overlay])
+				return;
+
+			// 보이던 테두리의 색이 바뀌면 반영한 색에서 이어서 바꿈. 색만 바뀌었으면 Animate 가 그림
+			if ((dirty & BorderDirty::Color) != 0 && (dirty & BorderDirty::Visibility) == 0 && animator.FadeEnabled())
+			{
+				animator.Fade(overlay, tracker->Styles().Get(scene.Committed(overlay).style).color, visual.color, nowUs);
+				if (dirty == BorderDirty::Color && animator.IsAnimating(overlay))
+					return;
+			}
+
+			// 움직이는 중에 옮기거나 크기가 바뀌면 색만 지금 보이는 색으로
+			uint32_t color = 0;
+			if (animator.CurrentColor(overlay, color))
+			{
+				BorderVisual animated = visual;
+				animated.color = color;
+				overlays[overlay]->Present(animated);
+			}
+			else
+				overlays[overlay]->Present(visual);
+		},
+		[this](uint32_t overlay)
+		{
+			animator.Cancel(overlay);
+			if (overlays[overlay])
+				overlays[overlay]->Hide();
+		});
+}
+
+uint64_t BorderPipeline::Animate()
+{
+	if (animator.Size() == 0)
+		return 0;
+
+	bool presented = false;
+	const uint64_t delayUs = animator.Tick(NowUs(), [this, &presented](uint32_t overlay, uint32_t color)
+		{
+			if (overlay >= overlays.size() || !overlays[overlay] || !scene.IsShown(overlay))
+				return;
+
+			BorderVisual visual = tracker->Styles().Expand(scene.Committed(overlay));
+			visual.color = color;
+			overlays[overlay]->Present(visual);
+			presented = true;
+		});
+	// 공유 오버레이는 프레임마다 한 번 그림
+	if (presented)
+		windowSystem.FlushOverlays();
+	return delayUs;
+}
+
+PipelineStats BorderPipeline::Stats() const noexcept
+{
+	PipelineStats stats{};
+	stats.ingested = ingested.load(std::memory_order_relaxed);
+	stats.filtered = filtered.load(std::memory_order_relaxed);
+	stats.layout = layoutCounters.Snapshot(ingestQueue.ApproxSize());
+	stats.present = presentCounters.Snapshot(presentQueue.ApproxSize());
+	stats.frames = frames.load(std::memory_order_relaxed);
+	stats.pollWakeups = pollWakeups.load(std::memory_order_relaxed);
+	stats.resyncs = resyncs.load(std::memory_order_relaxed);
+	stats.createBatches = createBatches.load(std::memory_order_relaxed);
+	stats.overlaysCreated = overlaysCreated.load(std::memory_order_relaxed);
+	stats.createUs = createUs.load(std::memory_order_relaxed);
+	stats.maxCreateBatchUs = maxCreateBatchUs.load(std::memory_order_relaxed);
+	stats.poolRebinds = poolRebinds.load(std::memory_order_relaxed);
+	stats.poolParks = poolParks.load(std::memory_order_relaxed);
+	stats.poolTrims = poolTrims.load(std::memory_order_relaxed);
+	stats.pooledOverlays = pooledOverlays.load(std::memory_order_relaxed);
+	return stats;
+}
+
+size_t BorderPipeline::OverlayCount() const noexcept
+{
+	size_t count = 0;
+	for (const auto& overlay : overlays)
+	{
+		if (overlay)
+			count++;
+	}
+	return count;
+}
+
+OverlayMemoryStats BorderPipeline::OverlayMemory() const noexcept
+{
+	OverlayMemoryStats memory{};
+	for (const auto& overlay : overlays)
+	{
+		if (!overlay)
+			continue;
+
+		const uint64_t bytes = overlay->SurfaceBytes();
+		memory.overlays++;
+		memory.surfaceBytes += bytes;
+		memory.maxSurfaceBytes = std::max(memory.maxSurfaceBytes, bytes);
+	}
+	for (const ParkedOverlay& parked : parkedOverlays)
+		memory.pooledBytes += parked.overlay->SurfaceBytes();
+	return memory;
+}
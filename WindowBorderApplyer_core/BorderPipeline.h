@@ -0,0 +1,301 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "BorderAnimator.h"
+#include "BorderLayout.h"
+#include "BorderScene.h"
+#include "BorderTracker.h"
+#include "MpscQueue.h"
+#include "WindowSystem.h"
+#include "WindowSystemTypes.h"
+#include "WorkStealingPool.h"
+
+struct PipelineOptions
+{
+	// 훅 -> 레이아웃 큐. 가득 차면 이벤트를 버리고 다음 프레임에 전체를 다시 맞춤
+	size_t ingestCapacity = 8192;
+	// 레이아웃 -> 표시 큐. 가득 차면 레이아웃 단계가 기다림
+	size_t presentCapacity = 4096;
+	// 첫 이벤트부터 반영까지 기다리는 시간 (병합 프레임 간격)
+	uint64_t frameIntervalUs = 16000;
+	// 여러 테두리를 한 번에 만들 때 준비 단계 (PrepareOverlay) 를 나눠 실행할 작업 스레드 수. 0 이면 표시 스레드에서 차례로
+	size_t createWorkers = 0;
+	// 파괴 대신 숨겨서 보관할 오버레이 수의 상한. 0 이면 보관하지 않음
+	size_t overlayPoolLimit = 64;
+	// 이 시간 동안 다시 쓰이지 않은 보관 오버레이는 파괴 (TrimOverlayPool)
+	uint64_t overlayPoolIdleUs = 30000000;
+	// 이벤트 없이 테두리 위치를 다시 확인하는 주기 (레이아웃 스레드의 타이머 휠 하나로 모든 창을 처리)
+	GeometryPollPolicy poll{};
+	// 색 이어 바꾸기와 포커스 깜빡임 (표시 스레드의 Animate 가 재생). 기본은 모두 꺼짐
+	BorderAnimationOptions animation{};
+};
+
+/// <summary> 단계 하나의 입력 큐 통계 </summary>
+struct PipelineStageStats
+{
+	// 입력 큐에서 꺼낸 항목
+	uint64_t items = 0;
+	// 입력 큐가 가득 찬 횟수 (레이아웃: 버린 이벤트, 표시: 레이아웃 단계가 기다린 횟수)
+	uint64_t rejected = 0;
+	// 입력 큐에 남은 항목 (근사값)
+	uint64_t queueDepth = 0;
+	uint64_t maxQueueDepth = 0;
+	// 항목이 입력 큐에서 기다린 시간
+	uint64_t totalLatencyUs = 0;
+	uint64_t maxLatencyUs = 0;
+
+	double AverageLatencyUs() const noexcept
+	{
+		return items == 0 ? 0.0 : static_cast<double>(totalLatencyUs) / static_cast<double>(items);
+	}
+};
+
+struct PipelineStats
+{
+	// 훅 단계가 큐에 넣은 이벤트
+	uint64_t ingested = 0;
+	// 사전 필터에 걸려 (최상위 창 자신의 이벤트가 아니거나 추적하지 않는 창) 큐에 넣지 않은 이벤트
+	uint64_t filtered = 0;
+	PipelineStageStats layout{};
+	PipelineStageStats present{};
+	uint64_t frames = 0;
+	// 위치 확인 타이머 때문에 레이아웃 스레드가 깨어난 횟수 (모든 창이 멈춰 있으면 늘지 않음)
+	uint64_t pollWakeups = 0;
+	// 이벤트를 버린 뒤 전체 테두리를 다시 맞춘 횟수
+	uint64_t resyncs = 0;
+	// 표시 단계가 한 번에 만든 오버레이 묶음과 그 수, 만드는 데 걸린 시간
+	uint64_t createBatches = 0;
+	uint64_t overlaysCreated = 0;
+	uint64_t createUs = 0;
+	uint64_t maxCreateBatchUs = 0;
+	// 보관 오버레이: 다시 붙인 수 (생성 절약), 보관한 수, 상한을 넘거나 오래 쉬어 파괴한 수, 지금 보관 중인 수
+	uint64_t poolRebinds = 0;
+	uint64_t poolParks = 0;
+	uint64_t poolTrims = 0;
+	uint64_t pooledOverlays = 0;
+};
+
+/// <summary> 표시 단계가 가진 오버레이의 그리기 표면 메모리 (BorderOverlay::SurfaceBytes) </summary>
+struct OverlayMemoryStats
+{
+	uint64_t overlays = 0;
+	uint64_t surfaceBytes = 0;
+	// 표면이 가장 큰 테두리 하나 (보통 최대화 창)
+	uint64_t maxSurfaceBytes = 0;
+	// 보관 중인 (숨긴) 오버레이가 가진 메모리. surfaceBytes 에는 포함하지 않음
+	uint64_t pooledBytes = 0;
+
+	double AverageBytes() const noexcept
+	{
+		return overlays == 0 ? 0.0 : static_cast<double>(surfaceBytes) / static_cast<double>(overlays);
+	}
+};
+
+/// <summary> 레이아웃 단계가 표시 단계에 보내는 명령 </summary>
+enum class PresentOp : uint8_t
+{
+	Create,
+	Present,
+	Hide,
+	Raise,
+	Destroy,
+	Focus,
+};
+
+struct PresentCommand
+{
+	PresentOp op = PresentOp::Present;
+	uint32_t overlay = 0;
+	WindowHandle target = nullptr;
+	// 스타일 값은 번호로만 보냄. 표시 단계가 추적기의 스타일 표 (BorderTracker::Styles) 로 BorderVisual 을 만듦
+	BorderPlacement placement{};
+	uint64_t enqueueUs = 0;
+};
+
+/// <summary>
+/// 훅 수신 -> 레이아웃 -> 표시 세 단계 파이프라인. 단계 사이는 잠금 없는 고정 크기 큐로 연결하므로
+/// 렌더링 (EndDraw) 이 느려도 훅 콜백은 멈추지 않습니다.
+///  - 수신: Ingest. 훅 스레드 (여러 개여도 됨) 에서 레이아웃 스레드가 게시한 사전 필터를 통과한 이벤트만 큐에 넣음
+///  - 레이아웃: 파이프라인이 만드는 스레드. BorderTracker 로 병합, 프레임 사각형 조회, 표시 여부를 결정
+///  - 표시: PumpPresent 를 부르는 스레드. 오버레이 생성과 그리기 (Windows 에서는 테두리 창을 소유하는 스레드)
+/// </summary>
+class BorderPipeline
+{
+public:
+	using Event = BorderTracker::Event;
+	using LayoutCommand = std::function<void(BorderTracker&)>;
+	using FrameCallback = std::function<void(const BorderTracker&)>;
+
+	/// <summary> windowSystem 의 조회는 레이아웃 스레드에서, CreateOverlay 와 오버레이 호출은 표시 스레드에서 일어납니다 </summary>
+	BorderPipeline(WindowSystem& windowSystem, const BorderStyle& style, const PipelineOptions& options = {});
+	~BorderPipeline();
+
+	BorderPipeline(const BorderPipeline&) = delete;
+	BorderPipeline& operator=(const BorderPipeline&) = delete;
+
+	/// <summary>
+	/// 레이아웃 스레드를 시작합니다. onPresentReady 는 표시 큐가 비어 있다가 채워질 때 레이아웃 스레드에서 호출되며
+	/// 표시 스레드를 깨워 PumpPresent 를 부르게 해야 합니다. onFrame 은 프레임을 반영한 뒤 레이아웃 스레드에서 호출됩니다
+	/// </summary>
+	void Start(std::function<void()> onPresentReady, FrameCallback onFrame = nullptr);
+	/// <summary> 남은 작업 (Post) 을 실행한 뒤 레이아웃 스레드를 멈춥니다. 남은 표시 명령은 PumpPresent 로 처리할 수 있습니다 </summary>
+	void Stop();
+
+	/// <summary>
+	/// 수신 단계: 기다리지 않습니다. 추적하지 않는 창의 이벤트는 큐에 넣기 전에 사전 필터 (BorderTracker::MayAccept) 로 버리므로
+	/// 다른 프로세스의 이벤트가 몰려도 큐가 넘치지 않습니다. 버렸으면 false (큐가 가득 차면 다음 프레임에 전체를 다시 맞춤)
+	/// </summary>
+	bool Ingest(const Event& event) noexcept;
+	/// <summary> 레이아웃 스레드에서 추적기를 다루는 작업 (창 등록, 설정 변경 등). 레이아웃 스레드가 멈췄으면 false </summary>
+	bool Post(LayoutCommand command);
+	/// <summary> 레이아웃 스레드를 깨웁니다 (데스크톱 전환 알림 등). 깨어나면 SyncDesktop 을 확인합니다 </summary>
+	void Wake() noexcept;
+	/// <summary> 모든 테두리의 스타일을 바꿉니다 (BorderTracker::SetStyle 을 레이아웃 스레드에서). 레이아웃 스레드가 멈췄으면 false </summary>
+	bool SetStyle(const BorderStyle& style);
+
+	/// <summary>
+	/// 표시 단계: 쌓인 표시 명령을 실행하고 실행한 수를 반환합니다. 한 스레드에서만 호출.
+	/// 생성 명령은 모아서 끝에 한 번에 만들고 (준비 단계는 작업 풀에서), 만들어지기 전의 오버레이에 대한 명령은 그 뒤로 미룹니다.
+	/// 표시 / 숨김 / 올림은 장면 (BorderScene) 에만 기록했다가 끝에 바뀐 오버레이만 한 번씩 반영하고,
+	/// 실행한 명령이 있으면 마지막으로 WindowSystem::FlushOverlays 를 한 번 부릅니다
+	/// </summary>
+	size_t PumpPresent();
+	/// <summary> 표시 스레드가 끝나기 전에 호출: 남은 명령을 실행하고 모든 오버레이를 (보관 중인 것까지) 파괴합니다 </summary>
+	void ReleaseOverlays();
+	/// <summary>
+	/// 표시 스레드: overlayPoolIdleUs 동안 쓰이지 않은 보관 오버레이를 파괴합니다.
+	/// 다음 정리까지 남은 시간 (us) 을 반환하며, 보관 중인 오버레이가 없으면 0 (부를 필요 없음)
+	/// </summary>
+	uint64_t TrimOverlayPool();
+	/// <summary>
+	/// 표시 단계: 움직이는 테두리 (PipelineOptions::animation) 의 다음 프레임을 그립니다. 프레임 시각 전이면 그리지 않습니다.
+	/// 다음 프레임까지 남은 시간 (us) 을 반환하며, 움직이는 테두리가 없으면 0 (부를 필요 없음)
+	/// </summary>
+	uint64_t Animate();
+
+	/// <summary> 어느 스레드에서나 호출 가능 </summary>
+	PipelineStats Stats() const noexcept;
+	/// <summary> 표시 단계가 가진 오버레이 수. 표시 스레드에서만 호출 </summary>
+	size_t OverlayCount() const noexcept;
+	/// <summary> 오버레이마다 표면 메모리를 더합니다. 표시 스레드에서만 호출 </summary>
+	OverlayMemoryStats OverlayMemory() const noexcept;
+	/// <summary> 장면이 반영한 횟수 (다시 그림 / 옮김 / 숨김) 와 마지막 프레임. 표시 스레드에서만 호출 </summary>
+	const SceneStats& SceneStatistics() const noexcept { return scene.Stats(); }
+	/// <summary> 애니메이션 수와 계산한 프레임. 표시 스레드에서만 호출 </summary>
+	const AnimationStats& AnimationStatistics() const noexcept { return animator.Stats(); }
+
+private:
+	class DeferredWindowSystem;
+	class DeferredOverlay;
+
+	struct IngestedEvent
+	{
+		Event event{};
+		uint64_t ingestUs = 0;
+	};
+
+	struct StageCounters
+	{
+		std::atomic<uint64_t> items{ 0 };
+		std::atomic<uint64_t> rejected{ 0 };
+		std::atomic<uint64_t> maxQueueDepth{ 0 };
+		std::atomic<uint64_t> totalLatencyUs{ 0 };
+		std::atomic<uint64_t> maxLatencyUs{ 0 };
+
+		/// <summary> 소비자 스레드 하나만 기록 </summary>
+		void Record(uint64_t latencyUs, uint64_t depth) noexcept;
+		PipelineStageStats Snapshot(uint64_t depth) const noexcept;
+	};
+
+	WindowSystem& windowSystem;
+	// 오버레이 생성에 넘기는 처음 스타일. 모양은 생성 명령의 BorderVisual 을 따르므로 SetStyle 뒤에도 바꾸지 않음
+	BorderStyle style;
+	PipelineOptions options;
+
+	std::unique_ptr<DeferredWindowSystem> layoutWindowSystem;
+	std::unique_ptr<BorderTracker> tracker;
+
+	BoundedMpscQueue<IngestedEvent> ingestQueue;
+	BoundedMpscQueue<PresentCommand> presentQueue;
+
+	// 0 -> 1 로 바뀔 때만 세마포어를 올려 깨움. 위치 확인 타이머가 있으면 그 시각까지만 기다림
+	std::atomic<uint32_t> layoutSignal{ 0 };
+	std::counting_semaphore<> layoutWakeup{ 0 };
+	std::atomic<bool> presentSignaled{ false };
+	// 표시 스레드가 오버레이를 모두 파괴한 뒤에는 표시 명령을 보내지 않음
+	std::atomic<bool> presentReleased{ false };
+	std::atomic<bool> resyncRequested{ false };
+	std::atomic<bool> stopping{ false };
+	std::thread layoutThread;
+	std::function<void()> onPresentReady;
+	FrameCallback onFrame;
+
+	// 레이아웃 스레드가 작업을 받는 동안 true (commandMutex 로 보호)
+	std::mutex commandMutex;
+	std::vector<LayoutCommand> commands{};
+	bool accepting = false;
+
+	std::atomic<uint64_t> ingested{ 0 };
+	std::atomic<uint64_t> filtered{ 0 };
+	std::atomic<uint64_t> frames{ 0 };
+	std::atomic<uint64_t> pollWakeups{ 0 };
+	std::atomic<uint64_t> resyncs{ 0 };
+	StageCounters layoutCounters{};
+	StageCounters presentCounters{};
+
+	// 레이아웃 스레드 전용: 오버레이 번호 할당
+	std::vector<uint32_t> freeOverlayIds{};
+	uint32_t nextOverlayId = 0;
+
+	// 표시 스레드 전용: 번호 -> 실제 오버레이와, 같은 번호의 장면 노드 (반영한 상태와 바라는 상태).
+	// 장면은 추적기의 스타일 표를 읽으므로 tracker 뒤에 선언
+	std::vector<std::unique_ptr<BorderOverlay>> overlays{};
+	BorderScene scene;
+	// 표시 스레드 전용: 한 번에 만들 생성 명령, 그 오버레이에 대한 명령 (생성 뒤로 미룸), 번호별 대기 여부
+	std::vector<PresentCommand> pendingCreates{};
+	std::vector<PresentCommand> deferredCommands{};
+	std::vector<uint8_t> pendingCreateIds{};
+	std::unique_ptr<WorkStealingPool> createPool;
+	// 표시 스레드 전용: 노드 번호마다 움직이는 색
+	BorderAnimator animator;
+
+	// 표시 스레드 전용: 숨겨서 보관한 오버레이. 뒤에서 꺼내고 (최근 것), 앞에서부터 정리 (오래된 것)
+	struct ParkedOverlay
+	{
+		std::unique_ptr<BorderOverlay> overlay;
+		uint64_t parkedUs = 0;
+	};
+	std::deque<ParkedOverlay> parkedOverlays{};
+	std::atomic<uint64_t> poolRebinds{ 0 };
+	std::atomic<uint64_t> poolParks{ 0 };
+	std::atomic<uint64_t> poolTrims{ 0 };
+	std::atomic<uint64_t> pooledOverlays{ 0 };
+
+	std::atomic<uint64_t> createBatches{ 0 };
+	std::atomic<uint64_t> overlaysCreated{ 0 };
+	std::atomic<uint64_t> createUs{ 0 };
+	std::atomic<uint64_t> maxCreateBatchUs{ 0 };
+
+	void RunLayout();
+	void RunCommands();
+	uint64_t DrainIngest(uint64_t frameDeadlineUs);
+	uint32_t AllocateOverlayId();
+	void EnqueuePresent(const PresentCommand& command);
+	void ExecutePresent(const PresentCommand& command);
+	/// <summary> 장면에서 바뀐 노드만 오버레이에 반영합니다 </summary>
+	void CommitScene();
+	bool IsPendingCreate(uint32_t overlay) const noexcept;
+	void CreatePending();
+	/// <summary> 보관 오버레이를 다시 붙였으면 true </summary>
+	bool TryRebind(const PresentCommand& command);
+	void ParkOrDestroy(std::unique_ptr<BorderOverlay> overlay);
+};
@@ -0,0 +1,350 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <variant>
+
+#include "BorderLayout.h"
+#include "BorderRaster.h"
+#include "BorderScene.h"
+
+// 테두리 모양마다 컴파일 시간에 특수화한 그리기 / 비교 정책.
+// 정책은 visual (오버레이 안 좌표) 에서 자기에게 필요한 값만 담은 Shape 를 만들고 (Build), 두 Shape 를 비교해 BorderDirty 를 돌려주며 (Diff),
+// Canvas 에 그립니다 (Draw). Canvas 는 아래 메서드를 가진 타입이면 됩니다 (FrameDrawer 의 Direct2D, 테스트 / 벤치마크의 기록용).
+//  StrokeRect(rect, thickness, color, alpha)
+//  StrokeRoundedRect(rect, radius, thickness, color, alpha)
+//  FillRect(rect, color, alpha)
+//  StrokeGradientRect(rect, radius, thickness, color, endColor, alpha)
+
+/// <summary> 테두리를 그리는 정책 </summary>
+enum class BorderPolicyKind : uint8_t
+{
+	// 직각 사각형 하나를 선으로
+	Sharp,
+	// 둥근 사각형 하나를 선으로
+	Rounded,
+	// 네 변을 두께가 다른 띠로 채움 (BorderStrips)
+	PerEdge,
+	// 위에서 아래로 두 색을 잇는 선 (둥근 모서리 포함)
+	Gradient,
+};
+
+/// <summary> visual 을 그릴 정책. 그라데이션, 변마다 두께, 둥근 모서리 순으로 우선 </summary>
+inline BorderPolicyKind SelectBorderPolicy(const BorderVisual& visual) noexcept
+{
+	if (visual.gradient)
+		return BorderPolicyKind::Gradient;
+	if (visual.HasEdgeThickness())
+		return BorderPolicyKind::PerEdge;
+	if (visual.cornerRadius != 0.0f)
+		return BorderPolicyKind::Rounded;
+	return BorderPolicyKind::Sharp;
+}
+
+inline const char* BorderPolicyName(BorderPolicyKind kind) noexcept
+{
+	switch (kind)
+	{
+	case BorderPolicyKind::Rounded:
+		return "rounded";
+	case BorderPolicyKind::PerEdge:
+		return "per-edge";
+	case BorderPolicyKind::Gradient:
+		return "gradient";
+	default:
+		return "sharp";
+	}
+}
+
+/// <summary> 선의 중심을 지나는 사각형 (픽셀 좌표, 실수) </summary>
+struct BorderRectF
+{
+	float left = 0.0f;
+	float top = 0.0f;
+	float right = 0.0f;
+	float bottom = 0.0f;
+
+	bool operator==(const BorderRectF& other) const noexcept = default;
+};
+
+/// <summary> 선의 중심 사각형. bounds 에서 1 픽셀 안쪽부터 thickness 만큼 그리도록 반 두께를 더 들임 (BorderStrips 와 같은 자리) </summary>
+inline BorderRectF StrokeCenterRect(const WindowRect& bounds, int32_t thickness) noexcept
+{
+	const float inset = static_cast<float>(thickness) / 2.0f + 1.0f;
+	return BorderRectF{ static_cast<float>(bounds.left) + inset, static_cast<float>(bounds.top) + inset,
+		static_cast<float>(bounds.right) - inset, static_cast<float>(bounds.bottom) - inset };
+}
+
+/// <summary> changed 면 bit, 아니면 0. 비교 결과를 분기 없이 비트로 모음 </summary>
+constexpr uint8_t DirtyIf(bool changed, uint8_t bit) noexcept
+{
+	return static_cast<uint8_t>(static_cast<uint8_t>(changed) * bit);
+}
+
+struct SharpBorderPolicy
+{
+	static constexpr BorderPolicyKind Kind = BorderPolicyKind::Sharp;
+
+	struct Shape
+	{
+		BorderRectF rect{};
+		int32_t width = 0;
+		int32_t height = 0;
+		int32_t thickness = 0;
+		uint32_t color = 0;
+		uint8_t alpha = 0;
+	};
+
+	static Shape Build(const BorderVisual& visual) noexcept
+	{
+		return Shape{ StrokeCenterRect(visual.bounds, visual.thickness), visual.bounds.Width(), visual.bounds.Height(),
+			visual.thickness, visual.color, visual.alpha };
+	}
+
+	static uint8_t Diff(const Shape& from, const Shape& to) noexcept
+	{
+		return DirtyIf((from.width != to.width) | (from.height != to.height), BorderDirty::Size)
+			| DirtyIf(from.thickness != to.thickness, BorderDirty::Thickness)
+			| DirtyIf((from.color != to.color) | (from.alpha != to.alpha), BorderDirty::Color);
+	}
+
+	template <typename Canvas>
+	static void Draw(Canvas& canvas, const Shape& shape)
+	{
+		canvas.StrokeRect(shape.rect, shape.thickness, shape.color, shape.alpha);
+	}
+};
+
+struct RoundedBorderPolicy
+{
+	static constexpr BorderPolicyKind Kind = BorderPolicyKind::Rounded;
+
+	struct Shape
+	{
+		BorderRectF rect{};
+		float radius = 0.0f;
+		int32_t width = 0;
+		int32_t height = 0;
+		int32_t thickness = 0;
+		uint32_t color = 0;
+		uint8_t alpha = 0;
+	};
+
+	static Shape Build(const BorderVisual& visual) noexcept
+	{
+		return Shape{ StrokeCenterRect(visual.bounds, visual.thickness), visual.cornerRadius, visual.bounds.Width(), visual.bounds.Height(),
+			visual.thickness, visual.color, visual.alpha };
+	}
+
+	static uint8_t Diff(const Shape& from, const Shape& to) noexcept
+	{
+		return DirtyIf((from.width != to.width) | (from.height != to.height), BorderDirty::Size)
+			| DirtyIf(from.thickness != to.thickness, BorderDirty::Thickness)
+			| DirtyIf(from.radius != to.radius, BorderDirty::Radius)
+			| DirtyIf((from.color != to.color) | (from.alpha != to.alpha), BorderDirty::Color);
+	}
+
+	template <typename Canvas>
+	static void Draw(Canvas& canvas, const Shape& shape)
+	{
+		canvas.StrokeRoundedRect(shape.rect, shape.radius, shape.thickness, shape.color, shape.alpha);
+	}
+};
+
+struct PerEdgeBorderPolicy
+{
+	static constexpr BorderPolicyKind Kind = BorderPolicyKind::PerEdge;
+
+	struct Shape
+	{
+		// BorderStrips 순서 (위, 아래, 왼쪽, 오른쪽)
+		std::array<WindowRect, 4> strips{};
+		int32_t width = 0;
+		int32_t height = 0;
+		std::array<int32_t, 4> thickness{};
+		uint32_t color = 0;
+		uint8_t alpha = 0;
+	};
+
+	static Shape Build(const BorderVisual& visual) noexcept
+	{
+		Shape shape{};
+		WindowRect strips[4];
+		BorderStrips(visual, strips);
+		for (size_t edge = 0; edge < shape.strips.size(); ++edge)
+		{
+			shape.strips[edge] = strips[edge];
+			shape.thickness[edge] = visual.EdgeThickness(edge);
+		}
+		shape.width = visual.bounds.Width();
+		shape.height = visual.bounds.Height();
+		shape.color = visual.color;
+		shape.alpha = visual.alpha;
+		return shape;
+	}
+
+	static uint8_t Diff(const Shape& from, const Shape& to) noexcept
+	{
+		return DirtyIf((from.width != to.width) | (from.height != to.height), BorderDirty::Size)
+			| DirtyIf(from.thickness != to.thickness, BorderDirty::Thickness)
+			| DirtyIf((from.color != to.color) | (from.alpha != to.alpha), BorderDirty::Color);
+	}
+
+	template <typename Canvas>
+	static void Draw(Canvas& canvas, const Shape& shape)
+	{
+		for (const WindowRect& strip : shape.strips)
+			canvas.FillRect(strip, shape.color, shape.alpha);
+	}
+};
+
+struct GradientBorderPolicy
+{
+	static constexpr BorderPolicyKind Kind = BorderPolicyKind::Gradient;
+
+	struct Shape
+	{
+		BorderRectF rect{};
+		float radius = 0.0f;
+		int32_t width = 0;
+		int32_t height = 0;
+		int32_t thickness = 0;
+		uint32_t color = 0;
+		uint32_t endColor = 0;
+		uint8_t alpha = 0;
+	};
+
+	static Shape Build(const BorderVisual& visual) noexcept
+	{
+		return Shape{ StrokeCenterRect(visual.bounds, visual.thickness), visual.cornerRadius, visual.bounds.Width(), visual.bounds.Height(),
+			visual.thickness, visual.color, visual.gradientColor, visual.alpha };
+	}
+
+	static uint8_t Diff(const Shape& from, const Shape& to) noexcept
+	{
+		return DirtyIf((from.width != to.width) | (from.height != to.height), BorderDirty::Size)
+			| DirtyIf(from.thickness != to.thickness, BorderDirty::Thickness)
+			| DirtyIf(from.radius != to.radius, BorderDirty::Radius)
+			| DirtyIf((from.color != to.color) | (from.endColor != to.endColor) | (from.alpha != to.alpha), BorderDirty::Color);
+	}
+
+	template <typename Canvas>
+	static void Draw(Canvas& canvas, const Shape& shape)
+	{
+		canvas.StrokeGradientRect(shape.rect, shape.radius, shape.thickness, shape.color, shape.endColor, shape.alpha);
+	}
+};
+
+/// <summary>
+/// 테두리 하나의 그리기 상태. 정책은 스타일이 바뀔 때만 Select 로 고르고, 그 정책의 Build / Diff / Draw 인스턴스를
+/// 함수 포인터로 기억하므로 Update 와 Draw 는 모양의 종류 (optional, 둥근 모서리 여부) 를 다시 확인하지 않습니다.
+/// 그려 둔 모양은 고른 정책의 것 하나만 두며, 정책을 바꾼 뒤 첫 Update 는 그리는 내용이 모두 바뀐 것으로 봅니다
+/// </summary>
+template <typename Canvas>
+class BorderPainter
+{
+public:
+	BorderPainter() noexcept { Select(BorderPolicyKind::Sharp); }
+
+	/// <summary> kind 정책의 인스턴스로 바꿉니다. 이미 그 정책이면 아무것도 하지 않음 </summary>
+	void Select(BorderPolicyKind kind) noexcept
+	{
+		if (selected && kind == policy)
+			return;
+
+		switch (kind)
+		{
+		case BorderPolicyKind::Rounded:
+			Bind<RoundedBorderPolicy>();
+			break;
+		case BorderPolicyKind::PerEdge:
+			Bind<PerEdgeBorderPolicy>();
+			break;
+		case BorderPolicyKind::Gradient:
+			Bind<GradientBorderPolicy>();
+			break;
+		default:
+			Bind<SharpBorderPolicy>();
+			break;
+		}
+		selected = true;
+	}
+
+	BorderPolicyKind Policy() const noexcept { return policy; }
+
+	/// <summary> visual (오버레이 안 좌표) 의 모양을 기억하고 이전 모양과 다른 점 (BorderDirty) 을 돌려줍니다 </summary>
+	uint8_t Update(const BorderVisual& visual) noexcept
+	{
+		const uint8_t dirty = static_cast<uint8_t>(update(shapes, visual) | pending);
+		pending = 0;
+		return dirty;
+	}
+
+	/// <summary> 마지막으로 Update 한 모양을 그립니다 </summary>
+	void Draw(Canvas& canvas) const { draw(canvas, shapes); }
+
+	/// <summary> Update 후 바뀐 것이 있으면 바로 그립니다. 간접 호출 한 번으로 끝남 </summary>
+	uint8_t Paint(const BorderVisual& visual, Canvas& canvas)
+	{
+		const uint8_t changed = paint(shapes, visual, canvas);
+		// 정책을 바꾼 직후에는 모양이 같아도 그림
+		if (changed == 0 && pending != 0)
+			draw(canvas, shapes);
+		const uint8_t dirty = static_cast<uint8_t>(changed | pending);
+		pending = 0;
+		return dirty;
+	}
+
+private:
+	// 고른 정책의 모양 하나만 둠 (테두리마다 가장 큰 모양 하나 크기)
+	using Shapes = std::variant<SharpBorderPolicy::Shape, RoundedBorderPolicy::Shape, PerEdgeBorderPolicy::Shape, GradientBorderPolicy::Shape>;
+	using UpdateFn = uint8_t(*)(Shapes&, const BorderVisual&) noexcept;
+	using DrawFn = void(*)(Canvas&, const Shapes&);
+	using PaintFn = uint8_t(*)(Shapes&, const BorderVisual&, Canvas&);
+
+	UpdateFn update = nullptr;
+	DrawFn draw = nullptr;
+	PaintFn paint = nullptr;
+	Shapes shapes{};
+	BorderPolicyKind policy = BorderPolicyKind::Sharp;
+	bool selected = false;
+	// 정책을 바꾼 뒤 다음 Update 에 더할 변경
+	uint8_t pending = 0;
+
+	template <typename Policy>
+	void Bind() noexcept
+	{
+		update = &UpdateWith<Policy>;
+		draw = &DrawWith<Policy>;
+		paint = &PaintWith<Policy>;
+		shapes.template emplace<typename Policy::Shape>();
+		policy = Policy::Kind;
+		pending = BorderDirty::Content & ~BorderDirty::Visibility;
+	}
+
+	template <typename Policy>
+	static uint8_t UpdateWith(Shapes& shapes, const BorderVisual& visual) noexcept
+	{
+		// 함수 포인터는 Bind 에서 모양과 함께 바꾸므로 항상 이 정책의 모양
+		auto& shape = *std::get_if<typename Policy::Shape>(&shapes);
+		const typename Policy::Shape next = Policy::Build(visual);
+		const uint8_t dirty = Policy::Diff(shape, next);
+		shape = next;
+		return dirty;
+	}
+
+	template <typename Policy>
+	static uint8_t PaintWith(Shapes& shapes, const BorderVisual& visual, Canvas& canvas)
+	{
+		const uint8_t dirty = UpdateWith<Policy>(shapes, visual);
+		if (dirty != 0)
+			Policy::Draw(canvas, *std::get_if<typename Policy::Shape>(&shapes));
+		return dirty;
+	}
+
+	template <typename Policy>
+	static void DrawWith(Canvas& canvas, const Shapes& shapes)
+	{
+		Policy::Draw(canvas, *std::get_if<typename Policy::Shape>(&shapes));
+	}
+};
@@ -0,0 +1,355 @@
+﻿#include "BorderRaster.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WBA_RASTER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// AVX2 는 빌드 옵션과 관계없이 이 함수들만 AVX2 로 컴파일하고, 실행할 때 CPU 를 확인해서 고름 (MSVC 는 속성 없이 사용 가능)
+#if defined(WBA_RASTER_X86) && (defined(__GNUC__) || defined(__clang__))
+#define WBA_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define WBA_TARGET_AVX2
+#endif
+
+namespace
+{
+	// 사각형 하나를 통째로 넘겨 구현을 고르는 간접 호출과 AVX 상태 전환은 행마다가 아니라 사각형마다 한 번
+	using FillRectFn = void (*)(uint32_t* row, size_t stride, size_t width, size_t rows, uint32_t pixel);
+
+	void FillRectScalar(uint32_t* row, size_t stride, size_t width, size_t rows, uint32_t pixel)
+	{
+		for (; rows != 0; --rows, row += stride)
+		{
+			for (size_t x = 0; x < width; ++x)
+				row[x] = pixel;
+		}
+	}
+
+#if defined(WBA_RASTER_X86)
+	void FillRectSse2(uint32_t* row, size_t stride, size_t width, size_t rows, uint32_t pixel)
+	{
+		const __m128i value = _mm_set1_epi32(static_cast<int>(pixel));
+		for (; rows != 0; --rows, row += stride)
+		{
+			size_t x = 0;
+			for (; x + 4 <= width; x += 4)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), value);
+			for (; x < width; ++x)
+				row[x] = pixel;
+		}
+	}
+
+	WBA_TARGET_AVX2 void FillRectAvx2(uint32_t* row, size_t stride, size_t width, size_t rows, uint32_t pixel)
+	{
+		const __m256i value = _mm256_set1_epi32(static_cast<int>(pixel));
+		for (; rows != 0; --rows, row += stride)
+		{
+			size_t x = 0;
+			for (; x + 16 <= width; x += 16)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), value);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x + 8), value);
+			}
+			for (; x + 8 <= width; x += 8)
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), value);
+			// 남은 7 픽셀 이하는 SSE2 폭으로
+			if (x + 4 <= width)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), _mm256_castsi256_si128(value));
+				x += 4;
+			}
+			for (; x < width; ++x)
+				row[x] = pixel;
+		}
+	}
+
+	bool CpuSupportsAvx2() noexcept
+	{
+#if defined(_MSC_VER)
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// 운영체제가 YMM 레지스터를 저장하는지 (OSXSAVE + XCR0) 도 확인
+		__cpuid(info, 1);
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		if (!osxsave || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}
+#endif
+
+	FillRectFn RectKernel(RasterKernel kernel) noexcept
+	{
+		if (!IsRasterKernelSupported(kernel))
+			return FillRectScalar;
+
+		switch (kernel)
+		{
+#if defined(WBA_RASTER_X86)
+		case RasterKernel::Sse2:
+			return FillRectSse2;
+		case RasterKernel::Avx2:
+			return FillRectAvx2;
+#endif
+		default:
+			return FillRectScalar;
+		}
+	}
+
+	/// <summary> premultiplied 픽셀의 네 채널에 coverage / 255 를 곱함 (반올림) </summary>
+	uint32_t ScalePixel(uint32_t pixel, uint32_t coverage) noexcept
+	{
+		uint32_t rb = (pixel & 0x00FF00FFu) * coverage + 0x00800080u;
+		uint32_t ag = ((pixel >> 8) & 0x00FF00FFu) * coverage + 0x00800080u;
+		rb = ((rb + ((rb >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+		ag = ((ag + ((ag >> 8) & 0x00FF00FFu)) >> 8) & 0x00FF00FFu;
+		return rb | (ag << 8);
+	}
+
+	/// <summary> RedrawBorder 가 비교하는 조각: 띠 네 개, 둥근 테두리면 곧은 변 네 개와 모서리 네 개 (뒤의 네 개) </summary>
+	struct BorderParts
+	{
+		WindowRect rects[8]{};
+		size_t count = 0;
+		std::shared_ptr<const CornerMask> mask{};
+
+		explicit BorderParts(const BorderVisual& visual)
+		{
+			RoundedBorderParts rounded{};
+			if (MakeRoundedBorderParts(visual, rounded))
+			{
+				for (size_t i = 0; i < 4; ++i)
+				{
+					rects[i] = rounded.spans[i];
+					rects[4 + i] = rounded.corners[i];
+				}
+				count = 8;
+				mask = std::move(rounded.mask);
+				return;
+			}
+
+			WindowRect strips[4];
+			BorderStrips(visual, strips);
+			for (size_t i = 0; i < 4; ++i)
+				rects[i] = strips[i];
+			count = 4;
+		}
+
+		BorderParts() = default;
+	};
+
+	void FillRect(uint32_t* pixels, size_t stride, const WindowRect& rect, uint32_t pixel, FillRectFn fillRect) noexcept
+	{
+		if (rect.IsEmpty())
+			return;
+
+		uint32_t* row = pixels + static_cast<size_t>(rect.top) * stride + static_cast<size_t>(rect.left);
+		const size_t width = static_cast<size_t>(rect.Width());
+		// 세로 띠처럼 벡터 폭보다 좁은 사각형은 스칼라가 더 빠름
+		if (width < 4)
+			fillRect = FillRectScalar;
+		fillRect(row, stride, width, static_cast<size_t>(rect.Height()), pixel);
+	}
+}
+
+bool IsRasterKernelSupported(RasterKernel kernel) noexcept
+{
+	switch (kernel)
+	{
+	case RasterKernel::Scalar:
+		return true;
+#if defined(WBA_RASTER_X86)
+	case RasterKernel::Sse2:
+		// x86-64 의 기본 명령어
+		return true;
+	case RasterKernel::Avx2:
+	{
+		static const bool supported = CpuSupportsAvx2();
+		return supported;
+	}
+#endif
+	default:
+		return false;
+	}
+}
+
+RasterKernel BestRasterKernel() noexcept
+{
+	static const RasterKernel best = IsRasterKernelSupported(RasterKernel::Avx2) ? RasterKernel::Avx2
+		: IsRasterKernelSupported(RasterKernel::Sse2) ? RasterKernel::Sse2 : RasterKernel::Scalar;
+	return best;
+}
+
+const char* RasterKernelName(RasterKernel kernel) noexcept
+{
+	switch (kernel)
+	{
+	case RasterKernel::Sse2:
+		return "sse2";
+	case RasterKernel::Avx2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+void FillPixels(uint32_t* pixels, size_t stride, const WindowRect& rect, uint32_t pixel) noexcept
+{
+	static const FillRectFn best = RectKernel(BestRasterKernel());
+	FillRect(pixels, stride, rect, pixel, best);
+}
+
+void FillPixels(uint32_t* pixels, size_t stride, const WindowRect& rect, uint32_t pixel, RasterKernel kernel) noexcept
+{
+	FillRect(pixels, stride, rect, pixel, RectKernel(kernel));
+}
+
+bool MakeRoundedBorderParts(const BorderVisual& visual, RoundedBorderParts& parts, CornerMaskCache& cache)
+{
+	if (visual.cornerRadius <= 0.0f || visual.HasEdgeThickness())
+		return false;
+
+	const WindowRect outer{ visual.bounds.left + 1, visual.bounds.top + 1, visual.bounds.right - 1, visual.bounds.bottom - 1 };
+	const int32_t thickness = visual.thickness;
+	// 모서리 크기는 반지름과 두께로 정해지므로 캐시에 묻기 전에 알 수 없음. 작은 창은 캐시에 넣지 않도록 반지름으로 먼저 거름
+	if (outer.Width() < 2 * thickness || outer.Height() < 2 * thickness || outer.Width() < 2 * visual.cornerRadius || outer.Height() < 2 * visual.cornerRadius)
+		return false;
+
+	std::shared_ptr<const CornerMask> mask = cache.Get(visual.cornerRadius, thickness);
+	if (!mask || outer.Width() < 2 * mask->size || outer.Height() < 2 * mask->size)
+		return false;
+
+	const int32_t size = mask->size;
+	parts.corners[BorderCorner::TopLeft] = WindowRect{ outer.left, outer.top, outer.left + size, outer.top + size };
+	parts.corners[BorderCorner::TopRight] = WindowRect{ outer.right - size, outer.top, outer.right, outer.top + size };
+	parts.corners[BorderCorner::BottomLeft] = WindowRect{ outer.left, outer.bottom - size, outer.left + size, outer.bottom };
+	parts.corners[BorderCorner::BottomRight] = WindowRect{ outer.right - size, outer.bottom - size, outer.right, outer.bottom };
+	parts.spans[0] = WindowRect{ outer.left + size, outer.top, outer.right - size, outer.top + thickness };
+	parts.spans[1] = WindowRect{ outer.left + size, outer.bottom - thickness, outer.right - size, outer.bottom };
+	parts.spans[2] = WindowRect{ outer.left, outer.top + size, outer.left + thickness, outer.bottom - size };
+	parts.spans[3] = WindowRect{ outer.right - thickness, outer.top + size, outer.right, outer.bottom - size };
+	parts.mask = std::move(mask);
+	return true;
+}
+
+void FillCornerPixels(uint32_t* pixels, size_t stride, const WindowRect& square, size_t corner, const CornerMask& mask, uint32_t pixel,
+	const WindowRect& clip) noexcept
+{
+	const WindowRect area = square.Intersect(clip);
+	if (area.IsEmpty())
+		return;
+
+	// 덮임은 몇 단계뿐이므로 (가장자리 몇 픽셀) 직전 값을 다시 씀
+	uint32_t lastCoverage = 255;
+	uint32_t scaled = pixel;
+	for (int32_t y = area.top; y < area.bottom; ++y)
+	{
+		uint32_t* row = pixels + static_cast<size_t>(y) * stride;
+		for (int32_t x = area.left; x < area.right; ++x)
+		{
+			const uint32_t coverage = mask.At(corner, x - square.left, y - square.top);
+			if (coverage != lastCoverage)
+			{
+				lastCoverage = coverage;
+				scaled = coverage == 0 ? 0 : ScalePixel(pixel, coverage);
+			}
+			row[x] = scaled;
+		}
+	}
+}
+
+void AddCoveredPixels(uint32_t* pixels, size_t stride, const WindowRect& clip, uint32_t pixel, const CornerSquare* own,
+	const CornerSquare* above, size_t aboveCount) noexcept
+{
+	const WindowRect area = own ? own->square.Intersect(clip) : clip;
+	if (area.IsEmpty())
+		return;
+
+	for (int32_t y = area.top; y < area.bottom; ++y)
+	{
+		uint32_t* row = pixels + static_cast<size_t>(y) * stride;
+		for (int32_t x = area.left; x < area.right; ++x)
+		{
+			uint32_t coverage = own ? own->mask->At(own->corner, x - own->square.left, y - own->square.top) : 255;
+			for (size_t i = 0; i < aboveCount && coverage != 0; ++i)
+			{
+				const CornerSquare& square = above[i];
+				if (x < square.square.left || x >= square.square.right || y < square.square.top || y >= square.square.bottom)
+					continue;
+				const uint32_t product = coverage * square.mask->OutsideAt(square.corner, x - square.square.left, y - square.square.top) + 128;
+				coverage = (product + (product >> 8)) >> 8;
+			}
+			if (coverage == 0)
+				continue;
+
+			// premultiplied 라 덮임이 겹치지 않는 두 조각은 더하면 됨. 반올림으로 넘치는 채널만 255 에서 멈춤
+			const uint32_t added = coverage == 255 ? pixel : ScalePixel(pixel, coverage);
+			const uint32_t existing = row[x];
+			uint32_t sum = 0;
+			for (uint32_t shift = 0; shift < 32; shift += 8)
+				sum |= std::min<uint32_t>(((existing >> shift) & 0xFF) + ((added >> shift) & 0xFF), 255) << shift;
+			row[x] = sum;
+		}
+	}
+}
+
+WindowRect RedrawBorder(uint32_t* pixels, size_t stride, const BorderVisual& previous, const BorderVisual& next) noexcept
+{
+	const bool drawn = !previous.bounds.IsEmpty();
+	if (drawn && previous == next)
+		return WindowRect{};
+
+	BorderParts oldParts{};
+	if (drawn)
+		oldParts = BorderParts(previous);
+	const BorderParts newParts(next);
+
+	const uint32_t pixel = BorderPixel(next.color, next.alpha);
+	// 모서리 모양 (반지름, 두께) 이 바뀌면 같은 자리라도 모두 다시 채움. 직각과 둥근 테두리 사이도 마찬가지
+	const bool reshaped = oldParts.count != newParts.count || oldParts.mask != newParts.mask;
+	const bool recolored = !drawn || reshaped || BorderPixel(previous.color, previous.alpha) != pixel;
+
+	// 자리가 바뀐 이전 조각만 지움 (색만 바뀌었으면 지우지 않고 덮어씀. 모서리는 투명한 픽셀까지 덮어씀)
+	WindowRect dirty{};
+	WindowRect cleared[8]{};
+	for (size_t i = 0; i < oldParts.count; ++i)
+	{
+		if (!reshaped && oldParts.rects[i] == newParts.rects[i])
+			continue;
+
+		FillPixels(pixels, stride, oldParts.rects[i], 0);
+		cleared[i] = oldParts.rects[i];
+		dirty = dirty.Union(oldParts.rects[i]);
+	}
+
+	// 색이나 자리가 바뀌었거나, 지운 조각과 겹쳐 지워진 부분이 있는 조각을 채움
+	for (size_t i = 0; i < newParts.count; ++i)
+	{
+		const WindowRect& part = newParts.rects[i];
+		bool refill = recolored || !(part == oldParts.rects[i]);
+		for (size_t j = 0; j < oldParts.count && !refill; ++j)
+			refill = part.Intersects(cleared[j]);
+		if (!refill)
+			continue;
+
+		if (i < 4)
+			FillPixels(pixels, stride, part, pixel);
+		else
+			FillCornerPixels(pixels, stride, part, i - 4, *newParts.mask, pixel, part);
+		dirty = dirty.Union(part);
+	}
+	return dirty;
+}
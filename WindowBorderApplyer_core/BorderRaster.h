@@ -0,0 +1,106 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "BorderLayout.h"
+#include "CornerMask.h"
+#include "WindowSystemTypes.h"
+
+// 소프트웨어 표면에 테두리를 그리는 도구. 픽셀은 premultiplied BGRA (0xAARRGGBB, UpdateLayeredWindow 의 32 bpp DIB 와 같은 배치) 입니다.
+
+/// <summary> 행을 채우는 구현. 지원하지 않는 구현을 지정하면 Scalar 로 그립니다 </summary>
+enum class RasterKernel : uint8_t
+{
+	Scalar,
+	Sse2,
+	Avx2,
+};
+
+/// <summary> 이 CPU 에서 쓸 수 있는 구현인지 (x86 이 아니면 Scalar 만) </summary>
+bool IsRasterKernelSupported(RasterKernel kernel) noexcept;
+/// <summary> 쓸 수 있는 가장 넓은 구현. 처음 한 번만 CPU 를 확인합니다 </summary>
+RasterKernel BestRasterKernel() noexcept;
+const char* RasterKernelName(RasterKernel kernel) noexcept;
+
+/// <summary> COLORREF (0x00BBGGRR) 와 불투명도를 premultiplied BGRA 픽셀로 </summary>
+inline uint32_t BorderPixel(uint32_t colorRef, uint8_t alpha = 255) noexcept
+{
+	// 반올림한 c * a / 255
+	const auto premultiply = [alpha](uint32_t channel)
+		{
+			const uint32_t product = channel * alpha + 128;
+			return (product + (product >> 8)) >> 8;
+		};
+	const uint32_t r = premultiply(colorRef & 0xFF);
+	const uint32_t g = premultiply((colorRef >> 8) & 0xFF);
+	const uint32_t b = premultiply((colorRef >> 16) & 0xFF);
+	return (static_cast<uint32_t>(alpha) << 24) | (r << 16) | (g << 8) | b;
+}
+
+/// <summary>
+/// 테두리 선을 이루는 네 띠 (위, 아래, 왼쪽, 오른쪽) 의 좌표. FrameDrawer::ConvertRECT 와 같은 자리로,
+/// bounds 에서 1 픽셀 안쪽부터 변마다 두께 (EdgeThickness) 만큼이며 네 띠는 겹치지 않습니다. 둥근 모서리와 그라데이션은 고려하지 않습니다
+/// </summary>
+inline void BorderStrips(const BorderVisual& visual, WindowRect (&strips)[4]) noexcept
+{
+	const WindowRect outer{ visual.bounds.left + 1, visual.bounds.top + 1, visual.bounds.right - 1, visual.bounds.bottom - 1 };
+	const int32_t top = visual.EdgeThickness(0);
+	const int32_t bottom = visual.EdgeThickness(1);
+	const int32_t left = visual.EdgeThickness(2);
+	const int32_t right = visual.EdgeThickness(3);
+	strips[0] = WindowRect{ outer.left, outer.top, outer.right, outer.top + top };
+	strips[1] = WindowRect{ outer.left, outer.bottom - bottom, outer.right, outer.bottom };
+	strips[2] = WindowRect{ outer.left, outer.top + top, outer.left + left, outer.bottom - bottom };
+	strips[3] = WindowRect{ outer.right - right, outer.top + top, outer.right, outer.bottom - bottom };
+}
+
+/// <summary>
+/// 둥근 테두리를 이루는 조각: 모서리 네 개 (mask 크기의 정사각형, BorderCorner 순서) 와 그 사이의 곧은 변 네 띠 (BorderStrips 순서).
+/// 곧은 변은 FillPixels 로 채우고 모서리는 캐시한 덮임 (CornerMask) 으로 채우므로 프레임마다 원호를 계산하지 않습니다
+/// </summary>
+struct RoundedBorderParts
+{
+	WindowRect spans[4]{};
+	WindowRect corners[4]{};
+	std::shared_ptr<const CornerMask> mask{};
+};
+
+/// <summary>
+/// visual 을 둥근 테두리 조각으로 나눕니다. 반지름이 0 이거나, 변마다 두께가 다르거나 (PerEdge 가 우선), 창이 모서리 두 개보다 작으면
+/// false 이며 그때는 BorderStrips 로 그립니다. 그라데이션은 소프트웨어 그리기에서 쓰지 않으므로 보지 않음
+/// </summary>
+bool MakeRoundedBorderParts(const BorderVisual& visual, RoundedBorderParts& parts, CornerMaskCache& cache = CornerMaskCache::Shared());
+
+/// <summary> square (corner 모서리 정사각형, 표면 좌표) 중 clip 안쪽을 덮임을 곱한 pixel 로 씁니다. 덮임이 0 인 픽셀은 투명 (0) </summary>
+void FillCornerPixels(uint32_t* pixels, size_t stride, const WindowRect& square, size_t corner, const CornerMask& mask, uint32_t pixel,
+	const WindowRect& clip) noexcept;
+
+/// <summary> 둥근 테두리의 모서리 정사각형 하나 (corner 는 BorderCorner 순서) </summary>
+struct CornerSquare
+{
+	WindowRect square{};
+	size_t corner = 0;
+	std::shared_ptr<const CornerMask> mask{};
+};
+
+/// <summary>
+/// clip (표면 좌표) 안의 픽셀마다 pixel 에 덮임을 곱해 지금 픽셀에 더합니다 (채널마다 255 에서 멈춤). 덮임은 own 이 있으면
+/// 그 모서리의 덮임, 없으면 255 이고, above (위 창의 모서리, 표면 좌표) 안이면 그 모서리의 바깥 원호 밖인 정도를 곱합니다.
+/// 덮임이 0 인 픽셀은 건드리지 않습니다. 위에서 아래 창 순서로 그리는 공유 오버레이가 위 창의 모서리 밑에 아래 창을 그릴 때 씁니다
+/// </summary>
+void AddCoveredPixels(uint32_t* pixels, size_t stride, const WindowRect& clip, uint32_t pixel, const CornerSquare* own,
+	const CornerSquare* above, size_t aboveCount) noexcept;
+
+/// <summary> rect (표면 좌표, 이미 표면 안으로 잘린 것) 를 pixel 로 채웁니다. stride 는 한 행의 픽셀 수 </summary>
+void FillPixels(uint32_t* pixels, size_t stride, const WindowRect& rect, uint32_t pixel) noexcept;
+/// <summary> 지정한 구현으로 채웁니다 (테스트 / 벤치마크용) </summary>
+void FillPixels(uint32_t* pixels, size_t stride, const WindowRect& rect, uint32_t pixel, RasterKernel kernel) noexcept;
+
+/// <summary>
+/// 창 하나 크기의 버퍼 (visual 은 버퍼 좌표, 보통 LocalRect) 에 그린 테두리를 previous 에서 next 로 바꿉니다.
+/// 버퍼 전체를 지우지 않고 바뀐 띠 (둥근 테두리면 곧은 변과 모서리) 만 지우고 채우며, 건드린 영역 (반영할 영역) 을 반환합니다. 바뀐 것이 없으면 비어 있음.
+/// previous.bounds 가 비어 있으면 아무것도 그려지지 않은 (0 으로 채운) 버퍼로 봅니다
+/// </summary>
+WindowRect RedrawBorder(uint32_t* pixels, size_t stride, const BorderVisual& previous, const BorderVisual& next) noexcept;
@@ -0,0 +1,157 @@
+﻿#include "BorderScene.h"
+
+#include <algorithm>
+
+uint8_t DiffResolvedStyle(const ResolvedStyle& from, const ResolvedStyle& to) noexcept
+{
+	uint8_t dirty = 0;
+	if (from.margin != to.margin)
+		dirty |= BorderDirty::Size;
+	if (from.color != to.color || from.alpha != to.alpha || from.gradient != to.gradient || from.gradientColor != to.gradientColor)
+		dirty |= BorderDirty::Color;
+	if (from.thickness != to.thickness || from.edgeThickness != to.edgeThickness)
+		dirty |= BorderDirty::Thickness;
+	if (from.cornerRadius != to.cornerRadius)
+		dirty |= BorderDirty::Radius;
+	return dirty;
+}
+
+namespace
+{
+	uint8_t DiffBounds(const WindowRect& from, const WindowRect& to) noexcept
+	{
+		uint8_t dirty = 0;
+		if (from.left != to.left || from.top != to.top)
+			dirty |= BorderDirty::Position;
+		if (from.Width() != to.Width() || from.Height() != to.Height())
+			dirty |= BorderDirty::Size;
+		return dirty;
+	}
+}
+
+uint8_t DiffBorderVisual(const BorderVisual& from, const BorderVisual& to) noexcept
+{
+	return DiffBounds(from.bounds, to.bounds) | DiffResolvedStyle(from.Style(), to.Style());
+}
+
+uint8_t DiffBorderPlacement(const BorderStyleTable& styles, const BorderPlacement& from, const BorderPlacement& to) noexcept
+{
+	// 번호가 같으면 스타일 값을 읽지 않음 (대부분의 프레임)
+	const uint8_t dirty = DiffBounds(from.bounds, to.bounds);
+	if (from.style == to.style)
+		return dirty;
+	return dirty | DiffResolvedStyle(styles.Get(from.style), styles.Get(to.style));
+}
+
+BorderScene::BorderScene(const BorderStyleTable& styles) : styles(styles)
+{
+}
+
+void BorderScene::Insert(uint32_t node, const BorderPlacement& placement)
+{
+	if (nodes.size() <= node)
+		nodes.resize(static_cast<size_t>(node) + 1);
+
+	Node& entry = nodes[node];
+	if (!entry.live)
+		liveNodes++;
+
+	// 대기열에 남아 있을 수 있으므로 queued 는 그대로 (Commit 이 live 를 보고 건너뜀)
+	const bool queued = entry.queued;
+	entry = Node{};
+	entry.committed = placement;
+	entry.desired = placement;
+	entry.committedShown = true;
+	entry.desiredShown = true;
+	entry.queued = queued;
+	entry.live = true;
+	stats.nodes = liveNodes;
+}
+
+void BorderScene::Remove(uint32_t node) noexcept
+{
+	if (!Contains(node))
+		return;
+
+	nodes[node].live = false;
+	liveNodes--;
+	stats.nodes = liveNodes;
+}
+
+void BorderScene::Clear() noexcept
+{
+	nodes.clear();
+	dirtyNodes.clear();
+	pendingUpdates = 0;
+	liveNodes = 0;
+	stats.nodes = 0;
+}
+
+BorderScene::Node* BorderScene::Touch(uint32_t node)
+{
+	if (!Contains(node))
+		return nullptr;
+
+	pendingUpdates++;
+	Node& entry = nodes[node];
+	if (!entry.queued)
+	{
+		entry.queued = true;
+		dirtyNodes.push_back(node);
+	}
+	return &entry;
+}
+
+void BorderScene::Show(uint32_t node, const BorderPlacement& placement)
+{
+	if (Node* entry = Touch(node))
+	{
+		entry->desired = placement;
+		entry->desiredShown = true;
+	}
+}
+
+void BorderScene::Hide(uint32_t node)
+{
+	if (Node* entry = Touch(node))
+		entry->desiredShown = false;
+}
+
+void BorderScene::Restack(uint32_t node)
+{
+	if (Node* entry = Touch(node))
+		entry->restack = true;
+}
+
+uint8_t BorderScene::PendingDirty(uint32_t node) const noexcept
+{
+	if (!Contains(node) || !nodes[node].queued)
+		return 0;
+
+	const Node& entry = nodes[node];
+	if (!entry.desiredShown)
+		return entry.committedShown ? BorderDirty::Visibility : 0;
+
+	uint8_t dirty = DiffBorderPlacement(styles, entry.committed, entry.desired);
+	if (!entry.committedShown)
+		dirty |= BorderDirty::Visibility;
+	if (entry.restack)
+		dirty |= BorderDirty::Stacking;
+	return dirty;
+}
+
+void BorderScene::Record(const SceneFrameStats& frame) noexcept
+{
+	stats.frames++;
+	if (frame.repaints == 0)
+		stats.framesWithoutRepaint++;
+	stats.updates += frame.updates;
+	stats.presents += frame.presents;
+	stats.repaints += frame.repaints;
+	stats.moves += frame.moves;
+	stats.restacks += frame.restacks;
+	stats.hides += frame.hides;
+	stats.unchanged += frame.unchanged;
+	stats.maxRepaintsPerFrame = std::max(stats.maxRepaintsPerFrame, frame.repaints);
+	stats.lastFrame = frame;
+}
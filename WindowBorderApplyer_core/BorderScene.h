@@ -0,0 +1,203 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BorderLayout.h"
+#include "BorderStyleTable.h"
+
+// 테두리 노드에서 반영하지 않은 변경의 종류
+namespace BorderDirty
+{
+	// 화면 위치 (bounds 의 왼쪽 위)
+	constexpr uint8_t Position = 1 << 0;
+	// bounds 크기, margin
+	constexpr uint8_t Size = 1 << 1;
+	// 색, 불투명도, 그라데이션
+	constexpr uint8_t Color = 1 << 2;
+	// 선 두께, 변마다 두께
+	constexpr uint8_t Thickness = 1 << 3;
+	constexpr uint8_t Radius = 1 << 4;
+	// 숨김 -> 표시
+	constexpr uint8_t Visibility = 1 << 5;
+	// 대상 창이 포그라운드가 되어 z 순서를 다시 맞춤
+	constexpr uint8_t Stacking = 1 << 6;
+
+	// 그려진 픽셀이 바뀌는 변경. 나머지는 창을 옮기거나 z 순서만 바꿈
+	constexpr uint8_t Content = Size | Color | Thickness | Radius | Visibility;
+}
+
+/// <summary> from 을 그려 둔 테두리를 to 로 바꾸려면 필요한 변경 (BorderDirty). 같으면 0 </summary>
+uint8_t DiffBorderVisual(const BorderVisual& from, const BorderVisual& to) noexcept;
+/// <summary> 스타일 값만 비교 (위치 제외). margin 은 Size </summary>
+uint8_t DiffResolvedStyle(const ResolvedStyle& from, const ResolvedStyle& to) noexcept;
+/// <summary> DiffBorderVisual 과 같은 비트. 스타일 번호가 같으면 위치만 비교합니다 </summary>
+uint8_t DiffBorderPlacement(const BorderStyleTable& styles, const BorderPlacement& from, const BorderPlacement& to) noexcept;
+
+/// <summary> 한 번의 Commit (표시 단계의 명령 묶음 하나) 에서 한 일 </summary>
+struct SceneFrameStats
+{
+	// 이번 프레임에 노드에 기록한 표시 / 숨김 / 올림 명령
+	uint32_t updates = 0;
+	// 변경이 기록된 노드
+	uint32_t dirtyNodes = 0;
+	// 오버레이 Present 호출. 아래 셋으로 나뉨
+	uint32_t presents = 0;
+	// 픽셀이 바뀐 (다시 그린) 노드. 다시 보인 노드 포함
+	uint32_t repaints = 0;
+	// 옮기기만 한 노드
+	uint32_t moves = 0;
+	// z 순서만 다시 맞춘 노드
+	uint32_t restacks = 0;
+	uint32_t hides = 0;
+	// 변경이 기록됐지만 반영한 상태와 같아져 아무것도 하지 않은 노드 (예: 숨겼다가 같은 자리에 다시 표시)
+	uint32_t unchanged = 0;
+};
+
+struct SceneStats
+{
+	// Commit 에서 변경이 기록된 노드가 있었던 프레임
+	uint64_t frames = 0;
+	// 그 중 아무것도 다시 그리지 않은 프레임 (옮기기, 숨기기, 같은 상태뿐)
+	uint64_t framesWithoutRepaint = 0;
+	uint64_t updates = 0;
+	uint64_t presents = 0;
+	uint64_t repaints = 0;
+	uint64_t moves = 0;
+	uint64_t restacks = 0;
+	uint64_t hides = 0;
+	uint64_t unchanged = 0;
+	// 한 프레임에서 가장 많이 다시 그린 노드 수
+	uint32_t maxRepaintsPerFrame = 0;
+	size_t nodes = 0;
+	SceneFrameStats lastFrame{};
+};
+
+/// <summary>
+/// 모든 테두리의 유지 장면 (retained scene). 노드마다 오버레이에 마지막으로 반영한 상태와 바라는 상태를 따로 두고,
+/// 표시 / 숨김 / 올림 명령은 바라는 상태만 바꿉니다. Commit 에서 변경이 기록된 노드만 두 상태를 비교해 (BorderDirty)
+/// 노드마다 한 번만 반영하므로, 한 묶음에서 같은 테두리를 여러 번 옮기거나 숨겼다 다시 보여도 오버레이 호출은 많아야 한 번이고
+/// 결과가 같으면 한 번도 하지 않습니다. 노드 번호는 오버레이 번호 (작은 정수) 입니다. 한 스레드에서만 사용해야 합니다.
+/// 노드는 위치와 스타일 번호 (BorderPlacement) 만 두고, 반영할 때 styles 로 BorderVisual 을 만듭니다
+/// </summary>
+class BorderScene
+{
+public:
+	/// <summary> styles 는 장면보다 오래 살아 있어야 합니다 </summary>
+	explicit BorderScene(const BorderStyleTable& styles);
+
+	/// <summary> 오버레이를 만들거나 다시 붙여 placement 로 이미 표시한 노드를 추가합니다 </summary>
+	void Insert(uint32_t node, const BorderPlacement& placement);
+	/// <summary> 노드와 반영하지 않은 변경을 버립니다 </summary>
+	void Remove(uint32_t node) noexcept;
+	void Clear() noexcept;
+
+	/// <summary> 노드를 placement 로 보이게 합니다. 없는 노드면 무시 </summary>
+	void Show(uint32_t node, const BorderPlacement& placement);
+	void Hide(uint32_t node);
+	/// <summary> 대상 창이 맨 위로 올라와 위치가 같아도 다음 Commit 에서 다시 반영하게 합니다 </summary>
+	void Restack(uint32_t node);
+
+	bool Contains(uint32_t node) const noexcept { return node < nodes.size() && nodes[node].live; }
+	/// <summary> 오버레이에 마지막으로 반영한 위치와 스타일. Contains(node) 일 때만 </summary>
+	const BorderPlacement& Committed(uint32_t node) const noexcept { return nodes[node].committed; }
+	/// <summary> 오버레이가 지금 보이는지 (반영한 상태 기준) </summary>
+	bool IsShown(uint32_t node) const noexcept { return Contains(node) && nodes[node].committedShown; }
+	/// <summary> 노드가 반영하지 않은 변경 (BorderDirty). 테스트용 </summary>
+	uint8_t PendingDirty(uint32_t node) const noexcept;
+	bool HasPending() const noexcept { return !dirtyNodes.empty(); }
+
+	/// <summary>
+	/// 변경이 기록된 노드를 기록된 순서로 한 번씩 반영합니다. 보여야 하는 노드는 present(node, visual, dirty),
+	/// 숨겨야 하는 노드는 hide(node) 를 부릅니다. 반영할 것이 없으면 아무것도 부르지 않습니다
+	/// </summary>
+	template <typename PresentNode, typename HideNode>
+	SceneFrameStats Commit(PresentNode&& present, HideNode&& hide);
+
+	const SceneStats& Stats() const noexcept { return stats; }
+
+private:
+	struct Node
+	{
+		BorderPlacement committed{};
+		BorderPlacement desired{};
+		bool committedShown = false;
+		bool desiredShown = false;
+		bool restack = false;
+		bool queued = false;
+		bool live = false;
+	};
+
+	const BorderStyleTable& styles;
+	std::vector<Node> nodes{};
+	// 이번 프레임에 변경이 기록된 노드 (중복 없음)
+	std::vector<uint32_t> dirtyNodes{};
+	uint32_t pendingUpdates = 0;
+	size_t liveNodes = 0;
+	SceneStats stats{};
+
+	Node* Touch(uint32_t node);
+	void Record(const SceneFrameStats& frame) noexcept;
+};
+
+template <typename PresentNode, typename HideNode>
+SceneFrameStats BorderScene::Commit(PresentNode&& present, HideNode&& hide)
+{
+	SceneFrameStats frame{};
+	frame.updates = pendingUpdates;
+	pendingUpdates = 0;
+	if (dirtyNodes.empty())
+		return frame;
+
+	for (uint32_t id : dirtyNodes)
+	{
+		Node& node = nodes[id];
+		node.queued = false;
+		if (!node.live)
+			continue;
+
+		frame.dirtyNodes++;
+		const bool restack = node.restack;
+		node.restack = false;
+
+		if (!node.desiredShown)
+		{
+			if (node.committedShown)
+			{
+				hide(id);
+				node.committedShown = false;
+				frame.hides++;
+			}
+			else
+				frame.unchanged++;
+			continue;
+		}
+
+		uint8_t dirty = DiffBorderPlacement(styles, node.committed, node.desired);
+		if (!node.committedShown)
+			dirty |= BorderDirty::Visibility;
+		if (restack)
+			dirty |= BorderDirty::Stacking;
+		if (dirty == 0)
+		{
+			frame.unchanged++;
+			continue;
+		}
+
+		present(id, styles.Expand(node.desired), dirty);
+		node.committed = node.desired;
+		node.committedShown = true;
+		frame.presents++;
+		if ((dirty & BorderDirty::Content) != 0)
+			frame.repaints++;
+		else if ((dirty & BorderDirty::Position) != 0)
+			frame.moves++;
+		else
+			frame.restacks++;
+	}
+	dirtyNodes.clear();
+
+	Record(frame);
+	return frame;
+}
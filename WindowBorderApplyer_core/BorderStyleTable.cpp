@@ -0,0 +1,64 @@
+﻿#include "BorderStyleTable.h"
+
+BorderStyleTable::BorderStyleTable(const BorderStyle& style)
+{
+	roles[0].style = style;
+}
+
+void BorderStyleTable::SetStyle(const BorderStyle& next)
+{
+	roles[0].Reset(next);
+	stats.restyles++;
+}
+
+void BorderStyleTable::SetInactiveStyle(const BorderStyle& next)
+{
+	roles[1].Reset(next);
+	separateInactive = true;
+	stats.restyles++;
+}
+
+StyleId BorderStyleTable::ResolveSlow(uint32_t dpi, size_t slot)
+{
+	RoleSlot& role = roles[slot];
+	role.lastDpi = dpi;
+	for (const auto& [knownDpi, id] : role.byDpi)
+	{
+		if (knownDpi == dpi)
+		{
+			stats.hits++;
+			role.lastId = id;
+			return id;
+		}
+	}
+
+	// 두 역할의 값이 같으면 Intern 이 같은 번호를 돌려줌
+	stats.resolves++;
+	role.lastId = Intern(ResolveBorderStyle(role.style, dpi));
+	role.byDpi.emplace_back(dpi, role.lastId);
+	return role.lastId;
+}
+
+StyleId BorderStyleTable::Intern(const ResolvedStyle& resolved)
+{
+	// 레코드는 스타일 값 x DPI 수만큼이라 몇 개뿐. 스타일을 되돌리면 이전 레코드를 다시 씀
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (Get(static_cast<StyleId>(i)) == resolved)
+			return static_cast<StyleId>(i);
+	}
+
+	if (count == Capacity)
+		return static_cast<StyleId>(count - 1);
+
+	// 묶음을 먼저 만들고 레코드를 채운 뒤에야 번호를 돌려줌. 번호를 받은 스레드는 이미 채워진 레코드만 읽음
+	std::unique_ptr<Chunk>& chunk = chunks[count / ChunkSize];
+	if (!chunk)
+		chunk = std::make_unique<Chunk>();
+	chunk->records[count % ChunkSize] = resolved;
+
+	const StyleId id = static_cast<StyleId>(count++);
+	stats.interned++;
+	stats.records = count;
+	return id;
+}
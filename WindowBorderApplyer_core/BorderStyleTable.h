@@ -0,0 +1,129 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BorderLayout.h"
+
+/// <summary> 테두리가 어느 스타일로 그려지는지. 포그라운드 창만 Active </summary>
+enum class BorderRole : uint8_t
+{
+	Active,
+	Inactive,
+};
+
+struct StyleTableStats
+{
+	// Resolve 호출 중 DPI 별 번호로 바로 답한 횟수
+	uint64_t hits = 0;
+	// 새로 해석한 횟수 (처음 보는 DPI, 스타일 변경 뒤)
+	uint64_t resolves = 0;
+	// 표에 새로 넣은 레코드 (같은 값이 이미 있으면 세지 않음)
+	uint64_t interned = 0;
+	// SetStyle / SetInactiveStyle 횟수
+	uint64_t restyles = 0;
+	size_t records = 0;
+};
+
+/// <summary>
+/// 해석한 스타일 (ResolvedStyle) 의 표. 값마다 레코드 하나만 두고 테두리는 번호 (StyleId) 만 기억하므로,
+/// 창이 몇 개든 스타일 값은 DPI 마다 하나이고 선 두께도 DPI 마다 한 번만 계산합니다.
+/// 레코드는 한 번 넣으면 바꾸지 않고 옮기지 않습니다 (고정 크기 묶음). 스타일을 바꾸면 (SetStyle) 새 레코드를 넣고
+/// DPI 별 번호만 바꾸므로, 이전 번호를 가진 표시 명령도 끝까지 읽을 수 있습니다.
+/// 비활성 창의 스타일 (SetInactiveStyle) 을 따로 정하지 않으면 두 역할 모두 같은 번호를 씁니다.
+/// 쓰기 (Resolve, Intern, SetStyle) 는 한 스레드 (레이아웃 스레드) 에서만, Get 은 번호를 받은 뒤 어느 스레드에서나 (번호를 넘기는 큐가 순서를 보장)
+/// </summary>
+class BorderStyleTable
+{
+public:
+	static constexpr size_t ChunkSize = 64;
+	static constexpr size_t MaxChunks = 1024;
+	// NoStyle 을 뺀 번호 수
+	static constexpr size_t Capacity = ChunkSize * MaxChunks - 1;
+
+	explicit BorderStyleTable(const BorderStyle& style);
+
+	BorderStyleTable(const BorderStyleTable&) = delete;
+	BorderStyleTable& operator=(const BorderStyleTable&) = delete;
+
+	/// <summary> 활성 (포그라운드) 창의 스타일 </summary>
+	const BorderStyle& Style() const noexcept { return roles[0].style; }
+	/// <summary> 비활성 창의 스타일. 따로 정하지 않았으면 Style 과 같음 </summary>
+	const BorderStyle& InactiveStyle() const noexcept { return roles[SlotOf(BorderRole::Inactive)].style; }
+	bool HasInactiveStyle() const noexcept { return separateInactive; }
+	/// <summary> 활성 창의 스타일을 바꿉니다. DPI 별 번호만 비우며 (다음 Resolve 에서 다시 해석), 테두리는 호출하는 쪽이 다시 표시합니다 </summary>
+	void SetStyle(const BorderStyle& next);
+	/// <summary> 비활성 창의 스타일을 따로 정합니다. SetStyle 과 마찬가지로 테두리는 호출하는 쪽이 다시 표시합니다 </summary>
+	void SetInactiveStyle(const BorderStyle& next);
+
+	/// <summary> role 의 스타일을 dpi 로 해석한 번호. 역할과 DPI 마다 처음 한 번만 해석합니다 </summary>
+	StyleId Resolve(uint32_t dpi, BorderRole role = BorderRole::Active)
+	{
+		// 모니터가 하나면 항상 여기서 끝남
+		const RoleSlot& slot = roles[SlotOf(role)];
+		if (dpi == slot.lastDpi && slot.lastId != NoStyle)
+		{
+			stats.hits++;
+			return slot.lastId;
+		}
+		return ResolveSlow(dpi, SlotOf(role));
+	}
+	/// <summary> resolved 의 번호. 같은 값이 있으면 그 번호, 없으면 새로 넣음. 표가 가득 차면 마지막 레코드 </summary>
+	StyleId Intern(const ResolvedStyle& resolved);
+	/// <summary> 대상 창의 프레임 사각형과 DPI 로 오버레이 위치와 번호 (ComputeBorderVisual 과 같은 위치) </summary>
+	BorderPlacement Place(const WindowRect& frame, uint32_t dpi, BorderRole role = BorderRole::Active)
+	{
+		const StyleId id = Resolve(dpi, role);
+		return BorderPlacement{ BorderBounds(frame, Get(id).margin), id };
+	}
+
+	/// <summary> 넣은 레코드. id 는 이 표가 돌려준 번호여야 함 </summary>
+	const ResolvedStyle& Get(StyleId id) const noexcept { return chunks[id / ChunkSize]->records[id % ChunkSize]; }
+	/// <summary> 그리는 쪽에 넘길 값 </summary>
+	BorderVisual Expand(const BorderPlacement& placement) const noexcept
+	{
+		return MakeBorderVisual(placement.bounds, Get(placement.style), placement.style);
+	}
+
+	size_t Size() const noexcept { return count; }
+	const StyleTableStats& Stats() const noexcept { return stats; }
+
+private:
+	struct Chunk
+	{
+		std::array<ResolvedStyle, ChunkSize> records{};
+	};
+
+	/// <summary> 역할 하나의 스타일과 DPI 별 번호 </summary>
+	struct RoleSlot
+	{
+		BorderStyle style{};
+		// 지금 스타일의 DPI 별 번호. 모니터 배율 수만큼이라 몇 개뿐
+		std::vector<std::pair<uint32_t, StyleId>> byDpi{};
+		// 마지막으로 찾은 DPI 와 번호
+		uint32_t lastDpi = 0;
+		StyleId lastId = NoStyle;
+
+		void Reset(const BorderStyle& next)
+		{
+			style = next;
+			byDpi.clear();
+			lastId = NoStyle;
+		}
+	};
+
+	StyleId ResolveSlow(uint32_t dpi, size_t slot);
+	/// <summary> 비활성 스타일을 따로 정하지 않았으면 활성 자리를 함께 씀 </summary>
+	size_t SlotOf(BorderRole role) const noexcept { return role == BorderRole::Inactive && separateInactive ? 1 : 0; }
+
+	std::array<std::unique_ptr<Chunk>, MaxChunks> chunks{};
+	size_t count = 0;
+	// 0 은 활성, 1 은 비활성 (separateInactive 일 때만)
+	std::array<RoleSlot, 2> roles{};
+	bool separateInactive = false;
+	StyleTableStats stats{};
+};
@@ -0,0 +1,523 @@
+﻿#include "BorderTracker.h"
+
+BorderTracker::BorderTracker(WindowSystem& windowSystem, const BorderStyle& style, const GeometryPollPolicy& pollPolicy) :
+	windowSystem(windowSystem),
+	styles(style),
+	pollPolicy(pollPolicy)
+{
+}
+
+void BorderTracker::RefreshWindows(const std::vector<WindowHandle>& windows)
+{
+	const bool outer = BeginGeometryTick();
+	HandleRegistry<WindowHandle, uint8_t> listed{};
+	listed.Reserve(windows.size());
+	for (WindowHandle window : windows)
+		listed.Emplace(window, uint8_t{ 1 });
+
+	std::vector<WindowHandle> removed{};
+	for (WindowHandle window : trackedWindows.Handles())
+	{
+		if (!listed.Contains(window))
+			removed.push_back(window);
+	}
+
+	for (WindowHandle window : removed)
+		Untrack(window);
+
+	trackedWindows.Reserve(windows.size());
+	for (WindowHandle window : windows)
+		Track(window);
+	EndGeometryTick(outer);
+}
+
+void BorderTracker::AddWindow(WindowHandle window)
+{
+	const bool outer = BeginGeometryTick();
+	if (Track(window).liveness.IsLive())
+		AssignBorder(window);
+	EndGeometryTick(outer);
+}
+
+bool BorderTracker::AssignBorder(WindowHandle window)
+{
+	const bool outer = BeginGeometryTick();
+	TrackedWindow& tracked = Track(window);
+	if (IsOnCurrentDesktop(window))
+	{
+		BorderPlacement placement{};
+		auto overlay = CreateOverlay(window, placement);
+		if (overlay)
+		{
+			tracked.overlay = std::move(overlay);
+			tracked.presented = placement;
+			SchedulePoll(window, tracked, true);
+		}
+	}
+	else
+		tracked.overlay = nullptr;
+
+	EndGeometryTick(outer);
+	return true;
+}
+
+void BorderTracker::AssignAll()
+{
+	// AssignBorder 는 이미 등록된 항목만 갱신하므로 순회 중 구조가 바뀌지 않음.
+	// 등록 순서 (위에서 아래 z 순서) 의 역순으로 만들어 나중에 만든 테두리가 위에 오는 공유 오버레이의 순서를 맞춤
+	const bool outer = BeginGeometryTick();
+	for (size_t i = trackedWindows.Size(); i-- > 0;)
+	{
+		if (trackedWindows.ValueAt(i).liveness.IsLive())
+			AssignBorder(trackedWindows.HandleAt(i));
+	}
+	EndGeometryTick(outer);
+}
+
+void BorderTracker::Clear()
+{
+	trackedWindows.Clear();
+	eventFilter.Clear();
+	desktopCache.Clear();
+	dpiCache.Clear();
+	pollWheel.Clear();
+	geometry.Clear();
+	focusedWindow = nullptr;
+	activeWindow = nullptr;
+	// 파괴한 오버레이를 공유 오버레이에서도 지움
+	windowSystem.FlushOverlays();
+}
+
+bool BorderTracker::PushEvent(const Event& event, uint64_t nowUs)
+{
+	if (!event.hwnd)
+		return false;
+
+	// 사전 필터는 블룸 필터라 거짓 양성이 있으므로 여기서 정확히 확인. 새 창은 표시 / 포그라운드 이벤트로만 등록
+	const bool mayAdopt = event.event == WinEventId::SystemForeground || event.event == WinEventId::ObjectShow;
+	if (!mayAdopt && !trackedWindows.Contains(event.hwnd))
+		return false;
+
+	return eventCoalescer.Push(event, nowUs);
+}
+
+void BorderTracker::Flush(uint64_t nowUs)
+{
+	const bool outer = BeginGeometryTick();
+	clockUs = nowUs;
+
+	// 전환 알림이 이벤트보다 먼저 왔으면 이번 프레임의 이벤트를 새 데스크톱 기준으로 반영
+	SyncDesktop();
+
+	bool refreshNeeded = false;
+	// 한 프레임에 포그라운드가 여러 창을 거쳐 가도 마지막 창만 활성 (기록은 창마다 처음 도착 순서라 이벤트 시각으로 고름)
+	bool foreground = false;
+	WindowHandle foregroundWindow = nullptr;
+	uint32_t foregroundTime = 0;
+	eventCoalescer.Flush(nowUs, [this, &refreshNeeded, &foreground, &foregroundWindow, &foregroundTime](const CoalescedEvent<WindowHandle>& record)
+		{
+			if (ApplyEvent(record))
+				refreshNeeded = true;
+			if (record.Has(CoalescedKind::Foreground) && (!foreground || static_cast<int32_t>(record.latestTime - foregroundTime) >= 0))
+			{
+				foreground = true;
+				foregroundWindow = record.hwnd;
+				foregroundTime = record.latestTime;
+			}
+		});
+
+	if (foreground)
+		SetActiveWindow(foregroundWindow);
+
+	// 놓친 데스크톱 전환: 한 프레임에 여러 번이어도 한 번만 갱신
+	if (refreshNeeded)
+	{
+		foregroundStats.refreshes++;
+		RefreshBorders();
+	}
+
+	// 이번 프레임에 위치가 바뀐 창은 여기서 한 번에 표시
+	EndGeometryTick(outer);
+}
+
+void BorderTracker::RefreshBorders()
+{
+	const bool outer = BeginGeometryTick();
+	for (size_t i = 0; i < trackedWindows.Size(); ++i)
+	{
+		WindowHandle window = trackedWindows.HandleAt(i);
+		auto& overlay = trackedWindows.ValueAt(i).overlay;
+		if (!trackedWindows.ValueAt(i).liveness.IsLive())
+			continue;
+
+		if (IsOnCurrentDesktop(window))
+		{
+			if (!overlay)
+				AssignBorder(window);
+		}
+		else
+		{
+			if (overlay)
+				overlay = nullptr;
+		}
+	}
+	EndGeometryTick(outer);
+}
+
+void BorderTracker::RefreshGeometry()
+{
+	const bool outer = BeginGeometryTick();
+	for (size_t i = 0; i < trackedWindows.Size(); ++i)
+	{
+		const TrackedWindow& tracked = trackedWindows.ValueAt(i);
+		if (tracked.overlay && tracked.liveness.IsLive())
+			UpdateGeometry(trackedWindows.HandleAt(i), false);
+	}
+	EndGeometryTick(outer);
+}
+
+uint64_t BorderTracker::Poll(uint64_t nowUs)
+{
+	const bool outer = BeginGeometryTick();
+	clockUs = nowUs;
+	polledWindows.clear();
+	pollWheel.Advance(nowUs, [this](WindowHandle window) { PollGeometry(window); });
+	EndGeometryTick(outer);
+
+	// 바뀐 창은 표시하면서 짧은 간격으로 다시 걸었으므로, 그대로인 창만 간격을 늘림
+	for (WindowHandle window : polledWindows)
+	{
+		if (geometry.WasChanged(window))
+		{
+			pollStats.changes++;
+			continue;
+		}
+
+		TrackedWindow* tracked = trackedWindows.Find(window);
+		if (tracked)
+			SchedulePoll(window, *tracked, false);
+	}
+	return pollWheel.NextDeadlineUs();
+}
+
+void BorderTracker::OnDesktopSwitched()
+{
+	desktopCache.BumpGeneration();
+	RefreshBorders();
+}
+
+void BorderTracker::OnDisplayChanged()
+{
+	dpiCache.BumpGeneration();
+	RefreshGeometry();
+}
+
+size_t BorderTracker::SetStyle(const BorderStyle& style)
+{
+	styles.SetStyle(style);
+	return RestyleAll();
+}
+
+size_t BorderTracker::SetInactiveStyle(const BorderStyle& style)
+{
+	styles.SetInactiveStyle(style);
+	return RestyleAll();
+}
+
+void BorderTracker::SetActiveWindow(WindowHandle window)
+{
+	if (window == activeWindow)
+		return;
+
+	const bool outer = BeginGeometryTick();
+	const WindowHandle previous = activeWindow;
+	activeWindow = window;
+	foregroundStats.switches++;
+
+	// 이전 활성 창은 위치가 그대로이므로 조회 없이 스타일 번호만 바꿈. 두 스타일이 같으면 다시 그리지 않음
+	TrackedWindow* deactivated = previous ? trackedWindows.Find(previous) : nullptr;
+	if (deactivated && deactivated->overlay && deactivated->liveness.IsLive() && deactivated->presented.style != NoStyle)
+	{
+		const BorderPlacement placement = Restyled(previous, deactivated->presented);
+		if (placement.style != deactivated->presented.style)
+		{
+			deactivated->presented = placement;
+			deactivated->overlay->Present(styles.Expand(placement));
+			foregroundStats.restyled++;
+		}
+	}
+
+	// 새 활성 창은 포그라운드 이벤트로 이번 틱에 이미 조회했으므로, 틱 끝에 새 스타일로 한 번만 표시
+	TrackedWindow* activated = window ? trackedWindows.Find(window) : nullptr;
+	if (activated && activated->overlay && activated->liveness.IsLive() && activated->presented.style != NoStyle
+		&& styles.Resolve(styles.Get(activated->presented.style).dpi, BorderRole::Active) != activated->presented.style)
+	{
+		UpdateGeometry(window, true);
+		foregroundStats.restyled++;
+	}
+	EndGeometryTick(outer);
+}
+
+void BorderTracker::AttachDesktopWatcher(const DesktopWatcher* watcher) noexcept
+{
+	desktopWatcher = watcher;
+	seenDesktopSwitches = watcher ? watcher->SwitchCount() : 0;
+}
+
+bool BorderTracker::SyncDesktop()
+{
+	if (!desktopWatcher)
+		return false;
+
+	// 알림이 여러 번 쌓여 있어도 마지막 데스크톱 기준으로 한 번만 정리
+	const uint64_t switches = desktopWatcher->SwitchCount();
+	if (switches == seenDesktopSwitches)
+		return false;
+
+	seenDesktopSwitches = switches;
+	OnDesktopSwitched();
+	return true;
+}
+
+bool BorderTracker::IsOnCurrentDesktop(WindowHandle window)
+{
+	// 같은 데스크톱 안에서의 포커스 변경은 캐시로만 답함
+	return desktopCache.IsOnCurrentDesktop(window, [this](WindowHandle handle) { return windowSystem.IsOnCurrentDesktop(handle); });
+}
+
+TrackedWindow& BorderTracker::Track(WindowHandle window)
+{
+	auto [tracked, inserted] = trackedWindows.Emplace(window);
+	if (inserted)
+	{
+		// 훅 스레드가 사전 필터를 먼저 보므로 조회보다 먼저 게시. 그 전에 거른 이벤트는 아래 조회 (위치는 그 뒤의 조회) 에 반영됨
+		eventFilter.Track(window);
+		tracked->liveness = windowSystem.QueryLiveness(window);
+	}
+	return *tracked;
+}
+
+void BorderTracker::Untrack(WindowHandle window)
+{
+	if (trackedWindows.Erase(window))
+		eventFilter.Untrack(window);
+	eventCoalescer.Forget(window);
+	desktopCache.Forget(window);
+	dpiCache.Forget(window);
+	pollWheel.Cancel(window);
+	geometry.Forget(window);
+	// 같은 HWND 값이 다른 창에 재사용되어도 포커스를 받으면 알림
+	if (focusedWindow == window)
+		focusedWindow = nullptr;
+	// 파괴된 활성 창은 다시 표시할 테두리가 없으므로 잊기만 함
+	if (activeWindow == window)
+		activeWindow = nullptr;
+}
+
+std::unique_ptr<BorderOverlay> BorderTracker::CreateOverlay(WindowHandle window, BorderPlacement& placement)
+{
+	const uint32_t index = SampleGeometry(window);
+	if (!geometry.IsValid(index))
+		return nullptr;
+
+	placement = styles.Place(geometry.Rect(index), geometry.Dpi(index), RoleOf(window));
+	auto overlay = windowSystem.CreateOverlay(window, styles.Style(), styles.Expand(placement));
+	// 새 테두리는 이미 이 값으로 표시했으므로 틱 끝에서 다시 보내지 않음
+	if (overlay)
+		geometry.Accept(index);
+	return overlay;
+}
+
+bool BorderTracker::ApplyEvent(const CoalescedEvent<WindowHandle>& record)
+{
+	// 창 파괴: 같은 HWND 값이 재사용되어도 이전 테두리가 붙지 않도록 항목을 제거
+	if (record.Has(CoalescedKind::Destroy))
+	{
+		Untrack(record.hwnd);
+		return false;
+	}
+
+	// 다른 데스크톱으로 옮겨지거나 데스크톱이 전환되면 창이 클로킹 / 해제됨
+	if (record.Has(CoalescedKind::Cloak))
+		desktopCache.Invalidate(record.hwnd);
+
+	// 포그라운드 창은 항상 현재 데스크톱에 있으므로, 캐시가 아니라고 하면 그 사이 데스크톱이 바뀐 것
+	// (감시자 알림이 늦거나 감시자가 없는 경우)
+	const bool missedSwitch = record.Has(CoalescedKind::Foreground) && desktopCache.Peek(record.hwnd) == false;
+	if (missedSwitch)
+		desktopCache.BumpGeneration();
+
+	auto tracked = trackedWindows.Find(record.hwnd);
+	if (!tracked)
+	{
+		// 주기적으로 창을 나열하지 않고, 처음 나타나거나 포그라운드가 된 창만 대상인지 확인해서 등록
+		if (record.Has(CoalescedKind::Visibility | CoalescedKind::Foreground) && windowSystem.IsBorderCandidate(record.hwnd))
+			AddWindow(record.hwnd);
+		// 등록하지 않은 창 (툴팁, 메뉴, 블룸 필터의 거짓 양성) 의 시간 기록은 남기지 않음. 파괴 이벤트는 사전 필터가 버리므로
+		// 지울 기회가 없고, 오래 남은 기록은 같은 HWND 값을 다시 쓰는 새 창의 이벤트를 오래된 것으로 버리게 함
+		else
+			eventCoalescer.Forget(record.hwnd);
+	}
+	else
+	{
+		// 최소화를 포함한 표시 상태 변경은 이 창 하나만 갱신
+		UpdateLiveness(*tracked, record);
+
+		// OBJECT의 위치, 모양, 크기가 변경됨 / 창 이동 또는 크기 조정 완료 (여러 번이어도 한 번만)
+		if (record.Has(CoalescedKind::Geometry) && tracked->overlay)
+			UpdateGeometry(record.hwnd, false);
+
+		// 포그라운드가 된 창은 위치가 그대로여도 테두리를 그 창 바로 위로 다시 올림
+		if (record.Has(CoalescedKind::Foreground) && tracked->overlay && tracked->liveness.IsLive())
+		{
+			tracked->overlay->Raise();
+			UpdateGeometry(record.hwnd, true);
+		}
+
+		// 포커스가 다른 추적 창에서 넘어왔을 때만 (EVENT_OBJECT_FOCUS 는 같은 창의 컨트롤 사이에서도 옴)
+		if (record.Has(CoalescedKind::Focus) && record.hwnd != focusedWindow && tracked->overlay && tracked->liveness.IsLive())
+		{
+			focusedWindow = record.hwnd;
+			tracked->overlay->Focus();
+		}
+	}
+
+	// 포그라운드 변경은 활성 창 두 개만 다시 표시 (Flush 의 SetActiveWindow). 모든 테두리의 소속은 놓친 전환일 때만 다시 정리.
+	// 감시자가 없어도 전환 때 클로킹 이벤트가 창마다 오므로 테두리는 UpdateLiveness 가 붙이고 뗌
+	return missedSwitch;
+}
+
+void BorderTracker::UpdateLiveness(TrackedWindow& tracked, const CoalescedEvent<WindowHandle>& record)
+{
+	const bool wasLive = tracked.liveness.IsLive();
+	record.ForEachLivenessEvent([&tracked](uint32_t event) { ApplyLivenessFlag(tracked.liveness, event); });
+
+	switch (CompareLiveness(wasLive, tracked.liveness))
+	{
+	case LivenessTransition::Shown:
+		AssignBorder(record.hwnd);
+		break;
+	case LivenessTransition::Hidden:
+		tracked.overlay = nullptr;
+		break;
+	default:
+		break;
+	}
+}
+
+size_t BorderTracker::RestyleAll()
+{
+	size_t restyled = 0;
+	for (size_t i = 0; i < trackedWindows.Size(); ++i)
+	{
+		TrackedWindow& tracked = trackedWindows.ValueAt(i);
+		if (!tracked.overlay || !tracked.liveness.IsLive() || tracked.presented.style == NoStyle)
+			continue;
+
+		tracked.presented = Restyled(trackedWindows.HandleAt(i), tracked.presented);
+		tracked.overlay->Present(styles.Expand(tracked.presented));
+		restyled++;
+	}
+
+	windowSystem.FlushOverlays();
+	return restyled;
+}
+
+BorderPlacement BorderTracker::Restyled(WindowHandle window, const BorderPlacement& presented)
+{
+	// 창 위치는 바뀌지 않았으므로 조회하지 않고, 보낸 위치에서 이전 margin 을 빼 프레임 사각형을 되살림
+	const ResolvedStyle& previous = styles.Get(presented.style);
+	const WindowRect frame = BorderBounds(presented.bounds, -previous.margin);
+	return styles.Place(frame, previous.dpi, RoleOf(window));
+}
+
+bool BorderTracker::BeginGeometryTick()
+{
+	if (geometryDepth++ != 0)
+		return false;
+
+	geometry.BeginTick();
+	return true;
+}
+
+void BorderTracker::EndGeometryTick(bool outer)
+{
+	geometryDepth--;
+	if (!outer)
+		return;
+
+	geometry.Diff([this](WindowHandle window, uint32_t index) { PresentGeometry(window, index); });
+	// 이번 틱의 생성, 표시, 숨김, 파괴를 공유 오버레이에 한 번에 반영
+	windowSystem.FlushOverlays();
+}
+
+uint32_t BorderTracker::SampleGeometry(WindowHandle window)
+{
+	return geometry.Sample(window, [this](WindowHandle handle, WindowRect& frame, uint32_t& dpi)
+		{
+			if (!windowSystem.GetFrameBounds(handle, frame))
+				return false;
+
+			// 창이 그대로면 캐시로만 답하고, 움직였으면 모니터만 다시 찾음
+			dpi = dpiCache.GetDpi(handle, frame,
+				[this](WindowHandle moved, const WindowRect& movedFrame) { return windowSystem.GetMonitor(moved, movedFrame); },
+				[this](MonitorHandle monitor) { return windowSystem.GetMonitorDpi(monitor); });
+			return true;
+		});
+}
+
+void BorderTracker::UpdateGeometry(WindowHandle window, bool force)
+{
+	const uint32_t index = SampleGeometry(window);
+	if (force)
+		geometry.Force(index);
+}
+
+void BorderTracker::PresentGeometry(WindowHandle window, uint32_t index)
+{
+	// 틱 사이에 테두리가 떨어졌으면 다시 붙을 때 새로 조회
+	TrackedWindow* tracked = trackedWindows.Find(window);
+	if (!tracked || !tracked->overlay || !tracked->liveness.IsLive())
+		return;
+
+	if (!geometry.IsValid(index))
+	{
+		tracked->overlay->Hide();
+		pollWheel.Cancel(window);
+		return;
+	}
+
+	tracked->presented = styles.Place(geometry.Rect(index), geometry.Dpi(index), RoleOf(window));
+	tracked->overlay->Present(styles.Expand(tracked->presented));
+	SchedulePoll(window, *tracked, true);
+}
+
+void BorderTracker::SchedulePoll(WindowHandle window, TrackedWindow& tracked, bool moved)
+{
+	if (pollPolicy.fastIntervalUs == 0)
+		return;
+
+	tracked.pollIntervalUs = moved ? pollPolicy.fastIntervalUs : tracked.pollIntervalUs * 2;
+	if (tracked.pollIntervalUs > pollPolicy.maxIntervalUs)
+	{
+		// 한동안 그대로였으면 다음 이벤트까지 깨어나지 않음
+		pollWheel.Cancel(window);
+		pollStats.settled++;
+		return;
+	}
+
+	pollWheel.Schedule(window, clockUs + tracked.pollIntervalUs, clockUs);
+}
+
+void BorderTracker::PollGeometry(WindowHandle window)
+{
+	// 그 사이 테두리가 떨어졌으면 다시 붙을 때 (AssignBorder) 타이머를 새로 검
+	TrackedWindow* tracked = trackedWindows.Find(window);
+	if (!tracked || !tracked->overlay || !tracked->liveness.IsLive())
+		return;
+
+	// 조회만 하고, 바뀌었는지는 틱 끝의 Diff 가 판단 (Poll)
+	pollStats.polls++;
+	SampleGeometry(window);
+	polledWindows.push_back(window);
+}
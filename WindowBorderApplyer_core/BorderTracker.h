@@ -0,0 +1,207 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "BorderLayout.h"
+#include "BorderStyleTable.h"
+#include "DesktopMembershipCache.h"
+#include "DesktopWatcher.h"
+#include "DpiCache.h"
+#include "EventCoalescer.h"
+#include "GeometrySnapshot.h"
+#include "HandleRegistry.h"
+#include "TimerWheel.h"
+#include "WinEventFilter.h"
+#include "WinEvents.h"
+#include "WindowLiveness.h"
+#include "WindowSystem.h"
+#include "WindowSystemTypes.h"
+
+/// <summary> 추적 중인 창 하나의 상태 (테두리가 없으면 overlay 는 nullptr) </summary>
+struct TrackedWindow
+{
+	std::unique_ptr<BorderOverlay> overlay;
+	WindowLiveness liveness;
+	// 마지막으로 보낸 위치와 스타일 번호 (값은 BorderTracker::Styles), 다음 위치 확인까지의 간격 (Poll)
+	BorderPlacement presented{};
+	uint64_t pollIntervalUs = 0;
+};
+
+/// <summary>
+/// 이벤트 없이 테두리 위치를 다시 확인하는 주기 (이벤트를 놓치거나 DPI 만 바뀐 경우).
+/// 움직인 직후에는 fastIntervalUs 로 확인하고, 그대로면 간격을 두 배씩 늘리다가 maxIntervalUs 를 넘으면 다음 이벤트까지 멈춥니다
+/// </summary>
+struct GeometryPollPolicy
+{
+	// 0 이면 확인하지 않음 (이벤트로만 갱신)
+	uint64_t fastIntervalUs = 100000;
+	uint64_t maxIntervalUs = 3200000;
+};
+
+struct GeometryPollStats
+{
+	// 타이머로 위치를 확인한 횟수 (조회는 스냅샷이 틱마다 한 번으로 묶음)
+	uint64_t polls = 0;
+	// 그 중 모양이 바뀌어 다시 표시한 횟수 (이벤트를 놓친 경우)
+	uint64_t changes = 0;
+	// 간격이 상한을 넘어 확인을 멈춘 횟수
+	uint64_t settled = 0;
+};
+
+struct ForegroundSwitchStats
+{
+	// 활성 창이 바뀐 횟수 (같은 창이 다시 포그라운드가 되면 세지 않음)
+	uint64_t switches = 0;
+	// 그 때문에 스타일을 바꿔 다시 표시한 테두리 (전환마다 이전 창과 새 창, 최대 둘)
+	uint64_t restyled = 0;
+	// 포그라운드 이벤트로 모든 테두리의 데스크톱 소속을 다시 정리한 횟수 (전환을 놓쳤을 때만)
+	uint64_t refreshes = 0;
+};
+
+/// <summary>
+/// 창 추적과 테두리 배치 로직. 창 시스템은 WindowSystem 으로만 접근하므로 Windowmodule (Win32) 과
+/// 재생 도구 (SimulatedWindowSystem) 가 같은 코드를 사용합니다. 한 스레드에서만 사용해야 합니다.
+/// </summary>
+class BorderTracker
+{
+public:
+	using Event = BasicWinEventHook<WindowHandle>;
+
+	BorderTracker(WindowSystem& windowSystem, const BorderStyle& style, const GeometryPollPolicy& pollPolicy = {});
+
+	BorderTracker(const BorderTracker&) = delete;
+	BorderTracker& operator=(const BorderTracker&) = delete;
+
+	/// <summary> 목록에 없는 창은 추적 해제, 새 창은 테두리 없이 등록 </summary>
+	void RefreshWindows(const std::vector<WindowHandle>& windows);
+	/// <summary> 창을 등록하고, 보이는 창이면 테두리를 붙입니다 </summary>
+	void AddWindow(WindowHandle window);
+	bool IsTracked(WindowHandle window) const noexcept { return trackedWindows.Contains(window); }
+	/// <summary> 현재 데스크톱에 있으면 테두리를 새로 만들고, 아니면 뗍니다 </summary>
+	bool AssignBorder(WindowHandle window);
+	/// <summary> 보이는 모든 창에 테두리를 붙입니다 </summary>
+	void AssignAll();
+	void Clear();
+
+	/// <summary> WinHookProc 의 사전 필터. false 면 이벤트를 바로 버려도 됩니다 </summary>
+	bool Accept(uint32_t event, WindowHandle window, int32_t idObject, int32_t idChild) noexcept
+	{
+		return eventFilter.Accept(event, window, idObject, idChild);
+	}
+	/// <summary> 아무 스레드: Accept 와 같은 판정이지만 세지 않습니다. 추적 집합은 이 추적기를 쓰는 스레드가 바꾸는 대로 원자적으로 게시됨 </summary>
+	bool MayAccept(uint32_t event, WindowHandle window, int32_t idObject, int32_t idChild) const noexcept
+	{
+		return eventFilter.MayAccept(event, window, idObject, idChild);
+	}
+
+	/// <summary> 이벤트를 병합 대기열에 넣습니다. 대기열이 비어 있다가 채워졌으면 true (프레임 타이머를 걸어야 함) </summary>
+	bool PushEvent(const Event& event, uint64_t nowUs);
+	/// <summary> 프레임 타이머: 병합된 이벤트를 창별로 한 번씩 반영합니다 </summary>
+	void Flush(uint64_t nowUs);
+	/// <summary> 가상 데스크톱 소속에 따라 테두리를 붙이거나 뗍니다 </summary>
+	void RefreshBorders();
+	/// <summary> 모든 테두리 위치를 다시 맞춥니다 (이벤트를 놓쳤을 때) </summary>
+	void RefreshGeometry();
+	/// <summary>
+	/// 위치 확인 타이머: nowUs 까지 만료된 창의 프레임 사각형을 다시 조회합니다.
+	/// 다음으로 부를 시각 (us) 을 반환하며, 확인할 창이 없으면 0 (깨어날 필요 없음)
+	/// </summary>
+	uint64_t Poll(uint64_t nowUs);
+	/// <summary> 현재 데스크톱이 바뀌었음을 알고 있을 때: 소속 캐시를 무효화하고 테두리를 다시 정리합니다 </summary>
+	void OnDesktopSwitched();
+	/// <summary> 디스플레이 구성이나 배율이 바뀌었을 때: DPI 캐시를 무효화하고 모든 테두리를 다시 조회해 DPI 가 바뀐 테두리만 다시 그립니다 </summary>
+	void OnDisplayChanged();
+	/// <summary>
+	/// 데스크톱 전환 감시자를 붙입니다 (nullptr 이면 뗌). 붙어 있으면 감시자가 전환을 알렸을 때 SyncDesktop 에서 한 번에 정리하고,
+	/// 없으면 포그라운드 창이 다른 데스크톱에 있다고 캐시된 경우 (놓친 전환) 에만 정리합니다. 감시자는 추적기보다 오래 살아 있어야 합니다
+	/// </summary>
+	void AttachDesktopWatcher(const DesktopWatcher* watcher) noexcept;
+	/// <summary> 감시자가 마지막으로 확인한 뒤 전환을 알렸으면 OnDesktopSwitched 를 한 번 수행하고 true </summary>
+	bool SyncDesktop();
+
+	size_t Size() const noexcept { return trackedWindows.Size(); }
+	const std::vector<WindowHandle>& Handles() const noexcept { return trackedWindows.Handles(); }
+	const TrackedWindow* Find(WindowHandle window) const noexcept { return trackedWindows.Find(window); }
+
+	const CoalescerStats& EventStats() const noexcept { return eventCoalescer.Stats(); }
+	/// <summary> 병합 단계가 시간 기록을 남겨 둔 창 수. 추적 중인 창보다 많지 않음 </summary>
+	size_t EventWatermarkCount() const noexcept { return eventCoalescer.WatermarkCount(); }
+	const WinEventFilterStats& FilterStats() const noexcept { return eventFilter.Stats(); }
+	const DesktopCacheStats& DesktopStats() const noexcept { return desktopCache.Stats(); }
+	const DpiCacheStats& DpiStats() const noexcept { return dpiCache.Stats(); }
+	const GeometryPollStats& PollStats() const noexcept { return pollStats; }
+	const TimerWheelStats& PollTimerStats() const noexcept { return pollWheel.Stats(); }
+	const GeometrySnapshotStats& GeometryStats() const noexcept { return geometry.Stats(); }
+	/// <summary> 위치 확인 타이머가 걸린 창 수 (모두 멈춰 있으면 0) </summary>
+	size_t PollingWindows() const noexcept { return pollWheel.Size(); }
+	const ForegroundSwitchStats& ForegroundStats() const noexcept { return foregroundStats; }
+	/// <summary> 마지막으로 포그라운드가 된 창 (추적하지 않는 창일 수 있음). 이 창의 테두리만 활성 스타일 </summary>
+	WindowHandle ActiveWindow() const noexcept { return activeWindow; }
+	/// <summary>
+	/// 활성 창을 바꿉니다 (EVENT_SYSTEM_FOREGROUND). 이전 활성 창과 새 활성 창의 테두리만 스타일을 바꿔 다시 표시하므로
+	/// 추적 중인 창 수와 관계없이 전환마다 테두리 둘까지만 다룹니다. 시작할 때 지금 포그라운드 창을 알려 줄 때도 사용
+	/// </summary>
+	void SetActiveWindow(WindowHandle window);
+	/// <summary> 마지막으로 키보드 포커스를 받은 추적 창 (EVENT_OBJECT_FOCUS). 없으면 nullptr </summary>
+	WindowHandle FocusedWindow() const noexcept { return focusedWindow; }
+	const BorderStyle& Style() const noexcept { return styles.Style(); }
+	/// <summary> 테두리들이 번호로 가리키는 스타일 표. 번호는 이 표로 값을 읽습니다 </summary>
+	const BorderStyleTable& Styles() const noexcept { return styles; }
+	/// <summary>
+	/// 활성 창의 스타일을 바꿉니다 (비활성 스타일을 따로 정하지 않았으면 모든 테두리). 위치는 그대로 두고 (창 조회 없음)
+	/// 마지막으로 보낸 위치에서 margin 만 다시 맞춰 새 스타일 번호로 다시 표시합니다. 다시 표시한 테두리 수를 반환
+	/// </summary>
+	size_t SetStyle(const BorderStyle& style);
+	/// <summary> 비활성 창의 스타일을 따로 정합니다. SetStyle 과 같은 방법으로 다시 표시한 테두리 수를 반환 </summary>
+	size_t SetInactiveStyle(const BorderStyle& style);
+
+private:
+	WindowSystem& windowSystem;
+	BorderStyleTable styles;
+	HandleRegistry<WindowHandle, TrackedWindow> trackedWindows{};
+	WinEventPrefilter<WindowHandle> eventFilter{};
+	EventCoalescer<WindowHandle> eventCoalescer{};
+	DesktopMembershipCache<WindowHandle> desktopCache{};
+	DpiCache<WindowHandle> dpiCache{};
+	const DesktopWatcher* desktopWatcher = nullptr;
+	uint64_t seenDesktopSwitches = 0;
+	GeometryPollPolicy pollPolicy;
+	TimerWheel<WindowHandle> pollWheel{};
+	GeometryPollStats pollStats{};
+	// 마지막으로 받은 시각. 시각을 받지 않는 호출 (AddWindow 등) 에서 타이머를 걸 때 사용
+	uint64_t clockUs = 0;
+	// 공개 호출 하나가 한 틱. 틱 안에서는 창마다 프레임 사각형을 한 번만 조회하고, 끝날 때 바뀐 창만 표시
+	GeometrySnapshot<WindowHandle> geometry{};
+	uint32_t geometryDepth = 0;
+	std::vector<WindowHandle> polledWindows{};
+	// 포커스가 같은 창 안에서 옮겨 다녀도 (자식 컨트롤) 오버레이에는 창이 바뀔 때만 알림
+	WindowHandle focusedWindow = nullptr;
+	// 포그라운드 전환 때 모든 테두리를 훑지 않도록 마지막 활성 창만 기억
+	WindowHandle activeWindow = nullptr;
+	ForegroundSwitchStats foregroundStats{};
+
+	bool IsOnCurrentDesktop(WindowHandle window);
+	TrackedWindow& Track(WindowHandle window);
+	void Untrack(WindowHandle window);
+	std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle window, BorderPlacement& placement);
+	bool ApplyEvent(const CoalescedEvent<WindowHandle>& record);
+	BorderRole RoleOf(WindowHandle window) const noexcept { return window == activeWindow ? BorderRole::Active : BorderRole::Inactive; }
+	/// <summary> 모든 테두리를 지금 스타일 표로 다시 표시 (SetStyle, SetInactiveStyle) </summary>
+	size_t RestyleAll();
+	/// <summary> 보낸 위치에서 margin 만 다시 맞춘 위치 (창 조회 없음). 번호는 지금 역할의 스타일 </summary>
+	BorderPlacement Restyled(WindowHandle window, const BorderPlacement& presented);
+	void UpdateLiveness(TrackedWindow& tracked, const CoalescedEvent<WindowHandle>& record);
+	/// <summary> 가장 바깥 호출이면 스냅샷의 새 틱을 시작하고 true </summary>
+	bool BeginGeometryTick();
+	/// <summary> 가장 바깥 호출이면 (outer) 이번 틱에 조회한 창 중 바뀐 창만 표시 </summary>
+	void EndGeometryTick(bool outer);
+	uint32_t SampleGeometry(WindowHandle window);
+	/// <summary> 이번 틱에 위치를 다시 조회하게 합니다. force 면 그대로여도 다시 표시 (z 순서를 다시 맞춤) </summary>
+	void UpdateGeometry(WindowHandle window, bool force);
+	void PresentGeometry(WindowHandle window, uint32_t index);
+	/// <summary> 움직였으면 짧은 간격으로, 아니면 간격을 늘려 다시 겁니다. 상한을 넘으면 걸지 않음 </summary>
+	void SchedulePoll(WindowHandle window, TrackedWindow& tracked, bool moved);
+	void PollGeometry(WindowHandle window);
+};
@@ -0,0 +1,138 @@
+﻿#include "CornerMask.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// 픽셀마다 SampleGrid x SampleGrid 점
+	constexpr int32_t SampleGrid = 8;
+
+	/// <summary> 모서리 정사각형 안의 점 (x, y) 가 바깥 원호 밖인지 </summary>
+	bool Outside(float x, float y, float radius) noexcept
+	{
+		if (x >= radius || y >= radius)
+			return false;
+
+		const float dx = radius - x;
+		const float dy = radius - y;
+		return dx * dx + dy * dy > radius * radius;
+	}
+
+	/// <summary> 모서리 정사각형 안의 점 (x, y) 가 선 위인지. 바깥 원호 안쪽이면서 안쪽 둥근 사각형 바깥 </summary>
+	bool Covered(float x, float y, float radius, float thickness) noexcept
+	{
+		if (Outside(x, y, radius))
+			return false;
+
+		if (x < thickness || y < thickness)
+			return true;
+
+		// 안쪽 원호는 바깥 원호와 중심이 같음. 두께가 반지름보다 두꺼우면 안쪽은 직각
+		const float inner = radius - thickness;
+		if (inner > 0.0f && x < radius && y < radius)
+		{
+			const float dx = radius - x;
+			const float dy = radius - y;
+			return dx * dx + dy * dy > inner * inner;
+		}
+		return false;
+	}
+}
+
+CornerMask BuildCornerMask(float radius, int32_t thickness)
+{
+	CornerMask mask{};
+	mask.radiusQuarters = CornerRadiusQuarters(radius);
+	mask.thickness = thickness;
+
+	const float snapped = mask.Radius();
+	mask.size = std::max(static_cast<int32_t>(std::ceil(snapped)), thickness);
+	mask.coverage.assign(static_cast<size_t>(mask.size) * static_cast<size_t>(mask.size), 0);
+	mask.outside.assign(mask.coverage.size(), 0);
+
+	const float step = 1.0f / SampleGrid;
+	for (int32_t y = 0; y < mask.size; ++y)
+	{
+		for (int32_t x = 0; x < mask.size; ++x)
+		{
+			int32_t count = 0;
+			int32_t outsideCount = 0;
+			for (int32_t sy = 0; sy < SampleGrid; ++sy)
+			{
+				for (int32_t sx = 0; sx < SampleGrid; ++sx)
+				{
+					const float px = x + (sx + 0.5f) * step;
+					const float py = y + (sy + 0.5f) * step;
+					if (Covered(px, py, snapped, static_cast<float>(thickness)))
+						count++;
+					else if (Outside(px, py, snapped))
+						outsideCount++;
+				}
+			}
+			constexpr int32_t Samples = SampleGrid * SampleGrid;
+			const size_t index = static_cast<size_t>(y) * static_cast<size_t>(mask.size) + static_cast<size_t>(x);
+			mask.coverage[index] = static_cast<uint8_t>((count * 255 + Samples / 2) / Samples);
+			mask.outside[index] = static_cast<uint8_t>((outsideCount * 255 + Samples / 2) / Samples);
+		}
+	}
+	return mask;
+}
+
+std::shared_ptr<const CornerMask> CornerMaskCache::Get(float radius, int32_t thickness)
+{
+	const int32_t quarters = CornerRadiusQuarters(radius);
+	if (quarters <= 0 || thickness <= 0)
+		return nullptr;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = masks.size(); i-- > 0;)
+	{
+		if (masks[i]->radiusQuarters != quarters || masks[i]->thickness != thickness)
+			continue;
+
+		stats.hits++;
+		std::shared_ptr<const CornerMask> found = masks[i];
+		// 최근에 쓴 것을 뒤로 (보통 이미 맨 뒤)
+		if (i + 1 != masks.size())
+		{
+			masks.erase(masks.begin() + static_cast<std::ptrdiff_t>(i));
+			masks.push_back(found);
+		}
+		return found;
+	}
+
+	// 계산하는 동안 다른 스레드는 기다림. 같은 키를 두 번 계산하지 않음 (모서리 하나는 수십 us)
+	if (masks.size() >= MaxMasks)
+	{
+		stats.bytes -= masks.front()->Bytes();
+		masks.erase(masks.begin());
+		stats.evictions++;
+	}
+	auto built = std::make_shared<const CornerMask>(BuildCornerMask(radius, thickness));
+	masks.push_back(built);
+	stats.builds++;
+	stats.bytes += built->Bytes();
+	return built;
+}
+
+CornerMaskCacheStats CornerMaskCache::Stats() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	CornerMaskCacheStats snapshot = stats;
+	snapshot.masks = masks.size();
+	return snapshot;
+}
+
+void CornerMaskCache::Clear()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	masks.clear();
+	stats.bytes = 0;
+}
+
+CornerMaskCache& CornerMaskCache::Shared()
+{
+	static CornerMaskCache cache;
+	return cache;
+}
@@ -0,0 +1,90 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// <summary> 모서리 순서 (RoundedBorderParts 의 corners 순서) </summary>
+namespace BorderCorner
+{
+	constexpr size_t TopLeft = 0;
+	constexpr size_t TopRight = 1;
+	constexpr size_t BottomLeft = 2;
+	constexpr size_t BottomRight = 3;
+}
+
+/// <summary>
+/// 둥근 테두리 모서리 하나 (왼쪽 위) 의 안티앨리어싱 덮임 정도 (0~255). size x size 정사각형이며, 바깥 반지름 radius 의 원호와
+/// 안쪽 반지름 radius - thickness 의 원호 사이가 덮인 영역입니다. 다른 모서리는 뒤집어서 씁니다.
+/// outside 는 바깥 원호 밖 (창도 선도 아닌 투명한 부분) 의 덮임으로, 공유 오버레이가 위 창의 모서리 아래로 아래 창을 그릴 때 씁니다
+/// </summary>
+struct CornerMask
+{
+	// 반지름의 1/4 픽셀 단위 (캐시 키)
+	int32_t radiusQuarters = 0;
+	int32_t thickness = 0;
+	int32_t size = 0;
+	std::vector<uint8_t> coverage{};
+	std::vector<uint8_t> outside{};
+
+	float Radius() const noexcept { return static_cast<float>(radiusQuarters) / 4.0f; }
+	/// <summary> corner 모서리의 정사각형 안 좌표 (x, y) 의 덮임 정도 </summary>
+	uint8_t At(size_t corner, int32_t x, int32_t y) const noexcept { return coverage[Index(corner, x, y)]; }
+	/// <summary> corner 모서리의 정사각형 안 좌표 (x, y) 중 바깥 원호 밖인 정도 </summary>
+	uint8_t OutsideAt(size_t corner, int32_t x, int32_t y) const noexcept { return outside[Index(corner, x, y)]; }
+	size_t Bytes() const noexcept { return coverage.size() + outside.size(); }
+
+private:
+	size_t Index(size_t corner, int32_t x, int32_t y) const noexcept
+	{
+		const int32_t maskX = (corner & 1) != 0 ? size - 1 - x : x;
+		const int32_t maskY = (corner & 2) != 0 ? size - 1 - y : y;
+		return static_cast<size_t>(maskY) * static_cast<size_t>(size) + static_cast<size_t>(maskX);
+	}
+};
+
+/// <summary> 반지름 (픽셀, 1/4 단위로 반올림) 과 선 두께로 모서리를 만듭니다. 픽셀마다 8 x 8 점을 찍어 덮임을 셉니다 </summary>
+CornerMask BuildCornerMask(float radius, int32_t thickness);
+
+/// <summary> 반지름을 캐시 키 단위 (1/4 픽셀) 로 </summary>
+inline int32_t CornerRadiusQuarters(float radius) noexcept
+{
+	return radius > 0.0f ? static_cast<int32_t>(radius * 4.0f + 0.5f) : 0;
+}
+
+struct CornerMaskCacheStats
+{
+	uint64_t hits = 0;
+	// 새로 계산한 모서리 (처음 보는 반지름 / 두께)
+	uint64_t builds = 0;
+	// 상한을 넘어 가장 오래된 것을 버린 횟수
+	uint64_t evictions = 0;
+	size_t masks = 0;
+	size_t bytes = 0;
+};
+
+/// <summary>
+/// 모서리 덮임의 캐시. 키는 (반지름, 선 두께) 이며 둘 다 DPI 를 반영한 픽셀 값이므로 DPI 마다 따로 계산됩니다.
+/// 다른 DPI 라도 픽셀 값이 같으면 같은 모서리를 씁니다. 여러 스레드 (생성 작업 풀) 에서 불러도 됩니다
+/// </summary>
+class CornerMaskCache
+{
+public:
+	static constexpr size_t MaxMasks = 64;
+
+	/// <summary> 반지름이 0 이하거나 두께가 0 이하면 nullptr </summary>
+	std::shared_ptr<const CornerMask> Get(float radius, int32_t thickness);
+	CornerMaskCacheStats Stats() const;
+	void Clear();
+
+	/// <summary> 소프트웨어 그리기 (RedrawBorder, BorderCompositor) 가 함께 쓰는 캐시 </summary>
+	static CornerMaskCache& Shared();
+
+private:
+	mutable std::mutex mutex;
+	// 최근에 쓴 것이 뒤. 몇 개뿐이라 선형 탐색
+	std::vector<std::shared_ptr<const CornerMask>> masks{};
+	CornerMaskCacheStats stats{};
+};
@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include "HandleRegistry.h"
+
+struct DesktopCacheStats
+{
+	// 캐시로 답한 조회
+	uint64_t hits = 0;
+	// 창 시스템에 실제로 물어본 조회 (Windows 에서는 IVirtualDesktopManager COM 호출)
+	uint64_t queries = 0;
+	// 창 하나의 항목을 무효화한 횟수 (CLOAKED / UNCLOAKED)
+	uint64_t invalidations = 0;
+	// 데스크톱 전환으로 모든 항목을 무효화한 횟수
+	uint64_t generationBumps = 0;
+};
+
+/// <summary>
+/// 창별 "현재 가상 데스크톱에 있는지" 캐시. 항목은 조회한 시점의 데스크톱 세대를 기억하고,
+/// 데스크톱이 바뀌면 세대만 올려서 모든 항목을 한 번에 무효화합니다. 무효화된 항목은 실제로 다시 조회될 때만 갱신합니다.
+/// </summary>
+template <typename Handle, typename Hasher = HandleBits<Handle>>
+class DesktopMembershipCache
+{
+public:
+	/// <summary> 캐시된 값이 현재 세대면 그대로, 아니면 query(window) 로 조회해서 저장합니다 </summary>
+	template <typename Query>
+	bool IsOnCurrentDesktop(const Handle& window, Query&& query)
+	{
+		auto [entry, inserted] = entries.Emplace(window);
+		if (!inserted && entry->generation == generation)
+		{
+			stats.hits++;
+			return entry->onCurrentDesktop;
+		}
+
+		stats.queries++;
+		entry->onCurrentDesktop = query(window);
+		entry->generation = generation;
+		return entry->onCurrentDesktop;
+	}
+
+	/// <summary> 조회 없이 캐시된 값만 확인합니다. 없거나 이전 세대면 nullopt </summary>
+	std::optional<bool> Peek(const Handle& window) const noexcept
+	{
+		const Entry* entry = entries.Find(window);
+		if (entry == nullptr || entry->generation != generation)
+			return std::nullopt;
+
+		return entry->onCurrentDesktop;
+	}
+
+	/// <summary> 창 하나의 항목을 다음 조회 때 갱신하도록 표시합니다 (다른 데스크톱으로 옮겨진 창) </summary>
+	void Invalidate(const Handle& window) noexcept
+	{
+		if (Entry* entry = entries.Find(window))
+		{
+			entry->generation = InvalidGeneration;
+			stats.invalidations++;
+		}
+	}
+
+	/// <summary> 데스크톱 전환: 모든 항목을 무효화합니다. O(1) </summary>
+	void BumpGeneration() noexcept
+	{
+		generation++;
+		stats.generationBumps++;
+	}
+
+	void Forget(const Handle& window)
+	{
+		entries.Erase(window);
+	}
+
+	void Clear() noexcept
+	{
+		entries.Clear();
+	}
+
+	uint64_t Generation() const noexcept { return generation; }
+	const DesktopCacheStats& Stats() const noexcept { return stats; }
+
+private:
+	static constexpr uint64_t InvalidGeneration = 0;
+
+	struct Entry
+	{
+		uint64_t generation = InvalidGeneration;
+		bool onCurrentDesktop = false;
+	};
+
+	HandleRegistry<Handle, Entry, Hasher> entries{};
+	uint64_t generation = InvalidGeneration + 1;
+	DesktopCacheStats stats{};
+};
@@ -0,0 +1,106 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+/// <summary> 가상 데스크톱 식별자 (Windows GUID 와 같은 16 바이트) </summary>
+struct DesktopId
+{
+	uint64_t high = 0;
+	uint64_t low = 0;
+
+	bool IsNull() const noexcept { return high == 0 && low == 0; }
+
+	bool operator==(const DesktopId& other) const noexcept { return high == other.high && low == other.low; }
+	bool operator!=(const DesktopId& other) const noexcept { return !(*this == other); }
+};
+
+/// <summary>
+/// 기록자가 하나인 seqlock 으로 게시하는 DesktopId. 16 바이트는 lock-free 원자 변수가 아닐 수 있으므로
+/// 순서 번호가 짝수이고 읽기 전후로 같을 때만 값을 받아들입니다. 읽는 쪽은 잠금 없이 어느 스레드에서나 읽을 수 있습니다.
+/// </summary>
+class PublishedDesktopId
+{
+public:
+	/// <summary> 기록 스레드 하나에서만 호출 </summary>
+	void Store(const DesktopId& id) noexcept
+	{
+		const uint32_t begin = sequence.load(std::memory_order_relaxed);
+		sequence.store(begin + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		high.store(id.high, std::memory_order_relaxed);
+		low.store(id.low, std::memory_order_relaxed);
+
+		sequence.store(begin + 2, std::memory_order_release);
+	}
+
+	DesktopId Load() const noexcept
+	{
+		for (;;)
+		{
+			const uint32_t begin = sequence.load(std::memory_order_acquire);
+			DesktopId id{ high.load(std::memory_order_relaxed), low.load(std::memory_order_relaxed) };
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if ((begin & 1) == 0 && sequence.load(std::memory_order_relaxed) == begin)
+				return id;
+		}
+	}
+
+private:
+	std::atomic<uint32_t> sequence{ 0 };
+	std::atomic<uint64_t> high{ 0 };
+	std::atomic<uint64_t> low{ 0 };
+};
+
+/// <summary>
+/// 현재 가상 데스크톱 전환 감시자. 구현 (Windows 는 RegistryDesktopWatcher, 테스트는 SimulatedDesktopSwitcher) 이
+/// 자기 스레드에서 Publish 를 호출하면 현재 데스크톱과 전환 횟수를 게시하고 onSwitch 로 알립니다.
+/// 추적 스레드는 SwitchCount 가 바뀌었을 때만 테두리를 한 번에 정리합니다 (BorderTracker::SyncDesktop).
+/// </summary>
+class DesktopWatcher
+{
+public:
+	/// <summary> 감시 스레드에서 호출됩니다. 추적 스레드를 깨우는 정도만 해야 합니다 </summary>
+	using SwitchCallback = std::function<void(const DesktopId&)>;
+
+	virtual ~DesktopWatcher() = default;
+
+	/// <summary> 감시를 시작합니다. 현재 데스크톱을 알 수 없으면 false </summary>
+	virtual bool Start(SwitchCallback callback) = 0;
+	virtual void Stop() = 0;
+
+	DesktopId CurrentDesktop() const noexcept { return current.Load(); }
+	/// <summary> Start 이후 감지한 전환 횟수. 값이 바뀌었으면 CurrentDesktop 도 이미 새 값입니다 </summary>
+	uint64_t SwitchCount() const noexcept { return switches.load(std::memory_order_acquire); }
+
+protected:
+	SwitchCallback onSwitch;
+
+	/// <summary> 시작할 때의 데스크톱. 전환으로 세지 않습니다 </summary>
+	void PublishInitial(const DesktopId& id) noexcept
+	{
+		current.Store(id);
+	}
+
+	/// <summary> 감시 스레드: 데스크톱이 실제로 바뀌었으면 게시하고 알립니다 (이름 변경 등 다른 값 변경은 무시) </summary>
+	bool Publish(const DesktopId& id)
+	{
+		if (id == current.Load())
+			return false;
+
+		// 번호를 올리기 전에 값을 게시해야 새 번호를 본 쪽이 새 값을 읽음
+		current.Store(id);
+		switches.fetch_add(1, std::memory_order_release);
+
+		if (onSwitch)
+			onSwitch(id);
+		return true;
+	}
+
+private:
+	PublishedDesktopId current{};
+	std::atomic<uint64_t> switches{ 0 };
+};
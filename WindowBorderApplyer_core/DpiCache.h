@@ -0,0 +1,108 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include "HandleRegistry.h"
+#include "WindowSystemTypes.h"
+
+struct DpiCacheStats
+{
+	// 창 항목으로 답한 조회 (창이 그대로라 모니터도 DPI 도 묻지 않음)
+	uint64_t windowHits = 0;
+	// 창이 움직여 모니터는 다시 찾았지만 그 모니터의 DPI 는 캐시로 답한 조회
+	uint64_t monitorHits = 0;
+	// 창 시스템에 모니터를 물어본 횟수 (Windows 에서는 MonitorFromRect)
+	uint64_t monitorLookups = 0;
+	// 창 시스템에 DPI 를 물어본 횟수 (Windows 에서는 GetDpiForMonitor)
+	uint64_t queries = 0;
+	// 디스플레이 구성 / DPI 변경으로 모든 항목을 무효화한 횟수
+	uint64_t generationBumps = 0;
+
+	/// <summary> 캐시가 없었으면 GetDpiForMonitor 를 불렀을 조회 수 </summary>
+	uint64_t Avoided() const noexcept { return windowHits + monitorHits; }
+};
+
+/// <summary>
+/// 모니터별, 창별 DPI 캐시. 창 항목은 조회할 때의 프레임 사각형과 모니터를 기억하므로 창이 그대로면 해시 조회 한 번으로 답하고,
+/// 움직였으면 모니터만 다시 찾아 모니터 항목의 DPI 를 씁니다. DPI 는 창이 모니터를 옮기거나 디스플레이 설정이 바뀔 때만 바뀌므로,
+/// 디스플레이 변경 / DPI 변경 알림에서 세대를 올려 모든 항목을 한 번에 무효화합니다. 한 스레드에서만 사용해야 합니다.
+/// </summary>
+template <typename Handle, typename Hasher = HandleBits<Handle>>
+class DpiCache
+{
+public:
+	/// <summary>
+	/// frame 에 놓인 window 의 DPI. 캐시에 없거나 이전 세대면 resolveMonitor(window, frame) 로 모니터를 찾고,
+	/// 그 모니터도 캐시에 없으면 queryDpi(monitor) 로 조회합니다
+	/// </summary>
+	template <typename ResolveMonitor, typename QueryDpi>
+	uint32_t GetDpi(const Handle& window, const WindowRect& frame, ResolveMonitor&& resolveMonitor, QueryDpi&& queryDpi)
+	{
+		auto [entry, inserted] = windows.Emplace(window);
+		if (!inserted && entry->generation == generation && entry->frame == frame)
+		{
+			stats.windowHits++;
+			return entry->dpi;
+		}
+
+		stats.monitorLookups++;
+		const MonitorHandle monitor = resolveMonitor(window, frame);
+		auto [monitorEntry, monitorInserted] = monitors.Emplace(monitor);
+		if (!monitorInserted && monitorEntry->generation == generation)
+			stats.monitorHits++;
+		else
+		{
+			stats.queries++;
+			monitorEntry->dpi = queryDpi(monitor);
+			monitorEntry->generation = generation;
+		}
+
+		entry->frame = frame;
+		entry->dpi = monitorEntry->dpi;
+		entry->generation = generation;
+		return entry->dpi;
+	}
+
+	/// <summary> 디스플레이 구성 / DPI 변경: 모든 항목을 무효화합니다. O(1) </summary>
+	void BumpGeneration() noexcept
+	{
+		generation++;
+		stats.generationBumps++;
+	}
+
+	void Forget(const Handle& window)
+	{
+		windows.Erase(window);
+	}
+
+	void Clear() noexcept
+	{
+		windows.Clear();
+		monitors.Clear();
+	}
+
+	uint64_t Generation() const noexcept { return generation; }
+	const DpiCacheStats& Stats() const noexcept { return stats; }
+
+private:
+	static constexpr uint64_t InvalidGeneration = 0;
+
+	struct WindowEntry
+	{
+		WindowRect frame{};
+		uint32_t dpi = 0;
+		uint64_t generation = InvalidGeneration;
+	};
+
+	struct MonitorEntry
+	{
+		uint32_t dpi = 0;
+		uint64_t generation = InvalidGeneration;
+	};
+
+	HandleRegistry<Handle, WindowEntry, Hasher> windows{};
+	// 모니터는 몇 개뿐이고 구성이 바뀌면 세대로 무효화되므로 지우지 않음
+	HandleRegistry<MonitorHandle, MonitorEntry> monitors{};
+	uint64_t generation = InvalidGeneration + 1;
+	DpiCacheStats stats{};
+};
@@ -0,0 +1,90 @@
+﻿#include "EdgeStripBorder.h"
+
+#include <utility>
+
+#include "BorderRaster.h"
+
+EdgeStripBorder::EdgeStripBorder(SurfaceFactory surfaceFactory) : surfaceFactory(std::move(surfaceFactory))
+{
+}
+
+bool EdgeStripBorder::Present(const BorderVisual& visual)
+{
+	WindowRect strips[4];
+	BorderStrips(visual, strips);
+	const uint32_t pixel = BorderPixel(visual.color, visual.alpha);
+
+	bool presented = true;
+	for (size_t i = 0; i < surfaces.size(); ++i)
+	{
+		const WindowRect& strip = strips[i];
+		std::unique_ptr<EdgeSurface>& surface = surfaces[i];
+
+		// 창이 두께보다 작으면 그 변은 없음
+		if (strip.IsEmpty())
+		{
+			if (surface)
+				surface->Hide();
+			continue;
+		}
+
+		bool redrawn = false;
+		if (!surface)
+		{
+			surface = surfaceFactory(static_cast<BorderEdge>(i), strip.Width(), strip.Height());
+			if (!surface)
+			{
+				presented = false;
+				continue;
+			}
+			stats.allocations++;
+			redrawn = true;
+		}
+		else if (surface->Width() != strip.Width() || surface->Height() != strip.Height())
+		{
+			// 길이 (또는 두께) 가 바뀐 변만 다시 할당. 너비만 바뀌면 위 / 아래 변뿐
+			if (!surface->Resize(strip.Width(), strip.Height()))
+			{
+				presented = false;
+				continue;
+			}
+			stats.allocations++;
+			redrawn = true;
+		}
+
+		if (redrawn || filled[i] != pixel)
+		{
+			FillPixels(surface->Pixels(), static_cast<size_t>(strip.Width()), WindowRect{ 0, 0, strip.Width(), strip.Height() }, pixel);
+			filled[i] = pixel;
+			redrawn = true;
+			stats.redraws++;
+		}
+		else
+		{
+			stats.moves++;
+		}
+
+		presented = surface->Present(strip, redrawn) && presented;
+	}
+	return presented;
+}
+
+void EdgeStripBorder::Hide()
+{
+	for (const std::unique_ptr<EdgeSurface>& surface : surfaces)
+	{
+		if (surface)
+			surface->Hide();
+	}
+}
+
+uint64_t EdgeStripBorder::SurfaceBytes() const noexcept
+{
+	uint64_t bytes = 0;
+	for (const std::unique_ptr<EdgeSurface>& surface : surfaces)
+	{
+		if (surface)
+			bytes += static_cast<uint64_t>(surface->Width()) * static_cast<uint64_t>(surface->Height()) * sizeof(uint32_t);
+	}
+	return bytes;
+}
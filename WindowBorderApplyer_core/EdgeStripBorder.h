@@ -0,0 +1,133 @@
+﻿#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "BorderLayout.h"
+#include "WindowSystemTypes.h"
+
+/// <summary> 테두리의 한 변. BorderStrips 의 띠 순서와 같음 </summary>
+enum class BorderEdge : uint8_t
+{
+	Top,
+	Bottom,
+	Left,
+	Right,
+};
+
+/// <summary>
+/// 테두리 한 변만 덮는 표면. 픽셀은 premultiplied BGRA 이고 한 행은 Width() 픽셀입니다.
+/// Windows 에서는 변 크기의 레이어드 창 하나 (EdgeStripWindow), 테스트에서는 SoftwareEdgeSurface 입니다
+/// </summary>
+class EdgeSurface
+{
+public:
+	virtual ~EdgeSurface() = default;
+
+	virtual uint32_t* Pixels() noexcept = 0;
+	virtual int32_t Width() const noexcept = 0;
+	virtual int32_t Height() const noexcept = 0;
+	/// <summary> 픽셀 버퍼를 새 크기로 다시 할당합니다. 내용은 호출하는 쪽이 다시 채웁니다 </summary>
+	virtual bool Resize(int32_t width, int32_t height) = 0;
+	/// <summary> 화면 좌표 screen 으로 옮기고 보입니다. redrawn 이면 픽셀 내용도 반영합니다 </summary>
+	virtual bool Present(const WindowRect& screen, bool redrawn) = 0;
+	virtual void Hide() = 0;
+};
+
+/// <summary> 메모리에만 있는 변 표면. 할당과 반영 횟수를 셉니다 </summary>
+class SoftwareEdgeSurface : public EdgeSurface
+{
+public:
+	SoftwareEdgeSurface(int32_t width, int32_t height) { Resize(width, height); }
+
+	uint32_t* Pixels() noexcept override { return pixels.data(); }
+	int32_t Width() const noexcept override { return width; }
+	int32_t Height() const noexcept override { return height; }
+
+	bool Resize(int32_t newWidth, int32_t newHeight) override
+	{
+		width = newWidth;
+		height = newHeight;
+		// shrink_to_fit 까지 해서 실제로 새로 할당하는 창 시스템 표면과 같은 메모리를 보고
+		pixels.assign(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+		pixels.shrink_to_fit();
+		allocations++;
+		return true;
+	}
+
+	bool Present(const WindowRect& newScreen, bool redrawn) override
+	{
+		screen = newScreen;
+		shown = true;
+		presents++;
+		if (redrawn)
+			contentPresents++;
+		return true;
+	}
+
+	void Hide() override { shown = false; }
+
+	uint32_t PixelAt(int32_t x, int32_t y) const noexcept { return pixels[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)]; }
+	const WindowRect& Screen() const noexcept { return screen; }
+	bool IsShown() const noexcept { return shown; }
+	uint64_t Allocations() const noexcept { return allocations; }
+	uint64_t Presents() const noexcept { return presents; }
+	uint64_t ContentPresents() const noexcept { return contentPresents; }
+
+private:
+	int32_t width = 0;
+	int32_t height = 0;
+	std::vector<uint32_t> pixels{};
+	WindowRect screen{};
+	bool shown = false;
+	uint64_t allocations = 0;
+	uint64_t presents = 0;
+	uint64_t contentPresents = 0;
+};
+
+struct EdgeStripStats
+{
+	// 변 표면을 만들거나 (첫 할당) 크기를 바꾼 횟수
+	uint64_t allocations = 0;
+	// 픽셀을 다시 채운 변
+	uint64_t redraws = 0;
+	// 옮기기만 한 변 (내용은 그대로)
+	uint64_t moves = 0;
+};
+
+/// <summary>
+/// 테두리 하나를 창 크기 표면 하나 대신 네 변의 얇은 표면으로 그립니다. 메모리는 창 넓이가 아니라 둘레에 비례하고
+/// (4K 최대화 창에서 약 33 MB -> 약 100 KB), 크기가 바뀌면 길이가 바뀐 변만 다시 할당합니다. 옮기기만 하면 그리지 않습니다.
+/// 변은 한 색으로 채운 띠이므로 둥근 모서리는 그리지 않습니다. 표면을 만든 스레드에서만 사용해야 합니다
+/// </summary>
+class EdgeStripBorder
+{
+public:
+	/// <summary> 변 하나의 표면을 처음 필요할 때 만듭니다. nullptr 이면 그 변은 그리지 않습니다 </summary>
+	using SurfaceFactory = std::function<std::unique_ptr<EdgeSurface>(BorderEdge edge, int32_t width, int32_t height)>;
+
+	explicit EdgeStripBorder(SurfaceFactory surfaceFactory);
+
+	EdgeStripBorder(const EdgeStripBorder&) = delete;
+	EdgeStripBorder& operator=(const EdgeStripBorder&) = delete;
+
+	/// <summary> 네 변을 visual 의 띠 (BorderStrips) 자리로 옮기고, 크기나 색이 바뀐 변만 다시 채웁니다 </summary>
+	bool Present(const BorderVisual& visual);
+	void Hide();
+
+	/// <summary> 네 변 표면의 픽셀 메모리 </summary>
+	uint64_t SurfaceBytes() const noexcept;
+	const EdgeStripStats& Stats() const noexcept { return stats; }
+	/// <summary> 테스트용: 변의 표면 (아직 만들지 않았으면 nullptr) </summary>
+	const EdgeSurface* Surface(BorderEdge edge) const noexcept { return surfaces[static_cast<size_t>(edge)].get(); }
+
+private:
+	SurfaceFactory surfaceFactory;
+	std::array<std::unique_ptr<EdgeSurface>, 4> surfaces{};
+	// 변마다 지금 채워진 픽셀 (0 이면 채운 적 없음)
+	std::array<uint32_t, 4> filled{};
+	EdgeStripStats stats{};
+};
@@ -0,0 +1,263 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include "HandleRegistry.h"
+#include "WinEvents.h"
+
+// 병합된 기록이 담고 있는 이벤트 종류
+namespace CoalescedKind
+{
+	// LOCATIONCHANGE, MOVESIZEEND
+	constexpr uint16_t Geometry = 1 << 0;
+	// SHOW, HIDE
+	constexpr uint16_t Visibility = 1 << 1;
+	// CLOAKED, UNCLOAKED
+	constexpr uint16_t Cloak = 1 << 2;
+	// MINIMIZESTART, MINIMIZEEND
+	constexpr uint16_t Minimize = 1 << 3;
+	constexpr uint16_t Destroy = 1 << 4;
+	constexpr uint16_t Foreground = 1 << 5;
+	constexpr uint16_t Focus = 1 << 6;
+}
+
+/// <summary>
+/// 한 프레임 동안 같은 창에 대해 쌓인 이벤트를 하나로 합친 "최신 상태" 기록.
+/// 위치 변경은 몇 번이 오든 한 번으로, 표시 상태는 분류별로 마지막 이벤트만 남습니다.
+/// </summary>
+template <typename Handle>
+struct CoalescedEvent
+{
+	Handle hwnd{};
+	uint16_t kinds = 0;
+	uint32_t visibilityEvent = 0;
+	uint32_t cloakEvent = 0;
+	uint32_t minimizeEvent = 0;
+	// 병합된 이벤트 중 가장 최근의 dwmsEventTime
+	uint32_t latestTime = 0;
+	uint32_t mergedCount = 0;
+	uint64_t firstArrivalUs = 0;
+
+	bool Has(uint16_t kind) const noexcept { return (kinds & kind) != 0; }
+
+	/// <summary> 남아 있는 표시 상태 이벤트 (SHOW/HIDE, CLOAKED/UNCLOAKED, MINIMIZE) 를 전달합니다 </summary>
+	template <typename Fn>
+	void ForEachLivenessEvent(Fn&& fn) const
+	{
+		if (Has(CoalescedKind::Visibility))
+			fn(visibilityEvent);
+		if (Has(CoalescedKind::Cloak))
+			fn(cloakEvent);
+		if (Has(CoalescedKind::Minimize))
+			fn(minimizeEvent);
+	}
+};
+
+struct CoalescerStats
+{
+	uint64_t received = 0;
+	// 이미 대기 중인 기록에 합쳐진 이벤트
+	uint64_t collapsed = 0;
+	// 그 중 위치 변경: 각각 UpdateBorderPosition 한 번 (DWM 조회 + SetWindowPos) 을 절약
+	uint64_t collapsedGeometry = 0;
+	// dwmsEventTime 이 이미 반영된 이벤트보다 오래되어 버린 이벤트
+	uint64_t stale = 0;
+	// 병합 대상이 아닌 이벤트
+	uint64_t ignored = 0;
+	uint64_t flushedRecords = 0;
+	uint64_t frames = 0;
+
+	// 프레임 (flush) 간 간격, 마이크로초
+	uint64_t lastFrameIntervalUs = 0;
+	uint64_t maxFrameIntervalUs = 0;
+	uint64_t totalFrameIntervalUs = 0;
+
+	// 기록의 첫 이벤트 도착부터 flush 까지의 지연, 마이크로초
+	uint64_t lastLatencyUs = 0;
+	uint64_t maxLatencyUs = 0;
+	uint64_t totalLatencyUs = 0;
+
+	double AverageFrameIntervalUs() const noexcept
+	{
+		return frames > 1 ? static_cast<double>(totalFrameIntervalUs) / static_cast<double>(frames - 1) : 0.0;
+	}
+
+	double AverageLatencyUs() const noexcept
+	{
+		return flushedRecords ? static_cast<double>(totalLatencyUs) / static_cast<double>(flushedRecords) : 0.0;
+	}
+};
+
+/// <summary> dwmsEventTime (GetTickCount 기반, 약 49일마다 되돌아감) 비교 </summary>
+inline bool IsEventTimeOlder(uint32_t time, uint32_t reference) noexcept
+{
+	return static_cast<int32_t>(time - reference) < 0;
+}
+
+/// <summary>
+/// WinHookProc 과 테두리 갱신 사이의 병합 단계.
+/// Push 는 창별 기록 하나에 이벤트를 합치고, Flush 는 프레임마다 한 번 기록을 도착 순서대로 전달합니다.
+/// 같은 스레드에서 사용해야 하며, Flush 콜백 안에서 Push 해도 다음 프레임으로 넘어갑니다.
+/// </summary>
+template <typename Handle, typename Hasher = HandleBits<Handle>>
+class EventCoalescer
+{
+public:
+	using Event = BasicWinEventHook<Handle>;
+	using Record = CoalescedEvent<Handle>;
+
+	/// <summary> 이벤트를 대기열에 합칩니다. 대기열이 비어 있다가 채워졌으면 true (프레임 타이머를 걸어야 함) </summary>
+	bool Push(const Event& event, uint64_t arrivalUs)
+	{
+		stats.received++;
+
+		const uint16_t kind = KindOf(event.event);
+		if (kind == 0)
+		{
+			stats.ignored++;
+			return false;
+		}
+
+		const bool wasEmpty = pending.Empty();
+		auto [record, inserted] = pending.Emplace(event.hwnd);
+		if (inserted)
+		{
+			record->hwnd = event.hwnd;
+			record->firstArrivalUs = arrivalUs;
+			if (const uint32_t* watermark = watermarks.Find(event.hwnd))
+				record->latestTime = *watermark;
+			else
+				record->latestTime = event.dwmsEventTime;
+		}
+
+		if (IsEventTimeOlder(event.dwmsEventTime, record->latestTime) && kind != CoalescedKind::Destroy)
+		{
+			stats.stale++;
+			if (inserted)
+				pending.Erase(event.hwnd);
+			return false;
+		}
+
+		if (!inserted)
+		{
+			stats.collapsed++;
+			if (kind == CoalescedKind::Geometry && record->Has(CoalescedKind::Geometry))
+				stats.collapsedGeometry++;
+		}
+
+		record->kinds |= kind;
+		record->latestTime = event.dwmsEventTime;
+		record->mergedCount++;
+		switch (kind)
+		{
+		case CoalescedKind::Visibility:
+			record->visibilityEvent = event.event;
+			break;
+		case CoalescedKind::Cloak:
+			record->cloakEvent = event.event;
+			break;
+		case CoalescedKind::Minimize:
+			record->minimizeEvent = event.event;
+			break;
+		case CoalescedKind::Destroy:
+			// 파괴 이전의 변경은 의미가 없음
+			record->kinds = CoalescedKind::Destroy;
+			break;
+		default:
+			break;
+		}
+
+		return wasEmpty;
+	}
+
+	bool Empty() const noexcept { return pending.Empty(); }
+	size_t PendingCount() const noexcept { return pending.Size(); }
+
+	/// <summary> 대기 중인 기록을 도착 순서대로 fn 에 전달하고 비웁니다. 전달한 기록 수를 반환 </summary>
+	template <typename Fn>
+	size_t Flush(uint64_t nowUs, Fn&& fn)
+	{
+		if (flushing)
+			return 0;
+
+		if (stats.frames > 0)
+		{
+			stats.lastFrameIntervalUs = nowUs - lastFlushUs;
+			stats.totalFrameIntervalUs += stats.lastFrameIntervalUs;
+			if (stats.lastFrameIntervalUs > stats.maxFrameIntervalUs)
+				stats.maxFrameIntervalUs = stats.lastFrameIntervalUs;
+		}
+		stats.frames++;
+		lastFlushUs = nowUs;
+
+		flushing = true;
+		std::swap(pending, draining);
+		const size_t count = draining.Size();
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Record& record = draining.ValueAt(i);
+			stats.lastLatencyUs = nowUs - record.firstArrivalUs;
+			stats.totalLatencyUs += stats.lastLatencyUs;
+			if (stats.lastLatencyUs > stats.maxLatencyUs)
+				stats.maxLatencyUs = stats.lastLatencyUs;
+
+			if (record.Has(CoalescedKind::Destroy))
+				watermarks.Erase(record.hwnd);
+			else
+				watermarks[record.hwnd] = record.latestTime;
+
+			fn(record);
+		}
+		stats.flushedRecords += count;
+		draining.Clear();
+		flushing = false;
+		return count;
+	}
+
+	/// <summary> 더 이상 추적하지 않는 창의 시간 기록을 지웁니다 </summary>
+	void Forget(const Handle& hwnd)
+	{
+		watermarks.Erase(hwnd);
+	}
+
+	const CoalescerStats& Stats() const noexcept { return stats; }
+	/// <summary> 시간 기록이 남아 있는 창 수 </summary>
+	size_t WatermarkCount() const noexcept { return watermarks.Size(); }
+
+	static uint16_t KindOf(uint32_t event) noexcept
+	{
+		switch (event)
+		{
+		case WinEventId::ObjectLocationChange:
+		case WinEventId::SystemMoveSizeEnd:
+			return CoalescedKind::Geometry;
+		case WinEventId::ObjectShow:
+		case WinEventId::ObjectHide:
+			return CoalescedKind::Visibility;
+		case WinEventId::ObjectCloaked:
+		case WinEventId::ObjectUncloaked:
+			return CoalescedKind::Cloak;
+		case WinEventId::SystemMinimizeStart:
+		case WinEventId::SystemMinimizeEnd:
+			return CoalescedKind::Minimize;
+		case WinEventId::ObjectDestroy:
+			return CoalescedKind::Destroy;
+		case WinEventId::SystemForeground:
+			return CoalescedKind::Foreground;
+		case WinEventId::ObjectFocus:
+			return CoalescedKind::Focus;
+		default:
+			return 0;
+		}
+	}
+
+private:
+	HandleRegistry<Handle, Record, Hasher> pending{};
+	HandleRegistry<Handle, Record, Hasher> draining{};
+	// 창별로 마지막으로 반영된 dwmsEventTime
+	HandleRegistry<Handle, uint32_t, Hasher> watermarks{};
+	CoalescerStats stats{};
+	uint64_t lastFlushUs = 0;
+	bool flushing = false;
+};
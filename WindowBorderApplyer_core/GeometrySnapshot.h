@@ -0,0 +1,267 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "HandleRegistry.h"
+#include "WindowSystemTypes.h"
+
+struct GeometrySnapshotStats
+{
+	uint64_t ticks = 0;
+	// 창 시스템에 실제로 물어본 조회 (Windows 에서는 DWMWA_EXTENDED_FRAME_BOUNDS + DPI)
+	uint64_t queries = 0;
+	// 같은 틱에 이미 조회한 창이라 다시 묻지 않은 요청
+	uint64_t reused = 0;
+	// 이전 스냅샷과 달라 (또는 강제로) 표시 단계로 넘긴 창
+	uint64_t changed = 0;
+	// 조회했지만 그대로여서 넘기지 않은 창
+	uint64_t unchanged = 0;
+};
+
+/// <summary>
+/// 창별 프레임 사각형 스냅샷. 값은 필드별 배열 (left / top / right / bottom / dpi / flags) 에 두고,
+/// 틱마다 창 하나를 최대 한 번만 조회합니다. Diff 는 배열 전체를 분기 없이 이전 값과 비교하므로 (자동 벡터화)
+/// 조회한 창 중 실제로 바뀐 창만 골라냅니다. 한 스레드에서만 사용해야 합니다.
+/// </summary>
+template <typename Handle, typename Hasher = HandleBits<Handle>>
+class GeometrySnapshot
+{
+public:
+	static constexpr uint8_t ValidFlag = 1 << 0;
+
+	size_t Size() const noexcept { return handles.size(); }
+	const GeometrySnapshotStats& Stats() const noexcept { return stats; }
+
+	/// <summary> 새 틱을 시작합니다. 이전 틱에 조회한 값은 다시 조회해야 합니다 </summary>
+	void BeginTick() noexcept
+	{
+		tick++;
+		stats.ticks++;
+		sampled.clear();
+	}
+
+	/// <summary>
+	/// 이번 틱에 조회하지 않았으면 query(handle, rect, dpi) 로 조회하고 (실패하면 false), 항목 번호를 반환합니다.
+	/// 번호는 Forget / Clear 전까지만 유효합니다
+	/// </summary>
+	template <typename Query>
+	uint32_t Sample(const Handle& handle, Query&& query)
+	{
+		const uint32_t index = IndexOf(handle);
+		if (sampledTick[index] == tick)
+		{
+			stats.reused++;
+			return index;
+		}
+
+		WindowRect rect{};
+		uint32_t windowDpi = 0;
+		const bool valid = query(handle, rect, windowDpi);
+		stats.queries++;
+		// 실패한 조회끼리는 같은 값으로 비교되도록 지움
+		if (!valid)
+		{
+			rect = WindowRect{};
+			windowDpi = 0;
+		}
+
+		left[index] = rect.left;
+		top[index] = rect.top;
+		right[index] = rect.right;
+		bottom[index] = rect.bottom;
+		dpi[index] = windowDpi;
+		flags[index] = valid ? ValidFlag : 0;
+		sampledTick[index] = tick;
+		sampled.push_back(index);
+		return index;
+	}
+
+	/// <summary> 값이 그대로여도 이번 Diff 에서 바뀐 것으로 넘깁니다 (z 순서만 다시 맞출 때) </summary>
+	void Force(uint32_t index) noexcept { forced[index] = 1; }
+	/// <summary> 이미 반영한 값 (예: 새로 만든 테두리) 을 이전 스냅샷으로 삼아 Diff 에서 넘기지 않습니다 </summary>
+	void Accept(uint32_t index) noexcept
+	{
+		Commit(index);
+		forced[index] = 0;
+	}
+
+	bool IsValid(uint32_t index) const noexcept { return (flags[index] & ValidFlag) != 0; }
+	WindowRect Rect(uint32_t index) const noexcept { return WindowRect{ left[index], top[index], right[index], bottom[index] }; }
+	uint32_t Dpi(uint32_t index) const noexcept { return dpi[index]; }
+
+	/// <summary>
+	/// 이번 틱에 조회한 창 중 이전 스냅샷과 다르거나 Force 한 창마다 fn(handle, index) 를 부르고, 그 값을 이전 스냅샷으로 삼습니다.
+	/// 넘긴 창 수를 반환합니다. 이후 BeginTick 전까지 WasChanged 로 결과를 확인할 수 있습니다
+	/// </summary>
+	template <typename Fn>
+	size_t Diff(Fn&& fn)
+	{
+		if (sampled.empty())
+			return 0;
+
+		// 조회하지 않은 항목은 현재 값과 이전 값이 같으므로 배열 전체를 그대로 비교 (필드마다 한 번씩, 분기 없이)
+		const size_t count = handles.size();
+		changed = forced;
+		MarkDifferent(left.data(), previousLeft.data(), changed.data(), count);
+		MarkDifferent(top.data(), previousTop.data(), changed.data(), count);
+		MarkDifferent(right.data(), previousRight.data(), changed.data(), count);
+		MarkDifferent(bottom.data(), previousBottom.data(), changed.data(), count);
+		MarkDifferent(dpi.data(), previousDpi.data(), changed.data(), count);
+		MarkDifferent(flags.data(), previousFlags.data(), changed.data(), count);
+
+		size_t passed = 0;
+		for (uint32_t index : sampled)
+		{
+			if (!changed[index])
+			{
+				stats.unchanged++;
+				continue;
+			}
+
+			Commit(index);
+			forced[index] = 0;
+			stats.changed++;
+			passed++;
+			fn(handles[index], index);
+		}
+		return passed;
+	}
+
+	/// <summary> 마지막 Diff 에서 넘긴 창인지 (이번 틱에 조회하지 않았으면 false) </summary>
+	bool WasChanged(const Handle& handle) const noexcept
+	{
+		const uint32_t* index = indices.Find(handle);
+		return index != nullptr && sampledTick[*index] == tick && changed[*index] != 0;
+	}
+
+	void Forget(const Handle& handle)
+	{
+		const uint32_t* found = indices.Find(handle);
+		if (found == nullptr)
+			return;
+
+		// 마지막 항목을 지운 자리로 옮김. 이번 틱의 조회 목록은 번호가 바뀌므로 다시 만듦
+		const uint32_t index = *found;
+		const uint32_t last = static_cast<uint32_t>(handles.size() - 1);
+		indices.Erase(handle);
+		if (index != last)
+		{
+			MoveEntry(last, index);
+			indices[handles[index]] = index;
+		}
+		PopEntry();
+
+		size_t kept = 0;
+		for (uint32_t entry : sampled)
+		{
+			if (entry == index)
+				continue;
+			sampled[kept++] = entry == last ? index : entry;
+		}
+		sampled.resize(kept);
+	}
+
+	void Clear() noexcept
+	{
+		indices.Clear();
+		handles.clear();
+		for (auto* field : { &left, &top, &right, &bottom, &previousLeft, &previousTop, &previousRight, &previousBottom })
+			field->clear();
+		for (auto* field : { &dpi, &previousDpi })
+			field->clear();
+		for (auto* field : { &flags, &previousFlags, &forced, &changed })
+			field->clear();
+		sampledTick.clear();
+		sampled.clear();
+	}
+
+private:
+	HandleRegistry<Handle, uint32_t, Hasher> indices{};
+	std::vector<Handle> handles{};
+
+	// 이번 틱에 조회한 값 (조회하지 않은 항목은 이전 값과 같음)
+	std::vector<int32_t> left{};
+	std::vector<int32_t> top{};
+	std::vector<int32_t> right{};
+	std::vector<int32_t> bottom{};
+	std::vector<uint32_t> dpi{};
+	std::vector<uint8_t> flags{};
+
+	// 마지막으로 표시 단계에 넘긴 값
+	std::vector<int32_t> previousLeft{};
+	std::vector<int32_t> previousTop{};
+	std::vector<int32_t> previousRight{};
+	std::vector<int32_t> previousBottom{};
+	std::vector<uint32_t> previousDpi{};
+	std::vector<uint8_t> previousFlags{};
+
+	std::vector<uint8_t> forced{};
+	std::vector<uint8_t> changed{};
+	std::vector<uint64_t> sampledTick{};
+	std::vector<uint32_t> sampled{};
+	// 0 은 "조회한 적 없음"
+	uint64_t tick = 1;
+	GeometrySnapshotStats stats{};
+
+	uint32_t IndexOf(const Handle& handle)
+	{
+		auto [index, inserted] = indices.Emplace(handle, static_cast<uint32_t>(handles.size()));
+		if (inserted)
+		{
+			// 이전 값은 유효하지 않음 (flags 0) 으로 두어 처음 조회에 성공하면 바뀐 것으로 나오게 함
+			handles.push_back(handle);
+			for (auto* field : { &left, &top, &right, &bottom, &previousLeft, &previousTop, &previousRight, &previousBottom })
+				field->push_back(0);
+			for (auto* field : { &dpi, &previousDpi })
+				field->push_back(0);
+			for (auto* field : { &flags, &previousFlags, &forced, &changed })
+				field->push_back(0);
+			sampledTick.push_back(0);
+		}
+		return *index;
+	}
+
+	/// <summary> 다른 항목의 out 을 1 로. 배열이 겹치지 않으므로 (__restrict) 컴파일러가 SIMD 비교로 바꿈 </summary>
+	template <typename T>
+	static void MarkDifferent(const T* __restrict current, const T* __restrict previous, uint8_t* __restrict out, size_t count) noexcept
+	{
+		for (size_t i = 0; i < count; ++i)
+			out[i] |= static_cast<uint8_t>(current[i] != previous[i]);
+	}
+
+	void Commit(uint32_t index) noexcept
+	{
+		previousLeft[index] = left[index];
+		previousTop[index] = top[index];
+		previousRight[index] = right[index];
+		previousBottom[index] = bottom[index];
+		previousDpi[index] = dpi[index];
+		previousFlags[index] = flags[index];
+	}
+
+	void MoveEntry(uint32_t from, uint32_t to) noexcept
+	{
+		handles[to] = handles[from];
+		for (auto* field : { &left, &top, &right, &bottom, &previousLeft, &previousTop, &previousRight, &previousBottom })
+			(*field)[to] = (*field)[from];
+		for (auto* field : { &dpi, &previousDpi })
+			(*field)[to] = (*field)[from];
+		for (auto* field : { &flags, &previousFlags, &forced, &changed })
+			(*field)[to] = (*field)[from];
+		sampledTick[to] = sampledTick[from];
+	}
+
+	void PopEntry() noexcept
+	{
+		handles.pop_back();
+		for (auto* field : { &left, &top, &right, &bottom, &previousLeft, &previousTop, &previousRight, &previousBottom })
+			field->pop_back();
+		for (auto* field : { &dpi, &previousDpi })
+			field->pop_back();
+		for (auto* field : { &flags, &previousFlags, &forced, &changed })
+			field->pop_back();
+		sampledTick.pop_back();
+	}
+};
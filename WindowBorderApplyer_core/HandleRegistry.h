@@ -0,0 +1,312 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// <summary>
+/// HandleRegistry 항목을 가리키는 키. 항목이 제거되면 세대(generation)가 증가하므로,
+/// 재사용된 핸들 값으로 새 항목이 만들어져도 이전 키로는 접근할 수 없습니다.
+/// </summary>
+struct RegistryKey
+{
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	bool IsValid() const noexcept { return index != UINT32_MAX; }
+	bool operator==(const RegistryKey& other) const noexcept { return index == other.index && generation == other.generation; }
+	bool operator!=(const RegistryKey& other) const noexcept { return !(*this == other); }
+};
+
+/// <summary> 핸들을 64비트 정수로 바꾸는 기본 해셔 (포인터, 정수, std::hash 지원 타입) </summary>
+template <typename Handle>
+struct HandleBits
+{
+	uint64_t operator()(const Handle& handle) const noexcept
+	{
+		if constexpr (std::is_pointer_v<Handle>)
+			return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+		else if constexpr (std::is_integral_v<Handle> || std::is_enum_v<Handle>)
+			return static_cast<uint64_t>(handle);
+		else
+			return static_cast<uint64_t>(std::hash<Handle>{}(handle));
+	}
+};
+
+/// <summary>
+/// 핸들(HWND 등) -> 값 매핑을 위한 밀집(dense) 레지스트리.
+/// 오픈 어드레싱(선형 탐사, 역방향 시프트 삭제) 인덱스 테이블이 핸들을 슬롯으로 연결하고,
+/// 값은 연속된 배열에 저장되어 순회가 캐시 친화적입니다. 조회/삽입/삭제는 모두 O(1) 입니다.
+/// 삭제 시 마지막 항목과 자리를 바꾸므로, 순회 중에는 삽입/삭제를 하지 마세요.
+/// </summary>
+template <typename Handle, typename Value, typename Hasher = HandleBits<Handle>>
+class HandleRegistry
+{
+public:
+	HandleRegistry() = default;
+
+	size_t Size() const noexcept { return denseHandles.size(); }
+	bool Empty() const noexcept { return denseHandles.empty(); }
+
+	void Reserve(size_t count)
+	{
+		denseHandles.reserve(count);
+		denseValues.reserve(count);
+		denseSlots.reserve(count);
+		slots.reserve(count);
+		if (count * 2 > table.size())
+			Rehash(count * 2);
+	}
+
+	void Clear() noexcept
+	{
+		denseHandles.clear();
+		denseValues.clear();
+		denseSlots.clear();
+		// 슬롯 세대는 유지해야 이전 키가 무효화됩니다
+		freeSlot = NoSlot;
+		for (uint32_t i = static_cast<uint32_t>(slots.size()); i-- > 0;)
+		{
+			slots[i].generation++;
+			slots[i].dense = freeSlot;
+			freeSlot = i;
+		}
+		for (auto& entry : table)
+			entry.slot = NoSlot;
+	}
+
+	bool Contains(const Handle& handle) const noexcept
+	{
+		return FindTableIndex(handle) != NoSlot;
+	}
+
+	Value* Find(const Handle& handle) noexcept
+	{
+		const uint32_t at = FindTableIndex(handle);
+		return (at == NoSlot) ? nullptr : &denseValues[slots[table[at].slot].dense];
+	}
+
+	const Value* Find(const Handle& handle) const noexcept
+	{
+		return const_cast<HandleRegistry*>(this)->Find(handle);
+	}
+
+	/// <summary> 현재 항목의 키를 반환합니다. 없으면 유효하지 않은 키 </summary>
+	RegistryKey KeyOf(const Handle& handle) const noexcept
+	{
+		const uint32_t at = FindTableIndex(handle);
+		if (at == NoSlot)
+			return {};
+
+		const uint32_t slot = table[at].slot;
+		return RegistryKey{ slot, slots[slot].generation };
+	}
+
+	/// <summary> 키로 값을 조회합니다. 항목이 제거되었거나 재사용되었다면 nullptr </summary>
+	Value* Get(RegistryKey key) noexcept
+	{
+		if (key.index >= slots.size())
+			return nullptr;
+
+		const Slot& slot = slots[key.index];
+		if (slot.generation != key.generation || slot.dense >= denseSlots.size() || denseSlots[slot.dense] != key.index)
+			return nullptr;
+
+		return &denseValues[slot.dense];
+	}
+
+	const Value* Get(RegistryKey key) const noexcept
+	{
+		return const_cast<HandleRegistry*>(this)->Get(key);
+	}
+
+	/// <summary> 항목이 없으면 기본값으로 만들고, 값에 대한 참조를 반환합니다 (std::map::operator[] 와 같음) </summary>
+	Value& operator[](const Handle& handle)
+	{
+		return *Emplace(handle).first;
+	}
+
+	/// <summary> 항목이 없으면 args 로 값을 만듭니다. 새로 삽입되었는지 여부를 함께 반환합니다 </summary>
+	template <typename... Args>
+	std::pair<Value*, bool> Emplace(const Handle& handle, Args&&... args)
+	{
+		if (Value* existing = Find(handle))
+			return { existing, false };
+
+		if ((denseHandles.size() + 1) * 2 > table.size())
+			Rehash(table.empty() ? MinTableSize : table.size() * 2);
+
+		uint32_t slot = freeSlot;
+		if (slot != NoSlot)
+			freeSlot = slots[slot].dense;
+		else
+		{
+			slot = static_cast<uint32_t>(slots.size());
+			slots.push_back(Slot{});
+		}
+
+		const uint32_t dense = static_cast<uint32_t>(denseHandles.size());
+		denseHandles.push_back(handle);
+		denseValues.emplace_back(std::forward<Args>(args)...);
+		denseSlots.push_back(slot);
+		slots[slot].dense = dense;
+
+		InsertTableEntry(handle, slot);
+		return { &denseValues[dense], true };
+	}
+
+	bool Erase(const Handle& handle)
+	{
+		const uint32_t at = FindTableIndex(handle);
+		if (at == NoSlot)
+			return false;
+
+		const uint32_t slot = table[at].slot;
+		EraseTableIndex(at);
+		EraseSlot(slot);
+		return true;
+	}
+
+	bool Erase(RegistryKey key)
+	{
+		if (!Get(key))
+			return false;
+
+		return Erase(denseHandles[slots[key.index].dense]);
+	}
+
+	/// <summary> 밀집 배열 순회용 접근자 (0 ~ Size()-1) </summary>
+	const Handle& HandleAt(size_t i) const noexcept { return denseHandles[i]; }
+	Value& ValueAt(size_t i) noexcept { return denseValues[i]; }
+	const Value& ValueAt(size_t i) const noexcept { return denseValues[i]; }
+	RegistryKey KeyAt(size_t i) const noexcept { return RegistryKey{ denseSlots[i], slots[denseSlots[i]].generation }; }
+
+	const std::vector<Handle>& Handles() const noexcept { return denseHandles; }
+
+	template <typename Fn>
+	void ForEach(Fn&& fn)
+	{
+		for (size_t i = 0; i < denseHandles.size(); ++i)
+			fn(denseHandles[i], denseValues[i]);
+	}
+
+	template <typename Fn>
+	void ForEach(Fn&& fn) const
+	{
+		for (size_t i = 0; i < denseHandles.size(); ++i)
+			fn(denseHandles[i], denseValues[i]);
+	}
+
+private:
+	static constexpr uint32_t NoSlot = UINT32_MAX;
+	static constexpr size_t MinTableSize = 16;
+
+	struct Slot
+	{
+		// 사용 중이면 밀집 배열 위치, 비어 있으면 다음 빈 슬롯
+		uint32_t dense = NoSlot;
+		uint32_t generation = 0;
+	};
+
+	struct TableEntry
+	{
+		Handle handle{};
+		uint32_t slot = NoSlot;
+	};
+
+	std::vector<Handle> denseHandles{};
+	std::vector<Value> denseValues{};
+	std::vector<uint32_t> denseSlots{};
+	std::vector<Slot> slots{};
+	std::vector<TableEntry> table{};
+	uint32_t freeSlot = NoSlot;
+	int tableShift = 64;
+
+	size_t HomeIndex(const Handle& handle) const noexcept
+	{
+		// 피보나치 해싱: HWND 값은 하위 비트가 고르지 않으므로 상위 비트를 사용
+		return static_cast<size_t>((Hasher{}(handle) * 0x9E3779B97F4A7C15ull) >> tableShift);
+	}
+
+	uint32_t FindTableIndex(const Handle& handle) const noexcept
+	{
+		if (table.empty())
+			return NoSlot;
+
+		const size_t mask = table.size() - 1;
+		for (size_t i = HomeIndex(handle);; i = (i + 1) & mask)
+		{
+			const TableEntry& entry = table[i];
+			if (entry.slot == NoSlot)
+				return NoSlot;
+			if (entry.handle == handle)
+				return static_cast<uint32_t>(i);
+		}
+	}
+
+	void InsertTableEntry(const Handle& handle, uint32_t slot) noexcept
+	{
+		const size_t mask = table.size() - 1;
+		size_t i = HomeIndex(handle);
+		while (table[i].slot != NoSlot)
+			i = (i + 1) & mask;
+
+		table[i].handle = handle;
+		table[i].slot = slot;
+	}
+
+	void EraseTableIndex(size_t hole) noexcept
+	{
+		// 역방향 시프트 삭제: 묘비(tombstone) 없이 탐사 체인을 유지
+		const size_t mask = table.size() - 1;
+		for (size_t i = (hole + 1) & mask; table[i].slot != NoSlot; i = (i + 1) & mask)
+		{
+			const size_t home = HomeIndex(table[i].handle);
+			if (((i - home) & mask) >= ((i - hole) & mask))
+			{
+				table[hole] = table[i];
+				hole = i;
+			}
+		}
+		table[hole].slot = NoSlot;
+	}
+
+	void EraseSlot(uint32_t slot)
+	{
+		const uint32_t dense = slots[slot].dense;
+		const uint32_t last = static_cast<uint32_t>(denseHandles.size() - 1);
+		if (dense != last)
+		{
+			denseHandles[dense] = std::move(denseHandles[last]);
+			denseValues[dense] = std::move(denseValues[last]);
+			denseSlots[dense] = denseSlots[last];
+			slots[denseSlots[dense]].dense = dense;
+		}
+		denseHandles.pop_back();
+		denseValues.pop_back();
+		denseSlots.pop_back();
+
+		slots[slot].generation++;
+		slots[slot].dense = freeSlot;
+		freeSlot = slot;
+	}
+
+	void Rehash(size_t minSize)
+	{
+		size_t size = MinTableSize;
+		int shift = 64 - 4;
+		while (size < minSize)
+		{
+			size *= 2;
+			shift--;
+		}
+
+		table.assign(size, TableEntry{});
+		tableShift = shift;
+		for (uint32_t dense = 0; dense < denseHandles.size(); ++dense)
+			InsertTableEntry(denseHandles[dense], denseSlots[dense]);
+	}
+};
@@ -0,0 +1,107 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/// <summary>
+/// 크기가 고정된 잠금 없는 다중 생산자 / 단일 소비자 큐 (칸마다 순서 번호를 두는 링 버퍼).
+/// 생산자는 꼬리 위치를 CAS 로 예약하고 값을 쓴 뒤 칸의 번호를 올려 공개합니다.
+/// 가득 차면 기다리지 않고 false 를 반환하므로 생산자 (훅 콜백) 가 소비자 때문에 멈추지 않습니다.
+/// </summary>
+template <typename T>
+class BoundedMpscQueue
+{
+public:
+	/// <summary> capacity 는 2 의 거듭제곱으로 올림 </summary>
+	explicit BoundedMpscQueue(size_t capacity)
+	{
+		// 클래스 안에 선언한 값 형식도 여기서는 완전한 형식이므로 생성자에서 검사
+		static_assert(std::is_nothrow_copy_assignable_v<T> && std::is_nothrow_default_constructible_v<T>,
+			"값은 예외 없이 복사할 수 있어야 합니다");
+
+		size_t rounded = 2;
+		while (rounded < capacity)
+			rounded <<= 1;
+
+		mask = rounded - 1;
+		cells = std::make_unique<Cell[]>(rounded);
+		for (size_t i = 0; i < rounded; ++i)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	BoundedMpscQueue(const BoundedMpscQueue&) = delete;
+	BoundedMpscQueue& operator=(const BoundedMpscQueue&) = delete;
+
+	/// <summary> 여러 스레드에서 호출 가능. 가득 찼으면 false </summary>
+	bool TryPush(const T& value) noexcept
+	{
+		size_t position = tail.load(std::memory_order_relaxed);
+		Cell* cell;
+		for (;;)
+		{
+			cell = &cells[position & mask];
+			const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+			if (diff == 0)
+			{
+				if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (diff < 0)
+			{
+				// 소비자가 한 바퀴 전의 값을 아직 꺼내지 않음
+				return false;
+			}
+			else
+			{
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->value = value;
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary> 소비자 스레드 하나에서만 호출. 비었거나 다음 값이 아직 공개되지 않았으면 false </summary>
+	bool TryPop(T& value) noexcept
+	{
+		const size_t position = head.load(std::memory_order_relaxed);
+		Cell& cell = cells[position & mask];
+		const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		if (static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0)
+			return false;
+
+		value = cell.value;
+		// 다음 바퀴의 생산자가 쓸 수 있도록 번호를 한 바퀴 올림
+		cell.sequence.store(position + mask + 1, std::memory_order_release);
+		head.store(position + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	size_t Capacity() const noexcept { return mask + 1; }
+
+	/// <summary> 남은 항목 수의 근사값 (다른 스레드가 동시에 넣고 빼므로 통계용) </summary>
+	size_t ApproxSize() const noexcept
+	{
+		const size_t consumed = head.load(std::memory_order_relaxed);
+		const size_t reserved = tail.load(std::memory_order_relaxed);
+		return reserved > consumed ? reserved - consumed : 0;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence{ 0 };
+		T value{};
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask = 0;
+	// 생산자끼리 다투는 꼬리와 소비자의 머리를 다른 캐시 줄에 둠
+	alignas(64) std::atomic<size_t> tail{ 0 };
+	alignas(64) std::atomic<size_t> head{ 0 };
+};
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "DesktopWatcher.h"
+
+/// <summary>
+/// 레지스트리 대신 테스트가 직접 전환을 일으키는 DesktopWatcher. SimulatedWindowSystem 의 데스크톱 번호를
+/// DesktopId 로 바꿔 게시하며, SwitchTo 를 부르는 스레드가 감시 스레드 역할을 합니다.
+/// </summary>
+class SimulatedDesktopSwitcher : public DesktopWatcher
+{
+public:
+	explicit SimulatedDesktopSwitcher(uint32_t initialDesktop = 0) : initialDesktop(initialDesktop) {}
+
+	static DesktopId IdOf(uint32_t desktop) noexcept
+	{
+		return DesktopId{ 0x5349'4D44'4553'4B00ull, uint64_t{ desktop } + 1 };
+	}
+
+	bool Start(SwitchCallback callback) override
+	{
+		onSwitch = std::move(callback);
+		PublishInitial(IdOf(initialDesktop));
+		running.store(true, std::memory_order_release);
+		return true;
+	}
+
+	/// <summary> SwitchTo 를 부르는 스레드가 끝난 뒤에 호출 </summary>
+	void Stop() override
+	{
+		running.store(false, std::memory_order_release);
+		onSwitch = nullptr;
+	}
+
+	/// <summary> 데스크톱 전환 알림을 흉내 냅니다. 같은 데스크톱이면 (이름 변경 같은 키 변경) 무시되어 false </summary>
+	bool SwitchTo(uint32_t desktop)
+	{
+		return SwitchTo(IdOf(desktop));
+	}
+
+	bool SwitchTo(const DesktopId& id)
+	{
+		if (!running.load(std::memory_order_acquire))
+			return false;
+
+		return Publish(id);
+	}
+
+private:
+	uint32_t initialDesktop;
+	std::atomic<bool> running{ false };
+};
@@ -0,0 +1,382 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "BorderLayout.h"
+#include "HandleRegistry.h"
+#include "WinEventTrace.h"
+#include "WinEvents.h"
+#include "WindowLiveness.h"
+#include "WindowSystem.h"
+#include "WindowSystemTypes.h"
+
+/// <summary> 시뮬레이션 창 하나의 상태 </summary>
+struct SimulatedWindow
+{
+	WindowRect frame{};
+	uint32_t desktop = 0;
+	bool visible = true;
+	bool cloaked = false;
+	bool minimized = false;
+	// 클수록 위 (z 순서)
+	uint64_t zOrder = 0;
+};
+
+/// <summary> 시뮬레이션 창 시스템이 받은 조회 / 그리기 횟수. 재생 결과를 비교할 때 사용합니다 </summary>
+struct SimulatedQueryStats
+{
+	// DWMWA_EXTENDED_FRAME_BOUNDS 에 해당
+	uint64_t frameBoundsQueries = 0;
+	// IsWindowVisible / IsIconic / DWMWA_CLOAKED 에 해당
+	uint64_t stateQueries = 0;
+	// GetDpiForMonitor 에 해당
+	uint64_t dpiQueries = 0;
+	// MonitorFromRect 에 해당
+	uint64_t monitorQueries = 0;
+	// IVirtualDesktopManager 에 해당
+	uint64_t desktopQueries = 0;
+	uint64_t enumerations = 0;
+
+	uint64_t overlaysCreated = 0;
+	uint64_t overlaysDestroyed = 0;
+	// 오버레이 위치 변경 (SetWindowPos 에 해당)
+	uint64_t presents = 0;
+	// 모양이 바뀌어 다시 그린 횟수
+	uint64_t redraws = 0;
+	// 보관했다가 다른 창에 다시 붙인 횟수 (생성 대신)
+	uint64_t rebinds = 0;
+};
+
+/// <summary> 시뮬레이션 오버레이. 마지막으로 받은 BorderVisual 을 보관합니다 </summary>
+class SimulatedOverlay : public BorderOverlay
+{
+public:
+	SimulatedOverlay(SimulatedQueryStats& stats, WindowHandle target, const BorderVisual& visual)
+		: stats(stats), target(target), visual(visual)
+	{
+		stats.overlaysCreated++;
+		stats.redraws++;
+	}
+
+	~SimulatedOverlay() override { stats.overlaysDestroyed++; }
+
+	bool Present(const BorderVisual& newVisual) override
+	{
+		stats.presents++;
+		if (!visual.SameShape(newVisual) || !shown)
+			stats.redraws++;
+
+		visual = newVisual;
+		shown = true;
+		return true;
+	}
+
+	void Hide() override { shown = false; }
+
+	bool Park() override
+	{
+		shown = false;
+		target = nullptr;
+		return true;
+	}
+
+	bool Rebind(WindowHandle newTarget, const BorderVisual& newVisual) override
+	{
+		stats.rebinds++;
+		target = newTarget;
+		return Present(newVisual);
+	}
+
+	/// <summary> 창마다 오버레이처럼 테두리 창 크기의 32 bpp 표면을 가진 것으로 봄 </summary>
+	uint64_t SurfaceBytes() const noexcept override { return static_cast<uint64_t>(visual.bounds.Area()) * sizeof(uint32_t); }
+
+	WindowHandle Target() const noexcept { return target; }
+	const BorderVisual& Visual() const noexcept { return visual; }
+	bool IsShown() const noexcept { return shown; }
+
+private:
+	SimulatedQueryStats& stats;
+	WindowHandle target;
+	BorderVisual visual;
+	bool shown = true;
+};
+
+/// <summary>
+/// 메모리 안에서만 존재하는 창 시스템. 기록된 이벤트를 적용해 창 상태를 재현하고,
+/// 추적 로직이 보내는 조회에 답하면서 그 횟수를 셉니다. Windows API 를 사용하지 않으므로 Linux 에서도 동작합니다.
+/// </summary>
+class SimulatedWindowSystem : public WindowSystem
+{
+public:
+	void AddWindow(WindowHandle hwnd, const WindowRect& frame)
+	{
+		SimulatedWindow& window = Emplace(hwnd);
+		window.frame = frame;
+	}
+
+	void RemoveWindow(WindowHandle hwnd)
+	{
+		windows.Erase(hwnd);
+	}
+
+	bool HasWindow(WindowHandle hwnd) const noexcept { return windows.Contains(hwnd); }
+	size_t WindowCount() const noexcept { return windows.Size(); }
+
+	/// <summary> 모니터를 추가합니다. 어느 모니터에도 중심이 들어 있지 않은 창은 주 모니터 (PrimaryMonitor) 에 있습니다 </summary>
+	MonitorHandle AddMonitor(const WindowRect& area, uint32_t dpi)
+	{
+		monitors.push_back(SimulatedMonitor{ area, dpi });
+		return MonitorFromIndex(monitors.size() - 1);
+	}
+
+	MonitorHandle PrimaryMonitor() const noexcept { return MonitorFromIndex(0); }
+
+	/// <summary> 모니터의 배율을 바꿉니다. Windows 처럼 알림 (WM_DISPLAYCHANGE / WM_DPICHANGED) 은 호출하는 쪽이 보냅니다 </summary>
+	void SetMonitorDpi(MonitorHandle monitor, uint32_t dpi)
+	{
+		const size_t index = static_cast<size_t>(HandleToBits(monitor) - 1);
+		if (index < monitors.size())
+			monitors[index].dpi = dpi;
+	}
+
+	const SimulatedWindow* FindWindow(WindowHandle hwnd) const noexcept { return windows.Find(hwnd); }
+	SimulatedWindow* FindWindow(WindowHandle hwnd) noexcept { return windows.Find(hwnd); }
+
+	/// <summary> 창을 맨 위로 올립니다 (포그라운드 전환) </summary>
+	void BringToTop(WindowHandle hwnd)
+	{
+		if (SimulatedWindow* window = windows.Find(hwnd))
+			window->zOrder = ++zCounter;
+	}
+
+	/// <summary>
+	/// 현재 데스크톱을 바꿉니다. Windows 처럼 다른 데스크톱의 창은 클로킹하고,
+	/// 클로킹 상태가 바뀐 창을 onCloakChanged(hwnd, cloaked) 로 알립니다 (CLOAKED / UNCLOAKED 이벤트에 해당)
+	/// </summary>
+	template <typename Fn>
+	void SwitchDesktop(uint32_t desktop, Fn&& onCloakChanged)
+	{
+		currentDesktop = desktop;
+		for (size_t i = 0; i < windows.Size(); ++i)
+		{
+			SimulatedWindow& window = windows.ValueAt(i);
+			const bool cloaked = window.desktop != currentDesktop;
+			if (window.cloaked != cloaked)
+			{
+				window.cloaked = cloaked;
+				onCloakChanged(windows.HandleAt(i), cloaked);
+			}
+		}
+	}
+
+	void SwitchDesktop(uint32_t desktop)
+	{
+		SwitchDesktop(desktop, [](WindowHandle, bool) {});
+	}
+
+	/// <summary> 창을 다른 데스크톱으로 옮깁니다. 클로킹 상태가 바뀌었으면 true </summary>
+	bool MoveWindowToDesktop(WindowHandle hwnd, uint32_t desktop)
+	{
+		SimulatedWindow* window = windows.Find(hwnd);
+		if (window == nullptr)
+			return false;
+
+		window->desktop = desktop;
+		const bool cloaked = desktop != currentDesktop;
+		const bool changed = window->cloaked != cloaked;
+		window->cloaked = cloaked;
+		return changed;
+	}
+
+	uint32_t CurrentDesktop() const noexcept { return currentDesktop; }
+
+	/// <summary> 등록된 창을 등록 순서와 무관하게 전달합니다 </summary>
+	template <typename Fn>
+	void ForEachWindow(Fn&& fn) const
+	{
+		for (size_t i = 0; i < windows.Size(); ++i)
+			fn(windows.HandleAt(i), windows.ValueAt(i));
+	}
+
+	void EnumerateWindows(std::vector<WindowHandle>& result) override
+	{
+		queryStats.enumerations++;
+
+		std::vector<std::pair<uint64_t, WindowHandle>> ordered;
+		ordered.reserve(windows.Size());
+		for (size_t i = 0; i < windows.Size(); ++i)
+		{
+			const SimulatedWindow& window = windows.ValueAt(i);
+			if (window.visible)
+				ordered.emplace_back(window.zOrder, windows.HandleAt(i));
+		}
+		std::sort(ordered.begin(), ordered.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+		result.clear();
+		for (const auto& entry : ordered)
+			result.push_back(entry.second);
+	}
+
+	bool IsBorderCandidate(WindowHandle hwnd) override
+	{
+		queryStats.stateQueries++;
+		const SimulatedWindow* window = windows.Find(hwnd);
+		return window != nullptr && window->visible;
+	}
+
+	bool GetFrameBounds(WindowHandle hwnd, WindowRect& frame) override
+	{
+		queryStats.frameBoundsQueries++;
+		const SimulatedWindow* window = windows.Find(hwnd);
+		if (window == nullptr)
+			return false;
+
+		frame = window->frame;
+		return true;
+	}
+
+	MonitorHandle GetMonitor(WindowHandle, const WindowRect& frame) override
+	{
+		queryStats.monitorQueries++;
+		// 프레임 중심이 들어 있는 모니터, 없으면 주 모니터 (MONITOR_DEFAULTTONEAREST 를 단순화)
+		const int32_t x = frame.left + frame.Width() / 2;
+		const int32_t y = frame.top + frame.Height() / 2;
+		for (size_t i = 1; i < monitors.size(); ++i)
+		{
+			const WindowRect& area = monitors[i].area;
+			if (x >= area.left && x < area.right && y >= area.top && y < area.bottom)
+				return MonitorFromIndex(i);
+		}
+		return MonitorFromIndex(0);
+	}
+
+	uint32_t GetMonitorDpi(MonitorHandle monitor) override
+	{
+		queryStats.dpiQueries++;
+		const size_t index = static_cast<size_t>(HandleToBits(monitor) - 1);
+		return index < monitors.size() ? monitors[index].dpi : DefaultDpi;
+	}
+
+	bool IsOnCurrentDesktop(WindowHandle hwnd) override
+	{
+		queryStats.desktopQueries++;
+		const SimulatedWindow* window = windows.Find(hwnd);
+		return window != nullptr && window->desktop == currentDesktop;
+	}
+
+	WindowLiveness QueryLiveness(WindowHandle hwnd) override
+	{
+		queryStats.stateQueries++;
+		WindowLiveness liveness{ 0 };
+		if (const SimulatedWindow* window = windows.Find(hwnd))
+		{
+			if (window->visible)
+				liveness.flags |= WindowLiveness::Visible;
+			if (window->cloaked)
+				liveness.flags |= WindowLiveness::Cloaked;
+			if (window->minimized)
+				liveness.flags |= WindowLiveness::Minimized;
+		}
+		return liveness;
+	}
+
+	std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle target, const BorderStyle&, const BorderVisual& visual) override
+	{
+		if (!windows.Contains(target))
+			return nullptr;
+
+		return std::make_unique<SimulatedOverlay>(queryStats, target, visual);
+	}
+
+	/// <summary> 기록된 이벤트가 뜻하는 상태 변화를 창에 적용합니다 </summary>
+	void ApplyEvent(const TraceRecord& record)
+	{
+		if (record.idObject != WinEventObjectId::Window || record.idChild != WinEventObjectId::ChildSelf)
+			return;
+
+		const WindowHandle hwnd = HandleFromBits(record.hwnd);
+		if (record.event == WinEventId::ObjectDestroy)
+		{
+			windows.Erase(hwnd);
+			return;
+		}
+
+		// 기록을 시작하기 전부터 있던 창은 처음 이벤트를 받을 때 만듦
+		SimulatedWindow& window = Emplace(hwnd);
+		if (record.hasRect)
+			window.frame = record.rect;
+
+		switch (record.event)
+		{
+		case WinEventId::ObjectCreate:
+		case WinEventId::ObjectShow:
+			window.visible = true;
+			break;
+		case WinEventId::ObjectHide:
+			window.visible = false;
+			break;
+		case WinEventId::ObjectCloaked:
+			window.cloaked = true;
+			break;
+		case WinEventId::ObjectUncloaked:
+			window.cloaked = false;
+			break;
+		case WinEventId::SystemMinimizeStart:
+			window.minimized = true;
+			break;
+		case WinEventId::SystemMinimizeEnd:
+			window.minimized = false;
+			break;
+		case WinEventId::SystemForeground:
+			window.zOrder = ++zCounter;
+			break;
+		default:
+			break;
+		}
+	}
+
+	void Clear()
+	{
+		windows.Clear();
+		monitors.resize(1);
+		queryStats = SimulatedQueryStats{};
+	}
+
+	const SimulatedQueryStats& QueryStats() const noexcept { return queryStats; }
+	void ResetQueryStats() noexcept { queryStats = SimulatedQueryStats{}; }
+
+private:
+	struct SimulatedMonitor
+	{
+		WindowRect area{};
+		uint32_t dpi = DefaultDpi;
+	};
+
+	HandleRegistry<WindowHandle, SimulatedWindow> windows{};
+	// 0 번은 주 모니터
+	std::vector<SimulatedMonitor> monitors{ SimulatedMonitor{} };
+	SimulatedQueryStats queryStats{};
+	uint32_t currentDesktop = 0;
+	uint64_t zCounter = 0;
+
+	static MonitorHandle MonitorFromIndex(size_t index) noexcept
+	{
+		// 0 은 HMONITOR 가 될 수 없으므로 1 부터
+		return HandleFromBits(index + 1);
+	}
+
+	SimulatedWindow& Emplace(WindowHandle hwnd)
+	{
+		auto [window, inserted] = windows.Emplace(hwnd);
+		if (inserted)
+		{
+			window->zOrder = ++zCounter;
+			window->desktop = currentDesktop;
+		}
+		return *window;
+	}
+};
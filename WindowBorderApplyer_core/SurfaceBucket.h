@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <cstdint>
+
+struct SurfaceBucketStats
+{
+	// 표면을 (다시) 할당한 횟수. 첫 할당 포함
+	uint64_t reallocations = 0;
+	// 논리 크기는 바뀌었지만 지금 표면 안에 들어가 다시 할당하지 않은 횟수
+	uint64_t reuses = 0;
+};
+
+/// <summary>
+/// 렌더 타깃 / DIB 같은 표면의 크기를 기하급수 단계 (Minimum 부터 약 1.25 배씩, 16 픽셀 단위) 로 올려 잡습니다.
+/// 그리는 쪽은 논리 크기 (0, 0 부터) 만 그리고 나머지는 투명하게 둡니다. 창 크기를 끌어 바꾸는 동안 매 단계마다
+/// 표면을 새로 만드는 대신 단계 경계를 넘을 때만 다시 할당하므로, 할당 횟수가 크기의 로그에 비례합니다.
+/// 작아질 때는 논리 크기가 표면의 절반보다 작아질 때만 줄여, 경계 근처에서 늘고 줄기를 되풀이하지 않습니다
+/// </summary>
+class SurfaceBucket
+{
+public:
+	static constexpr int32_t Minimum = 64;
+	static constexpr int32_t Alignment = 16;
+
+	/// <summary> extent 이상인 가장 작은 단계 </summary>
+	static constexpr int32_t BucketExtent(int32_t extent) noexcept
+	{
+		int32_t bucket = Minimum;
+		while (bucket < extent)
+			bucket = (bucket + bucket / 4 + Alignment - 1) / Alignment * Alignment;
+		return bucket;
+	}
+
+	/// <summary>
+	/// 논리 크기 width x height 를 담을 표면 크기를 정합니다. 지금 표면을 다시 할당해야 하면 true 이고,
+	/// 이때 AllocatedWidth / AllocatedHeight 가 새 표면 크기입니다. 크기가 0 이하면 아무것도 바꾸지 않습니다
+	/// </summary>
+	bool Fit(int32_t width, int32_t height) noexcept
+	{
+		if (width <= 0 || height <= 0)
+			return false;
+
+		if (allocatedWidth != 0 && FitsExtent(width, allocatedWidth) && FitsExtent(height, allocatedHeight))
+		{
+			if (width != logicalWidth || height != logicalHeight)
+				stats.reuses++;
+			logicalWidth = width;
+			logicalHeight = height;
+			return false;
+		}
+
+		allocatedWidth = BucketExtent(width);
+		allocatedHeight = BucketExtent(height);
+		logicalWidth = width;
+		logicalHeight = height;
+		stats.reallocations++;
+		return true;
+	}
+
+	/// <summary> 표면을 잃었을 때 (장치 손실 등): 다음 Fit 이 다시 할당하게 합니다 </summary>
+	void Reset() noexcept
+	{
+		allocatedWidth = 0;
+		allocatedHeight = 0;
+	}
+
+	int32_t AllocatedWidth() const noexcept { return allocatedWidth; }
+	int32_t AllocatedHeight() const noexcept { return allocatedHeight; }
+	int32_t LogicalWidth() const noexcept { return logicalWidth; }
+	int32_t LogicalHeight() const noexcept { return logicalHeight; }
+	uint64_t AllocatedBytes() const noexcept
+	{
+		return static_cast<uint64_t>(allocatedWidth) * static_cast<uint64_t>(allocatedHeight) * sizeof(uint32_t);
+	}
+	const SurfaceBucketStats& Stats() const noexcept { return stats; }
+
+private:
+	int32_t allocatedWidth = 0;
+	int32_t allocatedHeight = 0;
+	int32_t logicalWidth = 0;
+	int32_t logicalHeight = 0;
+	SurfaceBucketStats stats{};
+
+	static constexpr bool FitsExtent(int32_t extent, int32_t allocated) noexcept
+	{
+		// 들어가고, 절반 이상을 쓰고 있으면 (또는 더 줄일 단계가 없으면) 그대로
+		return extent <= allocated && (extent * 2 >= allocated || allocated == Minimum);
+	}
+};
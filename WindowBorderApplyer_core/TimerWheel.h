@@ -0,0 +1,244 @@
+﻿#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "HandleRegistry.h"
+
+struct TimerWheelStats
+{
+	// Schedule 호출 (이미 걸린 타이머를 다시 건 경우 포함)
+	uint64_t scheduled = 0;
+	uint64_t cancelled = 0;
+	// 만료되어 콜백을 부른 타이머
+	uint64_t expired = 0;
+	// 상위 단계에서 하위 단계로 옮긴 타이머
+	uint64_t cascaded = 0;
+};
+
+/// <summary>
+/// 핸들별 타이머 하나를 두는 계층형 타이머 휠. 단계마다 64 칸이며, 아래 단계 한 바퀴가 위 단계 한 칸입니다
+/// (tickUs = 10 ms 면 0.64 s / 41 s / 44 분 / 47 시간). 걸기 / 취소는 O(1) 이고, 위 단계의 타이머는
+/// 그 칸의 시각이 되면 아래 단계로 내려옵니다. 비어 있는 칸은 점유 비트로 건너뛰므로 오래 쉬었다가 Advance 해도 빠릅니다.
+/// 가장 위 단계의 한 바퀴를 넘는 타이머는 그 바퀴의 끝에서 다시 배치됩니다. 한 스레드에서만 사용해야 합니다.
+/// </summary>
+template <typename Handle, typename Hasher = HandleBits<Handle>>
+class TimerWheel
+{
+public:
+	explicit TimerWheel(uint64_t tickUs = 10000) : tickUs(tickUs) {}
+
+	size_t Size() const noexcept { return timers.Size(); }
+	bool Empty() const noexcept { return timers.Empty(); }
+	bool IsScheduled(const Handle& handle) const noexcept { return timers.Contains(handle); }
+	const TimerWheelStats& Stats() const noexcept { return stats; }
+
+	/// <summary> handle 의 타이머를 deadlineUs 에 만료되도록 겁니다 (이미 걸려 있으면 옮김). 칸 단위로 올림하므로 일찍 만료되지 않습니다 </summary>
+	void Schedule(const Handle& handle, uint64_t deadlineUs, uint64_t nowUs)
+	{
+		// 걸린 타이머가 없으면 지난 시간을 처리할 필요가 없으므로 현재 칸을 바로 옮김
+		if (timers.Empty() && nowUs / tickUs > currentTick)
+			currentTick = nowUs / tickUs;
+
+		auto [timer, inserted] = timers.Emplace(handle);
+		if (!inserted)
+			Unlink(*timer);
+
+		timer->deadlineTick = (deadlineUs + tickUs - 1) / tickUs;
+		Link(handle, *timer);
+		stats.scheduled++;
+	}
+
+	bool Cancel(const Handle& handle) noexcept
+	{
+		Timer* timer = timers.Find(handle);
+		if (timer == nullptr)
+			return false;
+
+		Unlink(*timer);
+		timers.Erase(handle);
+		stats.cancelled++;
+		return true;
+	}
+
+	void Clear() noexcept
+	{
+		timers.Clear();
+		for (auto& level : slots)
+		{
+			for (auto& slot : level)
+				slot.clear();
+		}
+		for (uint64_t& bits : occupied)
+			bits = 0;
+	}
+
+	/// <summary>
+	/// nowUs 까지 만료된 타이머를 빼고 onExpired(handle) 을 부릅니다. 콜백 안에서 다시 걸어도 됩니다
+	/// (이미 지난 시각이면 다음 Advance 에서 만료). 만료된 수를 반환합니다
+	/// </summary>
+	template <typename OnExpired>
+	size_t Advance(uint64_t nowUs, OnExpired&& onExpired)
+	{
+		const uint64_t targetTick = nowUs / tickUs;
+		size_t count = 0;
+		std::vector<Handle> due{};
+		while (currentTick <= targetTick)
+		{
+			if (timers.Empty())
+			{
+				currentTick = targetTick + 1;
+				break;
+			}
+
+			// 이 칸부터 같은 바퀴 안에서 다음으로 찬 칸까지 건너뜀
+			const uint32_t index = static_cast<uint32_t>(currentTick & SlotMask);
+			const uint64_t ahead = occupied[0] >> index;
+			if (ahead == 0 || currentTick + std::countr_zero(ahead) > targetTick)
+			{
+				const uint64_t nextLap = (currentTick | SlotMask) + 1;
+				currentTick = nextLap <= targetTick + 1 ? nextLap : targetTick + 1;
+				Cascade(currentTick);
+				continue;
+			}
+
+			currentTick += std::countr_zero(ahead);
+			const uint32_t slot = static_cast<uint32_t>(currentTick & SlotMask);
+			due.swap(slots[0][slot]);
+			occupied[0] &= ~(uint64_t{ 1 } << slot);
+			for (const Handle& handle : due)
+				timers.Erase(handle);
+
+			// 콜백이 다시 건 타이머가 방금 비운 칸에 들어가지 않도록 먼저 다음 칸으로 넘김
+			currentTick++;
+			Cascade(currentTick);
+			for (const Handle& handle : due)
+			{
+				stats.expired++;
+				count++;
+				onExpired(handle);
+			}
+			due.clear();
+		}
+		return count;
+	}
+
+	/// <summary>
+	/// 가장 먼저 만료될 타이머의 시각 (us). 비어 있으면 0 (깨어날 필요 없음).
+	/// 찬 칸 하나만 보므로 위 단계에 있어도 그 칸의 타이머 수만큼만 걸립니다
+	/// </summary>
+	uint64_t NextDeadlineUs() const noexcept
+	{
+		if (timers.Empty())
+			return 0;
+
+		for (uint32_t level = 0; level < Levels; ++level)
+		{
+			const uint32_t shift = level * SlotBits;
+			const uint64_t lapTick = currentTick >> shift;
+			// 아래 단계는 현재 칸부터, 위 단계는 현재 칸이 이미 내려왔으므로 다음 칸부터 (currentTick 을 옮길 때마다 Cascade)
+			const uint32_t from = static_cast<uint32_t>(lapTick & SlotMask) + (level == 0 ? 0 : 1);
+			if (from > SlotMask)
+				continue;
+
+			const uint64_t ahead = occupied[level] >> from;
+			if (ahead == 0)
+				continue;
+
+			// 아래 단계가 비었으면 위 단계의 가장 이른 칸에 가장 이른 타이머가 있음
+			const uint32_t slot = from + static_cast<uint32_t>(std::countr_zero(ahead));
+			uint64_t earliest = UINT64_MAX;
+			for (const Handle& handle : slots[level][slot])
+			{
+				const uint64_t deadlineTick = timers.Find(handle)->deadlineTick;
+				earliest = deadlineTick < earliest ? deadlineTick : earliest;
+			}
+			return (earliest > currentTick ? earliest : currentTick) * tickUs;
+		}
+		return currentTick * tickUs;
+	}
+
+private:
+	static constexpr uint32_t SlotBits = 6;
+	static constexpr uint32_t SlotCount = 1u << SlotBits;
+	static constexpr uint64_t SlotMask = SlotCount - 1;
+	static constexpr uint32_t Levels = 4;
+
+	struct Timer
+	{
+		uint64_t deadlineTick = 0;
+		uint8_t level = 0;
+		uint8_t slot = 0;
+		// 칸 벡터 안의 위치 (취소할 때 마지막 항목과 바꿈)
+		uint32_t position = 0;
+	};
+
+	uint64_t tickUs;
+	// 다음에 처리할 칸 (tickUs 단위 절대 시각). 이 칸에서 내려올 위 단계 타이머는 이미 내려와 있음
+	uint64_t currentTick = 0;
+	HandleRegistry<Handle, Timer, Hasher> timers{};
+	std::vector<Handle> slots[Levels][SlotCount]{};
+	uint64_t occupied[Levels]{};
+	TimerWheelStats stats{};
+
+	void Link(const Handle& handle, Timer& timer)
+	{
+		// 현재 칸과 처음으로 달라지는 자리의 단계에 둠. 지난 시각은 바로 다음에 처리할 칸
+		uint64_t deadlineTick = timer.deadlineTick < currentTick ? currentTick : timer.deadlineTick;
+
+		// 가장 위 단계의 현재 바퀴를 넘는 시각은 그 바퀴의 끝 칸에 두고, 내려올 때 실제 마감으로 다시 배치
+		const uint64_t span = uint64_t{ 1 } << (Levels * SlotBits);
+		if ((deadlineTick ^ currentTick) >= span)
+			deadlineTick = currentTick | (span - 1);
+
+		uint32_t level = 0;
+		while (level + 1 < Levels && (deadlineTick ^ currentTick) >> ((level + 1) * SlotBits) != 0)
+			level++;
+
+		const uint32_t slot = static_cast<uint32_t>((deadlineTick >> (level * SlotBits)) & SlotMask);
+		timer.level = static_cast<uint8_t>(level);
+		timer.slot = static_cast<uint8_t>(slot);
+		timer.position = static_cast<uint32_t>(slots[level][slot].size());
+		slots[level][slot].push_back(handle);
+		occupied[level] |= uint64_t{ 1 } << slot;
+	}
+
+	void Unlink(const Timer& timer) noexcept
+	{
+		std::vector<Handle>& slot = slots[timer.level][timer.slot];
+		if (timer.position + 1 != slot.size())
+		{
+			slot[timer.position] = slot.back();
+			timers.Find(slot[timer.position])->position = timer.position;
+		}
+		slot.pop_back();
+		if (slot.empty())
+			occupied[timer.level] &= ~(uint64_t{ 1 } << timer.slot);
+	}
+
+	/// <summary> tick 이 위 단계 칸의 시작이면 그 칸의 타이머를 아래 단계로 내림 (높은 단계부터) </summary>
+	void Cascade(uint64_t tick)
+	{
+		for (uint32_t level = Levels - 1; level > 0; --level)
+		{
+			const uint32_t shift = level * SlotBits;
+			if ((tick & ((uint64_t{ 1 } << shift) - 1)) != 0)
+				continue;
+
+			const uint32_t slot = static_cast<uint32_t>((tick >> shift) & SlotMask);
+			if ((occupied[level] & (uint64_t{ 1 } << slot)) == 0)
+				continue;
+
+			std::vector<Handle> moved{};
+			moved.swap(slots[level][slot]);
+			occupied[level] &= ~(uint64_t{ 1 } << slot);
+			for (const Handle& handle : moved)
+			{
+				Link(handle, *timers.Find(handle));
+				stats.cascaded++;
+			}
+		}
+	}
+};
@@ -0,0 +1,126 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "SimulatedWindowSystem.h"
+#include "WinEventTrace.h"
+#include "WinEvents.h"
+#include "WindowSystemTypes.h"
+
+enum class ReplayPacing
+{
+	// 기록된 시간은 프레임 경계 계산에만 쓰고 기다리지 않음
+	AsFastAsPossible,
+	// 기록된 도착 간격대로 (speed 배속으로) 기다리면서 재생
+	Realtime,
+};
+
+struct ReplayOptions
+{
+	ReplayPacing pacing = ReplayPacing::AsFastAsPossible;
+	double speed = 1.0;
+	// 추적 로직의 프레임 타이머 간격 (Windowmodule 의 Coalesce_Frame_Interval 과 같게)
+	uint64_t frameIntervalUs = 16000;
+};
+
+struct ReplayResult
+{
+	uint64_t events = 0;
+	uint64_t frames = 0;
+	// 기록 안의 첫 이벤트부터 마지막 이벤트까지
+	uint64_t traceDurationUs = 0;
+	// 재생에 실제로 걸린 시간
+	uint64_t wallDurationUs = 0;
+	// 기록 끝까지 읽지 못했으면 false
+	bool complete = true;
+};
+
+/// <summary>
+/// 기록된 WinEvent 를 시뮬레이션 창 시스템에 적용한 뒤 추적 로직에 그대로 전달합니다.
+/// 프레임 틱은 벽시계가 아니라 기록된 시간으로 계산하므로, 같은 기록은 몇 번을 재생해도 같은 순서로 처리됩니다.
+///   onEvent(const Event&, uint64_t arrivalUs) : WinHookProc 에 해당
+///   onFrame(uint64_t nowUs)                   : 프레임 타이머 (WM_TIMER) 에 해당
+/// </summary>
+class TraceReplayer
+{
+public:
+	using Event = BasicWinEventHook<WindowHandle>;
+
+	TraceReplayer(SimulatedWindowSystem& windowSystem, const ReplayOptions& options = {})
+		: windowSystem(windowSystem), options(options)
+	{
+	}
+
+	template <typename OnEvent, typename OnFrame>
+	ReplayResult Run(WinEventTraceReader& reader, OnEvent&& onEvent, OnFrame&& onFrame)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		ReplayResult result{};
+		const Clock::time_point wallStart = Clock::now();
+
+		TraceRecord record{};
+		bool first = true;
+		uint64_t startUs = 0;
+		uint64_t lastUs = 0;
+		uint64_t nextFrameUs = 0;
+
+		while (reader.Next(record))
+		{
+			if (first)
+			{
+				startUs = record.arrivalUs;
+				nextFrameUs = startUs + options.frameIntervalUs;
+				first = false;
+			}
+
+			// 이 이벤트보다 앞선 프레임 경계를 먼저 처리
+			while (record.arrivalUs >= nextFrameUs)
+			{
+				WaitUntil(wallStart, nextFrameUs - startUs);
+				onFrame(nextFrameUs);
+				result.frames++;
+				nextFrameUs += options.frameIntervalUs;
+			}
+
+			WaitUntil(wallStart, record.arrivalUs - startUs);
+			windowSystem.ApplyEvent(record);
+
+			const Event event{ record.event, HandleFromBits(record.hwnd), record.idObject, record.idChild,
+				record.idEventThread, record.dwmsEventTime };
+			onEvent(event, record.arrivalUs);
+
+			result.events++;
+			lastUs = record.arrivalUs;
+		}
+
+		// 마지막 이벤트를 처리하는 프레임
+		if (!first)
+		{
+			WaitUntil(wallStart, nextFrameUs - startUs);
+			onFrame(nextFrameUs);
+			result.frames++;
+		}
+
+		result.traceDurationUs = lastUs - startUs;
+		result.wallDurationUs = static_cast<uint64_t>(
+			std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - wallStart).count());
+		result.complete = reader.AtEnd();
+		return result;
+	}
+
+private:
+	SimulatedWindowSystem& windowSystem;
+	ReplayOptions options;
+
+	void WaitUntil(std::chrono::steady_clock::time_point wallStart, uint64_t traceOffsetUs) const
+	{
+		if (options.pacing != ReplayPacing::Realtime || options.speed <= 0.0)
+			return;
+
+		const auto offset = std::chrono::microseconds(static_cast<int64_t>(static_cast<double>(traceOffsetUs) / options.speed));
+		std::this_thread::sleep_until(wallStart + offset);
+	}
+};
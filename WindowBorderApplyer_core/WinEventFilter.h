@@ -0,0 +1,162 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "HandleRegistry.h"
+#include "WinEvents.h"
+
+/// <summary>
+/// 추적 중인 창 집합에 대한 카운팅 블룸 필터. MayContain 이 false 면 확실히 추적하지 않는 창입니다.
+/// 조회는 4 KB 비트맵만 읽으므로 L1 캐시에 머뭅니다. 삭제용 카운터는 조회 경로에서 읽지 않습니다.
+/// 바꾸기 (Add / Remove / Clear) 는 한 스레드에서만 하고, 비트맵은 단어마다 원자적으로 바로 게시하므로 MayContain 은 아무 스레드에서나
+/// 불러도 됩니다. 바꾸는 중에 읽으면 그 창의 비트만 이전 값일 수 있습니다 (훅 스레드는 레이아웃 스레드가 추적 중인 집합을 잠금 없이 읽음)
+/// </summary>
+template <typename Handle, typename Hasher = HandleBits<Handle>>
+class TrackedWindowFilter
+{
+public:
+	static constexpr uint32_t BitCount = 1u << 15;
+
+	void Add(const Handle& handle) noexcept
+	{
+		const auto [first, second] = Positions(handle);
+		Increment(first);
+		Increment(second);
+	}
+
+	void Remove(const Handle& handle) noexcept
+	{
+		const auto [first, second] = Positions(handle);
+		Decrement(first);
+		Decrement(second);
+	}
+
+	void Clear() noexcept
+	{
+		for (std::atomic<uint64_t>& word : bits)
+			word.store(0, std::memory_order_relaxed);
+		counts.fill(0);
+	}
+
+	bool MayContain(const Handle& handle) const noexcept
+	{
+		const auto [first, second] = Positions(handle);
+		return TestBit(first) && TestBit(second);
+	}
+
+private:
+	// 다른 비트맵 내용과 함께 게시할 데이터가 없으므로 relaxed. x86 / ARM64 에서 보통의 읽기, 쓰기와 같음
+	std::array<std::atomic<uint64_t>, BitCount / 64> bits{};
+	std::array<uint8_t, BitCount> counts{};
+
+	static std::pair<uint32_t, uint32_t> Positions(const Handle& handle) noexcept
+	{
+		const uint64_t hash = Hasher{}(handle) * 0x9E3779B97F4A7C15ull;
+		return { static_cast<uint32_t>(hash >> 49), static_cast<uint32_t>(hash >> 17) & (BitCount - 1) };
+	}
+
+	bool TestBit(uint32_t position) const noexcept
+	{
+		return (bits[position >> 6].load(std::memory_order_relaxed) >> (position & 63)) & 1;
+	}
+
+	void Increment(uint32_t position) noexcept
+	{
+		// 포화된 카운터는 더 이상 줄이지 않음 (비트가 남아 있어도 거짓 양성일 뿐)
+		if (counts[position] != UINT8_MAX)
+			counts[position]++;
+		// 쓰는 스레드는 하나뿐이라 fetch_or 없이 읽고 씀
+		std::atomic<uint64_t>& word = bits[position >> 6];
+		word.store(word.load(std::memory_order_relaxed) | (uint64_t{ 1 } << (position & 63)), std::memory_order_relaxed);
+	}
+
+	void Decrement(uint32_t position) noexcept
+	{
+		if (counts[position] == 0 || counts[position] == UINT8_MAX)
+			return;
+
+		if (--counts[position] == 0)
+		{
+			std::atomic<uint64_t>& word = bits[position >> 6];
+			word.store(word.load(std::memory_order_relaxed) & ~(uint64_t{ 1 } << (position & 63)), std::memory_order_relaxed);
+		}
+	}
+};
+
+/// <summary> 이벤트 종류별 통과/거부 횟수 </summary>
+struct WinEventFilterStats
+{
+	// 이벤트 코드 -> 칸: 시스템 이벤트 0x00xx 는 0~31, 개체 이벤트 0x80xx 는 32~63
+	static constexpr uint32_t SlotCount = 64;
+
+	std::array<uint64_t, SlotCount> accepted{};
+	std::array<uint64_t, SlotCount> rejected{};
+
+	static constexpr uint32_t SlotOf(uint32_t event) noexcept
+	{
+		return ((event >> 10) & 32) | (event & 31);
+	}
+
+	/// <summary> 칸 번호를 이벤트 코드로 되돌립니다 </summary>
+	static constexpr uint32_t EventOf(uint32_t slot) noexcept
+	{
+		return (slot & 32) ? (0x8000u | (slot & 31)) : (slot & 31);
+	}
+
+	uint64_t Accepted(uint32_t event) const noexcept { return accepted[SlotOf(event)]; }
+	uint64_t Rejected(uint32_t event) const noexcept { return rejected[SlotOf(event)]; }
+
+	uint64_t TotalAccepted() const noexcept
+	{
+		uint64_t total = 0;
+		for (uint64_t count : accepted)
+			total += count;
+		return total;
+	}
+
+	uint64_t TotalRejected() const noexcept
+	{
+		uint64_t total = 0;
+		for (uint64_t count : rejected)
+			total += count;
+		return total;
+	}
+};
+
+/// <summary>
+/// WinHookProc 에서 가장 먼저 실행되는 사전 필터.
+/// 전역 훅은 모든 프로세스의 캐럿, 커서, 스크롤바, 자식 개체 이벤트까지 받으므로,
+/// 최상위 창 자신이 아니거나 추적하지 않는 창에 대한 이벤트는 WinEventHook 을 만들기 전에 버립니다.
+/// </summary>
+template <typename Handle, typename Hasher = HandleBits<Handle>>
+class WinEventPrefilter
+{
+public:
+	bool Accept(uint32_t event, const Handle& hwnd, int32_t idObject, int32_t idChild) noexcept
+	{
+		const bool accept = MayAccept(event, hwnd, idObject, idChild);
+		(accept ? stats.accepted : stats.rejected)[WinEventFilterStats::SlotOf(event)]++;
+		return accept;
+	}
+
+	/// <summary> Accept 와 같은 판정이지만 세지 않습니다. 추적 집합을 바꾸는 스레드가 아닌 훅 스레드에서 불러도 됩니다 </summary>
+	bool MayAccept(uint32_t event, const Handle& hwnd, int32_t idObject, int32_t idChild) const noexcept
+	{
+		// 포그라운드 변경과 표시는 추적하지 않는 창이어도 처리해야 함 (새 창을 등록)
+		return idObject == WinEventObjectId::Window && idChild == WinEventObjectId::ChildSelf
+			&& (event == WinEventId::SystemForeground || event == WinEventId::ObjectShow || tracked.MayContain(hwnd));
+	}
+
+	void Track(const Handle& hwnd) noexcept { tracked.Add(hwnd); }
+	void Untrack(const Handle& hwnd) noexcept { tracked.Remove(hwnd); }
+	void Clear() noexcept { tracked.Clear(); }
+
+	const WinEventFilterStats& Stats() const noexcept { return stats; }
+
+private:
+	TrackedWindowFilter<Handle, Hasher> tracked{};
+	WinEventFilterStats stats{};
+};
@@ -0,0 +1,348 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "HandleRegistry.h"
+#include "WindowSystemTypes.h"
+
+/// <summary>
+/// WinHookProc 이 받은 이벤트 하나와, 그 이벤트가 가리키는 창의 위치 (기록 시점의 프레임 사각형).
+/// hwnd 는 64비트 값으로 저장하므로 재생할 때 실제 HWND 가 아니어도 됩니다.
+/// </summary>
+struct TraceRecord
+{
+	// 기록 시작부터 WinHookProc 도착까지, 마이크로초
+	uint64_t arrivalUs = 0;
+	uint32_t event = 0;
+	uint64_t hwnd = 0;
+	int32_t idObject = 0;
+	int32_t idChild = 0;
+	uint32_t idEventThread = 0;
+	uint32_t dwmsEventTime = 0;
+	bool hasRect = false;
+	WindowRect rect{};
+};
+
+/*
+ * 파일 형식 (리틀 엔디언, 가변 길이 정수는 LEB128, 부호 있는 값은 zigzag)
+ *   헤더: "WBTR" + 버전(1 바이트) + 예약(3 바이트)
+ *   기록: 플래그(1 바이트)
+ *         varint  도착 시간 차이 (이전 기록 대비, us)
+ *         varint  이벤트 코드                 (SameEvent 가 아니면)
+ *         zigzag  hwnd 차이 (이전 기록 대비)  (SameHwnd 가 아니면)
+ *         zigzag  idObject, idChild           (HasObjectIds 이면)
+ *         varint  스레드 ID                   (SameThread 가 아니면)
+ *         zigzag  dwmsEventTime 차이 (이전 기록 대비)
+ *         zigzag  left/top/right/bottom 차이  (HasRect 이면, 같은 창의 직전 사각형 대비)
+ * 창을 끄는 동안에는 같은 창, 같은 이벤트가 반복되고 좌표도 조금씩만 바뀌므로, 기록 하나가 고정 크기 구조체 (48 바이트) 대신 10 바이트 안팎이 됩니다.
+ */
+namespace WinEventTraceFormat
+{
+	constexpr char Magic[4] = { 'W', 'B', 'T', 'R' };
+	constexpr uint8_t Version = 1;
+	constexpr size_t HeaderSize = 8;
+
+	constexpr uint8_t HasRect = 1 << 0;
+	constexpr uint8_t SameEvent = 1 << 1;
+	constexpr uint8_t SameHwnd = 1 << 2;
+	constexpr uint8_t HasObjectIds = 1 << 3;
+	constexpr uint8_t SameThread = 1 << 4;
+
+	inline uint64_t ZigZag(int64_t value) noexcept
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	inline int64_t UnZigZag(uint64_t value) noexcept
+	{
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	inline void PutVarint(std::vector<uint8_t>& out, uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	inline bool GetVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value) noexcept
+	{
+		value = 0;
+		for (int shift = 0; shift < 64 && cursor < end; shift += 7)
+		{
+			const uint8_t byte = *cursor++;
+			value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+}
+
+/// <summary> 직전 기록과 창별 직전 사각형. 쓰기와 읽기가 같은 규칙으로 차이를 계산합니다 </summary>
+struct WinEventTraceDeltaState
+{
+	TraceRecord previous{};
+	HandleRegistry<uint64_t, WindowRect> lastRects{};
+
+	void Reset()
+	{
+		previous = TraceRecord{};
+		lastRects.Clear();
+	}
+};
+
+/// <summary> TraceRecord 를 압축된 이진 형식으로 기록합니다. 한 스레드에서만 사용하세요 </summary>
+class WinEventTraceWriter
+{
+public:
+	WinEventTraceWriter() { Reset(); }
+	~WinEventTraceWriter() { Close(); }
+
+	bool Open(const std::filesystem::path& path)
+	{
+		Close();
+		file.open(path, std::ios::binary | std::ios::trunc);
+		if (!file)
+			return false;
+
+		Reset();
+		return true;
+	}
+
+	void Close()
+	{
+		if (file.is_open())
+		{
+			FlushToFile();
+			file.close();
+		}
+	}
+
+	bool IsOpen() const noexcept { return file.is_open(); }
+
+	/// <summary> 쌓인 기록을 파일에 씁니다. 프로세스가 강제 종료되어도 여기까지는 남습니다 </summary>
+	void Flush()
+	{
+		if (!file.is_open())
+			return;
+
+		FlushToFile();
+		file.flush();
+	}
+
+	void Append(const TraceRecord& record)
+	{
+		using namespace WinEventTraceFormat;
+		const TraceRecord& previous = state.previous;
+
+		uint8_t flags = 0;
+		if (record.hasRect)
+			flags |= HasRect;
+		if (record.event == previous.event)
+			flags |= SameEvent;
+		if (record.hwnd == previous.hwnd)
+			flags |= SameHwnd;
+		if (record.idObject != 0 || record.idChild != 0)
+			flags |= HasObjectIds;
+		if (record.idEventThread == previous.idEventThread)
+			flags |= SameThread;
+
+		buffer.push_back(flags);
+		PutVarint(buffer, record.arrivalUs - previous.arrivalUs);
+		if (!(flags & SameEvent))
+			PutVarint(buffer, record.event);
+		if (!(flags & SameHwnd))
+			PutVarint(buffer, ZigZag(static_cast<int64_t>(record.hwnd - previous.hwnd)));
+		if (flags & HasObjectIds)
+		{
+			PutVarint(buffer, ZigZag(record.idObject));
+			PutVarint(buffer, ZigZag(record.idChild));
+		}
+		if (!(flags & SameThread))
+			PutVarint(buffer, record.idEventThread);
+		PutVarint(buffer, ZigZag(static_cast<int32_t>(record.dwmsEventTime - previous.dwmsEventTime)));
+
+		if (record.hasRect)
+		{
+			WindowRect& last = state.lastRects[record.hwnd];
+			PutVarint(buffer, ZigZag(static_cast<int64_t>(record.rect.left) - last.left));
+			PutVarint(buffer, ZigZag(static_cast<int64_t>(record.rect.top) - last.top));
+			PutVarint(buffer, ZigZag(static_cast<int64_t>(record.rect.right) - last.right));
+			PutVarint(buffer, ZigZag(static_cast<int64_t>(record.rect.bottom) - last.bottom));
+			last = record.rect;
+		}
+
+		state.previous = record;
+		recordCount++;
+
+		if (file.is_open() && buffer.size() >= FlushThreshold)
+			FlushToFile();
+	}
+
+	/// <summary> 파일 없이 메모리에 기록할 때 결과 바이트 (헤더 포함) </summary>
+	const std::vector<uint8_t>& Buffer() const noexcept { return buffer; }
+
+	uint64_t RecordCount() const noexcept { return recordCount; }
+	uint64_t BytesWritten() const noexcept { return flushedBytes + buffer.size(); }
+
+private:
+	static constexpr size_t FlushThreshold = 64 * 1024;
+
+	std::ofstream file;
+	std::vector<uint8_t> buffer;
+	WinEventTraceDeltaState state;
+	uint64_t recordCount = 0;
+	uint64_t flushedBytes = 0;
+
+	void Reset()
+	{
+		using namespace WinEventTraceFormat;
+		buffer.clear();
+		for (char c : Magic)
+			buffer.push_back(static_cast<uint8_t>(c));
+		buffer.push_back(Version);
+		buffer.insert(buffer.end(), 3, 0);
+		state.Reset();
+		recordCount = 0;
+		flushedBytes = 0;
+	}
+
+	void FlushToFile()
+	{
+		file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		flushedBytes += buffer.size();
+		buffer.clear();
+	}
+};
+
+/// <summary> WinEventTraceWriter 가 만든 기록을 순서대로 읽습니다 </summary>
+class WinEventTraceReader
+{
+public:
+	bool Open(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return false;
+
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return Rewind();
+	}
+
+	bool OpenBuffer(std::vector<uint8_t> bytes)
+	{
+		data = std::move(bytes);
+		return Rewind();
+	}
+
+	/// <summary> 처음 기록으로 돌아갑니다. 헤더가 올바르지 않으면 false </summary>
+	bool Rewind()
+	{
+		using namespace WinEventTraceFormat;
+		state.Reset();
+		cursor = data.size();
+		if (data.size() < HeaderSize || std::memcmp(data.data(), Magic, sizeof(Magic)) != 0 || data[4] != Version)
+			return false;
+
+		cursor = HeaderSize;
+		return true;
+	}
+
+	/// <summary> 다음 기록을 읽습니다. 끝이거나 손상된 기록이면 false </summary>
+	bool Next(TraceRecord& record)
+	{
+		using namespace WinEventTraceFormat;
+		if (cursor >= data.size())
+			return false;
+
+		const uint8_t* it = data.data() + cursor;
+		const uint8_t* end = data.data() + data.size();
+		const TraceRecord& previous = state.previous;
+		const uint8_t flags = *it++;
+
+		uint64_t value = 0;
+		record = TraceRecord{};
+		if (!GetVarint(it, end, value))
+			return false;
+		record.arrivalUs = previous.arrivalUs + value;
+
+		record.event = previous.event;
+		if (!(flags & SameEvent))
+		{
+			if (!GetVarint(it, end, value))
+				return false;
+			record.event = static_cast<uint32_t>(value);
+		}
+
+		record.hwnd = previous.hwnd;
+		if (!(flags & SameHwnd))
+		{
+			if (!GetVarint(it, end, value))
+				return false;
+			record.hwnd = previous.hwnd + static_cast<uint64_t>(UnZigZag(value));
+		}
+
+		if (flags & HasObjectIds)
+		{
+			if (!GetVarint(it, end, value))
+				return false;
+			record.idObject = static_cast<int32_t>(UnZigZag(value));
+			if (!GetVarint(it, end, value))
+				return false;
+			record.idChild = static_cast<int32_t>(UnZigZag(value));
+		}
+
+		record.idEventThread = previous.idEventThread;
+		if (!(flags & SameThread))
+		{
+			if (!GetVarint(it, end, value))
+				return false;
+			record.idEventThread = static_cast<uint32_t>(value);
+		}
+
+		if (!GetVarint(it, end, value))
+			return false;
+		record.dwmsEventTime = previous.dwmsEventTime + static_cast<uint32_t>(UnZigZag(value));
+
+		if (flags & HasRect)
+		{
+			int64_t deltas[4] = {};
+			for (int64_t& delta : deltas)
+			{
+				if (!GetVarint(it, end, value))
+					return false;
+				delta = UnZigZag(value);
+			}
+
+			WindowRect& last = state.lastRects[record.hwnd];
+			record.hasRect = true;
+			record.rect.left = static_cast<int32_t>(last.left + deltas[0]);
+			record.rect.top = static_cast<int32_t>(last.top + deltas[1]);
+			record.rect.right = static_cast<int32_t>(last.right + deltas[2]);
+			record.rect.bottom = static_cast<int32_t>(last.bottom + deltas[3]);
+			last = record.rect;
+		}
+
+		state.previous = record;
+		cursor = static_cast<size_t>(it - data.data());
+		return true;
+	}
+
+	bool AtEnd() const noexcept { return cursor >= data.size(); }
+	size_t SizeBytes() const noexcept { return data.size(); }
+
+private:
+	std::vector<uint8_t> data;
+	size_t cursor = 0;
+	WinEventTraceDeltaState state;
+};
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// Win32 의 WinEvent 상수 (WinUser.h 와 같은 값). 코어 코드는 Windows.h 없이 빌드되어야 하므로 따로 정의합니다.
+namespace WinEventId
+{
+	constexpr uint32_t SystemForeground = 0x0003;
+	constexpr uint32_t SystemMoveSizeStart = 0x000A;
+	constexpr uint32_t SystemMoveSizeEnd = 0x000B;
+	constexpr uint32_t SystemMinimizeStart = 0x0016;
+	constexpr uint32_t SystemMinimizeEnd = 0x0017;
+	constexpr uint32_t ObjectCreate = 0x8000;
+	constexpr uint32_t ObjectDestroy = 0x8001;
+	constexpr uint32_t ObjectShow = 0x8002;
+	constexpr uint32_t ObjectHide = 0x8003;
+	constexpr uint32_t ObjectReorder = 0x8004;
+	constexpr uint32_t ObjectFocus = 0x8005;
+	constexpr uint32_t ObjectLocationChange = 0x800B;
+	constexpr uint32_t ObjectCloaked = 0x8017;
+	constexpr uint32_t ObjectUncloaked = 0x8018;
+}
+
+namespace WinEventObjectId
+{
+	constexpr int32_t Window = 0;
+	constexpr int32_t Caret = -8;
+	constexpr int32_t Cursor = -9;
+	constexpr int32_t ChildSelf = 0;
+}
+
+/// <summary> WinEventProc 로 전달되는 인자 묶음. Handle 은 Windows 에서 HWND, 테스트에서는 가짜 핸들 </summary>
+template <typename Handle>
+struct BasicWinEventHook
+{
+	uint32_t event;
+	Handle hwnd;
+	int32_t idObject;
+	int32_t idChild;
+	uint32_t idEventThread;
+	uint32_t dwmsEventTime;
+
+	/// <summary> 최상위 창 자신에 대한 이벤트인지 (캐럿, 커서, 스크롤바, 자식 개체 제외) </summary>
+	bool IsWindowObject() const noexcept
+	{
+		return idObject == WinEventObjectId::Window && idChild == WinEventObjectId::ChildSelf;
+	}
+};
@@ -0,0 +1,86 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include "WinEvents.h"
+
+/// <summary>
+/// 추적 중인 창의 표시 상태. 매 이벤트마다 모든 창에 IsWindowVisible 을 호출하는 대신,
+/// SHOW / HIDE / CLOAKED / UNCLOAKED / MINIMIZE 이벤트로 상태 비트만 갱신합니다.
+/// </summary>
+struct WindowLiveness
+{
+	static constexpr uint8_t Visible = 1 << 0;
+	static constexpr uint8_t Cloaked = 1 << 1;
+	static constexpr uint8_t Minimized = 1 << 2;
+
+	uint8_t flags = Visible;
+
+	/// <summary> 테두리를 가져야 하는 상태인지 (보이고, 클로킹/최소화되지 않음) </summary>
+	bool IsLive() const noexcept
+	{
+		return (flags & (Visible | Cloaked | Minimized)) == Visible;
+	}
+};
+
+enum class LivenessTransition : uint8_t
+{
+	None,
+	// 테두리를 새로 붙여야 함
+	Shown,
+	// 테두리를 떼어야 함 (추적은 유지)
+	Hidden,
+	// 창이 파괴됨, 추적 해제
+	Destroyed,
+};
+
+/// <summary> 표시 상태 이벤트를 비트에 반영합니다. 표시 상태와 무관한 이벤트면 false </summary>
+inline bool ApplyLivenessFlag(WindowLiveness& liveness, uint32_t event) noexcept
+{
+	switch (event)
+	{
+	case WinEventId::ObjectShow:
+		liveness.flags |= WindowLiveness::Visible;
+		return true;
+	case WinEventId::ObjectHide:
+		liveness.flags &= ~WindowLiveness::Visible;
+		return true;
+	case WinEventId::ObjectCloaked:
+		liveness.flags |= WindowLiveness::Cloaked;
+		return true;
+	case WinEventId::ObjectUncloaked:
+		liveness.flags &= ~WindowLiveness::Cloaked;
+		return true;
+	case WinEventId::SystemMinimizeStart:
+		liveness.flags |= WindowLiveness::Minimized;
+		return true;
+	case WinEventId::SystemMinimizeEnd:
+		liveness.flags &= ~WindowLiveness::Minimized;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/// <summary> 이전 상태와 비교하여 테두리에 필요한 동작을 계산합니다 </summary>
+inline LivenessTransition CompareLiveness(bool wasLive, const WindowLiveness& liveness) noexcept
+{
+	const bool isLive = liveness.IsLive();
+	if (wasLive == isLive)
+		return LivenessTransition::None;
+
+	return isLive ? LivenessTransition::Shown : LivenessTransition::Hidden;
+}
+
+/// <summary> 창 하나에 대한 이벤트를 상태에 반영하고, 테두리에 필요한 동작을 반환합니다. O(1) </summary>
+inline LivenessTransition ApplyLivenessEvent(WindowLiveness& liveness, uint32_t event) noexcept
+{
+	if (event == WinEventId::ObjectDestroy)
+		return LivenessTransition::Destroyed;
+
+	const bool wasLive = liveness.IsLive();
+	if (!ApplyLivenessFlag(liveness, event))
+		return LivenessTransition::None;
+
+	return CompareLiveness(wasLive, liveness);
+}
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "BorderLayout.h"
+#include "WindowLiveness.h"
+#include "WindowSystemTypes.h"
+
+/// <summary> 대상 창 하나의 테두리를 그리는 오버레이 창 (Windows 에서는 BorderWindow) </summary>
+class BorderOverlay
+{
+public:
+	virtual ~BorderOverlay() = default;
+
+	/// <summary> 대상 창 바로 아래 z 순서에 visual.bounds 로 옮기고, 모양이 바뀌었으면 다시 그립니다 </summary>
+	virtual bool Present(const BorderVisual& visual) = 0;
+	virtual void Hide() = 0;
+
+	/// <summary>
+	/// 대상 창이 사라져 (최소화, 다른 데스크톱) 보관할 때: 숨기고 대상 창과의 연결을 끊습니다.
+	/// false 면 다시 쓸 수 없는 오버레이이므로 파괴합니다
+	/// </summary>
+	virtual bool Park() { return false; }
+	/// <summary> 보관했던 오버레이를 다른 (또는 같은) 대상 창에 다시 붙여 visual 로 표시합니다. 실패하면 파괴하고 새로 만듭니다 </summary>
+	virtual bool Rebind(WindowHandle, const BorderVisual&) { return false; }
+	/// <summary> 대상 창이 포그라운드가 되어 z 순서 맨 위로 올라옴. 창마다 오버레이가 있으면 Present 가 z 순서를 맞추므로 할 일이 없음 </summary>
+	virtual void Raise() {}
+	/// <summary> 대상 창이 키보드 포커스를 받음 (다른 추적 창에서 넘어온 경우만). 애니메이션이 없으면 할 일이 없음 </summary>
+	virtual void Focus() {}
+	/// <summary> 이 테두리가 가진 그리기 표면의 픽셀 메모리 (바이트). 공유 표면에 그리면 0 </summary>
+	virtual uint64_t SurfaceBytes() const noexcept { return 0; }
+};
+
+/// <summary>
+/// 추적 로직이 사용하는 창 시스템 기능. Win32WindowSystem 은 Win32 / DWM / COM 으로,
+/// SimulatedWindowSystem 은 메모리 안의 창 목록으로 구현하므로 코어는 Windows 없이도 빌드, 실행됩니다.
+/// </summary>
+class WindowSystem
+{
+public:
+	virtual ~WindowSystem() = default;
+
+	/// <summary> 테두리 대상이 될 수 있는 최상위 창을 위에서 아래 z 순서로 나열합니다 </summary>
+	virtual void EnumerateWindows(std::vector<WindowHandle>& windows) = 0;
+
+	/// <summary> 새로 나타난 창이 테두리 대상인지 (EnumerateWindows 가 나열하는 조건과 같음) </summary>
+	virtual bool IsBorderCandidate(WindowHandle window) = 0;
+
+	/// <summary> 그림자를 제외한 프레임 사각형 (DWMWA_EXTENDED_FRAME_BOUNDS). 없는 창이면 false </summary>
+	virtual bool GetFrameBounds(WindowHandle window, WindowRect& frame) = 0;
+
+	/// <summary> frame 에 놓인 창의 모니터 (MonitorFromRect, 가장 가까운 모니터) </summary>
+	virtual MonitorHandle GetMonitor(WindowHandle window, const WindowRect& frame) = 0;
+
+	/// <summary> 모니터의 유효 DPI (GetDpiForMonitor). 바뀌는 건 디스플레이 설정이 바뀔 때뿐이므로 추적기가 캐시합니다 </summary>
+	virtual uint32_t GetMonitorDpi(MonitorHandle monitor) = 0;
+
+	/// <summary> 현재 가상 데스크톱에 있는 창인지 </summary>
+	virtual bool IsOnCurrentDesktop(WindowHandle window) = 0;
+
+	/// <summary> 표시 / 클로킹 / 최소화 상태. 등록할 때 한 번만 조회하고 이후로는 이벤트로 갱신합니다 </summary>
+	virtual WindowLiveness QueryLiveness(WindowHandle window) = 0;
+
+	/// <summary> target 의 테두리 오버레이를 만들고 visual 로 처음 그립니다. 실패하면 nullptr </summary>
+	virtual std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) = 0;
+
+	/// <summary>
+	/// CreateOverlay 를 세 단계로 나눈 것. 여러 테두리를 한 번에 만들 때 (시작, 모두 최소화 후 복원) BorderPipeline 이 사용합니다.
+	///  - BeginOverlay / FinishOverlay: 오버레이를 소유할 스레드에서. 창 생성, z 순서, 표시처럼 스레드에 묶인 일
+	///  - PrepareOverlay: 작업 풀의 아무 스레드에서, 서로 다른 오버레이끼리 동시에. 장치와 창에 묶이지 않은 준비만
+	///    (모양 계산, 메모리 표면에 그리기). 소유 스레드는 기다리는 동안 메시지를 처리하지 않으므로 그 스레드의 창에
+	///    메시지를 보내거나 창에 묶인 장치 자원 (창 렌더 타깃) 을 만들면 안 됨. 그런 자원과 첫 반영은 FinishOverlay 에서
+	/// 기본 구현은 BeginOverlay 에서 CreateOverlay 로 모두 처리합니다. Prepare / Finish 가 false 면 오버레이를 버립니다
+	/// </summary>
+	virtual std::unique_ptr<BorderOverlay> BeginOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual)
+	{
+		return CreateOverlay(target, style, visual);
+	}
+	virtual bool PrepareOverlay(BorderOverlay&, const BorderVisual&) { return true; }
+	virtual bool FinishOverlay(BorderOverlay&, const BorderVisual&) { return true; }
+
+	/// <summary>
+	/// 오버레이 변경 묶음이 끝났을 때 (추적기의 틱, 표시 스레드의 명령 묶음). 모든 테두리를 표면 하나에 모아 그리는
+	/// 창 시스템 (CompositedWindowSystem) 은 여기서 한 번에 그리고 반영합니다
+	/// </summary>
+	virtual void FlushOverlays() {}
+};
@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <cstdint>
+
+// 코어 코드가 사용하는 창 시스템 공용 타입. Windows 에서 WindowHandle 은 HWND 와 같은 값입니다.
+
+using WindowHandle = void*;
+// Windows 에서는 HMONITOR 와 같은 값
+using MonitorHandle = void*;
+
+inline uint64_t HandleToBits(WindowHandle handle) noexcept
+{
+	return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+}
+
+inline WindowHandle HandleFromBits(uint64_t bits) noexcept
+{
+	return reinterpret_cast<WindowHandle>(static_cast<uintptr_t>(bits));
+}
+
+/// <summary> 화면 좌표의 사각형 (RECT 와 같은 배치) </summary>
+struct WindowRect
+{
+	int32_t left = 0;
+	int32_t top = 0;
+	int32_t right = 0;
+	int32_t bottom = 0;
+
+	int32_t Width() const noexcept { return right - left; }
+	int32_t Height() const noexcept { return bottom - top; }
+	bool IsEmpty() const noexcept { return right <= left || bottom <= top; }
+	int64_t Area() const noexcept { return IsEmpty() ? 0 : static_cast<int64_t>(Width()) * Height(); }
+
+	/// <summary> 겹치는 부분. 겹치지 않으면 비어 있는 사각형 </summary>
+	WindowRect Intersect(const WindowRect& other) const noexcept
+	{
+		return WindowRect{ left > other.left ? left : other.left, top > other.top ? top : other.top,
+			right < other.right ? right : other.right, bottom < other.bottom ? bottom : other.bottom };
+	}
+	bool Intersects(const WindowRect& other) const noexcept { return !Intersect(other).IsEmpty(); }
+
+	/// <summary> 둘을 모두 덮는 가장 작은 사각형 (비어 있는 쪽은 무시) </summary>
+	WindowRect Union(const WindowRect& other) const noexcept
+	{
+		if (IsEmpty())
+			return other;
+		if (other.IsEmpty())
+			return *this;
+		return WindowRect{ left < other.left ? left : other.left, top < other.top ? top : other.top,
+			right > other.right ? right : other.right, bottom > other.bottom ? bottom : other.bottom };
+	}
+
+	WindowRect Offset(int32_t dx, int32_t dy) const noexcept { return WindowRect{ left + dx, top + dy, right + dx, bottom + dy }; }
+
+	bool operator==(const WindowRect& other) const noexcept
+	{
+		return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+	}
+	bool operator!=(const WindowRect& other) const noexcept { return !(*this == other); }
+};
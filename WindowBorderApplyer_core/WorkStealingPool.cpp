@@ -0,0 +1,162 @@
+﻿#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(size_t workerCount)
+{
+	for (size_t i = 0; i < workerCount; ++i)
+		queues.push_back(std::make_unique<WorkerQueue>());
+
+	for (size_t i = 0; i < workerCount; ++i)
+		workers.emplace_back(&WorkStealingPool::RunWorker, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	sleepCondition.notify_all();
+
+	for (auto& worker : workers)
+		worker.join();
+}
+
+void WorkStealingPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn)
+{
+	if (count == 0)
+		return;
+
+	batches.fetch_add(1, std::memory_order_relaxed);
+	if (queues.empty() || count == 1)
+	{
+		for (size_t i = 0; i < count; ++i)
+			fn(i);
+		callerExecuted.fetch_add(count, std::memory_order_relaxed);
+		return;
+	}
+
+	Batch batch{};
+	batch.fn = &fn;
+	batch.remaining.store(count, std::memory_order_relaxed);
+
+	// 큐마다 연속된 구간을 넣음. 오래 걸리는 구간이 있으면 다른 스레드가 앞에서부터 훔쳐 감
+	const size_t queueCount = queues.size();
+	for (size_t q = 0; q < queueCount; ++q)
+	{
+		const size_t begin = count * q / queueCount;
+		const size_t end = count * (q + 1) / queueCount;
+		if (begin == end)
+			continue;
+
+		std::lock_guard<std::mutex> lock(queues[q]->mutex);
+		for (size_t i = begin; i < end; ++i)
+			queues[q]->tasks.push_back(Task{ &batch, i });
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		pendingTasks.fetch_add(count, std::memory_order_relaxed);
+	}
+	sleepCondition.notify_all();
+
+	// 기다리는 동안 호출 스레드도 훔쳐서 실행 (다른 ParallelFor 의 작업이어도 됨)
+	while (batch.remaining.load(std::memory_order_acquire) != 0)
+	{
+		Task task{};
+		bool wasStolen = false;
+		if (TryTake(queueCount, task, wasStolen))
+		{
+			Execute(task);
+			callerExecuted.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		// 남은 작업은 모두 작업 스레드가 실행 중
+		std::unique_lock<std::mutex> lock(doneMutex);
+		doneCondition.wait(lock, [&batch]() { return batch.remaining.load(std::memory_order_acquire) == 0; });
+	}
+}
+
+WorkPoolStats WorkStealingPool::Stats() const noexcept
+{
+	WorkPoolStats stats{};
+	stats.executed = executed.load(std::memory_order_relaxed);
+	stats.stolen = stolen.load(std::memory_order_relaxed);
+	stats.callerExecuted = callerExecuted.load(std::memory_order_relaxed);
+	stats.batches = batches.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void WorkStealingPool::RunWorker(size_t self)
+{
+	for (;;)
+	{
+		Task task{};
+		bool wasStolen = false;
+		if (TryTake(self, task, wasStolen))
+		{
+			Execute(task);
+			executed.fetch_add(1, std::memory_order_relaxed);
+			if (wasStolen)
+				stolen.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		// 큐를 다 본 뒤에 들어온 작업은 pendingTasks 로 알 수 있으므로 놓치지 않음
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCondition.wait(lock, [this]() { return stopping || pendingTasks.load(std::memory_order_relaxed) != 0; });
+		if (stopping)
+			return;
+	}
+}
+
+bool WorkStealingPool::TryTake(size_t self, Task& task, bool& wasStolen)
+{
+	const size_t queueCount = queues.size();
+	if (self < queueCount)
+	{
+		WorkerQueue& own = *queues[self];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.tasks.empty())
+		{
+			task = own.tasks.back();
+			own.tasks.pop_back();
+			pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+			wasStolen = false;
+			return true;
+		}
+	}
+
+	// 이웃부터 차례로 훔침
+	for (size_t offset = 1; offset <= queueCount; ++offset)
+	{
+		const size_t victim = (self + offset) % queueCount;
+		if (victim == self)
+			continue;
+
+		WorkerQueue& other = *queues[victim];
+		std::lock_guard<std::mutex> lock(other.mutex);
+		if (!other.tasks.empty())
+		{
+			task = other.tasks.front();
+			other.tasks.pop_front();
+			pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+			wasStolen = true;
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorkStealingPool::Execute(const Task& task)
+{
+	Batch& batch = *task.batch;
+	(*batch.fn)(task.index);
+
+	// 마지막 작업이면 기다리는 호출 스레드를 깨움. 깨운 뒤에는 batch (호출 스레드의 지역 변수) 를 건드리지 않음
+	if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		std::lock_guard<std::mutex> lock(doneMutex);
+		doneCondition.notify_all();
+	}
+}
@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// <summary> 작업 풀의 누적 횟수 </summary>
+struct WorkPoolStats
+{
+	// 작업 스레드가 실행한 작업 (자기 큐 + 훔친 작업)
+	uint64_t executed = 0;
+	// 다른 작업 스레드의 큐에서 가져온 작업
+	uint64_t stolen = 0;
+	// ParallelFor 를 부른 스레드가 기다리는 대신 직접 실행한 작업
+	uint64_t callerExecuted = 0;
+	uint64_t batches = 0;
+};
+
+/// <summary>
+/// 작업 훔치기 (work stealing) 스레드 풀. 작업 스레드마다 큐를 두고 ParallelFor 가 작업을 고르게 나눠 넣습니다.
+/// 자기 큐는 뒤에서 (최근 것부터), 다른 큐는 앞에서 가져오므로 오래 걸리는 작업이 한쪽에 몰려도 쉬는 스레드가 나눠 가집니다.
+/// 작업 하나가 밀리초 단위 (렌더 타깃 생성 등) 라고 보고 큐는 잠금으로 보호합니다.
+/// </summary>
+class WorkStealingPool
+{
+public:
+	/// <summary> workerCount 가 0 이면 스레드를 만들지 않고 ParallelFor 가 호출 스레드에서 차례로 실행합니다 </summary>
+	explicit WorkStealingPool(size_t workerCount);
+	~WorkStealingPool();
+
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	size_t WorkerCount() const noexcept { return workers.size(); }
+
+	/// <summary>
+	/// [0, count) 의 각 index 로 fn 을 실행하고 모두 끝날 때까지 기다립니다. 기다리는 동안 호출 스레드도 작업을 가져가 실행합니다.
+	/// fn 은 예외를 던지면 안 되며 서로 다른 index 끼리 동시에 실행됩니다. 여러 스레드에서 동시에 불러도 됩니다
+	/// </summary>
+	void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+	WorkPoolStats Stats() const noexcept;
+
+private:
+	struct Batch
+	{
+		const std::function<void(size_t)>* fn = nullptr;
+		std::atomic<size_t> remaining{ 0 };
+	};
+
+	struct Task
+	{
+		Batch* batch = nullptr;
+		size_t index = 0;
+	};
+
+	// 큐끼리 캐시 줄을 나눠 쓰지 않도록 정렬
+	struct alignas(64) WorkerQueue
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<std::thread> workers;
+
+	// 쉬는 작업 스레드를 깨움. pendingTasks 는 큐에 남은 작업 수
+	std::mutex sleepMutex;
+	std::condition_variable sleepCondition;
+	std::atomic<size_t> pendingTasks{ 0 };
+	bool stopping = false;
+
+	// ParallelFor 를 부른 스레드가 마지막 작업을 기다림
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+
+	std::atomic<uint64_t> executed{ 0 };
+	std::atomic<uint64_t> stolen{ 0 };
+	std::atomic<uint64_t> callerExecuted{ 0 };
+	std::atomic<uint64_t> batches{ 0 };
+
+	void RunWorker(size_t self);
+	/// <summary> self 의 큐 뒤에서, 없으면 다른 큐 앞에서 하나 꺼냅니다. self 가 큐 수 이상이면 (호출 스레드) 훔치기만 함 </summary>
+	bool TryTake(size_t self, Task& task, bool& wasStolen);
+	void Execute(const Task& task);
+};
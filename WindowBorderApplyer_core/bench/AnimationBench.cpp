@@ -0,0 +1,103 @@
+﻿// 테두리 애니메이션 (BorderAnimator) 의 비용. 가상 시각으로 재생합니다.
+// 시나리오:
+//  - idle  : 움직이는 것이 없을 때 1 초 동안 깨어난 횟수 (표시 스레드가 Tick 이 알려 준 시간만 잠) 와 Tick 한 번의 ns
+//  - fade  : N = 1 / 10 / 100 / 1000 개 테두리가 동시에 색을 이어 바꿈 (150 ms)
+//  - pulse : N 개 테두리가 동시에 두 번 깜빡임 (300 ms x 2)
+// fade / pulse 는 프레임 수, 프레임 하나의 ns, 프레임에서 애니메이션 하나의 ns 와 다시 그린 횟수를 냅니다
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. AnimationBench.cpp ../BorderAnimator.cpp -o AnimationBench
+
+#include "BenchUtil.h"
+#include "BorderAnimator.h"
+
+namespace
+{
+	constexpr int Rounds = 20;
+
+	BorderAnimationOptions AppOptions()
+	{
+		BorderAnimationOptions options{};
+		options.fadeUs = 150000;
+		options.pulseUs = 300000;
+		options.pulseCount = 2;
+		options.frameIntervalUs = 16000;
+		return options;
+	}
+
+	void ReportIdle()
+	{
+		BorderAnimator animator(AppOptions());
+		// 표시 스레드처럼 Tick 이 0 이면 다른 일 (최대 1 초) 이 있을 때까지 잠
+		uint64_t wakeups = 0;
+		for (uint64_t nowUs = 0; nowUs < 1000000;)
+		{
+			const uint64_t delayUs = animator.Tick(nowUs, [](uint32_t, uint32_t) {});
+			if (delayUs == 0)
+				break;
+			wakeups++;
+			nowUs += delayUs;
+		}
+
+		constexpr int Calls = 10000000;
+		uint64_t sum = 0;
+		BenchTimer timer;
+		for (int i = 0; i < Calls; ++i)
+		{
+			sum += animator.Tick(static_cast<uint64_t>(i), [](uint32_t, uint32_t) {});
+			DoNotOptimize(sum);
+		}
+		const double ns = timer.ElapsedNs() / Calls;
+		std::printf("idle: %llu wakeups, %llu frames per second, %.2f ns per Tick\n\n", static_cast<unsigned long long>(wakeups),
+			static_cast<unsigned long long>(animator.Stats().frames), ns);
+	}
+
+	/// <summary> 애니메이션 count 개를 start 로 시작해 끝까지 재생. 프레임마다 Tick 하나 </summary>
+	template <typename Start>
+	BENCH_NOINLINE void Replay(const char* name, uint32_t count, Start start)
+	{
+		double totalNs = 0;
+		AnimationStats last{};
+		for (int round = 0; round < Rounds; ++round)
+		{
+			BorderAnimator animator(AppOptions());
+			uint64_t nowUs = 0;
+			for (uint32_t node = 0; node < count; ++node)
+				start(animator, node, nowUs);
+
+			uint64_t sum = 0;
+			BenchTimer timer;
+			for (uint64_t delayUs = animator.Tick(nowUs, [&sum](uint32_t node, uint32_t color) { sum += node ^ color; }); delayUs != 0;
+				delayUs = animator.Tick(nowUs, [&sum](uint32_t node, uint32_t color) { sum += node ^ color; }))
+				nowUs += delayUs;
+			totalNs += timer.ElapsedNs();
+			DoNotOptimize(sum);
+			last = animator.Stats();
+		}
+
+		const double perRound = totalNs / Rounds;
+		std::printf("%-6s %6u %8llu %12.1f %12.2f %10llu\n", name, count, static_cast<unsigned long long>(last.frames),
+			perRound / static_cast<double>(last.frames), perRound / static_cast<double>(last.evaluated),
+			static_cast<unsigned long long>(last.applied));
+	}
+}
+
+int main()
+{
+	ReportIdle();
+
+	std::printf("%-6s %6s %8s %12s %12s %10s\n", "kind", "N", "frames", "ns/frame", "ns/anim", "redraws");
+	for (uint32_t count : { 1u, 10u, 100u, 1000u })
+	{
+		Replay("fade", count, [](BorderAnimator& animator, uint32_t node, uint64_t nowUs)
+			{
+				animator.Fade(node, 0x000000FF, 0x00FF0000 + node, nowUs);
+			});
+	}
+	for (uint32_t count : { 1u, 10u, 100u, 1000u })
+	{
+		Replay("pulse", count, [](BorderAnimator& animator, uint32_t node, uint64_t nowUs)
+			{
+				animator.Pulse(node, 0x000000FF + (node << 8), nowUs);
+			});
+	}
+	return 0;
+}
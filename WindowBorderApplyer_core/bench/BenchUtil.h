@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// 벤치마크 공용 도구: 리눅스에서도 빌드되도록 표준 라이브러리만 사용합니다.
+
+#if defined(_MSC_VER)
+#define BENCH_NOINLINE __declspec(noinline)
+#else
+#define BENCH_NOINLINE __attribute__((noinline))
+#endif
+
+/// <summary> 실제 HWND 대신 사용하는 가짜 핸들 </summary>
+struct FakeHwnd
+{
+	uint64_t value = 0;
+
+	bool operator==(const FakeHwnd& other) const noexcept { return value == other.value; }
+	bool operator!=(const FakeHwnd& other) const noexcept { return value != other.value; }
+	bool operator<(const FakeHwnd& other) const noexcept { return value < other.value; }
+};
+
+struct FakeHwndBits
+{
+	uint64_t operator()(const FakeHwnd& handle) const noexcept { return handle.value; }
+};
+
+/// <summary> HWND 처럼 4 의 배수로 증가하는 핸들을 만듭니다 </summary>
+inline FakeHwnd MakeFakeHwnd(uint64_t index)
+{
+	return FakeHwnd{ 0x10000 + index * 4 };
+}
+
+/// <summary> 결정적인 의사 난수 (xorshift64) </summary>
+struct BenchRandom
+{
+	uint64_t state = 0x2545F4914F6CDD1Dull;
+
+	uint64_t Next() noexcept
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		return state;
+	}
+
+	uint64_t Below(uint64_t bound) noexcept { return Next() % bound; }
+};
+
+class BenchTimer
+{
+public:
+	BenchTimer() : start(std::chrono::steady_clock::now()) {}
+
+	double ElapsedNs() const
+	{
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point start;
+};
+
+/// <summary> 최적화로 결과가 제거되지 않도록 값을 소비합니다 </summary>
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
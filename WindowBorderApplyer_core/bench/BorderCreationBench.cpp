@@ -0,0 +1,283 @@
+﻿// 창이 많을 때 모든 테두리가 나타날 때까지의 시간을 표시 스레드 혼자 만들 때 (serial) 와 작업 풀에 나눌 때 비교합니다.
+//  - startup : 이미 열린 창을 한꺼번에 등록 (프로그램 시작)
+//  - restore : 모두 최소화한 뒤 한꺼번에 복원 (Win+D 두 번)
+// 오버레이 생성 비용은 Windows 에서 잰 값을 흉내 냅니다. CPU 를 쓰는 부분은 바쁜 대기, 드라이버 / DWM 을 기다리는 부분은 sleep.
+//  - Begin   : RegisterClassExW + CreateWindowExW + SetLayeredWindowAttributes (표시 스레드)
+//  - Prepare : DWM 조회 + 모양 계산 (Software 는 DIB 생성과 그리기) (작업 풀)
+//  - Finish  : ID2D1HwndRenderTarget 생성 + 첫 EndDraw + SetWindowPos + ShowWindow + SetTimer (표시 스레드).
+//              창 렌더 타깃은 창 메시지를 주고받을 수 있어, 메시지를 처리하지 않고 풀을 기다리는 동안 만들 수 없음
+//  - Rebind  : 보관한 테두리 창을 다시 붙일 때. Finish 와 같은 호출 (표시 스레드)
+// 두 번째 표는 보관 상한 (overlayPoolLimit) 에 따라 복원 시간과 새로 만든 오버레이 수를 비교합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. BorderCreationBench.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp ../BorderPipeline.cpp ../BorderAnimator.cpp ../WorkStealingPool.cpp -o BorderCreationBench
+
+#include "BenchUtil.h"
+#include "BorderPipeline.h"
+#include "SimulatedWindowSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct CreateCost
+	{
+		uint32_t beginUs;
+		uint32_t prepareCpuUs;
+		uint32_t prepareWaitUs;
+		uint32_t finishUs;
+		uint32_t finishWaitUs;
+	};
+
+	constexpr CreateCost MeasuredCost{ 120, 150, 300, 310, 800 };
+	constexpr uint32_t RebindUs = 60;
+
+	void Spin(uint32_t us)
+	{
+		const auto until = Clock::now() + std::chrono::microseconds(us);
+		while (Clock::now() < until)
+		{
+		}
+	}
+
+	void Wait(uint32_t us)
+	{
+		if (us > 0)
+			std::this_thread::sleep_for(std::chrono::microseconds(us));
+	}
+
+	/// <summary> 다시 붙일 때 비용을 더하는 오버레이 </summary>
+	class CostedOverlay : public BorderOverlay
+	{
+	public:
+		explicit CostedOverlay(std::unique_ptr<BorderOverlay> overlay) : overlay(std::move(overlay)) {}
+
+		bool Present(const BorderVisual& visual) override { return overlay->Present(visual); }
+		void Hide() override { overlay->Hide(); }
+		bool Park() override { return overlay->Park(); }
+
+		bool Rebind(WindowHandle target, const BorderVisual& visual) override
+		{
+			Spin(RebindUs);
+			return overlay->Rebind(target, visual);
+		}
+
+	private:
+		std::unique_ptr<BorderOverlay> overlay;
+	};
+
+	/// <summary> 단계마다 비용을 더한 시뮬레이션 창 시스템 </summary>
+	class CostedWindowSystem : public SimulatedWindowSystem
+	{
+	public:
+		explicit CostedWindowSystem(const CreateCost& cost) : cost(cost) {}
+
+		std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) override
+		{
+			Spin(cost.beginUs + cost.prepareCpuUs + cost.finishUs);
+			Wait(cost.prepareWaitUs + cost.finishWaitUs);
+			return std::make_unique<CostedOverlay>(SimulatedWindowSystem::CreateOverlay(target, style, visual));
+		}
+
+		std::unique_ptr<BorderOverlay> BeginOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) override
+		{
+			Spin(cost.beginUs);
+			return std::make_unique<CostedOverlay>(SimulatedWindowSystem::CreateOverlay(target, style, visual));
+		}
+
+		bool PrepareOverlay(BorderOverlay&, const BorderVisual&) override
+		{
+			Spin(cost.prepareCpuUs);
+			Wait(cost.prepareWaitUs);
+			return true;
+		}
+
+		bool FinishOverlay(BorderOverlay&, const BorderVisual&) override
+		{
+			Spin(cost.finishUs);
+			Wait(cost.finishWaitUs);
+			return true;
+		}
+
+	private:
+		CreateCost cost;
+	};
+
+	WindowHandle MakeHandle(uint64_t index)
+	{
+		return HandleFromBits(0x10000 + index * 4);
+	}
+
+	/// <summary> Windows 의 표시 스레드 대신 onPresentReady 로 깨워 PumpPresent 를 부르고, 오버레이 수가 목표에 닿은 시각을 기록 </summary>
+	class PresentThread
+	{
+	public:
+		explicit PresentThread(BorderPipeline& pipeline) : pipeline(pipeline) {}
+
+		void Start()
+		{
+			thread = std::thread([this]()
+				{
+					for (;;)
+					{
+						signal.wait(0, std::memory_order_acquire);
+						signal.exchange(0, std::memory_order_acq_rel);
+						if (stopping.load(std::memory_order_acquire))
+							break;
+
+						pipeline.PumpPresent();
+						const size_t count = pipeline.OverlayCount();
+						if (count == target.load(std::memory_order_acquire))
+							reachedAt.store(Clock::now().time_since_epoch().count(), std::memory_order_release);
+						overlayCount.store(count, std::memory_order_release);
+					}
+					pipeline.ReleaseOverlays();
+				});
+		}
+
+		void Wake() noexcept
+		{
+			if (signal.exchange(1, std::memory_order_acq_rel) == 0)
+				signal.notify_one();
+		}
+
+		void Stop()
+		{
+			stopping.store(true, std::memory_order_release);
+			Wake();
+			thread.join();
+		}
+
+		/// <summary> 오버레이 수가 count 가 될 때까지 기다리고 그 시각을 반환 </summary>
+		Clock::time_point WaitForCount(size_t count)
+		{
+			while (overlayCount.load(std::memory_order_acquire) != count)
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+			return Clock::time_point(Clock::duration(reachedAt.load(std::memory_order_acquire)));
+		}
+
+		void Expect(size_t count)
+		{
+			target.store(count, std::memory_order_release);
+		}
+
+	private:
+		BorderPipeline& pipeline;
+		std::thread thread;
+		std::atomic<uint32_t> signal{ 0 };
+		std::atomic<bool> stopping{ false };
+		std::atomic<size_t> target{ 0 };
+		std::atomic<size_t> overlayCount{ 0 };
+		std::atomic<Clock::rep> reachedAt{ 0 };
+	};
+
+	struct Result
+	{
+		double startupMs = 0;
+		double restoreMs = 0;
+		// 복원할 때 새로 만든 오버레이 수
+		uint64_t restoreCreated = 0;
+		PipelineStats stats{};
+	};
+
+	Result Run(size_t windowCount, size_t workers, size_t poolLimit, const CreateCost& cost)
+	{
+		CostedWindowSystem windowSystem(cost);
+		for (size_t i = 0; i < windowCount; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 40) * 30;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, x, x + 800, x + 600 });
+		}
+
+		PipelineOptions options{};
+		options.createWorkers = workers;
+		options.overlayPoolLimit = poolLimit;
+		BorderPipeline pipeline(windowSystem, BorderStyle{}, options);
+		PresentThread presentThread(pipeline);
+		presentThread.Start();
+		pipeline.Start([&presentThread]() { presentThread.Wake(); });
+
+		Result result{};
+
+		// 시작: 나열한 창을 한 번에 등록
+		presentThread.Expect(windowCount);
+		auto start = Clock::now();
+		pipeline.Post([windowCount](BorderTracker& tracker)
+			{
+				for (size_t i = 0; i < windowCount; ++i)
+					tracker.AddWindow(MakeHandle(i));
+			});
+		result.startupMs = std::chrono::duration<double, std::milli>(presentThread.WaitForCount(windowCount) - start).count();
+
+		// 모두 최소화 -> 테두리 파괴 (보관 상한까지는 숨겨서 보관)
+		uint32_t eventTime = 0;
+		presentThread.Expect(0);
+		for (size_t i = 0; i < windowCount; ++i)
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::SystemMinimizeStart, MakeHandle(i), 0, 0, 1, ++eventTime });
+		presentThread.WaitForCount(0);
+		const uint64_t createdBeforeRestore = pipeline.Stats().overlaysCreated;
+
+		// 모두 복원: 복원 이벤트를 받은 순간부터 마지막 테두리가 나타날 때까지 (병합 프레임 대기 포함)
+		presentThread.Expect(windowCount);
+		start = Clock::now();
+		for (size_t i = 0; i < windowCount; ++i)
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::SystemMinimizeEnd, MakeHandle(i), 0, 0, 1, ++eventTime });
+		result.restoreMs = std::chrono::duration<double, std::milli>(presentThread.WaitForCount(windowCount) - start).count();
+
+		pipeline.Stop();
+		presentThread.Stop();
+		result.stats = pipeline.Stats();
+		result.restoreCreated = result.stats.overlaysCreated - createdBeforeRestore;
+		return result;
+	}
+}
+
+int main()
+{
+	const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+	std::printf("create cost: begin %u us, prepare %u us cpu + %u us wait, finish %u us cpu + %u us wait (%zu hardware threads)\n",
+		MeasuredCost.beginUs, MeasuredCost.prepareCpuUs, MeasuredCost.prepareWaitUs, MeasuredCost.finishUs, MeasuredCost.finishWaitUs, hardware);
+	std::printf("%8s %8s %12s %12s %10s %10s %8s %12s\n",
+		"windows", "workers", "startup ms", "restore ms", "speedup", "batches", "created", "max batch ms");
+
+	for (size_t windowCount : { 100, 300 })
+	{
+		double serialMs = 0;
+		for (size_t workers : { size_t(0), size_t(1), size_t(3), std::max<size_t>(hardware - 1, 7) })
+		{
+			const Result result = Run(windowCount, workers, 0, MeasuredCost);
+			if (workers == 0)
+				serialMs = result.startupMs + result.restoreMs;
+
+			std::printf("%8zu %8zu %12.1f %12.1f %9.2fx %10llu %8llu %12.1f\n",
+				windowCount, workers, result.startupMs, result.restoreMs,
+				serialMs / (result.startupMs + result.restoreMs),
+				static_cast<unsigned long long>(result.stats.createBatches),
+				static_cast<unsigned long long>(result.stats.overlaysCreated),
+				result.stats.maxCreateBatchUs / 1000.0);
+		}
+	}
+
+	std::printf("\nrestore with overlay pool (rebind %u us, 3 workers)\n", RebindUs);
+	std::printf("%8s %8s %12s %10s %10s %10s\n", "windows", "pool", "restore ms", "speedup", "created", "rebinds");
+
+	for (size_t windowCount : { 100, 300 })
+	{
+		double unpooledMs = 0;
+		for (size_t poolLimit : { size_t(0), size_t(64), windowCount })
+		{
+			const Result result = Run(windowCount, 3, poolLimit, MeasuredCost);
+			if (poolLimit == 0)
+				unpooledMs = result.restoreMs;
+
+			std::printf("%8zu %8zu %12.1f %9.2fx %10llu %10llu\n",
+				windowCount, poolLimit, result.restoreMs, unpooledMs / result.restoreMs,
+				static_cast<unsigned long long>(result.restoreCreated),
+				static_cast<unsigned long long>(result.stats.poolRebinds));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,263 @@
+﻿// 테두리 정책 (BorderPolicy 의 BorderPainter) 과 이전 FrameDrawer 의 일반 경로 (optional 두 개의 DrawableRect,
+// 색은 memcmp, 호출마다 has_value 비교와 분기) 의 갱신 + 그리기 비용을 비교합니다. 그리기는 좌표만 더하는 캔버스라
+// 비교와 분기 비용만 남습니다. 테두리 256 개를 프레임마다 한 번씩 갱신하고, 바뀐 것이 있을 때만 그립니다.
+//  - steady  : 그대로인 테두리 (비교만)
+//  - drag    : 프레임마다 너비가 바뀜 (비교 + 그리기)
+//  - recolor : 프레임마다 색이 바뀜
+//  - mixed   : 직각과 둥근 테두리가 번갈아 섞인 steady / drag
+// 변마다 두께와 그라데이션은 일반 경로에 없으므로 정책 경로만 잽니다.
+// 빌드: g++ -O2 -std=c++20 -I.. BorderPolicyBench.cpp -o BorderPolicyBench
+
+#include "BenchUtil.h"
+#include "BorderPolicy.h"
+
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace
+{
+	constexpr int Borders = 256;
+	constexpr int Frames = 4000;
+
+	// D2D1_RECT_F / D2D1_ROUNDED_RECT / D2D1_COLOR_F 와 같은 배치
+	struct RectF
+	{
+		float left, top, right, bottom;
+	};
+
+	struct RoundedRectF
+	{
+		RectF rect;
+		float radiusX, radiusY;
+	};
+
+	struct ColorF
+	{
+		float r, g, b, a;
+	};
+
+	// 그리기 대신 받은 값을 더하기만 함
+	struct SinkCanvas
+	{
+		float sum = 0.0f;
+		uint64_t draws = 0;
+
+		void StrokeRect(const BorderRectF& rect, int32_t thickness, uint32_t color, uint8_t)
+		{
+			sum += rect.left + rect.right + static_cast<float>(thickness + static_cast<int32_t>(color & 0xFF));
+			draws++;
+		}
+
+		void StrokeRoundedRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint8_t)
+		{
+			sum += rect.left + rect.right + radius + static_cast<float>(thickness + static_cast<int32_t>(color & 0xFF));
+			draws++;
+		}
+
+		void FillRect(const WindowRect& rect, uint32_t color, uint8_t)
+		{
+			sum += static_cast<float>(rect.left + rect.right + static_cast<int32_t>(color & 0xFF));
+			draws++;
+		}
+
+		void StrokeGradientRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint32_t endColor, uint8_t)
+		{
+			sum += rect.left + rect.right + radius + static_cast<float>(thickness + static_cast<int32_t>((color ^ endColor) & 0xFF));
+			draws++;
+		}
+
+		// 일반 경로용 (D2D 구조체를 그대로 받음)
+		void DrawRectangle(const RectF& rect, const ColorF& color, float thickness)
+		{
+			sum += rect.left + rect.right + thickness + color.r;
+			draws++;
+		}
+
+		void DrawRoundedRectangle(const RoundedRectF& rect, const ColorF& color, float thickness)
+		{
+			sum += rect.rect.left + rect.rect.right + rect.radiusX + thickness + color.r;
+			draws++;
+		}
+	};
+
+	/// <summary> 이전 FrameDrawer::SetBorderRect / Render 의 비교와 분기 (렌더 타깃과 브러시는 제외) </summary>
+	class GenericDrawer
+	{
+	public:
+		void SetBorderRect(const BorderVisual& visual, SinkCanvas& canvas)
+		{
+			auto newSceneRect = DrawableRect{};
+			newSceneRect.bordercolor = ConvertColor(visual.color);
+			newSceneRect.thickness = visual.thickness;
+
+			if ((visual.cornerRadius == 0) == false)
+				newSceneRect.roundedRect = RoundedRectF{ ConvertRect(visual.bounds, visual.thickness), visual.cornerRadius, visual.cornerRadius };
+			else
+				newSceneRect.rect = ConvertRect(visual.bounds, visual.thickness);
+
+			const bool roundedBoth = sceneRect.roundedRect.has_value() && newSceneRect.roundedRect.has_value();
+			uint8_t dirty = 0;
+			if (std::memcmp(&sceneRect.bordercolor, &newSceneRect.bordercolor, sizeof(newSceneRect.bordercolor)) != 0)
+				dirty |= BorderDirty::Color;
+			if (sceneRect.thickness != newSceneRect.thickness)
+				dirty |= BorderDirty::Thickness;
+			if (sceneRect.rect.has_value() != newSceneRect.rect.has_value() || sceneRect.roundedRect.has_value() != newSceneRect.roundedRect.has_value()
+				|| (roundedBoth && sceneRect.roundedRect->radiusX != newSceneRect.roundedRect->radiusX))
+				dirty |= BorderDirty::Radius;
+			if (visual.bounds.Width() != width || visual.bounds.Height() != height)
+				dirty |= BorderDirty::Size;
+
+			width = visual.bounds.Width();
+			height = visual.bounds.Height();
+			sceneRect = std::move(newSceneRect);
+
+			if (dirty != 0)
+				Render(canvas);
+		}
+
+	private:
+		struct DrawableRect
+		{
+			std::optional<RectF> rect;
+			std::optional<RoundedRectF> roundedRect;
+			ColorF bordercolor;
+			int thickness;
+		};
+
+		DrawableRect sceneRect = {};
+		int32_t width = -1;
+		int32_t height = -1;
+
+		void Render(SinkCanvas& canvas)
+		{
+			if (sceneRect.roundedRect)
+				canvas.DrawRoundedRectangle(sceneRect.roundedRect.value(), sceneRect.bordercolor, static_cast<float>(sceneRect.thickness));
+			else if (sceneRect.rect)
+				canvas.DrawRectangle(sceneRect.rect.value(), sceneRect.bordercolor, static_cast<float>(sceneRect.thickness));
+		}
+
+		static ColorF ConvertColor(uint32_t color)
+		{
+			return ColorF{ (color & 0xFF) / 255.f, ((color >> 8) & 0xFF) / 255.f, ((color >> 16) & 0xFF) / 255.f, 1.f };
+		}
+
+		static RectF ConvertRect(const WindowRect& rect, int thickness)
+		{
+			const float halfThickness = thickness / 2.0f;
+			return RectF{ static_cast<float>(rect.left) + halfThickness + 1, static_cast<float>(rect.top) + halfThickness + 1,
+				static_cast<float>(rect.right) - halfThickness - 1, static_cast<float>(rect.bottom) - halfThickness - 1 };
+		}
+	};
+
+	/// <summary> 정책 경로: 정책은 처음 (스타일이 바뀔 때) 한 번만 고르고, 프레임마다 Update 후 바뀐 것이 있으면 Draw </summary>
+	class PolicyDrawer
+	{
+	public:
+		void SetBorderRect(const BorderVisual& visual, SinkCanvas& canvas)
+		{
+			painter.Paint(visual, canvas);
+		}
+
+		void SetStyle(const BorderVisual& visual) { painter.Select(SelectBorderPolicy(visual)); }
+
+	private:
+		BorderPainter<SinkCanvas> painter;
+	};
+
+	enum class Change
+	{
+		None,
+		Width,
+		Color,
+	};
+
+	BorderVisual VisualAt(int border, int frame, Change change, bool rounded, bool perEdge, bool gradient)
+	{
+		BorderVisual visual{};
+		const int32_t width = 400 + (border % 17) * 20 + (change == Change::Width ? (frame % 64) * 3 : 0);
+		visual.bounds = WindowRect{ 0, 0, width, 300 + (border % 11) * 10 };
+		visual.color = change == Change::Color ? static_cast<uint32_t>(0x00A5FF + (frame & 1) * 0x10) : 0x00A5FFu;
+		visual.thickness = 2;
+		visual.margin = 3;
+		visual.cornerRadius = rounded ? 8.0f : 0.0f;
+		if (perEdge)
+			visual.edgeThickness = { 4, 2, 2, 2 };
+		visual.gradient = gradient;
+		visual.gradientColor = gradient ? 0x00FF8000u : 0u;
+		return visual;
+	}
+
+	struct PathResult
+	{
+		double ns = 0.0;
+		uint64_t draws = 0;
+	};
+
+	template <typename Drawer>
+	BENCH_NOINLINE PathResult Run(Change change, int roundedEvery, bool perEdge = false, bool gradient = false)
+	{
+		const auto roundedAt = [roundedEvery](int border) { return roundedEvery > 0 && border % roundedEvery == 0; };
+
+		std::vector<Drawer> drawers(Borders);
+		SinkCanvas canvas;
+		for (int border = 0; border < Borders; ++border)
+		{
+			const BorderVisual visual = VisualAt(border, 0, change, roundedAt(border), perEdge, gradient);
+			if constexpr (requires(Drawer & drawer) { drawer.SetStyle(visual); })
+				drawers[border].SetStyle(visual);
+			drawers[border].SetBorderRect(visual, canvas);
+		}
+
+		// 프레임마다 만드는 visual 은 두 경로가 같으므로 미리 만들어 두고 갱신만 잼
+		std::vector<BorderVisual> frames;
+		frames.reserve(static_cast<size_t>(128) * Borders);
+		for (int frame = 1; frame <= 128; ++frame)
+		{
+			for (int border = 0; border < Borders; ++border)
+				frames.push_back(VisualAt(border, frame, change, roundedAt(border), perEdge, gradient));
+		}
+
+		canvas.draws = 0;
+		BenchTimer timer;
+		uint64_t updates = 0;
+		for (int frame = 0; frame < Frames; ++frame)
+		{
+			const BorderVisual* row = frames.data() + static_cast<size_t>(frame % 128) * Borders;
+			for (int border = 0; border < Borders; ++border)
+				drawers[border].SetBorderRect(row[border], canvas);
+			updates += Borders;
+		}
+		const double elapsed = timer.ElapsedNs();
+		DoNotOptimize(canvas.sum);
+		return PathResult{ elapsed / static_cast<double>(updates), canvas.draws };
+	}
+
+	void Report(const char* name, const PathResult& generic, const PathResult& policy)
+	{
+		std::printf("%-16s %12.2f %12.2f %8.2fx %14llu %14llu\n", name, generic.ns, policy.ns, generic.ns / policy.ns,
+			static_cast<unsigned long long>(generic.draws), static_cast<unsigned long long>(policy.draws));
+	}
+
+	void ReportPolicyOnly(const char* name, const PathResult& policy)
+	{
+		std::printf("%-16s %12s %12.2f %9s %14s %14llu\n", name, "-", policy.ns, "-", "-", static_cast<unsigned long long>(policy.draws));
+	}
+}
+
+int main()
+{
+	std::printf("%d borders x %d frames, ns per border update\n", Borders, Frames);
+	std::printf("%-16s %12s %12s %9s %14s %14s\n", "scenario", "generic ns", "policy ns", "speedup", "generic draws", "policy draws");
+
+	Report("sharp steady", Run<GenericDrawer>(Change::None, 0), Run<PolicyDrawer>(Change::None, 0));
+	Report("sharp drag", Run<GenericDrawer>(Change::Width, 0), Run<PolicyDrawer>(Change::Width, 0));
+	Report("sharp recolor", Run<GenericDrawer>(Change::Color, 0), Run<PolicyDrawer>(Change::Color, 0));
+	Report("rounded steady", Run<GenericDrawer>(Change::None, 1), Run<PolicyDrawer>(Change::None, 1));
+	Report("rounded drag", Run<GenericDrawer>(Change::Width, 1), Run<PolicyDrawer>(Change::Width, 1));
+	Report("mixed steady", Run<GenericDrawer>(Change::None, 2), Run<PolicyDrawer>(Change::None, 2));
+	Report("mixed drag", Run<GenericDrawer>(Change::Width, 2), Run<PolicyDrawer>(Change::Width, 2));
+	ReportPolicyOnly("per-edge drag", Run<PolicyDrawer>(Change::Width, 0, true));
+	ReportPolicyOnly("gradient drag", Run<PolicyDrawer>(Change::Width, 0, false, true));
+	return 0;
+}
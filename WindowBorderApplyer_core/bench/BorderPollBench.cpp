@@ -0,0 +1,139 @@
+﻿// 테두리 위치 확인 타이머가 초당 몇 번 깨어나고 DWM 을 몇 번 부르는지, 테두리마다 100 ms SetTimer 를 걸던 방식과 비교합니다.
+//  - per-border : 테두리마다 100 ms 마다 깨어나 UpdateBorderPosition + UpdateBorderProperties
+//                 (DWMWA_EXTENDED_FRAME_BOUNDS 3 번 + GetDpiForMonitor 1 번, 이벤트와 관계없이)
+//  - wheel      : BorderTracker 의 타이머 휠 하나. 움직인 직후 100 ms, 그대로면 두 배씩 늘려 3.2 s 뒤 멈춤
+// 가상 시계로 60 초를 재생합니다.
+//  - idle  : 시작 뒤 아무 창도 움직이지 않음
+//  - drag  : 10 초부터 10 초마다 창 하나를 2 초 동안 끌기 (프레임마다 LOCATIONCHANGE, 마지막 10 초는 쉼)
+// DWM 호출에는 이벤트로 위치를 맞출 때의 조회 (프레임 사각형 + DPI) 도 포함합니다.
+// 빌드: g++ -O2 -std=c++20 -I.. BorderPollBench.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o BorderPollBench
+
+#include "BenchUtil.h"
+#include "BorderTracker.h"
+#include "SimulatedWindowSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr uint64_t DurationUs = 60000000;
+	constexpr uint64_t FrameUs = 16000;
+	constexpr uint64_t LegacyIntervalUs = 100000;
+	// 테두리 하나가 100 ms 마다 부르던 DWM 조회 (프레임 사각형 3 번 + DPI 1 번)
+	constexpr uint64_t LegacyCallsPerTick = 4;
+	constexpr uint64_t DragEveryUs = 10000000;
+	constexpr uint64_t DragForUs = 2000000;
+	constexpr uint64_t SettleUs = 10000000;
+
+	/// <summary> 끌기 프레임의 다음 시각. 끄는 구간이 끝났으면 다음 구간의 시작, 마지막 10 초에는 없음 </summary>
+	uint64_t NextDragFrame(uint64_t nowUs)
+	{
+		uint64_t nextUs = nowUs + FrameUs;
+		if (nextUs % DragEveryUs >= DragForUs)
+			nextUs = (nextUs / DragEveryUs + 1) * DragEveryUs;
+		return nextUs < DurationUs - SettleUs ? nextUs : UINT64_MAX;
+	}
+
+	uint64_t CountDragFrames()
+	{
+		uint64_t frames = 0;
+		for (uint64_t t = DragEveryUs; t != UINT64_MAX; t = NextDragFrame(t))
+			frames++;
+		return frames;
+	}
+
+	WindowHandle MakeHandle(uint64_t index)
+	{
+		return HandleFromBits(0x10000 + index * 4);
+	}
+
+	struct Result
+	{
+		uint64_t wakeups = 0;
+		uint64_t dwmCalls = 0;
+		// 마지막으로 끈 뒤 10 초 (모든 창이 멈춘 구간) 의 깨어남
+		uint64_t settledWakeups = 0;
+	};
+
+	Result RunLegacy(size_t windowCount, bool drag)
+	{
+		// 타이머는 움직임과 관계없이 일정하고, 끌기 이벤트마다 조회가 더해짐
+		Result result{};
+		result.wakeups = (DurationUs / LegacyIntervalUs) * windowCount;
+		result.dwmCalls = result.wakeups * LegacyCallsPerTick + (drag ? CountDragFrames() * 2 : 0);
+		result.settledWakeups = (SettleUs / LegacyIntervalUs) * windowCount;
+		return result;
+	}
+
+	Result RunWheel(size_t windowCount, bool drag)
+	{
+		SimulatedWindowSystem windowSystem;
+		for (size_t i = 0; i < windowCount; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 40) * 30;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, x, x + 800, x + 600 });
+		}
+
+		BorderTracker tracker(windowSystem, BorderStyle{});
+		for (size_t i = 0; i < windowCount; ++i)
+			tracker.AddWindow(MakeHandle(i));
+
+		Result result{};
+		uint32_t eventTime = 0;
+		uint64_t nextFrameUs = drag ? DragEveryUs : UINT64_MAX;
+		uint64_t pollUs = tracker.Poll(0);
+		for (;;)
+		{
+			const uint64_t nowUs = std::min(nextFrameUs, pollUs == 0 ? UINT64_MAX : pollUs);
+			if (nowUs >= DurationUs)
+				break;
+
+			if (nowUs == nextFrameUs)
+			{
+				// 끄는 창 하나: 프레임마다 움직이고 이벤트 한 번 (병합 뒤)
+				const size_t dragged = static_cast<size_t>(nowUs / DragEveryUs) % windowCount;
+				SimulatedWindow* window = windowSystem.FindWindow(MakeHandle(dragged));
+				window->frame.left += 3;
+				window->frame.right += 3;
+				tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(dragged), 0, 0, 1, ++eventTime }, nowUs);
+				tracker.Flush(nowUs);
+
+				nextFrameUs = NextDragFrame(nowUs);
+			}
+			else
+			{
+				result.wakeups++;
+				if (nowUs >= DurationUs - SettleUs)
+					result.settledWakeups++;
+			}
+
+			pollUs = tracker.Poll(nowUs);
+		}
+
+		const SimulatedQueryStats& queries = windowSystem.QueryStats();
+		result.dwmCalls = queries.frameBoundsQueries + queries.dpiQueries;
+		return result;
+	}
+
+	void Print(const char* scenario, const char* mode, size_t windowCount, const Result& result)
+	{
+		const double seconds = DurationUs / 1e6;
+		std::printf("%-6s %-11s %8zu %12.1f %14.1f %16llu\n", scenario, mode, windowCount,
+			result.wakeups / seconds, result.dwmCalls / seconds, static_cast<unsigned long long>(result.settledWakeups));
+	}
+}
+
+int main()
+{
+	std::printf("%-6s %-11s %8s %12s %14s %16s\n", "", "", "windows", "wakeups/s", "dwm calls/s", "wakeups last 10s");
+	for (size_t windowCount : { 20, 200, 1000 })
+	{
+		for (bool drag : { false, true })
+		{
+			const char* scenario = drag ? "drag" : "idle";
+			Print(scenario, "per-border", windowCount, RunLegacy(windowCount, drag));
+			Print(scenario, "wheel", windowCount, RunWheel(windowCount, drag));
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,106 @@
+﻿// 창을 끌어서 옮기는 상황 (창 하나에서 초당 500 번 LOCATIONCHANGE) 을 재생하여,
+// 프레임 (16.7 ms) 마다 병합했을 때 UpdateBorderPosition (DWM 조회 + SetWindowPos) 이 얼마나 줄어드는지 봅니다.
+// 빌드: g++ -O2 -std=c++20 -I.. CoalescerBench.cpp -o CoalescerBench
+
+#include "BenchUtil.h"
+#include "EventCoalescer.h"
+
+#include <vector>
+
+namespace
+{
+	using FakeEvent = BasicWinEventHook<FakeHwnd>;
+
+	struct TimedEvent
+	{
+		uint64_t arrivalUs;
+		FakeEvent event;
+	};
+
+	std::vector<TimedEvent> MakeDragSession(size_t backgroundWindows, uint64_t durationUs, uint64_t dragIntervalUs)
+	{
+		BenchRandom random;
+		std::vector<TimedEvent> events;
+		const FakeHwnd dragged = MakeFakeHwnd(0);
+		for (uint64_t t = 0; t < durationUs; t += dragIntervalUs)
+		{
+			const uint32_t eventTime = static_cast<uint32_t>(t / 1000);
+			events.push_back({ t, FakeEvent{ WinEventId::ObjectLocationChange, dragged, 0, 0, 1, eventTime } });
+
+			// 다른 창의 간헐적인 변경
+			if (backgroundWindows && random.Below(10) == 0)
+			{
+				const FakeHwnd other = MakeFakeHwnd(1 + random.Below(backgroundWindows));
+				events.push_back({ t, FakeEvent{ WinEventId::ObjectLocationChange, other, 0, 0, 2, eventTime } });
+			}
+
+			// 늦게 도착한 오래된 이벤트 (순서 뒤바뀜)
+			if (random.Below(100) == 0 && eventTime > 20)
+				events.push_back({ t, FakeEvent{ WinEventId::ObjectLocationChange, dragged, 0, 0, 1, eventTime - 20 } });
+		}
+		events.push_back({ durationUs, FakeEvent{ WinEventId::SystemMoveSizeEnd, dragged, 0, 0, 1, static_cast<uint32_t>(durationUs / 1000) } });
+		return events;
+	}
+}
+
+int main()
+{
+	constexpr uint64_t DurationUs = 2000000;
+	constexpr uint64_t FrameUs = 16667;
+
+	std::printf("%10s %10s %14s %14s %10s %8s %14s %14s %12s\n",
+		"drag(Hz)", "events", "updates(sync)", "updates(coal)", "collapsed", "stale", "frame avg(ms)", "latency avg(ms)", "push(ns)");
+
+	for (uint64_t dragHz : { 60, 250, 500, 1000 })
+	{
+		const auto session = MakeDragSession(20, DurationUs, 1000000 / dragHz);
+
+		// 동기 처리: 위치 변경마다 한 번씩 갱신
+		uint64_t syncUpdates = 0;
+		for (const auto& timed : session)
+		{
+			if (EventCoalescer<FakeHwnd, FakeHwndBits>::KindOf(timed.event.event) == CoalescedKind::Geometry)
+				syncUpdates++;
+		}
+
+		EventCoalescer<FakeHwnd, FakeHwndBits> coalescer;
+		uint64_t coalescedUpdates = 0;
+		uint64_t nextFrameUs = FrameUs;
+		double pushNs = 0;
+		auto flush = [&](uint64_t nowUs)
+		{
+			coalescer.Flush(nowUs, [&](const CoalescedEvent<FakeHwnd>& record)
+				{
+					if (record.Has(CoalescedKind::Geometry))
+						coalescedUpdates++;
+				});
+		};
+
+		for (const auto& timed : session)
+		{
+			while (timed.arrivalUs >= nextFrameUs)
+			{
+				flush(nextFrameUs);
+				nextFrameUs += FrameUs;
+			}
+
+			BenchTimer timer;
+			coalescer.Push(timed.event, timed.arrivalUs);
+			pushNs += timer.ElapsedNs();
+		}
+		flush(nextFrameUs);
+
+		const CoalescerStats& stats = coalescer.Stats();
+		std::printf("%10llu %10llu %14llu %14llu %10llu %8llu %14.2f %14.2f %12.1f\n",
+			static_cast<unsigned long long>(dragHz),
+			static_cast<unsigned long long>(stats.received),
+			static_cast<unsigned long long>(syncUpdates),
+			static_cast<unsigned long long>(coalescedUpdates),
+			static_cast<unsigned long long>(stats.collapsed),
+			static_cast<unsigned long long>(stats.stale),
+			stats.AverageFrameIntervalUs() / 1000.0,
+			stats.AverageLatencyUs() / 1000.0,
+			pushNs / static_cast<double>(stats.received));
+	}
+	return 0;
+}
@@ -0,0 +1,130 @@
+﻿// 창마다 오버레이를 두는 방식과 모니터마다 공유 오버레이 하나에 모아 그리는 방식 (BorderCompositor) 의
+// 표면 메모리와 프레임당 반영 (Present / UpdateLayeredWindow) 횟수를 비교합니다. 모니터는 1920x1080 두 개입니다.
+//  - drag    : 창 하나를 120 프레임 동안 끌기 (프레임마다 LOCATIONCHANGE)
+//  - display : 두 번째 모니터의 배율이 바뀌어 그 모니터의 모든 테두리를 다시 그림 (OnDisplayChanged)
+// 창마다 오버레이의 메모리는 테두리 창 크기의 32 bpp 렌더 타깃, 공유 오버레이는 모니터 크기 표면의 합입니다.
+// drag us/frame 은 추적기의 프레임 시간으로, 공유 오버레이는 소프트웨어 합성을 포함하지만 창마다 오버레이는 그리기 (D2D) 를 포함하지 않습니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. CompositorBench.cpp ../BorderCompositor.cpp ../BorderRaster.cpp ../CornerMask.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o CompositorBench
+
+#include "BenchUtil.h"
+#include "BorderCompositor.h"
+#include "BorderTracker.h"
+#include "SimulatedWindowSystem.h"
+
+namespace
+{
+	constexpr uint64_t DragFrames = 120;
+	constexpr uint64_t FrameUs = 16000;
+
+	WindowHandle MakeHandle(uint64_t index)
+	{
+		return HandleFromBits(0x10000 + index * 4);
+	}
+
+	struct Result
+	{
+		uint64_t surfaceBytes = 0;
+		double dragPresentsPerFrame = 0.0;
+		double displayPresents = 0.0;
+		double dragUsPerFrame = 0.0;
+	};
+
+	void AddWindows(SimulatedWindowSystem& windowSystem, size_t windowCount)
+	{
+		windowSystem.AddMonitor(WindowRect{ 1920, 0, 3840, 1080 }, DefaultDpi);
+		for (size_t i = 0; i < windowCount; ++i)
+		{
+			// 창 절반은 두 번째 모니터, 모니터마다 계단식으로 겹침
+			const int32_t x = static_cast<int32_t>(i % 2 == 0 ? 0 : 1920) + static_cast<int32_t>(i % 40) * 25;
+			const int32_t y = static_cast<int32_t>(i % 20) * 20;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, y, x + 800, y + 600 });
+		}
+	}
+
+	/// <summary> tracker 로 끌기와 배율 변경을 재생하고, presents() 로 그동안의 반영 횟수를 셉니다 </summary>
+	template <typename CountPresents>
+	void Replay(SimulatedWindowSystem& windowSystem, BorderTracker& tracker, size_t windowCount, CountPresents&& presents, Result& result)
+	{
+		uint32_t eventTime = 0;
+		uint64_t before = presents();
+		BenchTimer timer;
+		for (uint64_t frame = 0; frame < DragFrames; ++frame)
+		{
+			const uint64_t nowUs = (frame + 1) * FrameUs;
+			SimulatedWindow* window = windowSystem.FindWindow(MakeHandle(windowCount - 1));
+			window->frame.left += 3;
+			window->frame.right += 3;
+			tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(windowCount - 1), 0, 0, 1, ++eventTime }, nowUs);
+			tracker.Flush(nowUs);
+		}
+		result.dragUsPerFrame = timer.ElapsedNs() / 1e3 / DragFrames;
+		result.dragPresentsPerFrame = static_cast<double>(presents() - before) / DragFrames;
+
+		before = presents();
+		windowSystem.SetMonitorDpi(HandleFromBits(2), 144);
+		tracker.OnDisplayChanged();
+		result.displayPresents = static_cast<double>(presents() - before);
+	}
+
+	Result RunPerWindow(size_t windowCount)
+	{
+		SimulatedWindowSystem windowSystem;
+		AddWindows(windowSystem, windowCount);
+		BorderTracker tracker(windowSystem, BorderStyle{});
+		std::vector<WindowHandle> windows{};
+		windowSystem.EnumerateWindows(windows);
+		tracker.RefreshWindows(windows);
+		tracker.AssignAll();
+
+		Result result{};
+		for (WindowHandle window : windows)
+		{
+			const WindowRect& bounds = tracker.Find(window)->presented.bounds;
+			result.surfaceBytes += static_cast<uint64_t>(bounds.Width()) * static_cast<uint64_t>(bounds.Height()) * 4;
+		}
+		Replay(windowSystem, tracker, windowCount, [&windowSystem] { return windowSystem.QueryStats().presents; }, result);
+		return result;
+	}
+
+	Result RunShared(size_t windowCount)
+	{
+		SimulatedWindowSystem windowSystem;
+		AddWindows(windowSystem, windowCount);
+		BorderCompositor compositor([](const MonitorArea& monitor)
+			{
+				return std::make_unique<SoftwareSurface>(monitor.area.Width(), monitor.area.Height());
+			});
+		compositor.SetMonitors({
+			MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 1920, 1080 } },
+			MonitorArea{ HandleFromBits(2), WindowRect{ 1920, 0, 3840, 1080 } },
+		});
+		CompositedWindowSystem composited(windowSystem, compositor);
+		BorderTracker tracker(composited, BorderStyle{});
+		std::vector<WindowHandle> windows{};
+		windowSystem.EnumerateWindows(windows);
+		tracker.RefreshWindows(windows);
+		tracker.AssignAll();
+
+		Result result{};
+		result.surfaceBytes = compositor.Stats().surfaceBytes;
+		Replay(windowSystem, tracker, windowCount, [&compositor] { return compositor.Stats().presents; }, result);
+		return result;
+	}
+
+	void Print(const char* mode, size_t windowCount, const Result& result)
+	{
+		std::printf("%-10s %8zu %14.1f %16.2f %18.0f %14.1f\n", mode, windowCount, result.surfaceBytes / (1024.0 * 1024.0),
+			result.dragPresentsPerFrame, result.displayPresents, result.dragUsPerFrame);
+	}
+}
+
+int main()
+{
+	std::printf("%-10s %8s %14s %16s %18s %14s\n", "", "windows", "surface MiB", "drag presents/f", "display presents", "drag us/frame");
+	for (size_t windowCount : { 10, 100, 500 })
+	{
+		Print("per-window", windowCount, RunPerWindow(windowCount));
+		Print("shared", windowCount, RunShared(windowCount));
+	}
+	return 0;
+}
@@ -0,0 +1,100 @@
+﻿// 둥근 테두리의 소프트웨어 그리기 비용을 직각 테두리와 비교합니다. 96 / 144 / 192 DPI 에서 다시 그릴 때마다 (RedrawBorder) 의 ns.
+//  - square   : 반지름 0 (띠 네 개)
+//  - cached   : 반지름 8 (96 DPI 기준), 모서리 덮임은 캐시 (CornerMaskCache) 에서
+//  - uncached : 같은 둥근 테두리를 프레임마다 모서리를 새로 계산 (BuildCornerMask) 하는 비용을 더한 것
+// 시나리오:
+//  - resize  : 오른쪽 아래 모서리를 300 프레임 동안 3 픽셀씩 끌기 (창 크기 버퍼 하나에 바뀐 조각만 다시 그림)
+//  - recolor : 크기는 그대로 두고 색만 번갈아 바꾸기 (모든 조각을 다시 채움)
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. CornerMaskBench.cpp ../CornerMask.cpp ../BorderRaster.cpp -o CornerMaskBench
+
+#include "BenchUtil.h"
+#include "BorderRaster.h"
+#include "CornerMask.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	constexpr int Steps = 300;
+	constexpr int32_t MaxWidth = 1600;
+	constexpr int32_t MaxHeight = 1200;
+
+	enum class Mode
+	{
+		Square,
+		Cached,
+		Uncached,
+	};
+
+	BorderVisual LocalVisual(const WindowRect& frame, uint32_t dpi, uint32_t color, float radius)
+	{
+		BorderStyle style{};
+		style.color = color;
+		style.cornerRadius = radius;
+		BorderVisual visual = ComputeBorderVisual(frame, dpi, style);
+		visual.bounds = visual.LocalRect();
+		return visual;
+	}
+
+	/// <summary> frameAt(step) / colorAt(step) 을 차례로 그린 한 프레임의 ns </summary>
+	template <typename FrameAt, typename ColorAt>
+	BENCH_NOINLINE double Replay(std::vector<uint32_t>& surface, uint32_t dpi, Mode mode, FrameAt frameAt, ColorAt colorAt)
+	{
+		const float radius = mode == Mode::Square ? 0.0f : 8.0f;
+		std::fill(surface.begin(), surface.end(), 0u);
+		BorderVisual drawn{};
+		int64_t sum = 0;
+
+		BenchTimer timer;
+		for (int step = 0; step <= Steps; ++step)
+		{
+			const BorderVisual visual = LocalVisual(frameAt(step), dpi, colorAt(step), radius);
+			if (mode == Mode::Uncached)
+			{
+				// 캐시가 없으면 그리기 전에 모서리를 새로 계산해야 함
+				const CornerMask mask = BuildCornerMask(visual.cornerRadius, visual.thickness);
+				sum += mask.coverage[0];
+			}
+			const WindowRect dirty = RedrawBorder(surface.data(), MaxWidth, drawn, visual);
+			sum += dirty.right;
+			drawn = visual;
+		}
+		const double elapsed = timer.ElapsedNs();
+		DoNotOptimize(sum);
+		return elapsed / (Steps + 1);
+	}
+
+	template <typename FrameAt, typename ColorAt>
+	void Report(const char* name, FrameAt frameAt, ColorAt colorAt)
+	{
+		std::vector<uint32_t> surface(static_cast<size_t>(MaxWidth) * MaxHeight, 0);
+		std::printf("%s: ns per redraw\n", name);
+		std::printf("%-6s %12s %12s %12s\n", "dpi", "square", "cached", "uncached");
+		for (uint32_t dpi : { 96u, 144u, 192u })
+		{
+			// 처음 한 번으로 캐시를 채움 (DPI 마다 모서리 하나)
+			Replay(surface, dpi, Mode::Cached, frameAt, colorAt);
+			const double square = Replay(surface, dpi, Mode::Square, frameAt, colorAt);
+			const double cached = Replay(surface, dpi, Mode::Cached, frameAt, colorAt);
+			const double uncached = Replay(surface, dpi, Mode::Uncached, frameAt, colorAt);
+			std::printf("%-6u %12.1f %12.1f %12.1f\n", dpi, square, cached, uncached);
+		}
+		std::printf("\n");
+	}
+}
+
+int main()
+{
+	Report("resize",
+		[](int step) { return WindowRect{ 8, 8, 408 + step * 3, 308 + step * 2 }; },
+		[](int) { return 0x0000A5FFu; });
+	Report("recolor",
+		[](int) { return WindowRect{ 8, 8, 1208, 908 }; },
+		[](int step) { return (step & 1) ? 0x0000FF00u : 0x000000FFu; });
+
+	const CornerMaskCacheStats stats = CornerMaskCache::Shared().Stats();
+	std::printf("cache: %llu builds, %llu hits, %zu masks, %zu bytes\n", static_cast<unsigned long long>(stats.builds),
+		static_cast<unsigned long long>(stats.hits), stats.masks, stats.bytes);
+	return 0;
+}
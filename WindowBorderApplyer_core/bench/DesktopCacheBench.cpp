@@ -0,0 +1,133 @@
+﻿// 포커스 변경이 대부분이고 가끔 가상 데스크톱을 전환하는 세션에서, 데스크톱 소속 조회 (Windows 에서는 COM 호출) 횟수를 비교합니다.
+//  - legacy  : 포그라운드 변경마다 보이는 모든 창을 조회 (기존 RefreshBorders)
+//  - tracker : BorderTracker 의 DesktopMembershipCache. 전환 / 클로킹 때만 해당 창을 다시 조회
+// 빌드: g++ -O2 -std=c++20 -I.. DesktopCacheBench.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o DesktopCacheBench
+
+#include "BenchUtil.h"
+#include "BorderTracker.h"
+#include "SimulatedWindowSystem.h"
+
+namespace
+{
+	constexpr uint32_t DesktopCount = 4;
+
+	struct Session
+	{
+		size_t windowCount;
+		size_t focusChanges;
+		size_t focusChangesPerSwitch;
+	};
+
+	WindowHandle MakeHandle(uint64_t index)
+	{
+		return HandleFromBits(0x10000 + index * 4);
+	}
+
+	void CreateWindows(SimulatedWindowSystem& windowSystem, size_t windowCount)
+	{
+		for (size_t i = 0; i < windowCount; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 50) * 20;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, x, x + 800, x + 600 });
+			windowSystem.MoveWindowToDesktop(MakeHandle(i), static_cast<uint32_t>(i % DesktopCount));
+		}
+	}
+
+	// 현재 데스크톱에 있는 창 하나를 고름
+	WindowHandle PickFocus(BenchRandom& random, const Session& session, uint32_t desktop)
+	{
+		const size_t perDesktop = session.windowCount / DesktopCount;
+		return MakeHandle(random.Below(perDesktop) * DesktopCount + desktop);
+	}
+
+	uint64_t RunLegacy(const Session& session)
+	{
+		SimulatedWindowSystem windowSystem;
+		CreateWindows(windowSystem, session.windowCount);
+		windowSystem.ResetQueryStats();
+
+		BenchRandom random;
+		uint32_t desktop = 0;
+		for (size_t step = 0; step < session.focusChanges; ++step)
+		{
+			if (step % session.focusChangesPerSwitch == session.focusChangesPerSwitch - 1)
+			{
+				desktop = (desktop + 1) % DesktopCount;
+				windowSystem.SwitchDesktop(desktop);
+			}
+
+			// 기존 RefreshBorders: 보이는 창마다 조회
+			windowSystem.ForEachWindow([&windowSystem](WindowHandle hwnd, const SimulatedWindow& window)
+				{
+					if (window.visible && !window.cloaked && !window.minimized)
+						windowSystem.IsOnCurrentDesktop(hwnd);
+				});
+			PickFocus(random, session, desktop);
+		}
+		return windowSystem.QueryStats().desktopQueries;
+	}
+
+	uint64_t RunTracker(const Session& session, DesktopCacheStats& cacheStats)
+	{
+		SimulatedWindowSystem windowSystem;
+		CreateWindows(windowSystem, session.windowCount);
+
+		BorderTracker tracker(windowSystem, BorderStyle{});
+		for (size_t i = 0; i < session.windowCount; ++i)
+			tracker.AddWindow(MakeHandle(i));
+		windowSystem.ResetQueryStats();
+
+		BenchRandom random;
+		uint32_t desktop = 0;
+		uint64_t nowUs = 0;
+		uint32_t eventTime = 0;
+		for (size_t step = 0; step < session.focusChanges; ++step)
+		{
+			nowUs += 20000;
+			if (step % session.focusChangesPerSwitch == session.focusChangesPerSwitch - 1)
+			{
+				desktop = (desktop + 1) % DesktopCount;
+				windowSystem.SwitchDesktop(desktop, [&](WindowHandle hwnd, bool cloaked)
+					{
+						const uint32_t event = cloaked ? WinEventId::ObjectCloaked : WinEventId::ObjectUncloaked;
+						tracker.PushEvent(BorderTracker::Event{ event, hwnd, 0, 0, 1, ++eventTime }, nowUs);
+					});
+			}
+
+			const WindowHandle focus = PickFocus(random, session, desktop);
+			tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, focus, 0, 0, 1, ++eventTime }, nowUs);
+			tracker.Flush(nowUs + 16000);
+		}
+
+		cacheStats = tracker.DesktopStats();
+		return windowSystem.QueryStats().desktopQueries;
+	}
+}
+
+int main()
+{
+	std::printf("%8s %8s %8s %14s %14s %10s %10s %8s %12s\n",
+		"windows", "focus", "switches", "legacy queries", "cached queries", "hits", "invalidate", "bumps", "ns/focus");
+
+	for (size_t windowCount : { 40, 200, 1000 })
+	{
+		const Session session{ windowCount, 10000, 250 };
+
+		DesktopCacheStats cacheStats{};
+		const uint64_t legacy = RunLegacy(session);
+		BenchTimer timer;
+		const uint64_t cached = RunTracker(session, cacheStats);
+		const double elapsedNs = timer.ElapsedNs();
+		DoNotOptimize(cached);
+
+		std::printf("%8zu %8zu %8zu %14llu %14llu %10llu %10llu %8llu %12.1f\n",
+			windowCount, session.focusChanges, session.focusChanges / session.focusChangesPerSwitch,
+			static_cast<unsigned long long>(legacy),
+			static_cast<unsigned long long>(cached),
+			static_cast<unsigned long long>(cacheStats.hits),
+			static_cast<unsigned long long>(cacheStats.invalidations),
+			static_cast<unsigned long long>(cacheStats.generationBumps),
+			elapsedNs / session.focusChanges);
+	}
+	return 0;
+}
@@ -0,0 +1,115 @@
+﻿// 창 크기 표면 하나 (창마다 오버레이) 와 네 변 표면 (EdgeStripBorder) 의 테두리당 메모리와 크기 변경 비용을 비교합니다.
+//  - memory : 흔한 창 크기와 배율에서 테두리 하나의 표면 메모리
+//  - move   : 창을 300 프레임 동안 옮기기 (할당 / 다시 그리기 없음)
+//  - width  : 오른쪽 가장자리를 300 프레임 동안 끌기 (위 / 아래 변만 다시 할당)
+//  - corner : 오른쪽 아래 모서리를 300 프레임 동안 끌기 (네 변 모두)
+// 창 크기 표면은 크기가 바뀔 때마다 창 크기 전체를 다시 할당한다고 봅니다 (FrameDrawer 의 렌더 타깃).
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. EdgeStripBench.cpp ../EdgeStripBorder.cpp ../BorderRaster.cpp ../CornerMask.cpp -o EdgeStripBench
+
+#include "BenchUtil.h"
+#include "EdgeStripBorder.h"
+
+namespace
+{
+	constexpr int Steps = 300;
+
+	uint64_t WindowSurfaceBytes(const BorderVisual& visual)
+	{
+		return static_cast<uint64_t>(visual.bounds.Area()) * sizeof(uint32_t);
+	}
+
+	/// <summary> 할당한 바이트를 세는 변 표면 </summary>
+	class CountingEdgeSurface : public SoftwareEdgeSurface
+	{
+	public:
+		CountingEdgeSurface(int32_t width, int32_t height, uint64_t& allocatedBytes) :
+			SoftwareEdgeSurface(width, height),
+			allocatedBytes(allocatedBytes)
+		{
+			allocatedBytes += Bytes(width, height);
+		}
+
+		bool Resize(int32_t width, int32_t height) override
+		{
+			allocatedBytes += Bytes(width, height);
+			return SoftwareEdgeSurface::Resize(width, height);
+		}
+
+	private:
+		uint64_t& allocatedBytes;
+
+		static uint64_t Bytes(int32_t width, int32_t height)
+		{
+			return static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * sizeof(uint32_t);
+		}
+	};
+
+	void PrintMemory(const char* name, const WindowRect& frame, uint32_t dpi)
+	{
+		BorderStyle style{};
+		const BorderVisual visual = ComputeBorderVisual(frame, dpi, style);
+		EdgeStripBorder border([](BorderEdge, int32_t width, int32_t height)
+			{
+				return std::make_unique<SoftwareEdgeSurface>(width, height);
+			});
+		border.Present(visual);
+
+		std::printf("%-22s %14.1f %14.1f %10.0fx\n", name, WindowSurfaceBytes(visual) / 1024.0, border.SurfaceBytes() / 1024.0,
+			static_cast<double>(WindowSurfaceBytes(visual)) / static_cast<double>(border.SurfaceBytes()));
+	}
+
+	/// <summary> frameAt(step) 으로 창을 움직이며 두 방식의 할당 횟수와 바이트, 변 방식의 프레임 시간 </summary>
+	template <typename FrameAt>
+	void RunDrag(const char* name, FrameAt frameAt)
+	{
+		BorderStyle style{};
+		uint64_t edgeBytes = 0;
+		EdgeStripBorder border([&edgeBytes](BorderEdge, int32_t width, int32_t height)
+			{
+				return std::make_unique<CountingEdgeSurface>(width, height, edgeBytes);
+			});
+		BorderVisual previous = ComputeBorderVisual(frameAt(0), DefaultDpi, style);
+		border.Present(previous);
+		const EdgeStripStats before = border.Stats();
+		edgeBytes = 0;
+
+		uint64_t windowAllocations = 0;
+		uint64_t windowBytes = 0;
+		BenchTimer timer;
+		for (int step = 1; step <= Steps; ++step)
+		{
+			const BorderVisual visual = ComputeBorderVisual(frameAt(step), DefaultDpi, style);
+			if (!visual.SameShape(previous))
+			{
+				windowAllocations++;
+				windowBytes += WindowSurfaceBytes(visual);
+			}
+			border.Present(visual);
+			previous = visual;
+		}
+		const double edgeUs = timer.ElapsedNs() / 1000.0 / Steps;
+
+		const EdgeStripStats& after = border.Stats();
+		std::printf("%-8s %13llu %16.1f %12llu %16.3f %14llu %12.2f\n", name,
+			static_cast<unsigned long long>(windowAllocations), windowBytes / (1024.0 * 1024.0),
+			static_cast<unsigned long long>(after.allocations - before.allocations), edgeBytes / (1024.0 * 1024.0),
+			static_cast<unsigned long long>(after.redraws - before.redraws), edgeUs);
+	}
+}
+
+int main()
+{
+	std::printf("%-22s %14s %14s %11s\n", "window (scale)", "window KiB", "edges KiB", "ratio");
+	PrintMemory("800x600 (100%)", WindowRect{ 100, 100, 900, 700 }, 96);
+	PrintMemory("1920x1080 max (100%)", WindowRect{ 0, 0, 1920, 1080 }, 96);
+	PrintMemory("2560x1440 max (125%)", WindowRect{ 0, 0, 2560, 1440 }, 120);
+	PrintMemory("3840x2160 max (150%)", WindowRect{ 0, 0, 3840, 2160 }, 144);
+	PrintMemory("3840x2160 max (200%)", WindowRect{ 0, 0, 3840, 2160 }, 192);
+
+	std::printf("\n%-8s %13s %16s %12s %16s %14s %12s\n", "drag", "window allocs", "window MiB alloc", "edge allocs", "edge MiB alloc",
+		"edge redraws", "edge us/f");
+	RunDrag("move", [](int step) { return WindowRect{ 100 + step, 100 + step / 2, 1300 + step, 900 + step / 2 }; });
+	RunDrag("width", [](int step) { return WindowRect{ 100, 100, 1300 + step, 900 }; });
+	RunDrag("corner", [](int step) { return WindowRect{ 100, 100, 1300 + step, 900 + step }; });
+	return 0;
+}
@@ -0,0 +1,159 @@
+﻿// HandleRegistry 와 기존 std::map + std::vector 조합을 10 / 100 / 1k / 10k 개 창에서 비교합니다.
+// 빌드: g++ -O2 -std=c++20 -I.. HandleRegistryBench.cpp -o HandleRegistryBench
+
+#include "BenchUtil.h"
+#include "HandleRegistry.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	struct FakeBorder
+	{
+		int thickness = 3;
+	};
+
+	// 기존 Windowmodule 의 자료 구조
+	struct MapBaseline
+	{
+		std::map<FakeHwnd, std::unique_ptr<FakeBorder>> borderedWindows;
+		std::vector<FakeHwnd> hwnds;
+
+		void Add(FakeHwnd hwnd)
+		{
+			hwnds.push_back(hwnd);
+			borderedWindows[hwnd] = std::make_unique<FakeBorder>();
+		}
+
+		FakeBorder* Lookup(FakeHwnd hwnd)
+		{
+			if (std::find(hwnds.begin(), hwnds.end(), hwnd) == hwnds.end())
+				return nullptr;
+
+			auto it = borderedWindows.find(hwnd);
+			return it != borderedWindows.end() ? it->second.get() : nullptr;
+		}
+
+		void Remove(FakeHwnd hwnd)
+		{
+			borderedWindows.erase(hwnd);
+			hwnds.erase(std::find(hwnds.begin(), hwnds.end(), hwnd));
+		}
+
+		int Iterate()
+		{
+			int sum = 0;
+			for (const auto& [window, border] : borderedWindows)
+				sum += border ? border->thickness : 0;
+			return sum;
+		}
+	};
+
+	struct RegistryCandidate
+	{
+		HandleRegistry<FakeHwnd, std::unique_ptr<FakeBorder>, FakeHwndBits> borderedWindows;
+
+		void Add(FakeHwnd hwnd)
+		{
+			borderedWindows[hwnd] = std::make_unique<FakeBorder>();
+		}
+
+		FakeBorder* Lookup(FakeHwnd hwnd)
+		{
+			auto border = borderedWindows.Find(hwnd);
+			return border ? border->get() : nullptr;
+		}
+
+		void Remove(FakeHwnd hwnd)
+		{
+			borderedWindows.Erase(hwnd);
+		}
+
+		int Iterate()
+		{
+			int sum = 0;
+			borderedWindows.ForEach([&sum](const FakeHwnd&, const std::unique_ptr<FakeBorder>& border) { sum += border ? border->thickness : 0; });
+			return sum;
+		}
+	};
+
+	struct Result
+	{
+		double lookupNs;
+		double missNs;
+		double churnNs;
+		double iterateNs;
+	};
+
+	template <typename Container>
+	Result Run(size_t windowCount)
+	{
+		constexpr size_t Operations = 200000;
+
+		Container container;
+		std::vector<FakeHwnd> live;
+		for (size_t i = 0; i < windowCount; ++i)
+		{
+			live.push_back(MakeFakeHwnd(i));
+			container.Add(live.back());
+		}
+
+		BenchRandom random;
+		std::vector<FakeHwnd> probes;
+		probes.reserve(Operations);
+		for (size_t i = 0; i < Operations; ++i)
+			probes.push_back(live[random.Below(live.size())]);
+
+		Result result{};
+		{
+			BenchTimer timer;
+			for (const auto& probe : probes)
+				DoNotOptimize(container.Lookup(probe));
+			result.lookupNs = timer.ElapsedNs() / Operations;
+		}
+		{
+			BenchTimer timer;
+			for (size_t i = 0; i < Operations; ++i)
+				DoNotOptimize(container.Lookup(MakeFakeHwnd(windowCount + 1 + i)));
+			result.missNs = timer.ElapsedNs() / Operations;
+		}
+		{
+			// 창이 닫히고 새 창이 열리는 상황 (remove + add)
+			const size_t churn = std::min<size_t>(Operations, 20000);
+			uint64_t next = windowCount;
+			BenchTimer timer;
+			for (size_t i = 0; i < churn; ++i)
+			{
+				const size_t victim = random.Below(live.size());
+				container.Remove(live[victim]);
+				live[victim] = MakeFakeHwnd(next++);
+				container.Add(live[victim]);
+			}
+			result.churnNs = timer.ElapsedNs() / churn;
+		}
+		{
+			const size_t rounds = std::max<size_t>(1, Operations / windowCount);
+			BenchTimer timer;
+			for (size_t i = 0; i < rounds; ++i)
+				DoNotOptimize(container.Iterate());
+			result.iterateNs = timer.ElapsedNs() / (rounds * windowCount);
+		}
+		return result;
+	}
+}
+
+int main()
+{
+	std::printf("%8s  %-22s %12s %12s %14s %14s\n", "windows", "container", "lookup(ns)", "miss(ns)", "remove+add(ns)", "iterate(ns/el)");
+	for (size_t windowCount : { 10, 100, 1000, 10000 })
+	{
+		const Result baseline = Run<MapBaseline>(windowCount);
+		const Result registry = Run<RegistryCandidate>(windowCount);
+		std::printf("%8zu  %-22s %12.1f %12.1f %14.1f %14.2f\n", windowCount, "std::map + vector", baseline.lookupNs, baseline.missNs, baseline.churnNs, baseline.iterateNs);
+		std::printf("%8zu  %-22s %12.1f %12.1f %14.1f %14.2f\n", windowCount, "HandleRegistry", registry.lookupNs, registry.missNs, registry.churnNs, registry.iterateNs);
+	}
+	return 0;
+}
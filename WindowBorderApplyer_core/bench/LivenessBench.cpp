@@ -0,0 +1,136 @@
+﻿// 이벤트 하나당 처리 비용을 창 개수별로 비교합니다.
+//  - scan  : 기존 방식. 매 이벤트마다 추적 중인 모든 창의 표시 여부를 확인
+//  - event : SHOW / HIDE / CLOAKED / UNCLOAKED / MINIMIZE / DESTROY 로 해당 창 하나만 갱신
+// scan 의 IsWindowVisible 은 메모리 조회로 흉내 내므로, 실제로는 프로세스 간 호출 비용이 더해집니다.
+// 빌드: g++ -O2 -std=c++20 -I.. LivenessBench.cpp -o LivenessBench
+
+#include "BenchUtil.h"
+#include "HandleRegistry.h"
+#include "WindowLiveness.h"
+
+#include <vector>
+
+namespace
+{
+	using FakeEvent = BasicWinEventHook<FakeHwnd>;
+
+	struct FakeTrackedWindow
+	{
+		bool hasBorder = true;
+		WindowLiveness liveness;
+	};
+
+	using Registry = HandleRegistry<FakeHwnd, FakeTrackedWindow, FakeHwndBits>;
+
+	// 시뮬레이션된 창 시스템의 표시 여부 (핸들 인덱스로 접근)
+	struct SimulatedVisibility
+	{
+		std::vector<uint8_t> visible;
+
+		bool IsWindowVisible(FakeHwnd hwnd) const
+		{
+			const uint64_t index = (hwnd.value - 0x10000) / 4;
+			return index < visible.size() && visible[index];
+		}
+	};
+
+	std::vector<FakeEvent> MakeEventStream(size_t windowCount, size_t eventCount)
+	{
+		BenchRandom random;
+		std::vector<FakeEvent> events;
+		events.reserve(eventCount);
+		for (size_t i = 0; i < eventCount; ++i)
+		{
+			const uint64_t roll = random.Below(100);
+			uint32_t event = WinEventId::ObjectLocationChange;
+			if (roll >= 98)
+				event = (roll & 1) ? WinEventId::ObjectCloaked : WinEventId::ObjectUncloaked;
+			else if (roll >= 96)
+				event = (roll & 1) ? WinEventId::SystemMinimizeStart : WinEventId::SystemMinimizeEnd;
+			else if (roll >= 92)
+				event = (roll & 1) ? WinEventId::ObjectHide : WinEventId::ObjectShow;
+
+			events.push_back(FakeEvent{ event, MakeFakeHwnd(random.Below(windowCount)), 0, 0, 1, static_cast<uint32_t>(i) });
+		}
+		return events;
+	}
+
+	Registry MakeRegistry(size_t windowCount)
+	{
+		Registry registry;
+		registry.Reserve(windowCount);
+		for (size_t i = 0; i < windowCount; ++i)
+			registry.Emplace(MakeFakeHwnd(i));
+		return registry;
+	}
+
+	double RunScan(size_t windowCount, const std::vector<FakeEvent>& events)
+	{
+		Registry registry = MakeRegistry(windowCount);
+		SimulatedVisibility system{ std::vector<uint8_t>(windowCount, 1) };
+		std::vector<FakeHwnd> closed;
+
+		BenchTimer timer;
+		for (const auto& event : events)
+		{
+			closed.clear();
+			for (const auto& hwnd : registry.Handles())
+			{
+				if (!system.IsWindowVisible(hwnd))
+					closed.push_back(hwnd);
+			}
+
+			for (const auto& hwnd : closed)
+				registry.Find(hwnd)->hasBorder = false;
+
+			if (event.event == WinEventId::ObjectHide)
+				system.visible[(event.hwnd.value - 0x10000) / 4] = 0;
+			else if (event.event == WinEventId::ObjectShow)
+				system.visible[(event.hwnd.value - 0x10000) / 4] = 1;
+
+			DoNotOptimize(registry.Find(event.hwnd));
+		}
+		return timer.ElapsedNs() / events.size();
+	}
+
+	double RunEventDriven(size_t windowCount, const std::vector<FakeEvent>& events)
+	{
+		Registry registry = MakeRegistry(windowCount);
+
+		BenchTimer timer;
+		for (const auto& event : events)
+		{
+			auto tracked = registry.Find(event.hwnd);
+			if (!tracked)
+				continue;
+
+			switch (ApplyLivenessEvent(tracked->liveness, event.event))
+			{
+			case LivenessTransition::Shown:
+				tracked->hasBorder = true;
+				break;
+			case LivenessTransition::Hidden:
+				tracked->hasBorder = false;
+				break;
+			default:
+				break;
+			}
+			DoNotOptimize(tracked->hasBorder);
+		}
+		return timer.ElapsedNs() / events.size();
+	}
+}
+
+int main()
+{
+	std::printf("%8s %10s %16s %16s\n", "windows", "events", "scan(ns/event)", "event(ns/event)");
+	for (size_t windowCount : { 10, 100, 1000, 10000 })
+	{
+		const size_t eventCount = windowCount >= 10000 ? 20000 : 200000;
+		const auto events = MakeEventStream(windowCount, eventCount);
+		const double scan = RunScan(windowCount, events);
+		const double eventDriven = RunEventDriven(windowCount, events);
+		std::printf("%8zu %10zu %16.1f %16.1f\n", windowCount, eventCount, scan, eventDriven);
+	}
+	return 0;
+}
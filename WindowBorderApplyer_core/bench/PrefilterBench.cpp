@@ -0,0 +1,107 @@
+﻿// 캐럿, 커서, 자식 개체 이벤트가 대부분인 전역 훅 스트림을 재생하여
+// 사전 필터가 이벤트 하나를 거부하는 데 걸리는 시간을 측정합니다.
+//  - baseline  : WinEventHook 구조체를 만들고 레지스트리에서 창을 찾은 뒤 버림 (기존 방식)
+//  - prefilter : idObject / idChild / 블룸 필터로 먼저 거부하고, 통과한 것만 레지스트리 확인
+// 빌드: g++ -O2 -std=c++20 -I.. PrefilterBench.cpp -o PrefilterBench
+
+#include "BenchUtil.h"
+#include "HandleRegistry.h"
+#include "WinEventFilter.h"
+
+#include <vector>
+
+namespace
+{
+	using FakeEvent = BasicWinEventHook<FakeHwnd>;
+	using Registry = HandleRegistry<FakeHwnd, int, FakeHwndBits>;
+
+	// 추적하지 않는 창은 핸들 공간의 뒤쪽을 사용
+	constexpr uint64_t UntrackedBase = 1000000;
+
+	std::vector<FakeEvent> MakeCaretHeavyStream(size_t trackedCount, size_t eventCount)
+	{
+		BenchRandom random;
+		std::vector<FakeEvent> events;
+		events.reserve(eventCount);
+		for (size_t i = 0; i < eventCount; ++i)
+		{
+			const uint64_t roll = random.Below(100);
+			const FakeHwnd untracked = MakeFakeHwnd(UntrackedBase + random.Below(5000));
+			const FakeHwnd tracked = MakeFakeHwnd(random.Below(trackedCount));
+			const uint32_t time = static_cast<uint32_t>(i);
+
+			if (roll < 60)
+				events.push_back({ WinEventId::ObjectLocationChange, roll < 20 ? tracked : untracked, WinEventObjectId::Caret, 0, 1, time });
+			else if (roll < 75)
+				events.push_back({ WinEventId::ObjectLocationChange, untracked, WinEventObjectId::Cursor, 0, 1, time });
+			else if (roll < 85)
+				events.push_back({ roll & 1 ? WinEventId::ObjectShow : WinEventId::ObjectHide, tracked, -4, static_cast<int32_t>(roll), 1, time });
+			else if (roll < 95)
+				events.push_back({ WinEventId::ObjectLocationChange, untracked, WinEventObjectId::Window, 0, 1, time });
+			else
+				events.push_back({ WinEventId::ObjectLocationChange, tracked, WinEventObjectId::Window, 0, 1, time });
+		}
+		return events;
+	}
+
+	// 기존 WinHookProc -> ControlWinHookEvent 경로를 흉내
+	BENCH_NOINLINE bool Baseline(const Registry& registry, uint32_t event, FakeHwnd hwnd, int32_t idObject, int32_t idChild, uint32_t thread, uint32_t time)
+	{
+		FakeEvent data{ event, hwnd, idObject, idChild, thread, time };
+		DoNotOptimize(data);
+		return registry.Contains(data.hwnd) && data.IsWindowObject();
+	}
+}
+
+int main()
+{
+	constexpr size_t EventCount = 2000000;
+
+	for (size_t trackedCount : { 100, 1000 })
+	{
+		Registry registry;
+		WinEventPrefilter<FakeHwnd, FakeHwndBits> prefilter;
+		for (size_t i = 0; i < trackedCount; ++i)
+		{
+			registry.Emplace(MakeFakeHwnd(i), 0);
+			prefilter.Track(MakeFakeHwnd(i));
+		}
+
+		const auto events = MakeCaretHeavyStream(trackedCount, EventCount);
+
+		size_t baselineAccepted = 0;
+		BenchTimer baselineTimer;
+		for (const auto& e : events)
+			baselineAccepted += Baseline(registry, e.event, e.hwnd, e.idObject, e.idChild, e.idEventThread, e.dwmsEventTime);
+		const double baselineNs = baselineTimer.ElapsedNs() / EventCount;
+
+		size_t filterPassed = 0;
+		size_t accepted = 0;
+		BenchTimer filterTimer;
+		for (const auto& e : events)
+		{
+			if (!prefilter.Accept(e.event, e.hwnd, e.idObject, e.idChild))
+				continue;
+
+			filterPassed++;
+			accepted += registry.Contains(e.hwnd);
+		}
+		const double filterNs = filterTimer.ElapsedNs() / EventCount;
+
+		std::printf("tracked %zu, events %zu\n", trackedCount, EventCount);
+		std::printf("  baseline : %6.2f ns/event, accepted %zu\n", baselineNs, baselineAccepted);
+		std::printf("  prefilter: %6.2f ns/event, passed %zu, accepted %zu (bloom false positives %zu)\n",
+			filterNs, filterPassed, accepted, filterPassed - accepted);
+
+		const WinEventFilterStats& stats = prefilter.Stats();
+		for (uint32_t slot = 0; slot < WinEventFilterStats::SlotCount; ++slot)
+		{
+			if (stats.accepted[slot] || stats.rejected[slot])
+			{
+				std::printf("    event 0x%04x: accepted %10llu rejected %10llu\n", WinEventFilterStats::EventOf(slot),
+					static_cast<unsigned long long>(stats.accepted[slot]), static_cast<unsigned long long>(stats.rejected[slot]));
+			}
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,86 @@
+﻿// 소프트웨어 래스터라이저의 채우기 처리량 (Mpixels/s) 을 구현 (scalar / sse2 / avx2) 마다 측정합니다.
+//  - full       : 1920x1080 전체 (창 크기 버퍼를 지울 때)
+//  - horizontal : 1920x2 가로 띠 (위 / 아래 테두리)
+//  - vertical   : 2x1080 세로 띠 (왼쪽 / 오른쪽 테두리, 행이 짧아 벡터 폭을 못 채움)
+//  - redraw     : 1920x1080 창의 테두리 색 바꾸기 (RedrawBorder, 기본 구현)
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. RasterBench.cpp ../BorderRaster.cpp ../CornerMask.cpp -o RasterBench
+
+#include "BenchUtil.h"
+#include "BorderRaster.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	constexpr int32_t Width = 1920;
+	constexpr int32_t Height = 1080;
+
+	/// <summary> rect 를 repeat 번 채우고 Mpixels/s 를 반환 </summary>
+	double MeasureFill(std::vector<uint32_t>& pixels, const WindowRect& rect, RasterKernel kernel, int repeat)
+	{
+		BenchTimer timer;
+		for (int i = 0; i < repeat; ++i)
+		{
+			FillPixels(pixels.data(), Width, rect, static_cast<uint32_t>(i), kernel);
+			DoNotOptimize(pixels[static_cast<size_t>(rect.top) * Width + rect.left]);
+		}
+		const double pixelCount = static_cast<double>(rect.Area()) * repeat;
+		return pixelCount / (timer.ElapsedNs() / 1000.0);
+	}
+}
+
+int main()
+{
+	std::vector<uint32_t> pixels(static_cast<size_t>(Width) * Height, 0);
+
+	struct Scenario
+	{
+		const char* name;
+		WindowRect rect;
+		int repeat;
+	};
+	const Scenario scenarios[] = {
+		{ "full", WindowRect{ 0, 0, Width, Height }, 200 },
+		{ "horizontal", WindowRect{ 0, 100, Width, 102 }, 100000 },
+		{ "vertical", WindowRect{ 100, 0, 102, Height }, 100000 },
+	};
+
+	std::printf("best kernel: %s\n", RasterKernelName(BestRasterKernel()));
+	std::printf("%-8s %-11s %12s\n", "kernel", "scenario", "Mpixels/s");
+	for (RasterKernel kernel : { RasterKernel::Scalar, RasterKernel::Sse2, RasterKernel::Avx2 })
+	{
+		if (!IsRasterKernelSupported(kernel))
+		{
+			std::printf("%-8s (not supported)\n", RasterKernelName(kernel));
+			continue;
+		}
+
+		for (const Scenario& scenario : scenarios)
+			std::printf("%-8s %-11s %12.1f\n", RasterKernelName(kernel), scenario.name, MeasureFill(pixels, scenario.rect, kernel, scenario.repeat));
+	}
+
+	// 색이 바뀔 때마다 네 띠만 다시 채움 (버퍼 전체를 지우지 않음)
+	constexpr int Redraws = 20000;
+	BorderVisual previous{};
+	previous.bounds = WindowRect{ 0, 0, Width, Height };
+	previous.thickness = 2;
+	std::fill(pixels.begin(), pixels.end(), 0);
+	RedrawBorder(pixels.data(), Width, BorderVisual{}, previous);
+
+	uint64_t redrawnPixels = 0;
+	BenchTimer redrawTimer;
+	for (int i = 0; i < Redraws; ++i)
+	{
+		BorderVisual next = previous;
+		next.color = static_cast<uint32_t>(i + 1) & 0x00FFFFFF;
+		redrawnPixels += static_cast<uint64_t>(RedrawBorder(pixels.data(), Width, previous, next).Area());
+		previous = next;
+	}
+	const double redrawNs = redrawTimer.ElapsedNs() / Redraws;
+	DoNotOptimize(redrawnPixels);
+	std::printf("%-8s %-11s %12.1f  (%.2f us/redraw, whole buffer %.2f MiB)\n", RasterKernelName(BestRasterKernel()), "redraw",
+		(2.0 * (Width - 2) * 2 + 2.0 * (Height - 6) * 2) / (redrawNs / 1000.0), redrawNs / 1000.0,
+		static_cast<double>(pixels.size() * sizeof(uint32_t)) / (1024.0 * 1024.0));
+	return 0;
+}
@@ -0,0 +1,119 @@
+﻿// 창 크기를 끄는 동안 표면 (Software 의 DIB, Direct2D 의 렌더 타깃과 그에 맞춘 테두리 창) 을 크기마다 새로 만드는 방식과
+// SurfaceBucket 으로 단계마다만 만드는 방식의 다시 할당 횟수, 할당한 바이트, 프레임 시간을 비교합니다.
+// 표면은 0 으로 채운 메모리 버퍼이고 BorderRaster 로 그립니다.
+//  - move   : 창을 300 프레임 동안 옮기기 (두 방식 모두 표면을 건드리지 않음)
+//  - width  : 오른쪽 가장자리를 300 프레임 동안 3 픽셀씩 끌기
+//  - corner : 오른쪽 아래 모서리를 300 프레임 동안 3 픽셀씩 끌기
+//  - shrink : 오른쪽 아래 모서리를 300 프레임 동안 4 픽셀씩 안으로 끌기
+//  - jitter : 단계 경계 (너비 1504) 를 사이에 두고 모서리를 앞뒤로 흔들기
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. ResizeDragBench.cpp ../BorderRaster.cpp ../CornerMask.cpp -o ResizeDragBench
+
+#include "BenchUtil.h"
+#include "BorderRaster.h"
+#include "SurfaceBucket.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+	constexpr int Steps = 300;
+
+	struct DragResult
+	{
+		uint64_t reallocations = 0;
+		uint64_t allocatedBytes = 0;
+		uint64_t peakBytes = 0;
+		double frameUs = 0.0;
+	};
+
+	/// <summary> 크기가 바뀐 프레임만 표면에 그리며 (옮기기만 하면 건드리지 않음) 끌기를 재생합니다 </summary>
+	template <typename FrameAt>
+	DragResult Replay(FrameAt frameAt, bool bucketed)
+	{
+		BorderStyle style{};
+		SurfaceBucket bucket{};
+		std::vector<uint32_t> surface;
+		size_t stride = 0;
+		BorderVisual drawn{};
+		BorderVisual presented{};
+		DragResult result{};
+
+		BenchTimer timer;
+		for (int step = 0; step <= Steps; ++step)
+		{
+			const BorderVisual visual = ComputeBorderVisual(frameAt(step), DefaultDpi, style);
+			if (step != 0 && visual.SameShape(presented))
+				continue;
+			presented = visual;
+
+			const BorderVisual local = [&visual]()
+				{
+					BorderVisual copy = visual;
+					copy.bounds = visual.LocalRect();
+					return copy;
+				}();
+			const int32_t width = local.bounds.Width();
+			const int32_t height = local.bounds.Height();
+
+			bool reallocate = false;
+			int32_t allocatedWidth = width;
+			int32_t allocatedHeight = height;
+			if (bucketed)
+			{
+				reallocate = bucket.Fit(width, height);
+				allocatedWidth = bucket.AllocatedWidth();
+				allocatedHeight = bucket.AllocatedHeight();
+			}
+			else
+			{
+				reallocate = surface.empty() || !local.SameShape(drawn);
+			}
+
+			if (reallocate)
+			{
+				// 새 렌더 타깃 / DIB 와 같이 새 메모리를 0 으로 채워 받음
+				std::vector<uint32_t>().swap(surface);
+				surface.assign(static_cast<size_t>(allocatedWidth) * static_cast<size_t>(allocatedHeight), 0);
+				stride = static_cast<size_t>(allocatedWidth);
+				drawn = BorderVisual{};
+				result.reallocations++;
+				result.allocatedBytes += surface.size() * sizeof(uint32_t);
+				result.peakBytes = std::max<uint64_t>(result.peakBytes, surface.size() * sizeof(uint32_t));
+			}
+
+			RedrawBorder(surface.data(), stride, drawn, local);
+			drawn = local;
+			DoNotOptimize(surface.data());
+		}
+		result.frameUs = timer.ElapsedNs() / 1000.0 / Steps;
+		return result;
+	}
+
+	template <typename FrameAt>
+	void RunDrag(const char* name, FrameAt frameAt)
+	{
+		const DragResult exact = Replay(frameAt, false);
+		const DragResult bucketed = Replay(frameAt, true);
+		std::printf("%-8s %12llu %14.1f %11.2f %13llu %15.1f %12.1f %12.2f\n", name,
+			static_cast<unsigned long long>(exact.reallocations), exact.allocatedBytes / (1024.0 * 1024.0), exact.frameUs,
+			static_cast<unsigned long long>(bucketed.reallocations), bucketed.allocatedBytes / (1024.0 * 1024.0),
+			bucketed.peakBytes / (1024.0 * 1024.0), bucketed.frameUs);
+	}
+}
+
+int main()
+{
+	std::printf("%-8s %12s %14s %11s %13s %15s %12s %12s\n", "drag", "exact allocs", "exact MiB", "exact us/f",
+		"bucket allocs", "bucket MiB", "bucket peak", "bucket us/f");
+	RunDrag("move", [](int step) { return WindowRect{ 100 + step, 100 + step / 2, 1300 + step, 900 + step / 2 }; });
+	RunDrag("width", [](int step) { return WindowRect{ 100, 100, 1300 + step * 3, 900 }; });
+	RunDrag("corner", [](int step) { return WindowRect{ 100, 100, 1300 + step * 3, 900 + step * 3 }; });
+	RunDrag("shrink", [](int step) { return WindowRect{ 100, 100, 2500 - step * 4, 1500 - step * 4 }; });
+	RunDrag("jitter", [](int step)
+		{
+			const int offset = (step % 40 < 20) ? step % 20 : 20 - step % 20;
+			return WindowRect{ 100, 100, 1554 + offset * 6, 900 + offset * 6 };
+		});
+	return 0;
+}
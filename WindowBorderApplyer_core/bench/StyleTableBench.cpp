@@ -0,0 +1,180 @@
+﻿// 테두리마다 스타일 값을 통째로 (BorderVisual) 들고 있던 방식과 스타일 표 (BorderStyleTable) 의 번호만 드는 방식을 비교합니다.
+//  - memory  : 창 1000 개에서 테두리 하나가 기억하는 바이트 (추적기, 장면 노드 두 개, 표시 명령, 그리기 상태). 표는 창 수로 나눔
+//  - place   : 위치가 바뀔 때마다 스타일을 DPI 로 다시 해석 (ComputeBorderVisual) 하는 것과 표에서 번호로 찾는 것 (Place + Expand).
+//              스타일이 고정이라 컴파일러가 해석을 반복 밖으로 뺄 수 있으므로 앞의 값은 하한
+//  - recolor : 창 1000 개의 색을 바꾸는 비용 (BorderTracker::SetStyle, 위치 조회 없이 다시 표시)
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. StyleTableBench.cpp ../BorderStyleTable.cpp ../BorderTracker.cpp -o StyleTableBench
+
+#include "BenchUtil.h"
+#include "BorderPipeline.h"
+#include "BorderPolicy.h"
+#include "BorderStyleTable.h"
+#include "BorderTracker.h"
+#include "SimulatedWindowSystem.h"
+
+#include <tuple>
+#include <vector>
+
+namespace
+{
+	constexpr uint64_t Windows = 1000;
+
+	struct NullCanvas
+	{
+		void StrokeRect(const BorderRectF&, int32_t, uint32_t, uint8_t) {}
+		void StrokeRoundedRect(const BorderRectF&, float, int32_t, uint32_t, uint8_t) {}
+		void FillRect(const WindowRect&, uint32_t, uint8_t) {}
+		void StrokeGradientRect(const BorderRectF&, float, int32_t, uint32_t, uint32_t, uint8_t) {}
+	};
+
+	// 이전 BorderPainter 의 배치: 정책마다 모양을 하나씩 (tuple)
+	struct LegacyPainter
+	{
+		void* update;
+		void* draw;
+		void* paint;
+		std::tuple<SharpBorderPolicy::Shape, RoundedBorderPolicy::Shape, PerEdgeBorderPolicy::Shape, GradientBorderPolicy::Shape> shapes;
+		BorderPolicyKind policy;
+		bool selected;
+		uint8_t pending;
+	};
+
+	struct LegacyCommand
+	{
+		PresentOp op;
+		uint32_t overlay;
+		WindowHandle target;
+		BorderVisual visual;
+		uint64_t enqueueUs;
+	};
+
+	WindowHandle MakeHandle(uint64_t index)
+	{
+		return HandleFromBits(0x40000 + index * 4);
+	}
+
+	void ReportMemory()
+	{
+		BorderStyleTable styles(BorderStyle{});
+		for (uint32_t dpi : { 96u, 120u, 144u, 192u })
+			styles.Resolve(dpi);
+		// 표 자체와 채운 묶음 하나를 창 수로 나눔
+		const double table = static_cast<double>(sizeof(BorderStyleTable) + BorderStyleTable::ChunkSize * sizeof(ResolvedStyle)) / Windows;
+
+		const size_t before[] = { sizeof(BorderVisual), 2 * sizeof(BorderVisual), sizeof(LegacyCommand), sizeof(LegacyPainter) };
+		const size_t after[] = { sizeof(BorderPlacement), 2 * sizeof(BorderPlacement), sizeof(PresentCommand), sizeof(BorderPainter<NullCanvas>) };
+		const char* names[] = { "tracker presented", "scene nodes (x2)", "present command", "painter" };
+
+		std::printf("memory: bytes per border at %llu windows\n", static_cast<unsigned long long>(Windows));
+		std::printf("%-20s %10s %10s\n", "part", "before", "after");
+		size_t beforeTotal = 0;
+		size_t afterTotal = 0;
+		for (size_t i = 0; i < 4; ++i)
+		{
+			std::printf("%-20s %10zu %10zu\n", names[i], before[i], after[i]);
+			beforeTotal += before[i];
+			afterTotal += after[i];
+		}
+		std::printf("%-20s %10s %10.1f\n", "style table", "-", table);
+		std::printf("%-20s %10zu %10.1f  (%.1f KB -> %.1f KB)\n\n", "total", beforeTotal, static_cast<double>(afterTotal) + table,
+			static_cast<double>(beforeTotal * Windows) / 1024.0, (static_cast<double>(afterTotal) + table) * Windows / 1024.0);
+	}
+
+	BENCH_NOINLINE double RunCompute(const std::vector<WindowRect>& frames, const BorderStyle& style, int rounds)
+	{
+		BenchTimer timer;
+		int64_t sum = 0;
+		for (int round = 0; round < rounds; ++round)
+		{
+			for (size_t i = 0; i < frames.size(); ++i)
+			{
+				const BorderVisual visual = ComputeBorderVisual(frames[i], (i < frames.size() / 2) ? 96u : 144u, style);
+				sum += visual.bounds.left + visual.thickness;
+			}
+		}
+		const double elapsed = timer.ElapsedNs();
+		DoNotOptimize(sum);
+		return elapsed / static_cast<double>(frames.size() * rounds);
+	}
+
+	BENCH_NOINLINE double RunPlace(const std::vector<WindowRect>& frames, BorderStyleTable& styles, int rounds)
+	{
+		BenchTimer timer;
+		int64_t sum = 0;
+		for (int round = 0; round < rounds; ++round)
+		{
+			for (size_t i = 0; i < frames.size(); ++i)
+			{
+				const BorderVisual visual = styles.Expand(styles.Place(frames[i], (i < frames.size() / 2) ? 96u : 144u));
+				sum += visual.bounds.left + visual.thickness;
+			}
+		}
+		const double elapsed = timer.ElapsedNs();
+		DoNotOptimize(sum);
+		return elapsed / static_cast<double>(frames.size() * rounds);
+	}
+
+	void ReportPlace()
+	{
+		constexpr int Rounds = 2000;
+		std::vector<WindowRect> frames;
+		BenchRandom random{};
+		for (uint64_t i = 0; i < Windows; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(random.Below(1600));
+			const int32_t y = static_cast<int32_t>(random.Below(900));
+			frames.push_back(WindowRect{ x, y, x + 300 + static_cast<int32_t>(random.Below(600)), y + 200 + static_cast<int32_t>(random.Below(400)) });
+		}
+
+		BorderStyle style{};
+		style.edgeThickness = { 3.0f, 1.0f, 1.0f, 1.0f };
+		BorderStyleTable styles(style);
+		const double compute = RunCompute(frames, style, Rounds);
+		const double place = RunPlace(frames, styles, Rounds);
+		std::printf("place: ns per border update (2 monitors, 96 / 144 DPI)\n");
+		std::printf("%-20s %10.2f\n%-20s %10.2f\n", "ComputeBorderVisual", compute, "Place + Expand", place);
+		std::printf("%-20s %10llu / %llu\n\n", "resolves / hits", static_cast<unsigned long long>(styles.Stats().resolves),
+			static_cast<unsigned long long>(styles.Stats().hits));
+	}
+
+	void ReportRecolor()
+	{
+		constexpr int Rounds = 50;
+		SimulatedWindowSystem windowSystem{};
+		for (uint64_t i = 0; i < Windows; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 40) * 40;
+			const int32_t y = static_cast<int32_t>(i / 40) * 30;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, y, x + 400, y + 300 });
+		}
+
+		BorderTracker tracker(windowSystem, BorderStyle{}, GeometryPollPolicy{ 0, 0 });
+		for (uint64_t i = 0; i < Windows; ++i)
+			tracker.AddWindow(MakeHandle(i));
+
+		const SimulatedQueryStats before = windowSystem.QueryStats();
+		BorderStyle style{};
+		size_t restyled = 0;
+		BenchTimer timer;
+		for (int round = 0; round < Rounds; ++round)
+		{
+			style.color = (round & 1) ? 0x00FF00u : 0x0000FFu;
+			restyled += tracker.SetStyle(style);
+		}
+		const double elapsed = timer.ElapsedNs();
+
+		std::printf("recolor: %llu windows x %d\n", static_cast<unsigned long long>(Windows), Rounds);
+		std::printf("%-20s %10.2f\n", "ns per border", elapsed / static_cast<double>(restyled));
+		std::printf("%-20s %10.2f\n", "us per recolor", elapsed / Rounds / 1000.0);
+		std::printf("%-20s %10llu\n", "frame queries", static_cast<unsigned long long>(windowSystem.QueryStats().frameBoundsQueries - before.frameBoundsQueries));
+		std::printf("%-20s %10zu\n", "style records", tracker.Styles().Size());
+	}
+}
+
+int main()
+{
+	ReportMemory();
+	ReportPlace();
+	ReportRecolor();
+	return 0;
+}
@@ -0,0 +1,336 @@
+﻿// WinEvent 기록을 시뮬레이션 창 시스템 위에서 재생하여 추적 전략을 비교합니다.
+//  - sync      : 기존 방식. 추적 중인 창의 이벤트마다 바로 프레임 사각형 / 표시 상태를 조회
+//  - tracker   : BorderTracker (사전 필터 + 프레임 단위 병합 + 이벤트 기반 표시 상태, 현재 Windowmodule 이 사용)
+// 인자가 없으면 창 끌기 + 캐럿 폭주 세션을 만들어 재생하고, 인자로 기록 파일 (--trace 로 만든 것) 을 받을 수 있습니다.
+//   TraceReplayBench [기록 파일] [--realtime [배속]] [--save 경로]
+// 빌드: g++ -O2 -std=c++20 -I.. TraceReplayBench.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o TraceReplayBench
+
+#include "BenchUtil.h"
+#include "BorderTracker.h"
+#include "EventCoalescer.h"
+#include "HandleRegistry.h"
+#include "SimulatedWindowSystem.h"
+#include "TraceReplayer.h"
+#include "WinEventFilter.h"
+#include "WinEventTrace.h"
+#include "WindowLiveness.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	using Event = TraceReplayer::Event;
+
+	struct StrategyCounters
+	{
+		uint64_t borderUpdates = 0;
+		uint64_t borderShows = 0;
+		uint64_t borderHides = 0;
+	};
+
+	// 기존 ControlWinHookEvent: 이벤트마다 즉시 처리
+	class SyncStrategy
+	{
+	public:
+		explicit SyncStrategy(SimulatedWindowSystem& windowSystem) : windowSystem(windowSystem) {}
+
+		void Track(WindowHandle hwnd) { tracked.Emplace(hwnd, uint8_t{ 1 }); }
+
+		void OnEvent(const Event& event, uint64_t)
+		{
+			if (!tracked.Contains(event.hwnd) || !event.IsWindowObject())
+				return;
+
+			switch (event.event)
+			{
+			case WinEventId::ObjectDestroy:
+				tracked.Erase(event.hwnd);
+				break;
+			case WinEventId::ObjectLocationChange:
+			case WinEventId::SystemMoveSizeEnd:
+				if (windowSystem.GetFrameBounds(event.hwnd, frame))
+					counters.borderUpdates++;
+				break;
+			case WinEventId::ObjectShow:
+			case WinEventId::ObjectHide:
+			case WinEventId::ObjectCloaked:
+			case WinEventId::ObjectUncloaked:
+			case WinEventId::SystemMinimizeStart:
+			case WinEventId::SystemMinimizeEnd:
+			{
+				const bool live = windowSystem.QueryLiveness(event.hwnd).IsLive();
+				uint8_t& wasLive = tracked[event.hwnd];
+				if (live != static_cast<bool>(wasLive))
+					(live ? counters.borderShows : counters.borderHides)++;
+				wasLive = live;
+				break;
+			}
+			default:
+				break;
+			}
+		}
+
+		void OnFrame(uint64_t) {}
+
+		StrategyCounters Counters() const noexcept { return counters; }
+
+	private:
+		SimulatedWindowSystem& windowSystem;
+		HandleRegistry<WindowHandle, uint8_t> tracked{};
+		StrategyCounters counters{};
+		WindowRect frame{};
+	};
+
+	// 현재 Windowmodule 과 같은 BorderTracker: 사전 필터 -> 병합 -> 프레임마다 반영
+	class TrackerStrategy
+	{
+	public:
+		explicit TrackerStrategy(SimulatedWindowSystem& windowSystem) : windowSystem(windowSystem), tracker(windowSystem, BorderStyle{}) {}
+
+		void Track(WindowHandle hwnd) { tracker.AddWindow(hwnd); }
+
+		void OnEvent(const Event& event, uint64_t arrivalUs)
+		{
+			if (tracker.Accept(event.event, event.hwnd, event.idObject, event.idChild))
+				tracker.PushEvent(event, arrivalUs);
+		}
+
+		void OnFrame(uint64_t nowUs) { tracker.Flush(nowUs); }
+
+		StrategyCounters Counters() const noexcept
+		{
+			const SimulatedQueryStats& stats = windowSystem.QueryStats();
+			return StrategyCounters{ stats.presents, stats.overlaysCreated, stats.overlaysDestroyed };
+		}
+
+		const BorderTracker& Tracker() const noexcept { return tracker; }
+
+	private:
+		SimulatedWindowSystem& windowSystem;
+		BorderTracker tracker;
+	};
+
+	uint64_t MakeHandleBits(uint64_t index)
+	{
+		return 0x10000 + index * 4;
+	}
+
+	// 창 20 개, 그 중 하나를 2 초 동안 500 Hz 로 끌고, 다른 프로세스의 캐럿 / 커서 이벤트가 섞인 세션
+	void SynthesizeSession(WinEventTraceWriter& writer)
+	{
+		constexpr uint64_t WindowCount = 20;
+		constexpr uint64_t DurationUs = 2000000;
+		constexpr uint64_t DragIntervalUs = 2000;
+
+		BenchRandom random;
+		TraceRecord record{};
+		record.idEventThread = 100;
+
+		auto append = [&](uint64_t arrivalUs, uint32_t event, uint64_t hwnd, int32_t idObject, bool withRect, const WindowRect& rect)
+		{
+			record.arrivalUs = arrivalUs;
+			record.event = event;
+			record.hwnd = hwnd;
+			record.idObject = idObject;
+			record.idChild = 0;
+			record.dwmsEventTime = static_cast<uint32_t>(1000000 + arrivalUs / 1000);
+			record.hasRect = withRect;
+			record.rect = withRect ? rect : WindowRect{};
+			writer.Append(record);
+		};
+
+		for (uint64_t i = 0; i < WindowCount; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(40 * i);
+			append(i, WinEventId::ObjectShow, MakeHandleBits(i), WinEventObjectId::Window, true, WindowRect{ x, x, x + 800, x + 600 });
+		}
+
+		WindowRect dragged{ 0, 0, 800, 600 };
+		// 복원할 시각과 창. 도착 시간이 되돌아가지 않도록 시간이 되면 기록
+		std::vector<std::pair<uint64_t, uint64_t>> restores;
+		for (uint64_t t = 100; t < DurationUs; t += DragIntervalUs)
+		{
+			while (!restores.empty() && restores.front().first <= t)
+			{
+				append(restores.front().first, WinEventId::SystemMinimizeEnd, restores.front().second, WinEventObjectId::Window, false, {});
+				restores.erase(restores.begin());
+			}
+
+			dragged.left += 2;
+			dragged.right += 2;
+			dragged.top += 1;
+			dragged.bottom += 1;
+			append(t, WinEventId::ObjectLocationChange, MakeHandleBits(0), WinEventObjectId::Window, true, dragged);
+
+			// 다른 프로세스의 캐럿 / 커서
+			for (uint64_t burst = random.Below(8); burst > 0; --burst)
+			{
+				const int32_t idObject = random.Below(4) ? WinEventObjectId::Caret : WinEventObjectId::Cursor;
+				append(t + burst, WinEventId::ObjectLocationChange, MakeHandleBits(1000 + random.Below(200)), idObject, false, {});
+			}
+
+			// 가끔 다른 창을 최소화 / 복원
+			if (random.Below(200) == 0)
+			{
+				const uint64_t other = MakeHandleBits(1 + random.Below(WindowCount - 1));
+				append(t + 10, WinEventId::SystemMinimizeStart, other, WinEventObjectId::Window, false, {});
+				restores.emplace_back(t + 300000, other);
+			}
+		}
+		append(DurationUs, WinEventId::SystemMoveSizeEnd, MakeHandleBits(0), WinEventObjectId::Window, true, dragged);
+		append(DurationUs + 1000, WinEventId::ObjectDestroy, MakeHandleBits(WindowCount - 1), WinEventObjectId::Window, false, {});
+	}
+
+	// 기록에서 최상위 창 이벤트를 받는 창을 기록 시작 전부터 있던 창으로 보고 미리 추적
+	// (프로그램 시작 시 EnumWindows 에 해당). 위치는 그 창의 첫 사각형을 사용
+	template <typename Strategy>
+	void TrackInitialWindows(WinEventTraceReader& reader, Strategy& strategy, SimulatedWindowSystem& windowSystem)
+	{
+		TraceRecord record{};
+		std::vector<WindowHandle> initial;
+		reader.Rewind();
+		while (reader.Next(record))
+		{
+			if (record.idObject != WinEventObjectId::Window || record.idChild != WinEventObjectId::ChildSelf)
+				continue;
+
+			const WindowHandle hwnd = HandleFromBits(record.hwnd);
+			if (!windowSystem.HasWindow(hwnd))
+			{
+				windowSystem.AddWindow(hwnd, record.rect);
+				initial.push_back(hwnd);
+			}
+			else if (record.hasRect && windowSystem.FindWindow(hwnd)->frame.IsEmpty())
+				windowSystem.FindWindow(hwnd)->frame = record.rect;
+		}
+		reader.Rewind();
+
+		for (WindowHandle hwnd : initial)
+			strategy.Track(hwnd);
+		windowSystem.ResetQueryStats();
+	}
+
+	template <typename Strategy>
+	ReplayResult Replay(const char* name, WinEventTraceReader& reader, const ReplayOptions& options, Strategy& strategy, SimulatedWindowSystem& windowSystem)
+	{
+		TrackInitialWindows(reader, strategy, windowSystem);
+
+		TraceReplayer replayer(windowSystem, options);
+		const ReplayResult result = replayer.Run(reader,
+			[&strategy](const Event& event, uint64_t arrivalUs) { strategy.OnEvent(event, arrivalUs); },
+			[&strategy](uint64_t nowUs) { strategy.OnFrame(nowUs); });
+
+		const SimulatedQueryStats& queries = windowSystem.QueryStats();
+		const StrategyCounters counters = strategy.Counters();
+		const double wallSeconds = static_cast<double>(result.wallDurationUs) / 1e6;
+		std::printf("  %-10s: %10.0f events/s, frame bounds queries %6llu, state %4llu, dpi %6llu, desktop %4llu, updates %6llu, shows %llu, hides %llu%s\n",
+			name,
+			wallSeconds > 0 ? static_cast<double>(result.events) / wallSeconds : 0.0,
+			static_cast<unsigned long long>(queries.frameBoundsQueries),
+			static_cast<unsigned long long>(queries.stateQueries),
+			static_cast<unsigned long long>(queries.dpiQueries),
+			static_cast<unsigned long long>(queries.desktopQueries),
+			static_cast<unsigned long long>(counters.borderUpdates),
+			static_cast<unsigned long long>(counters.borderShows),
+			static_cast<unsigned long long>(counters.borderHides),
+			result.complete ? "" : " (truncated trace)");
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const char* tracePath = nullptr;
+	const char* savePath = nullptr;
+	ReplayOptions options{};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::strcmp(argv[i], "--realtime") == 0)
+		{
+			options.pacing = ReplayPacing::Realtime;
+			if (i + 1 < argc && std::atof(argv[i + 1]) > 0.0)
+				options.speed = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+			savePath = argv[++i];
+		else
+			tracePath = argv[i];
+	}
+
+	WinEventTraceReader reader;
+	if (tracePath != nullptr)
+	{
+		if (!reader.Open(tracePath))
+		{
+			std::fprintf(stderr, "cannot read trace: %s\n", tracePath);
+			return 1;
+		}
+	}
+	else
+	{
+		WinEventTraceWriter writer;
+		BenchTimer writeTimer;
+		SynthesizeSession(writer);
+		const double writeNs = writeTimer.ElapsedNs();
+		std::printf("synthesized %llu events, %llu bytes (%.2f bytes/event, %.1f ns/event to encode)\n",
+			static_cast<unsigned long long>(writer.RecordCount()),
+			static_cast<unsigned long long>(writer.BytesWritten()),
+			static_cast<double>(writer.BytesWritten() - WinEventTraceFormat::HeaderSize) / static_cast<double>(writer.RecordCount()),
+			writeNs / static_cast<double>(writer.RecordCount()));
+
+		if (savePath != nullptr)
+		{
+			WinEventTraceWriter fileWriter;
+			if (fileWriter.Open(savePath))
+				SynthesizeSession(fileWriter);
+		}
+		reader.OpenBuffer(writer.Buffer());
+	}
+
+	// 디코딩 비용
+	{
+		TraceRecord record{};
+		uint64_t count = 0;
+		BenchTimer readTimer;
+		while (reader.Next(record))
+		{
+			DoNotOptimize(record);
+			count++;
+		}
+		std::printf("trace %zu bytes, %llu events, %.1f ns/event to decode\n", reader.SizeBytes(),
+			static_cast<unsigned long long>(count), count ? readTimer.ElapsedNs() / static_cast<double>(count) : 0.0);
+
+		if (!reader.AtEnd())
+		{
+			std::fprintf(stderr, "trace is corrupt after %llu events\n", static_cast<unsigned long long>(count));
+			return 1;
+		}
+	}
+
+	{
+		SimulatedWindowSystem windowSystem;
+		SyncStrategy sync(windowSystem);
+		Replay("sync", reader, options, sync, windowSystem);
+	}
+
+	{
+		SimulatedWindowSystem windowSystem;
+		TrackerStrategy tracker(windowSystem);
+		const ReplayResult result = Replay("tracker", reader, options, tracker, windowSystem);
+
+		const CoalescerStats& stats = tracker.Tracker().EventStats();
+		const WinEventFilterStats& filterStats = tracker.Tracker().FilterStats();
+		std::printf("  %-10s  prefilter passed %llu / rejected %llu, collapsed %llu, stale %llu, frames %llu, latency avg %.2f ms\n", "",
+			static_cast<unsigned long long>(filterStats.TotalAccepted()),
+			static_cast<unsigned long long>(filterStats.TotalRejected()),
+			static_cast<unsigned long long>(stats.collapsed),
+			static_cast<unsigned long long>(stats.stale),
+			static_cast<unsigned long long>(result.frames),
+			stats.AverageLatencyUs() / 1000.0);
+	}
+	return 0;
+}
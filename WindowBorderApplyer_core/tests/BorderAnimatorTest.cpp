@@ -0,0 +1,312 @@
+﻿// BorderAnimator 가 이징 표대로 색을 이어 바꾸고 깜빡임 뒤에 원래 색으로 돌아오는지, 프레임 간격보다 자주 불러도 계산하지 않는지,
+// 움직이는 것이 없으면 Tick 이 0 (깨어날 필요 없음) 인지 가상 시각으로 검사합니다. 파이프라인에서는 스타일 변경이 표시 단계에서
+// 바로 그리지 않고 Animate 로 이어서 바뀌는지, EVENT_OBJECT_FOCUS 가 다른 추적 창으로 넘어갈 때만 깜빡이는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. BorderAnimatorTest.cpp ../BorderAnimator.cpp ../BorderScene.cpp ../BorderPipeline.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp ../WorkStealingPool.cpp -o BorderAnimatorTest
+
+#include "TestUtil.h"
+#include "BorderAnimator.h"
+#include "BorderPipeline.h"
+#include "SimulatedWindowSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t Red = 0x000000FF;
+	constexpr uint32_t Blue = 0x00FF0000;
+	constexpr uint32_t White = 0x00FFFFFF;
+
+	BorderAnimationOptions FadeOptions()
+	{
+		BorderAnimationOptions options{};
+		options.fadeUs = 160000;
+		options.frameIntervalUs = 16000;
+		return options;
+	}
+
+	/// <summary> 움직이는 것이 없어질 때까지 프레임 시각마다 Tick. 알린 색을 노드마다 모읍니다 </summary>
+	size_t RunToEnd(BorderAnimator& animator, uint64_t& nowUs, std::unordered_map<uint32_t, std::vector<uint32_t>>& colors)
+	{
+		size_t frames = 0;
+		for (uint64_t delayUs = animator.Tick(nowUs, [&colors](uint32_t node, uint32_t color) { colors[node].push_back(color); }); delayUs != 0;
+			delayUs = animator.Tick(nowUs, [&colors](uint32_t node, uint32_t color) { colors[node].push_back(color); }))
+		{
+			nowUs += delayUs;
+			frames++;
+		}
+		return frames;
+	}
+
+	// 표는 0 에서 256 까지 줄지 않고, 가운데를 중심으로 대칭
+	void TestEasingTable()
+	{
+		const EasingTable& easing = EasingTable::Shared();
+		CHECK_EQ(easing.Weight(0), 0);
+		CHECK_EQ(easing.Weight(65536), EasingTable::One);
+		CHECK_EQ(easing.Weight(32768), EasingTable::One / 2);
+		bool monotonic = true;
+		bool symmetric = true;
+		for (uint32_t progress = 256; progress <= 65536; progress += 256)
+		{
+			monotonic &= easing.Weight(progress) >= easing.Weight(progress - 256);
+			const int32_t sum = static_cast<int32_t>(easing.Weight(progress) + easing.Weight(65536 - progress));
+			symmetric &= sum >= 255 && sum <= 257;
+		}
+		CHECK(monotonic);
+		CHECK(symmetric);
+
+		CHECK_EQ(BlendColor(Red, Blue, 0), Red);
+		CHECK_EQ(BlendColor(Red, Blue, 256), Blue);
+		CHECK_EQ(BlendColor(0x00000000, 0x00FF8040, 128), 0x00804020u);
+	}
+
+	// 색 이어 바꾸기: 프레임 간격마다 한 번, 끝나면 최종 색을 알리고 쉼
+	void TestFade()
+	{
+		BorderAnimator animator(FadeOptions());
+		uint64_t nowUs = 1000000;
+		CHECK_EQ(animator.Tick(nowUs, [](uint32_t, uint32_t) {}), 0);
+
+		animator.Fade(3, Red, Blue, nowUs);
+		CHECK(animator.IsAnimating(3));
+		uint32_t current = 0;
+		CHECK(animator.CurrentColor(3, current));
+		CHECK_EQ(current, Red);
+
+		// 프레임 시각 전에는 계산하지 않음
+		CHECK_EQ(animator.Tick(nowUs + 5000, [](uint32_t, uint32_t) {}), 11000);
+		CHECK_EQ(animator.Stats().frames, 0);
+
+		std::unordered_map<uint32_t, std::vector<uint32_t>> colors{};
+		const size_t frames = RunToEnd(animator, nowUs, colors);
+		CHECK_EQ(frames, 10);
+		CHECK_EQ(animator.Stats().frames, 10);
+		CHECK_EQ(colors[3].back(), Blue);
+		bool monotonic = true;
+		for (size_t i = 1; i < colors[3].size(); ++i)
+			monotonic &= (colors[3][i] & 0xFF) <= (colors[3][i - 1] & 0xFF) && (colors[3][i] >> 16) >= (colors[3][i - 1] >> 16);
+		CHECK(monotonic);
+		CHECK_EQ(animator.Stats().finished, 1);
+
+		// 쉬는 동안은 몇 번을 불러도 계산하지 않음
+		const uint64_t idleFrames = animator.Stats().frames;
+		for (int i = 0; i < 100; ++i)
+			CHECK_EQ(animator.Tick(nowUs + static_cast<uint64_t>(i) * 16000, [](uint32_t, uint32_t) {}), 0);
+		CHECK_EQ(animator.Stats().frames, idleFrames);
+		CHECK_EQ(animator.NextFrameUs(), 0);
+	}
+
+	// 움직이는 중에 다시 바꾸면 지금 보이는 색에서 시작 (튀지 않음)
+	void TestFadeRestartsFromCurrent()
+	{
+		BorderAnimator animator(FadeOptions());
+		uint64_t nowUs = 0;
+		animator.Fade(0, Red, Blue, nowUs);
+		uint32_t middle = 0;
+		for (int i = 0; i < 5; ++i)
+		{
+			nowUs += 16000;
+			animator.Tick(nowUs, [&middle](uint32_t, uint32_t color) { middle = color; });
+		}
+		CHECK(middle != Red && middle != Blue);
+
+		animator.Fade(0, Blue, Red, nowUs);
+		uint32_t current = 0;
+		CHECK(animator.CurrentColor(0, current));
+		CHECK_EQ(current, middle);
+		CHECK_EQ(animator.Size(), 1);
+
+		std::unordered_map<uint32_t, std::vector<uint32_t>> colors{};
+		RunToEnd(animator, nowUs, colors);
+		CHECK_EQ(colors[0].back(), Red);
+
+		// 같은 색으로 바꾸면 움직이지 않음
+		animator.Fade(0, Red, Red, nowUs);
+		CHECK(!animator.IsAnimating(0));
+	}
+
+	// 깜빡임: pulseColor 쪽으로 갔다가 원래 색으로 돌아옴 (횟수만큼)
+	void TestPulse()
+	{
+		BorderAnimationOptions options{};
+		options.pulseUs = 96000;
+		options.pulseCount = 2;
+		options.pulseColor = White;
+		options.frameIntervalUs = 16000;
+		BorderAnimator animator(options);
+		CHECK(!animator.FadeEnabled());
+
+		uint64_t nowUs = 0;
+		animator.Pulse(1, Red, nowUs);
+		std::unordered_map<uint32_t, std::vector<uint32_t>> colors{};
+		const size_t frames = RunToEnd(animator, nowUs, colors);
+		CHECK_EQ(frames, 12);
+		// 반 주기 (48 ms) 마다 가장 밝음
+		CHECK_EQ(colors[1][2], White);
+		CHECK_EQ(colors[1].back(), Red);
+		size_t peaks = 0;
+		for (uint32_t color : colors[1])
+			peaks += color == White ? 1 : 0;
+		CHECK_EQ(peaks, 2);
+		CHECK_EQ(animator.Stats().pulses, 1);
+
+		// 꺼져 있으면 시작하지 않음
+		BorderAnimator disabled{};
+		disabled.Pulse(1, Red, 0);
+		CHECK(!disabled.IsAnimating(1));
+	}
+
+	// 여러 노드: 취소하면 나머지는 계속, 프레임마다 움직이는 노드만 계산
+	void TestManyNodes()
+	{
+		BorderAnimator animator(FadeOptions());
+		uint64_t nowUs = 0;
+		for (uint32_t node = 0; node < 100; ++node)
+			animator.Fade(node, Red, Blue, nowUs);
+		for (uint32_t node = 0; node < 100; node += 2)
+			animator.Cancel(node);
+		CHECK_EQ(animator.Size(), 50);
+		CHECK(!animator.IsAnimating(0));
+		CHECK(animator.IsAnimating(99));
+
+		std::unordered_map<uint32_t, std::vector<uint32_t>> colors{};
+		RunToEnd(animator, nowUs, colors);
+		CHECK_EQ(colors.size(), 50);
+		CHECK_EQ(colors[99].back(), Blue);
+		CHECK_EQ(colors.count(0), 0);
+		CHECK_EQ(animator.Stats().evaluated, 50 * 10);
+		CHECK_EQ(animator.Stats().maxActive, 100);
+	}
+
+	/// <summary> 마지막으로 그린 색을 대상 창마다 기록하는 오버레이 </summary>
+	class RecordingWindowSystem : public SimulatedWindowSystem
+	{
+	public:
+		std::unordered_map<WindowHandle, uint32_t> colors{};
+		uint64_t presents = 0;
+
+		std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle target, const BorderStyle&, const BorderVisual& visual) override
+		{
+			colors[target] = visual.color;
+			return std::make_unique<Overlay>(*this, target);
+		}
+
+	private:
+		class Overlay : public BorderOverlay
+		{
+		public:
+			Overlay(RecordingWindowSystem& owner, WindowHandle target) : owner(owner), target(target) {}
+
+			bool Present(const BorderVisual& visual) override
+			{
+				owner.presents++;
+				owner.colors[target] = visual.color;
+				return true;
+			}
+			void Hide() override {}
+
+		private:
+			RecordingWindowSystem& owner;
+			WindowHandle target;
+		};
+	};
+
+	/// <summary> 움직이는 테두리가 없어질 때까지 Animate 가 알려 준 시간만큼 자며 부름 </summary>
+	size_t AnimateToEnd(BorderPipeline& pipeline)
+	{
+		size_t calls = 0;
+		for (uint64_t delayUs = pipeline.Animate(); delayUs != 0; delayUs = pipeline.Animate())
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(delayUs));
+			calls++;
+		}
+		return calls;
+	}
+
+	// 파이프라인: 스타일 변경은 Commit 에서 그리지 않고 Animate 가 이어서 바꿈. 포커스는 다른 창으로 넘어갈 때만 깜빡임
+	void TestPipelineAnimation()
+	{
+		constexpr uint64_t Windows = 8;
+		RecordingWindowSystem windowSystem{};
+		for (uint64_t i = 0; i < Windows; ++i)
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ static_cast<int32_t>(i) * 120, 0, static_cast<int32_t>(i) * 120 + 100, 100 });
+
+		PipelineOptions options{};
+		options.poll.fastIntervalUs = 0;
+		options.animation.fadeUs = 40000;
+		options.animation.pulseUs = 20000;
+		options.animation.pulseCount = 1;
+		options.animation.frameIntervalUs = 5000;
+		BorderStyle style{};
+		style.color = Red;
+		BorderPipeline pipeline(windowSystem, style, options);
+		pipeline.Start([]() {});
+		RunOnLayout(pipeline, [](BorderTracker& tracker)
+			{
+				for (uint64_t i = 0; i < Windows; ++i)
+					tracker.AddWindow(MakeHandle(i));
+			});
+		pipeline.PumpPresent();
+		CHECK_EQ(pipeline.OverlayCount(), Windows);
+		CHECK_EQ(pipeline.Animate(), 0);
+
+		style.color = Blue;
+		CHECK(pipeline.SetStyle(style));
+		RunOnLayout(pipeline, [](BorderTracker&) {});
+		const uint64_t presentsBefore = windowSystem.presents;
+		pipeline.PumpPresent();
+		// 색만 바뀐 테두리는 아직 그리지 않음
+		CHECK_EQ(windowSystem.presents, presentsBefore);
+		CHECK_EQ(windowSystem.colors[MakeHandle(0)], Red);
+		CHECK_EQ(pipeline.AnimationStatistics().active, Windows);
+
+		AnimateToEnd(pipeline);
+		for (uint64_t i = 0; i < Windows; ++i)
+			CHECK_EQ(windowSystem.colors[MakeHandle(i)], Blue);
+		const AnimationStats fade = pipeline.AnimationStatistics();
+		CHECK_EQ(fade.fades, Windows);
+		CHECK_EQ(fade.finished, Windows);
+		CHECK_EQ(windowSystem.presents - presentsBefore, fade.applied);
+		// 프레임은 fadeUs / frameIntervalUs 근처 (잠이 늦으면 더 적음)
+		CHECK(fade.frames <= 9);
+		std::printf("fade: %llu windows, %llu frames, %llu redraws\n", static_cast<unsigned long long>(Windows),
+			static_cast<unsigned long long>(fade.frames), static_cast<unsigned long long>(fade.applied));
+
+		// 같은 창 안에서 포커스가 옮겨 다녀도 깜빡임은 한 번, 다른 창으로 넘어가면 다시
+		RunOnLayout(pipeline, [](BorderTracker& tracker)
+			{
+				uint32_t eventTime = 100;
+				for (uint64_t target : { 2, 2, 2, 5 })
+				{
+					tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectFocus, MakeHandle(target), 0, 0, 1, ++eventTime }, 1000);
+					tracker.Flush(2000 + eventTime);
+				}
+				CHECK(tracker.FocusedWindow() == MakeHandle(5));
+			});
+		pipeline.PumpPresent();
+		CHECK_EQ(pipeline.AnimationStatistics().pulses, 2);
+		AnimateToEnd(pipeline);
+		CHECK_EQ(windowSystem.colors[MakeHandle(2)], Blue);
+		CHECK_EQ(windowSystem.colors[MakeHandle(5)], Blue);
+		CHECK_EQ(pipeline.Animate(), 0);
+
+		pipeline.Stop();
+		pipeline.ReleaseOverlays();
+	}
+}
+
+int main()
+{
+	TestEasingTable();
+	TestFade();
+	TestFadeRestartsFromCurrent();
+	TestPulse();
+	TestManyNodes();
+	TestPipelineAnimation();
+	return TestResult("BorderAnimatorTest");
+}
@@ -0,0 +1,294 @@
+﻿// 테두리 정책 (BorderPolicy) 이 visual 에 맞는 정책을 고르고, 정책마다 바뀐 속성만 BorderDirty 로 보고하며,
+// 고른 정책의 그리기만 호출하는지, 그리고 변마다 두께가 띠 (BorderStrips) 와 소프트웨어 그리기에 반영되는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. BorderPolicyTest.cpp ../BorderRaster.cpp ../CornerMask.cpp ../BorderScene.cpp -o BorderPolicyTest
+
+#include "TestUtil.h"
+#include "BorderPolicy.h"
+#include "BorderRaster.h"
+#include "BorderScene.h"
+
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t Red = 0x000000FF;
+	constexpr uint32_t Blue = 0x00FF0000;
+
+	// 호출된 그리기 명령만 기록
+	struct RecordingCanvas
+	{
+		int strokes = 0;
+		int roundedStrokes = 0;
+		int fills = 0;
+		int gradientStrokes = 0;
+		BorderRectF lastRect{};
+		float lastRadius = 0.0f;
+		int32_t lastThickness = 0;
+		uint32_t lastColor = 0;
+		uint32_t lastEndColor = 0;
+		std::vector<WindowRect> filled;
+
+		void StrokeRect(const BorderRectF& rect, int32_t thickness, uint32_t color, uint8_t)
+		{
+			strokes++;
+			lastRect = rect;
+			lastThickness = thickness;
+			lastColor = color;
+		}
+
+		void StrokeRoundedRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint8_t)
+		{
+			roundedStrokes++;
+			lastRect = rect;
+			lastRadius = radius;
+			lastThickness = thickness;
+			lastColor = color;
+		}
+
+		void FillRect(const WindowRect& rect, uint32_t color, uint8_t)
+		{
+			fills++;
+			filled.push_back(rect);
+			lastColor = color;
+		}
+
+		void StrokeGradientRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint32_t endColor, uint8_t)
+		{
+			gradientStrokes++;
+			lastRect = rect;
+			lastRadius = radius;
+			lastThickness = thickness;
+			lastColor = color;
+			lastEndColor = endColor;
+		}
+
+		int Calls() const noexcept { return strokes + roundedStrokes + fills + gradientStrokes; }
+	};
+
+	BorderVisual LocalVisual(int32_t width, int32_t height, uint32_t color = Red, int32_t thickness = 2)
+	{
+		BorderVisual visual{};
+		visual.bounds = WindowRect{ 0, 0, width, height };
+		visual.color = color;
+		visual.thickness = thickness;
+		visual.margin = 3;
+		return visual;
+	}
+
+	void CheckRect(const WindowRect& actual, const WindowRect& expected)
+	{
+		CHECK_EQ(actual.left, expected.left);
+		CHECK_EQ(actual.top, expected.top);
+		CHECK_EQ(actual.right, expected.right);
+		CHECK_EQ(actual.bottom, expected.bottom);
+	}
+
+	// 그라데이션 > 변마다 두께 > 둥근 모서리 > 직각. 두께가 모두 thickness 와 같으면 변마다 두께가 아님
+	void TestSelection()
+	{
+		BorderVisual visual = LocalVisual(200, 100);
+		CHECK(SelectBorderPolicy(visual) == BorderPolicyKind::Sharp);
+
+		visual.cornerRadius = 8.0f;
+		CHECK(SelectBorderPolicy(visual) == BorderPolicyKind::Rounded);
+
+		visual.edgeThickness = { 2, 2, 0, 2 };
+		CHECK(SelectBorderPolicy(visual) == BorderPolicyKind::Rounded);
+		visual.edgeThickness = { 4, 0, 0, 0 };
+		CHECK(SelectBorderPolicy(visual) == BorderPolicyKind::PerEdge);
+
+		visual.gradient = true;
+		CHECK(SelectBorderPolicy(visual) == BorderPolicyKind::Gradient);
+
+		// 변마다 두께는 DPI 에 비례하고, 0 인 변은 thickness
+		BorderStyle style{};
+		style.thickness = 2.0f;
+		style.edgeThickness = { 6.0f, 0.0f, 1.0f, 0.0f };
+		const BorderVisual scaled = ComputeBorderVisual(WindowRect{ 100, 100, 300, 200 }, 192, style);
+		CHECK_EQ(scaled.EdgeThickness(0), 12);
+		CHECK_EQ(scaled.EdgeThickness(1), 4);
+		CHECK_EQ(scaled.EdgeThickness(2), 2);
+		CHECK_EQ(scaled.MinEdgeThickness(), 2);
+		CHECK(SelectBorderPolicy(scaled) == BorderPolicyKind::PerEdge);
+	}
+
+	// 고른 정책의 비교만: 같은 모양은 0, 바뀐 속성만 비트로
+	void TestSharpDiff()
+	{
+		BorderPainter<RecordingCanvas> painter;
+		CHECK(painter.Policy() == BorderPolicyKind::Sharp);
+
+		// 처음에는 그린 것이 없으므로 내용이 모두 바뀜
+		const BorderVisual visual = LocalVisual(200, 100);
+		const uint8_t first = painter.Update(visual);
+		CHECK((first & BorderDirty::Size) != 0);
+		CHECK((first & BorderDirty::Color) != 0);
+		CHECK((first & BorderDirty::Thickness) != 0);
+
+		CHECK_EQ(painter.Update(visual), 0);
+
+		BorderVisual recolored = visual;
+		recolored.color = Blue;
+		CHECK_EQ(painter.Update(recolored), BorderDirty::Color);
+
+		BorderVisual resized = recolored;
+		resized.bounds.right = 260;
+		CHECK_EQ(painter.Update(resized), BorderDirty::Size);
+
+		BorderVisual thicker = resized;
+		thicker.thickness = 4;
+		CHECK_EQ(painter.Update(thicker), BorderDirty::Thickness);
+
+		// 직각 정책은 반지름을 보지 않음 (반지름이 바뀌면 호출하는 쪽이 정책을 다시 고름)
+		RecordingCanvas canvas;
+		painter.Draw(canvas);
+		CHECK_EQ(canvas.strokes, 1);
+		CHECK_EQ(canvas.Calls(), 1);
+		CHECK_EQ(canvas.lastThickness, 4);
+		CHECK_EQ(canvas.lastColor, Blue);
+		// FrameDrawer::ConvertRECT 와 같은 자리: 1 픽셀 안쪽 + 반 두께
+		CHECK(canvas.lastRect == (BorderRectF{ 3.0f, 3.0f, 257.0f, 97.0f }));
+	}
+
+	// 정책을 바꾸면 첫 Update 는 내용이 모두 바뀐 것으로 보고 새 정책으로 그림. 같은 정책을 다시 고르면 아무것도 하지 않음
+	void TestPolicySwitch()
+	{
+		BorderPainter<RecordingCanvas> painter;
+		BorderVisual visual = LocalVisual(200, 100);
+		painter.Update(visual);
+		CHECK_EQ(painter.Update(visual), 0);
+
+		painter.Select(BorderPolicyKind::Sharp);
+		CHECK_EQ(painter.Update(visual), 0);
+
+		visual.cornerRadius = 8.0f;
+		painter.Select(SelectBorderPolicy(visual));
+		CHECK(painter.Policy() == BorderPolicyKind::Rounded);
+		const uint8_t switched = painter.Update(visual);
+		CHECK((switched & BorderDirty::Radius) != 0);
+		CHECK((switched & BorderDirty::Visibility) == 0);
+		CHECK_EQ(painter.Update(visual), 0);
+
+		BorderVisual rounder = visual;
+		rounder.cornerRadius = 10.0f;
+		CHECK_EQ(painter.Update(rounder), BorderDirty::Radius);
+
+		RecordingCanvas canvas;
+		painter.Draw(canvas);
+		CHECK_EQ(canvas.roundedStrokes, 1);
+		CHECK_EQ(canvas.Calls(), 1);
+		CHECK(canvas.lastRadius == 10.0f);
+
+		// 되돌아가면 직각 모양은 처음부터 다시
+		painter.Select(BorderPolicyKind::Sharp);
+		CHECK((painter.Update(visual) & BorderDirty::Size) != 0);
+
+		// Paint 는 바뀐 것이 있을 때만 그림. 정책을 바꾼 직후에는 항상
+		RecordingCanvas painted;
+		CHECK_EQ(painter.Paint(visual, painted), 0);
+		CHECK_EQ(painted.Calls(), 0);
+		painter.Select(BorderPolicyKind::Rounded);
+		CHECK(painter.Paint(rounder, painted) != 0);
+		CHECK_EQ(painted.roundedStrokes, 1);
+		CHECK(painter.Paint(visual, painted) == BorderDirty::Radius);
+		CHECK_EQ(painted.roundedStrokes, 2);
+		CHECK_EQ(painter.Paint(visual, painted), 0);
+		CHECK_EQ(painted.Calls(), 2);
+	}
+
+	// 변마다 두께: 띠 네 개를 채우고, 한 변의 두께만 바뀌어도 Thickness
+	void TestPerEdge()
+	{
+		BorderVisual visual = LocalVisual(200, 100);
+		visual.edgeThickness = { 1, 4, 0, 3 };
+
+		WindowRect strips[4];
+		BorderStrips(visual, strips);
+		CheckRect(strips[0], WindowRect{ 1, 1, 199, 2 });
+		CheckRect(strips[1], WindowRect{ 1, 95, 199, 99 });
+		CheckRect(strips[2], WindowRect{ 1, 2, 3, 95 });
+		CheckRect(strips[3], WindowRect{ 196, 2, 199, 95 });
+
+		BorderPainter<RecordingCanvas> painter;
+		painter.Select(SelectBorderPolicy(visual));
+		CHECK(painter.Policy() == BorderPolicyKind::PerEdge);
+		painter.Update(visual);
+		CHECK_EQ(painter.Update(visual), 0);
+
+		BorderVisual changed = visual;
+		changed.edgeThickness[2] = 5;
+		CHECK_EQ(painter.Update(changed), BorderDirty::Thickness);
+
+		RecordingCanvas canvas;
+		painter.Draw(canvas);
+		CHECK_EQ(canvas.fills, 4);
+		CHECK_EQ(canvas.Calls(), 4);
+		CHECK_EQ(canvas.filled.size(), 4u);
+		if (canvas.filled.size() == 4)
+			CheckRect(canvas.filled[2], WindowRect{ 1, 2, 6, 95 });
+
+		// 소프트웨어 그리기도 같은 띠를 채움: 채운 픽셀 수가 띠 넓이의 합
+		std::vector<uint32_t> pixels(200 * 100, 0);
+		RedrawBorder(pixels.data(), 200, BorderVisual{}, changed);
+		BorderStrips(changed, strips);
+		uint64_t expected = 0;
+		for (const WindowRect& strip : strips)
+			expected += static_cast<uint64_t>(strip.Width()) * static_cast<uint64_t>(strip.Height());
+		uint64_t painted = 0;
+		for (uint32_t pixel : pixels)
+			painted += pixel != 0 ? 1 : 0;
+		CHECK_EQ(painted, expected);
+	}
+
+	// 그라데이션: 끝 색만 바뀌어도 Color, 그리기는 두 색을 넘김
+	void TestGradient()
+	{
+		BorderVisual visual = LocalVisual(200, 100);
+		visual.gradient = true;
+		visual.gradientColor = Blue;
+
+		BorderPainter<RecordingCanvas> painter;
+		painter.Select(SelectBorderPolicy(visual));
+		painter.Update(visual);
+		CHECK_EQ(painter.Update(visual), 0);
+
+		BorderVisual changed = visual;
+		changed.gradientColor = 0x0000FF00;
+		CHECK_EQ(painter.Update(changed), BorderDirty::Color);
+
+		RecordingCanvas canvas;
+		painter.Draw(canvas);
+		CHECK_EQ(canvas.gradientStrokes, 1);
+		CHECK_EQ(canvas.Calls(), 1);
+		CHECK_EQ(canvas.lastColor, Red);
+		CHECK_EQ(canvas.lastEndColor, 0x0000FF00u);
+	}
+
+	// 장면 비교 (DiffBorderVisual) 와 SameShape 도 새 속성을 봄
+	void TestVisualDiff()
+	{
+		const BorderVisual visual = LocalVisual(200, 100);
+
+		BorderVisual gradient = visual;
+		gradient.gradient = true;
+		gradient.gradientColor = Blue;
+		CHECK_EQ(DiffBorderVisual(visual, gradient), BorderDirty::Color);
+		CHECK(!visual.SameShape(gradient));
+
+		BorderVisual edges = visual;
+		edges.edgeThickness[0] = 6;
+		CHECK_EQ(DiffBorderVisual(visual, edges), BorderDirty::Thickness);
+		CHECK(!visual.SameShape(edges));
+	}
+}
+
+int main()
+{
+	TestSelection();
+	TestSharpDiff();
+	TestPolicySwitch();
+	TestPerEdge();
+	TestGradient();
+	TestVisualDiff();
+	return TestResult("BorderPolicyTest");
+}
@@ -0,0 +1,216 @@
+﻿// 소프트웨어 래스터라이저가 테두리 띠를 정해진 그림대로 그리고, 바뀐 띠만 다시 그리며,
+// SIMD 구현이 스칼라 구현과 같은 픽셀을 쓰는지 (채울 사각형 밖은 건드리지 않는지) 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. BorderRasterTest.cpp ../BorderRaster.cpp ../CornerMask.cpp -o BorderRasterTest
+
+#include "TestUtil.h"
+#include "BorderRaster.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t Red = 0x000000FF;
+	constexpr uint32_t Green = 0x0000FF00;
+
+	/// <summary> 테스트용 버퍼. 투명은 '.', 그 밖은 '#' 로 그림을 만듦 </summary>
+	struct Canvas
+	{
+		int32_t width;
+		int32_t height;
+		std::vector<uint32_t> pixels;
+
+		Canvas(int32_t width, int32_t height) : width(width), height(height), pixels(static_cast<size_t>(width) * height, 0) {}
+
+		uint32_t* Data() { return pixels.data(); }
+		size_t Stride() const { return static_cast<size_t>(width); }
+		uint32_t At(int32_t x, int32_t y) const { return pixels[static_cast<size_t>(y) * width + x]; }
+
+		std::string Picture() const
+		{
+			std::string picture{};
+			for (int32_t y = 0; y < height; ++y)
+			{
+				for (int32_t x = 0; x < width; ++x)
+					picture += At(x, y) == 0 ? '.' : '#';
+				picture += '\n';
+			}
+			return picture;
+		}
+	};
+
+	BorderVisual VisualOf(const WindowRect& bounds, uint32_t color, int32_t thickness, uint8_t alpha = 255)
+	{
+		BorderVisual visual{};
+		visual.bounds = bounds;
+		visual.color = color;
+		visual.thickness = thickness;
+		visual.alpha = alpha;
+		return visual;
+	}
+
+	void CheckPicture(const Canvas& canvas, const char* expected)
+	{
+		const std::string actual = canvas.Picture();
+		CHECK(actual == expected);
+		if (actual != expected)
+			std::fprintf(stderr, "expected:\n%sactual:\n%s", expected, actual.c_str());
+	}
+
+	void CheckRect(const WindowRect& actual, const WindowRect& expected)
+	{
+		CHECK_EQ(actual.left, expected.left);
+		CHECK_EQ(actual.top, expected.top);
+		CHECK_EQ(actual.right, expected.right);
+		CHECK_EQ(actual.bottom, expected.bottom);
+	}
+
+	// COLORREF 를 반올림한 premultiplied BGRA 로
+	void TestBorderPixel()
+	{
+		CHECK_EQ(BorderPixel(Red), 0xFFFF0000u);
+		CHECK_EQ(BorderPixel(0x00FF0000), 0xFF0000FFu);
+		CHECK_EQ(BorderPixel(0x0000FF, 128), 0x80800000u);
+		CHECK_EQ(BorderPixel(Green, 64), 0x40004000u);
+		CHECK_EQ(BorderPixel(0x00FFFFFF, 0), 0u);
+		CHECK_EQ(BorderPixel(0x00808080, 255), 0xFF808080u);
+	}
+
+	// 처음 그릴 때는 네 띠 전체
+	void TestFirstDraw()
+	{
+		Canvas canvas(10, 8);
+		const BorderVisual visual = VisualOf(WindowRect{ 0, 0, 10, 8 }, Red, 2);
+		const WindowRect dirty = RedrawBorder(canvas.Data(), canvas.Stride(), BorderVisual{}, visual);
+
+		CheckPicture(canvas,
+			"..........\n"
+			".########.\n"
+			".########.\n"
+			".##....##.\n"
+			".##....##.\n"
+			".########.\n"
+			".########.\n"
+			"..........\n");
+		CheckRect(dirty, WindowRect{ 1, 1, 9, 7 });
+		CHECK_EQ(canvas.At(1, 1), BorderPixel(Red));
+
+		// 같은 모양이면 아무것도 하지 않음
+		CHECK(RedrawBorder(canvas.Data(), canvas.Stride(), visual, visual).IsEmpty());
+	}
+
+	// 두께가 줄면 이전 띠를 지우고 새 띠를 그림
+	void TestThicknessChange()
+	{
+		Canvas canvas(10, 8);
+		const BorderVisual thick = VisualOf(WindowRect{ 0, 0, 10, 8 }, Red, 2);
+		RedrawBorder(canvas.Data(), canvas.Stride(), BorderVisual{}, thick);
+
+		const WindowRect dirty = RedrawBorder(canvas.Data(), canvas.Stride(), thick, VisualOf(WindowRect{ 0, 0, 10, 8 }, Red, 1));
+		CheckPicture(canvas,
+			"..........\n"
+			".########.\n"
+			".#......#.\n"
+			".#......#.\n"
+			".#......#.\n"
+			".#......#.\n"
+			".########.\n"
+			"..........\n");
+		CheckRect(dirty, WindowRect{ 1, 1, 9, 7 });
+	}
+
+	// 색 (불투명도) 만 바뀌면 지우지 않고 덮어씀
+	void TestColorChange()
+	{
+		Canvas canvas(10, 8);
+		const BorderVisual red = VisualOf(WindowRect{ 0, 0, 10, 8 }, Red, 2);
+		RedrawBorder(canvas.Data(), canvas.Stride(), BorderVisual{}, red);
+
+		const WindowRect dirty = RedrawBorder(canvas.Data(), canvas.Stride(), red, VisualOf(WindowRect{ 0, 0, 10, 8 }, Green, 2, 64));
+		CheckRect(dirty, WindowRect{ 1, 1, 9, 7 });
+		CHECK_EQ(canvas.At(1, 1), 0x40004000u);
+		CHECK_EQ(canvas.At(8, 6), 0x40004000u);
+		CHECK_EQ(canvas.At(3, 3), 0);
+	}
+
+	// 아래로 늘어나면 위쪽 띠는 그대로 두고 나머지 세 띠만 다시 그림
+	void TestGrowDown()
+	{
+		Canvas canvas(10, 10);
+		const BorderVisual small = VisualOf(WindowRect{ 0, 0, 10, 8 }, Red, 2);
+		RedrawBorder(canvas.Data(), canvas.Stride(), BorderVisual{}, small);
+
+		const WindowRect dirty = RedrawBorder(canvas.Data(), canvas.Stride(), small, VisualOf(WindowRect{ 0, 0, 10, 10 }, Red, 2));
+		CheckPicture(canvas,
+			"..........\n"
+			".########.\n"
+			".########.\n"
+			".##....##.\n"
+			".##....##.\n"
+			".##....##.\n"
+			".##....##.\n"
+			".########.\n"
+			".########.\n"
+			"..........\n");
+		CheckRect(dirty, WindowRect{ 1, 3, 9, 9 });
+	}
+
+	// 모든 구현이 스칼라와 같은 픽셀을 쓰고 사각형 밖 (행 끝의 나머지 포함) 은 건드리지 않음
+	void TestKernelsMatchScalar()
+	{
+		constexpr int32_t Width = 67;
+		constexpr int32_t Height = 41;
+		constexpr uint32_t Canary = 0xDEADBEEF;
+
+		uint64_t state = 0x9E3779B97F4A7C15ull;
+		const auto next = [&state](int32_t bound)
+			{
+				state ^= state << 13;
+				state ^= state >> 7;
+				state ^= state << 17;
+				return static_cast<int32_t>(state % static_cast<uint64_t>(bound));
+			};
+
+		for (RasterKernel kernel : { RasterKernel::Sse2, RasterKernel::Avx2 })
+		{
+			if (!IsRasterKernelSupported(kernel))
+			{
+				std::printf("%s: not supported, skipped\n", RasterKernelName(kernel));
+				continue;
+			}
+
+			for (int round = 0; round < 500; ++round)
+			{
+				const int32_t left = next(Width);
+				const int32_t top = next(Height);
+				const WindowRect rect{ left, top, left + next(Width - left + 1), top + next(Height - top + 1) };
+				const uint32_t pixel = static_cast<uint32_t>(state);
+
+				std::vector<uint32_t> expected(static_cast<size_t>(Width) * Height, Canary);
+				std::vector<uint32_t> actual(expected);
+				FillPixels(expected.data(), Width, rect, pixel, RasterKernel::Scalar);
+				FillPixels(actual.data(), Width, rect, pixel, kernel);
+				CHECK(actual == expected);
+			}
+		}
+
+		// 기본 (가장 넓은) 구현도 벡터 폭보다 짧은 행의 경계를 지킴
+		std::vector<uint32_t> pixels(16, 0);
+		FillPixels(pixels.data(), 16, WindowRect{ 3, 0, 13, 1 }, 7);
+		CHECK_EQ(pixels[2], 0);
+		CHECK_EQ(pixels[3], 7);
+		CHECK_EQ(pixels[12], 7);
+		CHECK_EQ(pixels[13], 0);
+	}
+}
+
+int main()
+{
+	TestBorderPixel();
+	TestFirstDraw();
+	TestThicknessChange();
+	TestColorChange();
+	TestGrowDown();
+	TestKernelsMatchScalar();
+	return TestResult("BorderRasterTest");
+}
@@ -0,0 +1,262 @@
+﻿// BorderScene 이 노드마다 바뀐 속성만 기록해 한 프레임에 한 번만 반영하고, 결과가 같으면 반영하지 않는지,
+// 그리고 파이프라인에서 바뀌지 않은 데스크톱은 다시 그리기가 0 이고 밀린 명령 묶음이 노드마다 한 번으로 합쳐지는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. BorderSceneTest.cpp ../BorderScene.cpp ../BorderPipeline.cpp ../BorderAnimator.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp ../WorkStealingPool.cpp -o BorderSceneTest
+
+#include "TestUtil.h"
+#include "BorderPipeline.h"
+#include "BorderScene.h"
+#include "SimulatedWindowSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	uint64_t NowUs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	BorderVisual VisualAt(int32_t left, int32_t top, int32_t width, int32_t height, uint32_t color = 0x0000FF)
+	{
+		BorderStyle style{};
+		style.color = color;
+		return ComputeBorderVisual(WindowRect{ left, top, left + width, top + height }, DefaultDpi, style);
+	}
+
+	/// <summary> VisualAt 과 같은 위치와 스타일. 스타일은 styles 에 넣은 번호로 </summary>
+	BorderPlacement PlacementAt(BorderStyleTable& styles, int32_t left, int32_t top, int32_t width, int32_t height, uint32_t color = 0x0000FF)
+	{
+		BorderStyle style{};
+		style.color = color;
+		const ResolvedStyle resolved = ResolveBorderStyle(style, DefaultDpi);
+		return BorderPlacement{ BorderBounds(WindowRect{ left, top, left + width, top + height }, resolved.margin), styles.Intern(resolved) };
+	}
+
+	/// <summary> Commit 이 부른 반영을 기록 </summary>
+	struct CommitLog
+	{
+		struct Call
+		{
+			uint32_t node = 0;
+			bool hide = false;
+			uint8_t dirty = 0;
+			BorderVisual visual{};
+		};
+
+		std::vector<Call> calls{};
+
+		SceneFrameStats Commit(BorderScene& scene)
+		{
+			calls.clear();
+			return scene.Commit([this](uint32_t node, const BorderVisual& visual, uint8_t dirty)
+				{
+					calls.push_back(Call{ node, false, dirty, visual });
+				},
+				[this](uint32_t node)
+				{
+					calls.push_back(Call{ node, true, 0, BorderVisual{} });
+				});
+		}
+	};
+
+	// 속성마다 다른 비트
+	void TestDiffBits()
+	{
+		const BorderVisual base = VisualAt(100, 100, 400, 300);
+		CHECK_EQ(DiffBorderVisual(base, base), 0);
+		CHECK_EQ(DiffBorderVisual(base, VisualAt(150, 120, 400, 300)), BorderDirty::Position);
+		CHECK_EQ(DiffBorderVisual(base, VisualAt(100, 100, 500, 300)), BorderDirty::Size);
+		// 왼쪽 가장자리를 끌면 위치와 크기 모두
+		CHECK_EQ(DiffBorderVisual(base, VisualAt(90, 100, 410, 300)), BorderDirty::Position | BorderDirty::Size);
+		CHECK_EQ(DiffBorderVisual(base, VisualAt(100, 100, 400, 300, 0x00FF00)), BorderDirty::Color);
+
+		BorderVisual changed = base;
+		changed.alpha = 128;
+		CHECK_EQ(DiffBorderVisual(base, changed), BorderDirty::Color);
+		changed = base;
+		changed.thickness = 4;
+		CHECK_EQ(DiffBorderVisual(base, changed), BorderDirty::Thickness);
+		changed = base;
+		changed.cornerRadius = 8.0f;
+		CHECK_EQ(DiffBorderVisual(base, changed), BorderDirty::Radius);
+
+		// 번호로 비교해도 같은 비트. 번호가 같으면 위치만
+		BorderStyleTable styles(BorderStyle{});
+		const BorderPlacement placed = PlacementAt(styles, 100, 100, 400, 300);
+		CHECK_EQ(DiffBorderPlacement(styles, placed, placed), 0);
+		CHECK_EQ(DiffBorderPlacement(styles, placed, PlacementAt(styles, 90, 100, 410, 300)), BorderDirty::Position | BorderDirty::Size);
+		CHECK_EQ(DiffBorderPlacement(styles, placed, PlacementAt(styles, 100, 100, 400, 300, 0x00FF00)), BorderDirty::Color);
+		CHECK(styles.Expand(placed).SameShape(base));
+	}
+
+	// 한 프레임의 여러 변경은 노드마다 한 번, 되돌아온 변경은 0 번
+	void TestCommitMergesUpdates()
+	{
+		BorderStyleTable styles(BorderStyle{});
+		BorderScene scene(styles);
+		CommitLog log{};
+		const BorderPlacement base = PlacementAt(styles, 100, 100, 400, 300);
+		scene.Insert(0, base);
+		scene.Insert(3, PlacementAt(styles, 600, 100, 400, 300));
+
+		// 아무 변경도 없으면 아무것도 부르지 않음
+		SceneFrameStats frame = log.Commit(scene);
+		CHECK_EQ(log.calls.size(), 0);
+		CHECK_EQ(scene.Stats().frames, 0);
+
+		for (int32_t step = 1; step <= 10; ++step)
+			scene.Show(0, PlacementAt(styles, 100 + step, 100, 400, 300));
+		CHECK_EQ(scene.PendingDirty(0), BorderDirty::Position);
+		frame = log.Commit(scene);
+		CHECK_EQ(frame.updates, 10);
+		CHECK_EQ(frame.presents, 1);
+		CHECK_EQ(frame.moves, 1);
+		CHECK_EQ(frame.repaints, 0);
+		CHECK_EQ(log.calls.size(), 1);
+		CHECK_EQ(log.calls[0].visual.bounds.left, base.bounds.left + 10);
+		CHECK_EQ(log.calls[0].dirty, BorderDirty::Position);
+
+		// 숨겼다가 같은 자리에 다시 보이면 아무것도 하지 않음
+		scene.Hide(0);
+		scene.Show(0, PlacementAt(styles, 110, 100, 400, 300));
+		frame = log.Commit(scene);
+		CHECK_EQ(log.calls.size(), 0);
+		CHECK_EQ(frame.unchanged, 1);
+
+		// 크기와 색은 다시 그림, 다른 노드는 건드리지 않음
+		scene.Show(0, PlacementAt(styles, 110, 100, 500, 300, 0x00FF00));
+		frame = log.Commit(scene);
+		CHECK_EQ(frame.repaints, 1);
+		CHECK_EQ(log.calls.size(), 1);
+		CHECK_EQ(log.calls[0].node, 0);
+		CHECK_EQ(log.calls[0].dirty, BorderDirty::Size | BorderDirty::Color);
+
+		// 숨기면 한 번, 다시 보이면 Visibility 로 다시 그림
+		scene.Hide(3);
+		scene.Hide(3);
+		frame = log.Commit(scene);
+		CHECK_EQ(frame.hides, 1);
+		CHECK(log.calls.size() == 1 && log.calls[0].hide);
+		scene.Show(3, PlacementAt(styles, 600, 100, 400, 300));
+		frame = log.Commit(scene);
+		CHECK_EQ(frame.repaints, 1);
+		CHECK_EQ(log.calls[0].dirty, BorderDirty::Visibility);
+
+		// 같은 자리여도 포그라운드가 되면 z 순서만 다시 맞춤
+		scene.Restack(3);
+		scene.Show(3, PlacementAt(styles, 600, 100, 400, 300));
+		frame = log.Commit(scene);
+		CHECK_EQ(frame.restacks, 1);
+		CHECK_EQ(log.calls[0].dirty, BorderDirty::Stacking);
+
+		// 지운 노드의 변경은 버리고, 없는 노드에 대한 명령은 무시
+		scene.Show(3, PlacementAt(styles, 700, 100, 400, 300));
+		scene.Remove(3);
+		scene.Show(7, base);
+		frame = log.Commit(scene);
+		CHECK_EQ(log.calls.size(), 0);
+		CHECK_EQ(scene.Stats().nodes, 1);
+
+		// 같은 번호로 다시 만들면 새 노드
+		scene.Insert(3, base);
+		scene.Show(3, PlacementAt(styles, 100, 200, 400, 300));
+		frame = log.Commit(scene);
+		CHECK_EQ(frame.moves, 1);
+
+		CHECK_EQ(scene.Stats().repaints, 2);
+		CHECK_EQ(scene.Stats().moves, 2);
+		CHECK_EQ(scene.Stats().maxRepaintsPerFrame, 1);
+	}
+
+	// 바뀌지 않은 데스크톱은 다시 확인해도 아무것도 그리지 않고, 표시 단계가 밀린 동안의 이동은 창마다 한 번으로 합쳐짐
+	void TestPipelineFrames()
+	{
+		constexpr uint64_t Windows = 32;
+		SimulatedWindowSystem windowSystem{};
+		for (uint64_t i = 0; i < Windows; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 8) * 200;
+			const int32_t y = static_cast<int32_t>(i / 8) * 200;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, y, x + 180, y + 180 });
+		}
+
+		PipelineOptions options{};
+		// 타이머로 다시 확인하지 않음 (이 검사에서 명령은 모두 RunOnLayout 으로)
+		options.poll.fastIntervalUs = 0;
+		BorderPipeline pipeline(windowSystem, BorderStyle{}, options);
+		pipeline.Start([]() {});
+		RunOnLayout(pipeline, [](BorderTracker& tracker)
+			{
+				for (uint64_t i = 0; i < Windows; ++i)
+					tracker.AddWindow(MakeHandle(i));
+			});
+		pipeline.PumpPresent();
+		CHECK_EQ(pipeline.OverlayCount(), Windows);
+		const uint64_t createdPresents = windowSystem.QueryStats().presents;
+
+		// 정적인 데스크톱: 전체를 다시 맞춰도 (놓친 이벤트 복구와 같음) 반영할 것이 없음
+		for (int round = 0; round < 10; ++round)
+		{
+			RunOnLayout(pipeline, [](BorderTracker& tracker)
+				{
+					tracker.RefreshBorders();
+					tracker.RefreshGeometry();
+				});
+			pipeline.PumpPresent();
+		}
+		CHECK_EQ(windowSystem.QueryStats().presents, createdPresents);
+		CHECK_EQ(pipeline.SceneStatistics().repaints, 0);
+		CHECK_EQ(pipeline.SceneStatistics().presents, 0);
+
+		// 표시 스레드가 밀린 동안 창 0 을 다섯 번 옮기고, 창 1 은 옮겼다가 제자리로: 창 0 만 한 번 옮김
+		for (int32_t step = 1; step <= 5; ++step)
+		{
+			windowSystem.FindWindow(MakeHandle(0))->frame = WindowRect{ step * 10, 0, step * 10 + 180, 180 };
+			windowSystem.FindWindow(MakeHandle(1))->frame = (step == 5) ? WindowRect{ 200, 0, 380, 180 } : WindowRect{ 200 + step, 0, 380 + step, 180 };
+			RunOnLayout(pipeline, [](BorderTracker& tracker) { tracker.RefreshGeometry(); });
+		}
+		pipeline.PumpPresent();
+		const SceneFrameStats& frame = pipeline.SceneStatistics().lastFrame;
+		CHECK_EQ(frame.updates, 10);
+		CHECK_EQ(frame.dirtyNodes, 2);
+		CHECK_EQ(frame.presents, 1);
+		CHECK_EQ(frame.moves, 1);
+		CHECK_EQ(frame.unchanged, 1);
+		CHECK_EQ(frame.repaints, 0);
+		CHECK_EQ(windowSystem.QueryStats().presents, createdPresents + 1);
+
+		// 포그라운드 전환: 위치가 같아도 z 순서만 다시 맞추고 다시 그리지 않음
+		const uint64_t redraws = windowSystem.QueryStats().redraws;
+		windowSystem.BringToTop(MakeHandle(5));
+		RunOnLayout(pipeline, [](BorderTracker& tracker)
+			{
+				const uint64_t nowUs = NowUs();
+				tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, MakeHandle(5), 0, 0, 1, 1 }, nowUs);
+				tracker.Flush(nowUs + 1000000);
+			});
+		pipeline.PumpPresent();
+		CHECK_EQ(pipeline.SceneStatistics().lastFrame.restacks, 1);
+		CHECK_EQ(pipeline.SceneStatistics().lastFrame.repaints, 0);
+		CHECK_EQ(windowSystem.QueryStats().redraws, redraws);
+
+		std::printf("scene: %llu frames, %llu presents (%llu repaints, %llu moves, %llu restacks), %llu unchanged\n",
+			static_cast<unsigned long long>(pipeline.SceneStatistics().frames), static_cast<unsigned long long>(pipeline.SceneStatistics().presents),
+			static_cast<unsigned long long>(pipeline.SceneStatistics().repaints), static_cast<unsigned long long>(pipeline.SceneStatistics().moves),
+			static_cast<unsigned long long>(pipeline.SceneStatistics().restacks), static_cast<unsigned long long>(pipeline.SceneStatistics().unchanged));
+
+		pipeline.Stop();
+		pipeline.ReleaseOverlays();
+		CHECK_EQ(pipeline.SceneStatistics().nodes, 0);
+	}
+}
+
+int main()
+{
+	TestDiffBits();
+	TestCommitMergesUpdates();
+	TestPipelineFrames();
+	return TestResult("BorderSceneTest");
+}
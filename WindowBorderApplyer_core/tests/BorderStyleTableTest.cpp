@@ -0,0 +1,172 @@
+﻿// BorderStyleTable 이 같은 스타일 값을 레코드 하나로 합치고 DPI 마다 한 번만 해석하는지, 스타일을 바꿔도 이전 번호를 읽을 수 있는지,
+// 그리고 스타일 변경 (색만) 이 창 N 개에 정확히 N 번 다시 그리고 위치 조회는 0 번인지 (추적기와 파이프라인) 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. BorderStyleTableTest.cpp ../BorderStyleTable.cpp ../BorderScene.cpp ../BorderPipeline.cpp ../BorderAnimator.cpp ../BorderTracker.cpp ../WorkStealingPool.cpp -o BorderStyleTableTest
+
+#include "TestUtil.h"
+#include "BorderPipeline.h"
+#include "BorderStyleTable.h"
+#include "SimulatedWindowSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	BorderStyle StyleWithColor(uint32_t color)
+	{
+		BorderStyle style{};
+		style.color = color;
+		return style;
+	}
+
+	void AddWindows(SimulatedWindowSystem& windowSystem, uint64_t count)
+	{
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 16) * 120;
+			const int32_t y = static_cast<int32_t>(i / 16) * 120;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, y, x + 100, y + 100 });
+		}
+	}
+
+	// 같은 값은 번호 하나, DPI 마다 한 번만 해석
+	void TestInterning()
+	{
+		BorderStyleTable styles(StyleWithColor(0x0000FF));
+		const StyleId normal = styles.Resolve(DefaultDpi);
+		CHECK_EQ(styles.Resolve(DefaultDpi), normal);
+		CHECK_EQ(styles.Resolve(DefaultDpi), normal);
+		const StyleId scaled = styles.Resolve(192);
+		CHECK(scaled != normal);
+		CHECK(styles.Get(scaled).thickness > styles.Get(normal).thickness);
+		CHECK_EQ(styles.Get(scaled).dpi, 192);
+
+		CHECK_EQ(styles.Stats().resolves, 2);
+		CHECK_EQ(styles.Stats().hits, 2);
+		CHECK_EQ(styles.Size(), 2);
+
+		// 이미 있는 값을 넣으면 그 번호
+		CHECK_EQ(styles.Intern(ResolveBorderStyle(StyleWithColor(0x0000FF), DefaultDpi)), normal);
+		CHECK_EQ(styles.Size(), 2);
+
+		// 위치는 ComputeBorderVisual 과 같음
+		const WindowRect frame{ 100, 200, 500, 600 };
+		const BorderVisual expected = ComputeBorderVisual(frame, 192, StyleWithColor(0x0000FF));
+		const BorderVisual placed = styles.Expand(styles.Place(frame, 192));
+		CHECK(placed.SameShape(expected));
+		CHECK_EQ(placed.style, scaled);
+	}
+
+	// 스타일을 바꿔도 이전 번호는 그대로 읽을 수 있고, 되돌리면 이전 레코드를 다시 씀
+	void TestRestyleKeepsRecords()
+	{
+		BorderStyleTable styles(StyleWithColor(0x0000FF));
+		const StyleId before = styles.Resolve(DefaultDpi);
+
+		styles.SetStyle(StyleWithColor(0x00FF00));
+		const StyleId after = styles.Resolve(DefaultDpi);
+		CHECK(after != before);
+		CHECK_EQ(styles.Get(before).color, 0x0000FF);
+		CHECK_EQ(styles.Get(after).color, 0x00FF00);
+
+		styles.SetStyle(StyleWithColor(0x0000FF));
+		CHECK_EQ(styles.Resolve(DefaultDpi), before);
+		CHECK_EQ(styles.Size(), 2);
+		CHECK_EQ(styles.Stats().interned, 2);
+		CHECK_EQ(styles.Stats().restyles, 2);
+	}
+
+	// 레코드는 묶음 단위로만 늘어나고, 가득 차면 마지막 번호
+	void TestCapacity()
+	{
+		BorderStyleTable styles(BorderStyle{});
+		ResolvedStyle resolved = ResolveBorderStyle(BorderStyle{}, DefaultDpi);
+		for (size_t i = 0; i < BorderStyleTable::ChunkSize * 2 + 1; ++i)
+		{
+			resolved.color = static_cast<uint32_t>(i);
+			CHECK_EQ(styles.Intern(resolved), static_cast<StyleId>(i));
+		}
+		CHECK_EQ(styles.Get(static_cast<StyleId>(BorderStyleTable::ChunkSize)).color, static_cast<uint32_t>(BorderStyleTable::ChunkSize));
+		CHECK(BorderStyleTable::Capacity < NoStyle + 1u);
+	}
+
+	// 추적기: 창 N 개의 색을 바꾸면 N 번 다시 그리고 위치는 조회하지 않음
+	void TestTrackerRestyle()
+	{
+		constexpr uint64_t Windows = 64;
+		SimulatedWindowSystem windowSystem{};
+		AddWindows(windowSystem, Windows);
+		BorderTracker tracker(windowSystem, StyleWithColor(0x0000FF), GeometryPollPolicy{ 0, 0 });
+		for (uint64_t i = 0; i < Windows; ++i)
+			tracker.AddWindow(MakeHandle(i));
+
+		const SimulatedQueryStats before = windowSystem.QueryStats();
+		const WindowRect bounds = tracker.Find(MakeHandle(3))->presented.bounds;
+		CHECK_EQ(tracker.SetStyle(StyleWithColor(0x00FF00)), Windows);
+
+		const SimulatedQueryStats& after = windowSystem.QueryStats();
+		CHECK_EQ(after.frameBoundsQueries, before.frameBoundsQueries);
+		CHECK_EQ(after.dpiQueries, before.dpiQueries);
+		CHECK_EQ(after.redraws - before.redraws, Windows);
+		CHECK(tracker.Find(MakeHandle(3))->presented.bounds == bounds);
+		CHECK_EQ(tracker.Styles().Get(tracker.Find(MakeHandle(3))->presented.style).color, 0x00FF00);
+		// 창이 몇 개든 레코드는 스타일 값마다 하나
+		CHECK_EQ(tracker.Styles().Size(), 2);
+
+		// margin 이 바뀌면 보낸 위치에서 다시 맞춤 (조회 없이)
+		BorderStyle wide = StyleWithColor(0x00FF00);
+		wide.borderLength += 2;
+		tracker.SetStyle(wide);
+		CHECK_EQ(windowSystem.QueryStats().frameBoundsQueries, before.frameBoundsQueries);
+		CHECK_EQ(tracker.Find(MakeHandle(3))->presented.bounds.left, bounds.left - 2);
+		CHECK_EQ(tracker.Find(MakeHandle(3))->presented.bounds.Width(), bounds.Width() + 4);
+	}
+
+	// 파이프라인: 표시 명령은 번호만 보내고, 장면은 색만 바뀐 것을 노드마다 한 번 다시 그림
+	void TestPipelineRecolor()
+	{
+		constexpr uint64_t Windows = 100;
+		SimulatedWindowSystem windowSystem{};
+		AddWindows(windowSystem, Windows);
+
+		PipelineOptions options{};
+		options.poll.fastIntervalUs = 0;
+		BorderPipeline pipeline(windowSystem, StyleWithColor(0x0000FF), options);
+		pipeline.Start([]() {});
+		RunOnLayout(pipeline, [](BorderTracker& tracker)
+			{
+				for (uint64_t i = 0; i < Windows; ++i)
+					tracker.AddWindow(MakeHandle(i));
+			});
+		pipeline.PumpPresent();
+		CHECK_EQ(pipeline.OverlayCount(), Windows);
+
+		const SimulatedQueryStats before = windowSystem.QueryStats();
+		CHECK(pipeline.SetStyle(StyleWithColor(0x00FF00)));
+		RunOnLayout(pipeline, [](BorderTracker&) {});
+		pipeline.PumpPresent();
+
+		const SceneFrameStats& frame = pipeline.SceneStatistics().lastFrame;
+		CHECK_EQ(frame.repaints, Windows);
+		CHECK_EQ(frame.moves, 0);
+		CHECK_EQ(windowSystem.QueryStats().redraws - before.redraws, Windows);
+		CHECK_EQ(windowSystem.QueryStats().frameBoundsQueries, before.frameBoundsQueries);
+		std::printf("recolor: %llu windows, %llu repaints, %llu frame queries\n", static_cast<unsigned long long>(Windows),
+			static_cast<unsigned long long>(frame.repaints),
+			static_cast<unsigned long long>(windowSystem.QueryStats().frameBoundsQueries - before.frameBoundsQueries));
+
+		pipeline.Stop();
+		pipeline.ReleaseOverlays();
+	}
+}
+
+int main()
+{
+	TestInterning();
+	TestRestyleKeepsRecords();
+	TestCapacity();
+	TestTrackerRestyle();
+	TestPipelineRecolor();
+	return TestResult("BorderStyleTableTest");
+}
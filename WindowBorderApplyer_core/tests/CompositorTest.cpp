@@ -0,0 +1,270 @@
+﻿// 공유 오버레이 (BorderCompositor) 가 모든 테두리를 모니터마다 표면 하나에 그리고, z 순서대로 가리며,
+// 바뀐 영역이 있는 모니터만 프레임마다 한 번 반영하는지 소프트웨어 표면으로 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. CompositorTest.cpp ../BorderCompositor.cpp ../BorderRaster.cpp ../CornerMask.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o CompositorTest
+
+#include "TestUtil.h"
+#include "BorderCompositor.h"
+#include "BorderRaster.h"
+#include "BorderTracker.h"
+#include "SimulatedWindowSystem.h"
+
+namespace
+{
+	constexpr uint32_t Red = 0x000000FF;
+	constexpr uint32_t Blue = 0x00FF0000;
+
+	BorderCompositor::SurfaceFactory SoftwareSurfaces()
+	{
+		return [](const MonitorArea& monitor)
+			{
+				return std::make_unique<SoftwareSurface>(monitor.area.Width(), monitor.area.Height());
+			};
+	}
+
+	const SoftwareSurface& SurfaceOf(const BorderCompositor& compositor, size_t monitor)
+	{
+		return *static_cast<const SoftwareSurface*>(compositor.Surface(monitor));
+	}
+
+	BorderVisual VisualOf(const WindowRect& frame, uint32_t color)
+	{
+		BorderStyle style{};
+		style.color = color;
+		return ComputeBorderVisual(frame, DefaultDpi, style);
+	}
+
+	// 테두리 띠만 칠하고 창 안과 밖은 투명
+	void TestBorderPixels()
+	{
+		BorderCompositor compositor(SoftwareSurfaces());
+		compositor.SetMonitors({ MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 640, 480 } } });
+
+		// bounds {97, 97, 303, 203}, 띠는 1 픽셀 안쪽부터 2 픽셀
+		const uint32_t border = compositor.Add(MakeHandle(0));
+		compositor.Update(border, VisualOf(WindowRect{ 100, 100, 300, 200 }, Red));
+		CHECK_EQ(compositor.Compose(), 1);
+
+		const SoftwareSurface& surface = SurfaceOf(compositor, 0);
+		const uint32_t red = BorderPixel(Red);
+		CHECK_EQ(red, 0xFFFF0000u);
+		CHECK_EQ(surface.PixelAt(150, 98), red);
+		CHECK_EQ(surface.PixelAt(150, 201), red);
+		CHECK_EQ(surface.PixelAt(98, 150), red);
+		CHECK_EQ(surface.PixelAt(301, 150), red);
+		CHECK_EQ(surface.PixelAt(97, 150), 0);
+		CHECK_EQ(surface.PixelAt(150, 100), 0);
+		CHECK_EQ(surface.PixelAt(200, 150), 0);
+
+		// 숨기면 그 영역만 지우고 반영
+		compositor.Hide(border);
+		CHECK_EQ(compositor.Compose(), 1);
+		CHECK_EQ(surface.PixelAt(150, 98), 0);
+		CHECK_EQ(surface.PresentedPixels(), 640 * 480 + 206 * 106);
+	}
+
+	// 위에 있는 창의 프레임 안으로 들어간 아래 창의 테두리는 보이지 않고, 포그라운드가 바뀌면 뒤집힘
+	void TestZOrderClipping()
+	{
+		BorderCompositor compositor(SoftwareSurfaces());
+		compositor.SetMonitors({ MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 640, 480 } } });
+
+		const uint32_t lower = compositor.Add(MakeHandle(0));
+		const uint32_t upper = compositor.Add(MakeHandle(1));
+		compositor.Update(lower, VisualOf(WindowRect{ 100, 100, 300, 200 }, Red));
+		compositor.Update(upper, VisualOf(WindowRect{ 200, 150, 400, 300 }, Blue));
+		compositor.Compose();
+
+		const SoftwareSurface& surface = SurfaceOf(compositor, 0);
+		const uint32_t red = BorderPixel(Red);
+		const uint32_t blue = BorderPixel(Blue);
+		// 아래 창의 오른쪽 띠 (x 300..302): 위 창의 프레임 (y 150..300) 안은 가려짐
+		CHECK_EQ(surface.PixelAt(300, 120), red);
+		CHECK_EQ(surface.PixelAt(300, 160), 0);
+		// 위 창의 위쪽 띠 (y 148..150) 는 아래 창의 프레임 위로 그려짐
+		CHECK_EQ(surface.PixelAt(250, 149), blue);
+
+		compositor.Raise(lower);
+		CHECK_EQ(compositor.Compose(), 1);
+		CHECK_EQ(surface.PixelAt(300, 160), red);
+		CHECK_EQ(surface.PixelAt(250, 149), 0);
+		CHECK_EQ(surface.PixelAt(350, 149), blue);
+
+		// 제거하면 가려졌던 테두리가 다시 보임
+		compositor.Remove(lower);
+		compositor.Compose();
+		CHECK_EQ(surface.PixelAt(250, 149), blue);
+		CHECK_EQ(surface.PixelAt(300, 120), 0);
+		CHECK_EQ(compositor.Stats().borders, 1);
+	}
+
+	// 위 창의 테두리 띠도 아래 창의 띠를 가림. 띠와 프레임 사이의 틈 (borderLength 가 두께보다 넓을 때) 으로는 아래 창이 보임
+	void TestStripOcclusion()
+	{
+		BorderCompositor compositor(SoftwareSurfaces());
+		compositor.SetMonitors({ MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 640, 480 } } });
+
+		// 아래 창의 아래쪽 띠는 y 200..202, 위 창 (반투명) 의 위쪽 띠는 y 201..203
+		const uint32_t lower = compositor.Add(MakeHandle(0));
+		const uint32_t upper = compositor.Add(MakeHandle(1));
+		BorderStyle translucent{};
+		translucent.color = Blue;
+		translucent.opacity = 128;
+		compositor.Update(lower, VisualOf(WindowRect{ 100, 100, 300, 200 }, Red));
+		compositor.Update(upper, ComputeBorderVisual(WindowRect{ 150, 203, 400, 300 }, DefaultDpi, translucent));
+		compositor.Compose();
+
+		const SoftwareSurface& surface = SurfaceOf(compositor, 0);
+		const uint32_t red = BorderPixel(Red);
+		const uint32_t blue = BorderPixel(Blue, 128);
+		CHECK_EQ(blue, 0x80000080u);
+		CHECK_EQ(surface.PixelAt(200, 200), red);
+		CHECK_EQ(surface.PixelAt(200, 201), blue);
+		CHECK_EQ(surface.PixelAt(120, 201), red);
+
+		// 띠는 bounds 안쪽 1..3, 프레임은 6 부터: 위 창의 띠 (y 205..207) 아래 틈 (y 207..210) 으로 아래 창의 띠 (y 206..208) 가 보임
+		BorderStyle wide{};
+		wide.color = Blue;
+		wide.borderLength = 6;
+		compositor.Update(lower, VisualOf(WindowRect{ 100, 100, 300, 206 }, Red));
+		compositor.Update(upper, ComputeBorderVisual(WindowRect{ 150, 210, 400, 300 }, DefaultDpi, wide));
+		compositor.Compose();
+		CHECK_EQ(surface.PixelAt(200, 206), BorderPixel(Blue));
+		CHECK_EQ(surface.PixelAt(200, 207), red);
+		CHECK_EQ(surface.PixelAt(200, 208), 0);
+	}
+
+	// 테두리가 몇 개든 바뀐 모니터마다 한 번만 반영하고, 바뀐 영역 (이전 자리와 새 자리) 만 다시 그림
+	void TestDirtyPresents()
+	{
+		constexpr uint32_t Borders = 500;
+
+		BorderCompositor compositor(SoftwareSurfaces());
+		compositor.SetMonitors({
+			MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 1920, 1080 } },
+			MonitorArea{ HandleFromBits(2), WindowRect{ 1920, 0, 3840, 1080 } },
+		});
+
+		std::vector<uint32_t> borders{};
+		for (uint32_t i = 0; i < Borders; ++i)
+		{
+			borders.push_back(compositor.Add(MakeHandle(i)));
+			const int32_t x = static_cast<int32_t>(i % 2 == 0 ? 0 : 1920) + static_cast<int32_t>(i % 50) * 20;
+			const int32_t y = static_cast<int32_t>(i / 50) * 40;
+			compositor.Update(borders.back(), VisualOf(WindowRect{ x + 10, y + 10, x + 600, y + 500 }, Red));
+		}
+		CHECK_EQ(compositor.Compose(), 2);
+		CHECK_EQ(compositor.Stats().presents, 2);
+		CHECK_EQ(compositor.Stats().frames, 1);
+		CHECK_EQ(compositor.Stats().surfaces, 2);
+		CHECK_EQ(compositor.Stats().surfaceBytes, 2ull * 1920 * 1080 * 4);
+
+		// 바뀐 것이 없으면 그리지도 반영하지도 않음
+		CHECK_EQ(compositor.Compose(), 0);
+		compositor.Update(borders[0], VisualOf(WindowRect{ 10, 10, 600, 500 }, Red));
+		CHECK_EQ(compositor.Compose(), 0);
+
+		// 한 창을 옮기면 그 모니터만, 이전 자리와 새 자리를 합친 영역만
+		const SoftwareSurface& surface = SurfaceOf(compositor, 0);
+		const uint64_t presentedBefore = surface.PresentedPixels();
+		compositor.Update(borders[0], VisualOf(WindowRect{ 20, 10, 610, 500 }, Red));
+		CHECK_EQ(compositor.Compose(), 1);
+		CHECK_EQ(surface.Presents(), 2);
+		CHECK_EQ(SurfaceOf(compositor, 1).Presents(), 1);
+		CHECK_EQ(surface.PresentedPixels() - presentedBefore, (613 - 7) * (503 - 7));
+		CHECK_EQ(compositor.Stats().surfaceBytes, 2ull * 1920 * 1080 * 4);
+	}
+
+	// 두 모니터에 걸친 테두리는 양쪽 표면의 각자 좌표에 그려짐
+	void TestSpanningMonitors()
+	{
+		BorderCompositor compositor(SoftwareSurfaces());
+		compositor.SetMonitors({
+			MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 1000, 800 } },
+			MonitorArea{ HandleFromBits(2), WindowRect{ 1000, 0, 2000, 800 } },
+		});
+		compositor.Compose();
+
+		const uint32_t border = compositor.Add(MakeHandle(0));
+		compositor.Update(border, VisualOf(WindowRect{ 900, 100, 1100, 200 }, Red));
+		CHECK_EQ(compositor.Compose(), 2);
+
+		const uint32_t red = BorderPixel(Red);
+		CHECK_EQ(SurfaceOf(compositor, 0).PixelAt(950, 98), red);
+		CHECK_EQ(SurfaceOf(compositor, 1).PixelAt(50, 98), red);
+		CHECK_EQ(SurfaceOf(compositor, 1).PixelAt(101, 150), red);
+		CHECK_EQ(SurfaceOf(compositor, 0).PixelAt(950, 150), 0);
+	}
+
+	// 추적기의 틱마다 한 번 그리고, 포그라운드 창의 테두리를 맨 위로 올림
+	void TestTrackerFrames()
+	{
+		SimulatedWindowSystem windowSystem;
+		windowSystem.AddWindow(MakeHandle(0), WindowRect{ 100, 100, 500, 400 });
+		windowSystem.AddWindow(MakeHandle(1), WindowRect{ 300, 200, 700, 600 });
+		windowSystem.AddWindow(MakeHandle(2), WindowRect{ 1000, 100, 1300, 400 });
+
+		BorderCompositor compositor(SoftwareSurfaces());
+		compositor.SetMonitors({ MonitorArea{ windowSystem.PrimaryMonitor(), WindowRect{ 0, 0, 1920, 1080 } } });
+		compositor.Compose();
+		CompositedWindowSystem composited(windowSystem, compositor);
+
+		BorderStyle style{};
+		style.color = Red;
+		BorderTracker tracker(composited, style);
+		std::vector<WindowHandle> windows{};
+		composited.EnumerateWindows(windows);
+		tracker.RefreshWindows(windows);
+		tracker.AssignAll();
+		CHECK_EQ(compositor.Stats().borders, 3);
+		CHECK_EQ(compositor.Stats().frames, 2);
+		// 창마다 오버레이를 만드는 방식과 달리 오버레이 창을 만들지 않음
+		CHECK_EQ(windowSystem.QueryStats().presents, 0);
+
+		// 아래 창 (0) 의 오른쪽 띠 (x 500..502) 는 위 창 (1) 의 프레임 안에서 가려짐
+		const SoftwareSurface& surface = SurfaceOf(compositor, 0);
+		const uint32_t red = BorderPixel(Red);
+		CHECK_EQ(surface.PixelAt(501, 150), red);
+		CHECK_EQ(surface.PixelAt(501, 300), 0);
+
+		// 두 창이 같은 프레임에 움직여도 반영은 한 번
+		uint32_t eventTime = 0;
+		uint64_t nowUs = 1000000;
+		windowSystem.FindWindow(MakeHandle(1))->frame.left += 10;
+		windowSystem.FindWindow(MakeHandle(2))->frame.top += 10;
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(1), 0, 0, 1, ++eventTime }, nowUs);
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(2), 0, 0, 1, ++eventTime }, nowUs);
+		tracker.Flush(nowUs + 16000);
+		CHECK_EQ(compositor.Stats().frames, 3);
+		CHECK_EQ(surface.Presents(), 3);
+
+		// 창 0 이 포그라운드가 되면 그 테두리가 창 1 의 프레임 위로 올라옴
+		nowUs += 100000;
+		windowSystem.BringToTop(MakeHandle(0));
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, MakeHandle(0), 0, 0, 1, ++eventTime }, nowUs);
+		tracker.Flush(nowUs + 16000);
+		CHECK_EQ(surface.PixelAt(501, 300), red);
+
+		// 창이 사라지면 테두리도 지워짐
+		nowUs += 100000;
+		windowSystem.RemoveWindow(MakeHandle(2));
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectDestroy, MakeHandle(2), 0, 0, 1, ++eventTime }, nowUs);
+		tracker.Flush(nowUs + 16000);
+		CHECK_EQ(compositor.Stats().borders, 2);
+		CHECK_EQ(surface.PixelAt(1100, 108), 0);
+
+		tracker.Clear();
+		CHECK_EQ(compositor.Stats().borders, 0);
+		CHECK_EQ(surface.PixelAt(150, 98), 0);
+	}
+}
+
+int main()
+{
+	TestBorderPixels();
+	TestZOrderClipping();
+	TestStripOcclusion();
+	TestDirtyPresents();
+	TestSpanningMonitors();
+	TestTrackerFrames();
+	return TestResult("CompositorTest");
+}
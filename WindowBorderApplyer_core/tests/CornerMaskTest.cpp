@@ -0,0 +1,384 @@
+﻿// 둥근 테두리의 소프트웨어 그리기를 그림으로 비교합니다. 캐시한 모서리 (CornerMask) 로 그린 RedrawBorder 결과가 해석적으로 계산한
+// 고해상도 (픽셀마다 16 x 16 점) 기준 그림과 채널마다 허용 오차 안인지, 네 모서리가 대칭인지, 반지름 0 이 직각 띠와 같은지,
+// 옮김 / 크기 / 색 변경을 바뀐 조각만 다시 그린 결과가 처음부터 그린 것과 같은지, 공유 오버레이 (BorderCompositor) 가 같은 픽셀을 쓰는지,
+// 공유 오버레이에서 위 창의 둥근 모서리 밑으로 아래 창의 띠가 원호 밖으로만 섞여 보이는지,
+// 그리고 캐시가 (반지름, 두께) 마다 한 번만 계산하고 상한을 넘으면 오래된 것을 버리는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. CornerMaskTest.cpp ../CornerMask.cpp ../BorderRaster.cpp ../BorderCompositor.cpp -o CornerMaskTest
+
+#include "TestUtil.h"
+#include "BorderCompositor.h"
+#include "BorderRaster.h"
+#include "CornerMask.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t Red = 0x000000FF;
+	constexpr uint32_t Green = 0x0000FF00;
+	constexpr uint32_t Orange = 0x0000A5FF;
+
+	// 기준 그림은 픽셀마다 16 x 16 점, 캐시한 모서리는 8 x 8 점이라 가장자리 픽셀에서 조금 다름
+	constexpr int32_t MaxChannelError = 16;
+	constexpr double MaxMeanError = 0.1;
+
+	struct Canvas
+	{
+		int32_t width;
+		int32_t height;
+		std::vector<uint32_t> pixels;
+
+		Canvas(int32_t width, int32_t height) : width(width), height(height), pixels(static_cast<size_t>(width) * height, 0) {}
+
+		uint32_t* Data() { return pixels.data(); }
+		size_t Stride() const { return static_cast<size_t>(width); }
+		uint32_t At(int32_t x, int32_t y) const { return pixels[static_cast<size_t>(y) * width + x]; }
+	};
+
+	BorderVisual VisualOf(const WindowRect& frame, uint32_t dpi, uint32_t color, float radius, uint8_t alpha = 255)
+	{
+		BorderStyle style{};
+		style.color = color;
+		style.cornerRadius = radius;
+		style.opacity = alpha;
+		BorderVisual visual = ComputeBorderVisual(frame, dpi, style);
+		visual.bounds = visual.LocalRect();
+		return visual;
+	}
+
+	/// <summary> 점 (x, y) 가 모서리 반지름 radius 의 둥근 사각형 (left, top, right, bottom) 안인지 </summary>
+	bool InsideRounded(double x, double y, double left, double top, double right, double bottom, double radius)
+	{
+		if (x < left || x >= right || y < top || y >= bottom)
+			return false;
+		if (radius <= 0.0)
+			return true;
+		const double cx = std::clamp(x, left + radius, right - radius);
+		const double cy = std::clamp(y, top + radius, bottom - radius);
+		return (x - cx) * (x - cx) + (y - cy) * (y - cy) <= radius * radius;
+	}
+
+	/// <summary> 해석적인 기준 그림: 바깥 둥근 사각형 안이면서 안쪽 (두께만큼 들어간, 반지름 radius - thickness) 둥근 사각형 밖 </summary>
+	Canvas ReferenceBorder(const BorderVisual& visual)
+	{
+		constexpr int32_t Grid = 16;
+		Canvas canvas(visual.bounds.Width(), visual.bounds.Height());
+		const double left = visual.bounds.left + 1;
+		const double top = visual.bounds.top + 1;
+		const double right = visual.bounds.right - 1;
+		const double bottom = visual.bounds.bottom - 1;
+		const double radius = visual.cornerRadius;
+		const double thickness = visual.thickness;
+		const uint32_t pixel = BorderPixel(visual.color, visual.alpha);
+
+		for (int32_t y = 0; y < canvas.height; ++y)
+		{
+			for (int32_t x = 0; x < canvas.width; ++x)
+			{
+				int32_t count = 0;
+				for (int32_t sy = 0; sy < Grid; ++sy)
+				{
+					for (int32_t sx = 0; sx < Grid; ++sx)
+					{
+						const double px = x + (sx + 0.5) / Grid;
+						const double py = y + (sy + 0.5) / Grid;
+						if (InsideRounded(px, py, left, top, right, bottom, radius) &&
+							!InsideRounded(px, py, left + thickness, top + thickness, right - thickness, bottom - thickness, std::max(radius - thickness, 0.0)))
+							count++;
+					}
+				}
+
+				uint32_t scaled = 0;
+				for (int32_t shift = 0; shift < 32; shift += 8)
+				{
+					const double channel = ((pixel >> shift) & 0xFF) * count / static_cast<double>(Grid * Grid);
+					scaled |= static_cast<uint32_t>(std::lround(channel)) << shift;
+				}
+				canvas.pixels[static_cast<size_t>(y) * canvas.width + x] = scaled;
+			}
+		}
+		return canvas;
+	}
+
+	struct ImageDiff
+	{
+		int32_t maxError = 0;
+		double meanError = 0.0;
+		size_t differing = 0;
+	};
+
+	ImageDiff Compare(const Canvas& actual, const Canvas& expected)
+	{
+		ImageDiff diff{};
+		uint64_t total = 0;
+		for (size_t i = 0; i < actual.pixels.size(); ++i)
+		{
+			bool differs = false;
+			for (int32_t shift = 0; shift < 32; shift += 8)
+			{
+				const int32_t error = std::abs(static_cast<int32_t>((actual.pixels[i] >> shift) & 0xFF) - static_cast<int32_t>((expected.pixels[i] >> shift) & 0xFF));
+				diff.maxError = std::max(diff.maxError, error);
+				total += static_cast<uint64_t>(error);
+				differs |= error != 0;
+			}
+			diff.differing += differs ? 1 : 0;
+		}
+		diff.meanError = static_cast<double>(total) / static_cast<double>(actual.pixels.size() * 4);
+		return diff;
+	}
+
+	Canvas Draw(const BorderVisual& visual)
+	{
+		Canvas canvas(visual.bounds.Width(), visual.bounds.Height());
+		RedrawBorder(canvas.Data(), canvas.Stride(), BorderVisual{}, visual);
+		return canvas;
+	}
+
+	// DPI 마다 (반지름과 두께가 함께 커짐) 기준 그림과 허용 오차 안
+	void TestMatchesReference()
+	{
+		for (uint32_t dpi : { 96u, 144u, 192u })
+		{
+			for (uint8_t alpha : { uint8_t(255), uint8_t(160) })
+			{
+				const BorderVisual visual = VisualOf(WindowRect{ 0, 0, 120, 90 }, dpi, Orange, 8.0f, alpha);
+				RoundedBorderParts parts{};
+				CHECK(MakeRoundedBorderParts(visual, parts));
+
+				const ImageDiff diff = Compare(Draw(visual), ReferenceBorder(visual));
+				CHECK(diff.maxError <= MaxChannelError);
+				CHECK(diff.meanError <= MaxMeanError);
+				std::printf("dpi %u alpha %u: radius %.2f thickness %d, max %d mean %.3f differing %zu\n", dpi, alpha, visual.cornerRadius,
+					visual.thickness, diff.maxError, diff.meanError, diff.differing);
+			}
+		}
+	}
+
+	// 네 모서리는 서로 뒤집은 그림
+	void TestCornersAreSymmetric()
+	{
+		const BorderVisual visual = VisualOf(WindowRect{ 0, 0, 70, 50 }, 144, Green, 10.0f);
+		const Canvas canvas = Draw(visual);
+		bool symmetric = true;
+		for (int32_t y = 0; y < canvas.height; ++y)
+		{
+			for (int32_t x = 0; x < canvas.width; ++x)
+			{
+				const uint32_t pixel = canvas.At(x, y);
+				symmetric &= pixel == canvas.At(canvas.width - 1 - x, y);
+				symmetric &= pixel == canvas.At(x, canvas.height - 1 - y);
+			}
+		}
+		CHECK(symmetric);
+		// 바깥 모서리 픽셀은 비고, 곧은 변은 꽉 참
+		CHECK_EQ(canvas.At(1, 1), 0);
+		CHECK_EQ(canvas.At(canvas.width / 2, 1), BorderPixel(Green));
+		CHECK_EQ(canvas.At(1, canvas.height / 2), BorderPixel(Green));
+	}
+
+	// 반지름 0 이면 직각 띠와 비트 단위로 같음
+	void TestZeroRadiusIsSquare()
+	{
+		const BorderVisual visual = VisualOf(WindowRect{ 0, 0, 60, 40 }, 120, Red, 0.0f);
+		RoundedBorderParts parts{};
+		CHECK(!MakeRoundedBorderParts(visual, parts));
+
+		Canvas expected(visual.bounds.Width(), visual.bounds.Height());
+		WindowRect strips[4];
+		BorderStrips(visual, strips);
+		for (const WindowRect& strip : strips)
+			FillPixels(expected.Data(), expected.Stride(), strip, BorderPixel(Red));
+		CHECK(Draw(visual).pixels == expected.pixels);
+	}
+
+	// 옮김 / 크기 / 색 / 반지름 변경을 이어서 다시 그린 결과가 처음부터 그린 것과 같음
+	void TestIncrementalMatchesFresh()
+	{
+		constexpr int32_t Width = 160;
+		constexpr int32_t Height = 120;
+		const auto at = [](const WindowRect& rect, uint32_t color, float radius, uint32_t dpi)
+			{
+				BorderStyle style{};
+				style.color = color;
+				style.cornerRadius = radius;
+				return ComputeBorderVisual(rect, dpi, style);
+			};
+		const BorderVisual steps[] = {
+			at(WindowRect{ 10, 10, 100, 80 }, Red, 8.0f, 96),
+			at(WindowRect{ 14, 12, 104, 82 }, Red, 8.0f, 96),
+			at(WindowRect{ 14, 12, 130, 100 }, Red, 8.0f, 96),
+			at(WindowRect{ 14, 12, 130, 100 }, Green, 8.0f, 96),
+			at(WindowRect{ 14, 12, 130, 100 }, Green, 8.0f, 144),
+			at(WindowRect{ 14, 12, 130, 100 }, Green, 0.0f, 144),
+			at(WindowRect{ 20, 20, 60, 50 }, Orange, 12.0f, 192),
+		};
+
+		Canvas incremental(Width, Height);
+		BorderVisual previous{};
+		for (const BorderVisual& step : steps)
+		{
+			RedrawBorder(incremental.Data(), incremental.Stride(), previous, step);
+			previous = step;
+
+			Canvas fresh(Width, Height);
+			RedrawBorder(fresh.Data(), fresh.Stride(), BorderVisual{}, step);
+			CHECK(incremental.pixels == fresh.pixels);
+		}
+	}
+
+	// 공유 오버레이가 모니터 표면에 그린 둥근 테두리는 창마다 그린 것과 같은 픽셀
+	void TestCompositorMatchesRaster()
+	{
+		BorderCompositor compositor([](const MonitorArea& monitor)
+			{
+				return std::make_unique<SoftwareSurface>(monitor.area.Width(), monitor.area.Height());
+			});
+		compositor.SetMonitors({ MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 320, 240 } } });
+
+		BorderStyle style{};
+		style.color = Orange;
+		style.cornerRadius = 8.0f;
+		const BorderVisual visual = ComputeBorderVisual(WindowRect{ 40, 30, 200, 150 }, 144, style);
+		const uint32_t border = compositor.Add(HandleFromBits(0xB0000));
+		compositor.Update(border, visual);
+		CHECK_EQ(compositor.Compose(), 1);
+
+		BorderVisual local = visual;
+		local.bounds = visual.LocalRect();
+		const Canvas expected = Draw(local);
+		const SoftwareSurface& surface = *static_cast<const SoftwareSurface*>(compositor.Surface(0));
+		bool same = true;
+		for (int32_t y = 0; y < expected.height; ++y)
+		{
+			for (int32_t x = 0; x < expected.width; ++x)
+				same &= surface.PixelAt(visual.bounds.left + x, visual.bounds.top + y) == expected.At(x, y);
+		}
+		CHECK(same);
+	}
+
+	// 위 창의 둥근 모서리 정사각형을 지나는 아래 창의 띠: 원호 밖은 아래 창, 선 위는 덮임만큼 섞임, 안쪽 원호 안 (위 창) 은 가려짐.
+	// 정사각형을 통째로 가리거나 (빈 네모) 덮임 0 인 픽셀을 투명으로 덮어쓰지 않음
+	void TestCompositorBlendsCornerOverlap()
+	{
+		BorderCompositor compositor([](const MonitorArea& monitor)
+			{
+				return std::make_unique<SoftwareSurface>(monitor.area.Width(), monitor.area.Height());
+			});
+		compositor.SetMonitors({ MonitorArea{ HandleFromBits(1), WindowRect{ 0, 0, 320, 240 } } });
+
+		BorderStyle rounded{};
+		rounded.color = Orange;
+		rounded.cornerRadius = 8.0f;
+		const BorderVisual upper = ComputeBorderVisual(WindowRect{ 100, 80, 260, 200 }, 96, rounded);
+		RoundedBorderParts parts{};
+		CHECK(MakeRoundedBorderParts(upper, parts));
+		const WindowRect& square = parts.corners[BorderCorner::TopLeft];
+		const CornerMask& mask = *parts.mask;
+
+		BorderStyle straight{};
+		straight.color = Green;
+		BorderVisual lower = ComputeBorderVisual(WindowRect{ 0, 0, 100, 100 }, 96, straight);
+
+		const uint32_t lowerBorder = compositor.Add(HandleFromBits(0xB0000));
+		const uint32_t upperBorder = compositor.Add(HandleFromBits(0xB0004));
+		compositor.Update(upperBorder, upper);
+		const SoftwareSurface& surface = *static_cast<const SoftwareSurface*>(compositor.Surface(0));
+		const uint32_t upperPixel = BorderPixel(Orange);
+		const uint32_t lowerPixel = BorderPixel(Green);
+		const auto scale = [](uint32_t pixel, uint32_t coverage)
+			{
+				uint32_t scaled = 0;
+				for (int32_t shift = 0; shift < 32; shift += 8)
+					scaled |= static_cast<uint32_t>(std::lround(((pixel >> shift) & 0xFF) * coverage / 255.0)) << shift;
+				return scaled;
+			};
+
+		// 아래 창의 오른쪽 띠 (bounds 안쪽 1 부터 두께만큼) 를 정사각형의 열 column, column + 1 에 놓음
+		for (int32_t column : { 0, 3, 6 })
+		{
+			const int32_t right = square.left + column + 1 + lower.thickness;
+			lower.bounds = WindowRect{ right - 120, square.top - 40, right, square.bottom + 40 };
+			compositor.Update(lowerBorder, lower);
+			compositor.Compose();
+
+			const WindowRect strip{ lower.bounds.right - 1 - lower.thickness, lower.bounds.top + 1, lower.bounds.right - 1, lower.bounds.bottom - 1 };
+			int32_t maxError = 0;
+			for (int32_t y = square.top; y < square.bottom; ++y)
+			{
+				for (int32_t x = square.left; x < square.right; ++x)
+				{
+					const int32_t mx = x - square.left;
+					const int32_t my = y - square.top;
+					uint32_t expected = scale(upperPixel, mask.At(BorderCorner::TopLeft, mx, my));
+					if (x >= strip.left && x < strip.right && y >= strip.top && y < strip.bottom)
+						expected += scale(lowerPixel, mask.OutsideAt(BorderCorner::TopLeft, mx, my));
+					const uint32_t actual = surface.PixelAt(x, y);
+					for (int32_t shift = 0; shift < 32; shift += 8)
+						maxError = std::max(maxError, std::abs(static_cast<int32_t>((actual >> shift) & 0xFF) - static_cast<int32_t>((expected >> shift) & 0xFF)));
+				}
+			}
+			CHECK(maxError <= 1);
+		}
+
+		// 맨 바깥 구석 픽셀은 원호 밖이라 아래 창 그대로, 정사각형 안쪽 구석은 안쪽 원호 안이라 가려짐
+		lower.bounds = WindowRect{ square.left + 1 + lower.thickness - 120, square.top - 40, square.left + 1 + lower.thickness, square.bottom + 40 };
+		compositor.Update(lowerBorder, lower);
+		compositor.Compose();
+		CHECK_EQ(surface.PixelAt(square.left, square.top), lowerPixel);
+		lower.bounds = WindowRect{ square.right + lower.thickness - 120, square.top - 40, square.right + lower.thickness, square.bottom + 40 };
+		compositor.Update(lowerBorder, lower);
+		compositor.Compose();
+		CHECK_EQ(surface.PixelAt(square.right - 1, square.bottom - 1), 0);
+	}
+
+	// 같은 키는 같은 모서리, DPI / 두께가 바뀌면 새로 계산, 상한을 넘으면 오래된 것부터 버림
+	void TestCache()
+	{
+		CornerMaskCache cache{};
+		const auto first = cache.Get(8.0f, 2);
+		CHECK(first != nullptr);
+		CHECK(cache.Get(8.0f, 2) == first);
+		// 1/4 픽셀 단위로 반올림한 키
+		CHECK(cache.Get(8.1f, 2) == first);
+		CHECK_EQ(cache.Stats().builds, 1);
+		CHECK_EQ(cache.Stats().hits, 2);
+
+		// 144 DPI: 반지름과 두께가 함께 바뀌어 새 모서리
+		const auto scaled = cache.Get(12.0f, 3);
+		CHECK(scaled != first);
+		CHECK_EQ(scaled->size, 12);
+		CHECK(cache.Get(8.0f, 3) != first);
+		CHECK_EQ(cache.Stats().builds, 3);
+		// 덮임과 원호 밖 두 장
+		CHECK_EQ(cache.Stats().bytes, 2u * (8u * 8u + 12u * 12u + 8u * 8u));
+
+		CHECK(cache.Get(0.0f, 2) == nullptr);
+		CHECK(cache.Get(8.0f, 0) == nullptr);
+
+		for (int32_t i = 0; i < static_cast<int32_t>(CornerMaskCache::MaxMasks); ++i)
+			cache.Get(20.0f + static_cast<float>(i), 2);
+		const CornerMaskCacheStats stats = cache.Stats();
+		CHECK_EQ(stats.masks, CornerMaskCache::MaxMasks);
+		CHECK_EQ(stats.evictions, 3);
+		// 버린 모서리를 든 쪽은 그대로 쓸 수 있음
+		CHECK_EQ(first->At(BorderCorner::TopLeft, 0, 0), 0);
+		CHECK_EQ(first->At(BorderCorner::BottomRight, first->size - 1, first->size - 1), 0);
+		CHECK(cache.Get(8.0f, 2) != first);
+		CHECK_EQ(cache.Stats().builds, 3 + CornerMaskCache::MaxMasks + 1);
+	}
+}
+
+int main()
+{
+	TestMatchesReference();
+	TestCornersAreSymmetric();
+	TestZeroRadiusIsSquare();
+	TestIncrementalMatchesFresh();
+	TestCompositorMatchesRaster();
+	TestCompositorBlendsCornerOverlap();
+	TestCache();
+	return TestResult("CornerMaskTest");
+}
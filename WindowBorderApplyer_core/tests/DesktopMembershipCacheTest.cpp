@@ -0,0 +1,122 @@
+﻿// DesktopMembershipCache 가 같은 세대 안에서는 창 시스템에 다시 묻지 않고, 데스크톱 전환 (세대 올림) 뒤에는 모든 항목을
+// 한 번씩 다시 조회하며, 창 하나를 무효화하면 그 창만 다시 조회하는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. DesktopMembershipCacheTest.cpp -o DesktopMembershipCacheTest
+
+#include "TestUtil.h"
+#include "DesktopMembershipCache.h"
+
+#include <unordered_set>
+
+namespace
+{
+	// 현재 데스크톱에 있는 창 집합과 조회 횟수 (IVirtualDesktopManager 대신)
+	struct FakeDesktops
+	{
+		std::unordered_set<WindowHandle> onCurrent{};
+		uint64_t queries = 0;
+
+		auto Query()
+		{
+			return [this](WindowHandle window)
+				{
+					queries++;
+					return onCurrent.count(window) != 0;
+				};
+		}
+	};
+
+	// 같은 세대 안에서는 처음 한 번만 조회
+	void TestHitsWithinGeneration()
+	{
+		DesktopMembershipCache<WindowHandle> cache{};
+		FakeDesktops desktops{};
+		desktops.onCurrent.insert(MakeHandle(0));
+
+		CHECK(!cache.Peek(MakeHandle(0)).has_value());
+		for (int i = 0; i < 10; ++i)
+		{
+			CHECK(cache.IsOnCurrentDesktop(MakeHandle(0), desktops.Query()));
+			CHECK(!cache.IsOnCurrentDesktop(MakeHandle(1), desktops.Query()));
+		}
+		CHECK_EQ(desktops.queries, 2);
+		CHECK_EQ(cache.Stats().queries, 2);
+		CHECK_EQ(cache.Stats().hits, 18);
+		CHECK(cache.Peek(MakeHandle(0)) == std::optional<bool>(true));
+		CHECK(cache.Peek(MakeHandle(1)) == std::optional<bool>(false));
+	}
+
+	// 세대를 올리면 캐시된 값은 모두 무효: Peek 는 nullopt, 다음 조회는 창마다 한 번씩 새 값을 가져옴
+	void TestGenerationBumpInvalidatesAll()
+	{
+		DesktopMembershipCache<WindowHandle> cache{};
+		FakeDesktops desktops{};
+		constexpr uint64_t Count = 50;
+		for (uint64_t i = 0; i < Count; i += 2)
+			desktops.onCurrent.insert(MakeHandle(i));
+
+		for (uint64_t i = 0; i < Count; ++i)
+			CHECK_EQ(cache.IsOnCurrentDesktop(MakeHandle(i), desktops.Query()), i % 2 == 0);
+		CHECK_EQ(desktops.queries, Count);
+
+		// 다른 데스크톱으로 전환: 홀수 창이 현재 데스크톱에 있음
+		desktops.onCurrent.clear();
+		for (uint64_t i = 1; i < Count; i += 2)
+			desktops.onCurrent.insert(MakeHandle(i));
+		const uint64_t before = cache.Generation();
+		cache.BumpGeneration();
+		CHECK_EQ(cache.Generation(), before + 1);
+		CHECK_EQ(cache.Stats().generationBumps, 1);
+
+		for (uint64_t i = 0; i < Count; ++i)
+			CHECK(!cache.Peek(MakeHandle(i)).has_value());
+		for (uint64_t i = 0; i < Count; ++i)
+		{
+			CHECK_EQ(cache.IsOnCurrentDesktop(MakeHandle(i), desktops.Query()), i % 2 == 1);
+			CHECK_EQ(cache.IsOnCurrentDesktop(MakeHandle(i), desktops.Query()), i % 2 == 1);
+		}
+		CHECK_EQ(desktops.queries, Count * 2);
+		CHECK_EQ(cache.Stats().hits, Count);
+	}
+
+	// 창 하나만 무효화 (CLOAKED / UNCLOAKED): 그 창만 다시 조회. Forget 한 창은 새 항목으로 조회
+	void TestInvalidateAndForget()
+	{
+		DesktopMembershipCache<WindowHandle> cache{};
+		FakeDesktops desktops{};
+		desktops.onCurrent.insert(MakeHandle(0));
+		desktops.onCurrent.insert(MakeHandle(1));
+
+		CHECK(cache.IsOnCurrentDesktop(MakeHandle(0), desktops.Query()));
+		CHECK(cache.IsOnCurrentDesktop(MakeHandle(1), desktops.Query()));
+
+		// 창 0 이 다른 데스크톱으로 옮겨짐
+		desktops.onCurrent.erase(MakeHandle(0));
+		cache.Invalidate(MakeHandle(0));
+		CHECK_EQ(cache.Stats().invalidations, 1);
+		CHECK(!cache.Peek(MakeHandle(0)).has_value());
+		CHECK(cache.Peek(MakeHandle(1)) == std::optional<bool>(true));
+		CHECK(!cache.IsOnCurrentDesktop(MakeHandle(0), desktops.Query()));
+		CHECK(cache.IsOnCurrentDesktop(MakeHandle(1), desktops.Query()));
+		CHECK_EQ(desktops.queries, 3);
+
+		// 항목이 없는 창은 무효화로 세지 않음
+		cache.Invalidate(MakeHandle(9));
+		CHECK_EQ(cache.Stats().invalidations, 1);
+
+		cache.Forget(MakeHandle(1));
+		CHECK(!cache.Peek(MakeHandle(1)).has_value());
+		CHECK(cache.IsOnCurrentDesktop(MakeHandle(1), desktops.Query()));
+		CHECK_EQ(desktops.queries, 4);
+
+		cache.Clear();
+		CHECK(!cache.Peek(MakeHandle(0)).has_value());
+	}
+}
+
+int main()
+{
+	TestHitsWithinGeneration();
+	TestGenerationBumpInvalidatesAll();
+	TestInvalidateAndForget();
+	return TestResult("DesktopMembershipCacheTest");
+}
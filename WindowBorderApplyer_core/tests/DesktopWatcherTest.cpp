@@ -0,0 +1,163 @@
+﻿// DesktopWatcher 의 게시 (seqlock) 와 BorderTracker 의 전환 처리를 SimulatedDesktopSwitcher 로 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. DesktopWatcherTest.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o DesktopWatcherTest
+
+#include "TestUtil.h"
+#include "BorderTracker.h"
+#include "SimulatedDesktopSwitcher.h"
+#include "SimulatedWindowSystem.h"
+
+#include <atomic>
+#include <thread>
+
+namespace
+{
+	// 감시 스레드가 계속 게시하는 동안 읽은 값이 찢어지지 않고, 번호를 본 뒤에는 그 번호 이후의 값을 읽는지
+	void TestConcurrentPublish()
+	{
+		constexpr uint64_t Switches = 200000;
+
+		SimulatedDesktopSwitcher switcher;
+		CHECK(switcher.Start(nullptr));
+		const DesktopId initial = switcher.CurrentDesktop();
+		CHECK(initial == SimulatedDesktopSwitcher::IdOf(0));
+
+		std::atomic<bool> done{ false };
+		std::thread watcherThread([&switcher, &done]()
+			{
+				for (uint64_t i = 1; i <= Switches; ++i)
+					switcher.SwitchTo(DesktopId{ i, ~i });
+				done.store(true, std::memory_order_release);
+			});
+
+		uint64_t torn = 0;
+		uint64_t stale = 0;
+		uint64_t lastCount = 0;
+		uint64_t backwards = 0;
+		while (!done.load(std::memory_order_acquire))
+		{
+			const uint64_t count = switcher.SwitchCount();
+			const DesktopId id = switcher.CurrentDesktop();
+			if (count < lastCount)
+				backwards++;
+			lastCount = count;
+
+			if (id == initial)
+			{
+				if (count != 0)
+					stale++;
+				continue;
+			}
+			if (id.low != ~id.high)
+				torn++;
+			if (id.high < count)
+				stale++;
+		}
+		watcherThread.join();
+		switcher.Stop();
+
+		CHECK_EQ(torn, 0);
+		CHECK_EQ(stale, 0);
+		CHECK_EQ(backwards, 0);
+		CHECK_EQ(switcher.SwitchCount(), Switches);
+		CHECK(switcher.CurrentDesktop() == (DesktopId{ Switches, ~Switches }));
+	}
+
+	// 같은 데스크톱으로의 알림 (키의 다른 값 변경) 은 전환으로 세지 않음
+	void TestDuplicateNotificationIgnored()
+	{
+		SimulatedDesktopSwitcher switcher;
+		int callbacks = 0;
+		DesktopId notified{};
+		switcher.Start([&callbacks, &notified](const DesktopId& id)
+			{
+				callbacks++;
+				notified = id;
+			});
+
+		CHECK(!switcher.SwitchTo(0));
+		CHECK(switcher.SwitchTo(1));
+		CHECK(!switcher.SwitchTo(1));
+		CHECK_EQ(switcher.SwitchCount(), 1);
+		CHECK_EQ(callbacks, 1);
+		CHECK(notified == SimulatedDesktopSwitcher::IdOf(1));
+
+		switcher.Stop();
+		CHECK(!switcher.SwitchTo(2));
+		CHECK_EQ(switcher.SwitchCount(), 1);
+	}
+
+	// 감시자가 붙어 있으면 포그라운드 변경으로는 소속을 다시 확인하지 않고, 전환 알림 한 번에 테두리를 정리
+	void TestTrackerSwitchesOnNotification()
+	{
+		constexpr uint64_t WindowCount = 8;
+
+		SimulatedWindowSystem windowSystem;
+		for (uint64_t i = 0; i < WindowCount; ++i)
+		{
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ 0, 0, 400, 300 });
+			windowSystem.MoveWindowToDesktop(MakeHandle(i), static_cast<uint32_t>(i % 2));
+		}
+
+		SimulatedDesktopSwitcher switcher;
+		std::atomic<int> wakeups{ 0 };
+		switcher.Start([&wakeups](const DesktopId&) { wakeups++; });
+
+		BorderTracker tracker(windowSystem, BorderStyle{});
+		tracker.AttachDesktopWatcher(&switcher);
+		for (uint64_t i = 0; i < WindowCount; ++i)
+			tracker.AddWindow(MakeHandle(i));
+
+		for (uint64_t i = 0; i < WindowCount; ++i)
+			CHECK((tracker.Find(MakeHandle(i))->overlay != nullptr) == (i % 2 == 0));
+
+		// 같은 데스크톱 안의 포커스 변경: 조회도, 전체 정리도 없음
+		windowSystem.ResetQueryStats();
+		const uint64_t hitsBefore = tracker.DesktopStats().hits;
+		uint64_t nowUs = 0;
+		uint32_t eventTime = 0;
+		for (int step = 0; step < 50; ++step)
+		{
+			nowUs += 20000;
+			tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, MakeHandle((step % 4) * 2), 0, 0, 1, ++eventTime }, nowUs);
+			tracker.Flush(nowUs + 16000);
+		}
+		CHECK_EQ(windowSystem.QueryStats().desktopQueries, 0);
+		CHECK_EQ(tracker.DesktopStats().hits, hitsBefore);
+		CHECK(!tracker.SyncDesktop());
+
+		// 데스크톱 1 로 전환: 클로킹 이벤트는 추적 스레드에, 전환 알림은 감시 스레드에서 도착
+		nowUs += 20000;
+		windowSystem.SwitchDesktop(1, [&](WindowHandle hwnd, bool cloaked)
+			{
+				const uint32_t event = cloaked ? WinEventId::ObjectCloaked : WinEventId::ObjectUncloaked;
+				tracker.PushEvent(BorderTracker::Event{ event, hwnd, 0, 0, 1, ++eventTime }, nowUs);
+			});
+		std::thread watcherThread([&switcher]() { switcher.SwitchTo(1); });
+		watcherThread.join();
+		CHECK_EQ(wakeups.load(), 1);
+
+		tracker.Flush(nowUs + 16000);
+		CHECK_EQ(tracker.DesktopStats().generationBumps, 1);
+		CHECK(!tracker.SyncDesktop());
+		for (uint64_t i = 0; i < WindowCount; ++i)
+			CHECK((tracker.Find(MakeHandle(i))->overlay != nullptr) == (i % 2 == 1));
+
+		// 알림이 여러 번 쌓여도 정리는 한 번
+		switcher.SwitchTo(0);
+		switcher.SwitchTo(1);
+		CHECK(tracker.SyncDesktop());
+		CHECK(!tracker.SyncDesktop());
+		CHECK_EQ(tracker.DesktopStats().generationBumps, 2);
+
+		tracker.AttachDesktopWatcher(nullptr);
+		switcher.Stop();
+	}
+}
+
+int main()
+{
+	TestConcurrentPublish();
+	TestDuplicateNotificationIgnored();
+	TestTrackerSwitchesOnNotification();
+	return TestResult("DesktopWatcherTest");
+}
@@ -0,0 +1,105 @@
+﻿// DpiCache 가 창이 그대로면 조회하지 않고, 모니터를 옮기거나 디스플레이가 바뀌었을 때만 다시 조회하는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. DpiCacheTest.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o DpiCacheTest
+
+#include "TestUtil.h"
+#include "BorderTracker.h"
+#include "DpiCache.h"
+#include "SimulatedWindowSystem.h"
+
+namespace
+{
+	// 창 항목 적중, 같은 모니터 안의 이동, 모니터 이동, 세대 무효화
+	void TestCacheLevels()
+	{
+		const MonitorHandle left = HandleFromBits(0x100);
+		const MonitorHandle right = HandleFromBits(0x200);
+		uint32_t leftDpi = 96;
+		uint64_t lookups = 0;
+		uint64_t queries = 0;
+		const auto resolve = [&](WindowHandle, const WindowRect& frame)
+			{
+				lookups++;
+				return frame.left < 1000 ? left : right;
+			};
+		const auto query = [&](MonitorHandle monitor)
+			{
+				queries++;
+				return monitor == left ? leftDpi : 144u;
+			};
+
+		DpiCache<WindowHandle> cache{};
+		const WindowRect frame{ 100, 100, 500, 400 };
+		CHECK_EQ(cache.GetDpi(MakeHandle(0), frame, resolve, query), 96);
+		for (int i = 0; i < 100; ++i)
+			CHECK_EQ(cache.GetDpi(MakeHandle(0), frame, resolve, query), 96);
+		CHECK_EQ(lookups, 1);
+		CHECK_EQ(queries, 1);
+		CHECK_EQ(cache.Stats().windowHits, 100);
+
+		// 같은 모니터의 다른 창과 같은 모니터 안의 이동은 모니터만 다시 찾음
+		CHECK_EQ(cache.GetDpi(MakeHandle(1), frame, resolve, query), 96);
+		CHECK_EQ(cache.GetDpi(MakeHandle(0), WindowRect{ 110, 100, 510, 400 }, resolve, query), 96);
+		CHECK_EQ(lookups, 3);
+		CHECK_EQ(queries, 1);
+		CHECK_EQ(cache.Stats().monitorHits, 2);
+
+		// 다른 모니터로 옮기면 그 모니터를 한 번 조회
+		CHECK_EQ(cache.GetDpi(MakeHandle(0), WindowRect{ 1100, 100, 1500, 400 }, resolve, query), 144);
+		CHECK_EQ(queries, 2);
+
+		// 배율이 바뀌어도 알림 전에는 캐시된 값, 알림 뒤에는 모니터마다 한 번씩 다시 조회
+		leftDpi = 192;
+		CHECK_EQ(cache.GetDpi(MakeHandle(1), frame, resolve, query), 96);
+		cache.BumpGeneration();
+		CHECK_EQ(cache.GetDpi(MakeHandle(1), frame, resolve, query), 192);
+		CHECK_EQ(cache.GetDpi(MakeHandle(2), frame, resolve, query), 192);
+		CHECK_EQ(queries, 3);
+		CHECK_EQ(cache.Stats().queries, queries);
+		CHECK_EQ(cache.Stats().Avoided(), 100 + 2 + 1 + 1);
+	}
+
+	// 디스플레이 변경 알림은 배율이 바뀐 모니터의 테두리만 다시 그리고, 모니터마다 DPI 를 한 번만 조회
+	void TestTrackerDisplayChange()
+	{
+		constexpr uint64_t Windows = 40;
+
+		SimulatedWindowSystem windowSystem;
+		const MonitorHandle second = windowSystem.AddMonitor(WindowRect{ 2000, 0, 4000, 1200 }, 96);
+		for (uint64_t i = 0; i < Windows; ++i)
+		{
+			// 짝수 창은 주 모니터, 홀수 창은 두 번째 모니터
+			const int32_t x = static_cast<int32_t>(i % 2 == 0 ? 0 : 2000) + static_cast<int32_t>(i) * 10;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, 0, x + 400, 300 });
+		}
+
+		GeometryPollPolicy policy{};
+		policy.fastIntervalUs = 0;
+		BorderTracker tracker(windowSystem, BorderStyle{}, policy);
+		for (uint64_t i = 0; i < Windows; ++i)
+			tracker.AddWindow(MakeHandle(i));
+		CHECK_EQ(windowSystem.QueryStats().dpiQueries, 2);
+
+		// 위치가 그대로인 창의 갱신은 모니터도 DPI 도 묻지 않음
+		const SimulatedQueryStats before = windowSystem.QueryStats();
+		tracker.RefreshGeometry();
+		CHECK_EQ(windowSystem.QueryStats().monitorQueries, before.monitorQueries);
+		CHECK_EQ(windowSystem.QueryStats().dpiQueries, before.dpiQueries);
+		CHECK_EQ(tracker.DpiStats().windowHits, Windows);
+
+		const int32_t thickness = tracker.Styles().Get(tracker.Find(MakeHandle(1))->presented.style).thickness;
+		windowSystem.SetMonitorDpi(second, 192);
+		tracker.OnDisplayChanged();
+		const SimulatedQueryStats& after = windowSystem.QueryStats();
+		CHECK_EQ(after.dpiQueries - before.dpiQueries, 2);
+		CHECK_EQ(after.presents - before.presents, Windows / 2);
+		CHECK(tracker.Styles().Get(tracker.Find(MakeHandle(1))->presented.style).thickness > thickness);
+		CHECK_EQ(tracker.Styles().Get(tracker.Find(MakeHandle(0))->presented.style).thickness, thickness);
+	}
+}
+
+int main()
+{
+	TestCacheLevels();
+	TestTrackerDisplayChange();
+	return TestResult("DpiCacheTest");
+}
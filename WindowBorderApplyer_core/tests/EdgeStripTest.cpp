@@ -0,0 +1,238 @@
+﻿// 네 변 표면 (EdgeStripBorder) 이 띠 자리에 변 크기의 표면만 만들고, 크기가 바뀌면 길이가 바뀐 변만 다시 할당하며,
+// 옮기기만 하면 다시 그리지 않는지, 그리고 파이프라인이 두 방식의 테두리당 메모리를 보고하는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. EdgeStripTest.cpp ../EdgeStripBorder.cpp ../BorderRaster.cpp ../CornerMask.cpp ../BorderPipeline.cpp ../BorderAnimator.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp ../WorkStealingPool.cpp -o EdgeStripTest
+
+#include "TestUtil.h"
+#include "BorderPipeline.h"
+#include "BorderRaster.h"
+#include "EdgeStripBorder.h"
+#include "SimulatedWindowSystem.h"
+
+#include <chrono>
+#include <thread>
+
+namespace
+{
+	constexpr uint32_t Red = 0x000000FF;
+	constexpr uint32_t Blue = 0x00FF0000;
+
+	EdgeStripBorder::SurfaceFactory SoftwareEdges()
+	{
+		return [](BorderEdge, int32_t width, int32_t height)
+			{
+				return std::make_unique<SoftwareEdgeSurface>(width, height);
+			};
+	}
+
+	const SoftwareEdgeSurface& EdgeOf(const EdgeStripBorder& border, BorderEdge edge)
+	{
+		return *static_cast<const SoftwareEdgeSurface*>(border.Surface(edge));
+	}
+
+	BorderVisual VisualOf(const WindowRect& frame, uint32_t color, uint32_t dpi = DefaultDpi)
+	{
+		BorderStyle style{};
+		style.color = color;
+		return ComputeBorderVisual(frame, dpi, style);
+	}
+
+	void CheckRect(const WindowRect& actual, const WindowRect& expected)
+	{
+		CHECK_EQ(actual.left, expected.left);
+		CHECK_EQ(actual.top, expected.top);
+		CHECK_EQ(actual.right, expected.right);
+		CHECK_EQ(actual.bottom, expected.bottom);
+	}
+
+	// 변마다 띠 크기의 표면을 띠 자리에 놓고 한 색으로 채움
+	void TestEdgesCoverStrips()
+	{
+		EdgeStripBorder border(SoftwareEdges());
+		// bounds {97, 97, 303, 203}, 띠는 1 픽셀 안쪽부터 2 픽셀
+		const BorderVisual visual = VisualOf(WindowRect{ 100, 100, 300, 200 }, Red);
+		CHECK(border.Present(visual));
+
+		const SoftwareEdgeSurface& top = EdgeOf(border, BorderEdge::Top);
+		const SoftwareEdgeSurface& left = EdgeOf(border, BorderEdge::Left);
+		CheckRect(top.Screen(), WindowRect{ 98, 98, 302, 100 });
+		CheckRect(EdgeOf(border, BorderEdge::Bottom).Screen(), WindowRect{ 98, 200, 302, 202 });
+		CheckRect(left.Screen(), WindowRect{ 98, 100, 100, 200 });
+		CheckRect(EdgeOf(border, BorderEdge::Right).Screen(), WindowRect{ 300, 100, 302, 200 });
+		CHECK_EQ(top.Width(), 204);
+		CHECK_EQ(top.Height(), 2);
+		CHECK_EQ(top.PixelAt(0, 0), BorderPixel(Red));
+		CHECK_EQ(top.PixelAt(203, 1), BorderPixel(Red));
+		CHECK_EQ(left.PixelAt(1, 99), BorderPixel(Red));
+		CHECK(top.IsShown());
+
+		// 창 크기 표면 하나 (206 x 106) 대신 둘레만
+		CHECK_EQ(border.SurfaceBytes(), (2ull * 204 * 2 + 2ull * 2 * 100) * 4);
+		CHECK(border.SurfaceBytes() * 10 < static_cast<uint64_t>(visual.bounds.Area()) * 4);
+		CHECK_EQ(border.Stats().allocations, 4);
+		CHECK_EQ(border.Stats().redraws, 4);
+
+		border.Hide();
+		CHECK(!top.IsShown());
+		CHECK(!left.IsShown());
+	}
+
+	// 옮기면 다시 그리지 않고, 너비가 바뀌면 위 / 아래, 높이가 바뀌면 왼쪽 / 오른쪽만 다시 할당
+	void TestResizeReallocatesChangedEdges()
+	{
+		EdgeStripBorder border(SoftwareEdges());
+		border.Present(VisualOf(WindowRect{ 100, 100, 300, 200 }, Red));
+		const SoftwareEdgeSurface& top = EdgeOf(border, BorderEdge::Top);
+		const SoftwareEdgeSurface& bottom = EdgeOf(border, BorderEdge::Bottom);
+		const SoftwareEdgeSurface& left = EdgeOf(border, BorderEdge::Left);
+		const SoftwareEdgeSurface& right = EdgeOf(border, BorderEdge::Right);
+
+		border.Present(VisualOf(WindowRect{ 150, 120, 350, 220 }, Red));
+		CHECK_EQ(border.Stats().allocations, 4);
+		CHECK_EQ(border.Stats().redraws, 4);
+		CHECK_EQ(border.Stats().moves, 4);
+		CHECK_EQ(top.ContentPresents(), 1);
+		CheckRect(top.Screen(), WindowRect{ 148, 118, 352, 120 });
+
+		border.Present(VisualOf(WindowRect{ 150, 120, 450, 220 }, Red));
+		CHECK_EQ(top.Allocations(), 2);
+		CHECK_EQ(bottom.Allocations(), 2);
+		CHECK_EQ(left.Allocations(), 1);
+		CHECK_EQ(right.Allocations(), 1);
+		CHECK_EQ(left.ContentPresents(), 1);
+		CHECK_EQ(top.Width(), 304);
+		CHECK_EQ(top.PixelAt(303, 1), BorderPixel(Red));
+
+		border.Present(VisualOf(WindowRect{ 150, 120, 450, 320 }, Red));
+		CHECK_EQ(top.Allocations(), 2);
+		CHECK_EQ(left.Allocations(), 2);
+		CHECK_EQ(right.Allocations(), 2);
+		CHECK_EQ(left.Height(), 200);
+		CHECK_EQ(border.Stats().allocations, 8);
+
+		// DPI 가 바뀌어 두께가 바뀌면 네 변 모두
+		border.Present(VisualOf(WindowRect{ 150, 120, 450, 320 }, Red, 192));
+		CHECK_EQ(top.Height(), 4);
+		CHECK_EQ(border.Stats().allocations, 12);
+	}
+
+	// 색만 바뀌면 할당 없이 다시 채우고, 창이 두께보다 작으면 없는 변은 숨김
+	void TestRecolorAndDegenerateEdges()
+	{
+		EdgeStripBorder border(SoftwareEdges());
+		border.Present(VisualOf(WindowRect{ 100, 100, 300, 200 }, Red));
+
+		BorderStyle translucent{};
+		translucent.color = Blue;
+		translucent.opacity = 128;
+		border.Present(ComputeBorderVisual(WindowRect{ 100, 100, 300, 200 }, DefaultDpi, translucent));
+		CHECK_EQ(border.Stats().allocations, 4);
+		CHECK_EQ(border.Stats().redraws, 8);
+		CHECK_EQ(EdgeOf(border, BorderEdge::Right).PixelAt(1, 50), BorderPixel(Blue, 128));
+
+		// 높이 0 인 창: 왼쪽 / 오른쪽 띠가 비어 숨김
+		border.Present(VisualOf(WindowRect{ 100, 100, 300, 100 }, Red));
+		CHECK(EdgeOf(border, BorderEdge::Top).IsShown());
+		CHECK(!EdgeOf(border, BorderEdge::Left).IsShown());
+		CHECK(!EdgeOf(border, BorderEdge::Right).IsShown());
+	}
+
+	// 4K 최대화 창 (150%): 창 크기 표면은 약 33 MB, 네 변은 100 KB 남짓
+	void TestMaximizedMemory()
+	{
+		EdgeStripBorder border(SoftwareEdges());
+		const BorderVisual visual = VisualOf(WindowRect{ 0, 0, 3840, 2160 }, Red, 144);
+		border.Present(visual);
+
+		const uint64_t fullBytes = static_cast<uint64_t>(visual.bounds.Area()) * 4;
+		CHECK(fullBytes > 33ull * 1000 * 1000);
+		CHECK(border.SurfaceBytes() < 150ull * 1000);
+		std::printf("4K maximized: window-size surface %.1f MiB, edge strips %.1f KiB\n",
+			static_cast<double>(fullBytes) / (1024.0 * 1024.0), static_cast<double>(border.SurfaceBytes()) / 1024.0);
+	}
+
+	/// <summary> 테스트용 오버레이: 네 변 표면으로 그림 </summary>
+	class EdgeStripOverlay : public BorderOverlay
+	{
+	public:
+		EdgeStripOverlay() : border(SoftwareEdges()) {}
+
+		bool Present(const BorderVisual& visual) override { return border.Present(visual); }
+		void Hide() override { border.Hide(); }
+		uint64_t SurfaceBytes() const noexcept override { return border.SurfaceBytes(); }
+
+	private:
+		EdgeStripBorder border;
+	};
+
+	class EdgeStripWindowSystem : public SimulatedWindowSystem
+	{
+	public:
+		std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle, const BorderStyle&, const BorderVisual& visual) override
+		{
+			auto overlay = std::make_unique<EdgeStripOverlay>();
+			overlay->Present(visual);
+			return overlay;
+		}
+	};
+
+	/// <summary> 창을 등록하고 표시 단계를 이 스레드에서 돌려 모든 오버레이가 만들어진 뒤의 메모리 </summary>
+	OverlayMemoryStats MeasurePipeline(SimulatedWindowSystem& windowSystem, uint64_t count)
+	{
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 8) * 100;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, 0, x + 800, 600 });
+		}
+
+		BorderPipeline pipeline(windowSystem, BorderStyle{});
+		pipeline.Start([]() {});
+		pipeline.Post([count](BorderTracker& tracker)
+			{
+				for (uint64_t i = 0; i < count; ++i)
+					tracker.AddWindow(MakeHandle(i));
+			});
+
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+		while (pipeline.OverlayCount() < count && std::chrono::steady_clock::now() < deadline)
+		{
+			if (pipeline.PumpPresent() == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		const OverlayMemoryStats memory = pipeline.OverlayMemory();
+		pipeline.Stop();
+		pipeline.ReleaseOverlays();
+		return memory;
+	}
+
+	// 파이프라인은 어느 방식이든 테두리당 표면 메모리를 보고
+	void TestPipelineReportsMemory()
+	{
+		constexpr uint64_t Windows = 16;
+
+		SimulatedWindowSystem fullWindows;
+		const OverlayMemoryStats full = MeasurePipeline(fullWindows, Windows);
+		CHECK_EQ(full.overlays, Windows);
+		// 800 x 600 창의 bounds 는 806 x 606
+		CHECK_EQ(full.surfaceBytes, Windows * 806 * 606 * 4);
+		CHECK_EQ(full.maxSurfaceBytes, 806ull * 606 * 4);
+
+		EdgeStripWindowSystem edgeWindows;
+		const OverlayMemoryStats edges = MeasurePipeline(edgeWindows, Windows);
+		CHECK_EQ(edges.overlays, Windows);
+		CHECK_EQ(edges.maxSurfaceBytes, (2ull * 804 * 2 + 2ull * 2 * 600) * 4);
+		CHECK(edges.AverageBytes() * 50 < full.AverageBytes());
+		std::printf("800x600 windows: %.1f KiB/border (window-size), %.1f KiB/border (edge strips)\n",
+			full.AverageBytes() / 1024.0, edges.AverageBytes() / 1024.0);
+	}
+}
+
+int main()
+{
+	TestEdgesCoverStrips();
+	TestResizeReallocatesChangedEdges();
+	TestRecolorAndDegenerateEdges();
+	TestMaximizedMemory();
+	TestPipelineReportsMemory();
+	return TestResult("EdgeStripTest");
+}
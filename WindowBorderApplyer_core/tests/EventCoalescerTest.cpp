@@ -0,0 +1,180 @@
+﻿// 병합 단계 (EventCoalescer) 가 창마다 남기는 시간 기록을 검사합니다. 추적기가 등록하지 않은 창 (툴팁, 메뉴) 의 표시 / 포그라운드
+// 이벤트는 기록을 남기지 않아 기록 수가 추적 중인 창 수를 넘지 않는지, 같은 HWND 값을 25 일 뒤에 다시 쓰는 새 창의 이벤트가
+// 오래된 것으로 버려지지 않는지 봅니다. dwmsEventTime 이 0 으로 되돌아가는 (약 49 일) 경계를 사이에 두고도 병합, 오래된 이벤트
+// 버리기, 파괴 처리가 같게 동작하는지도 봅니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. EventCoalescerTest.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o EventCoalescerTest
+
+#include "TestUtil.h"
+#include "BorderTracker.h"
+#include "EventCoalescer.h"
+#include "SimulatedWindowSystem.h"
+
+#include <vector>
+
+namespace
+{
+	BorderTracker::Event EventOf(uint32_t event, WindowHandle window, uint32_t time)
+	{
+		return BorderTracker::Event{ event, window, WinEventObjectId::Window, 0, 1, time };
+	}
+
+	using Coalescer = EventCoalescer<WindowHandle>;
+
+	// 되돌아가기 직전과 직후의 시간
+	constexpr uint32_t BeforeWrap = 0xFFFFFFF0u;
+	constexpr uint32_t AfterWrap = 0x10u;
+
+	std::vector<Coalescer::Record> FlushAll(Coalescer& coalescer, uint64_t nowUs)
+	{
+		std::vector<Coalescer::Record> records{};
+		coalescer.Flush(nowUs, [&](const Coalescer::Record& record)
+			{
+				records.push_back(record);
+			});
+		return records;
+	}
+
+	// 경계를 넘은 이벤트는 더 새로운 것: 한 프레임 안에서 합쳐지고 가장 최근 시간이 남음
+	void TestMergeAcrossWrap()
+	{
+		Coalescer coalescer{};
+		const WindowHandle window = MakeHandle(0);
+		CHECK(IsEventTimeOlder(BeforeWrap, AfterWrap));
+		CHECK(!IsEventTimeOlder(AfterWrap, BeforeWrap));
+
+		CHECK(coalescer.Push(EventOf(WinEventId::ObjectLocationChange, window, BeforeWrap), 0));
+		CHECK(!coalescer.Push(EventOf(WinEventId::ObjectLocationChange, window, BeforeWrap + 8), 0));
+		CHECK(!coalescer.Push(EventOf(WinEventId::ObjectLocationChange, window, AfterWrap), 0));
+		CHECK(!coalescer.Push(EventOf(WinEventId::ObjectHide, window, AfterWrap + 1), 0));
+		CHECK_EQ(coalescer.PendingCount(), 1);
+		CHECK_EQ(coalescer.Stats().collapsed, 3);
+		CHECK_EQ(coalescer.Stats().collapsedGeometry, 2);
+		CHECK_EQ(coalescer.Stats().stale, 0);
+
+		const auto records = FlushAll(coalescer, 16000);
+		CHECK_EQ(records.size(), 1);
+		if (records.size() == 1)
+		{
+			CHECK(records[0].Has(CoalescedKind::Geometry));
+			CHECK(records[0].Has(CoalescedKind::Visibility));
+			CHECK_EQ(records[0].visibilityEvent, WinEventId::ObjectHide);
+			CHECK_EQ(records[0].latestTime, AfterWrap + 1);
+			CHECK_EQ(records[0].mergedCount, 4);
+		}
+	}
+
+	// 경계를 넘어 반영된 창에 경계 전 시간의 이벤트가 늦게 오면 오래된 것으로 버림 (같은 프레임이든 다음 프레임이든)
+	void TestStaleAcrossWrap()
+	{
+		Coalescer coalescer{};
+		const WindowHandle window = MakeHandle(1);
+
+		coalescer.Push(EventOf(WinEventId::ObjectShow, window, AfterWrap), 0);
+		coalescer.Push(EventOf(WinEventId::ObjectHide, window, BeforeWrap), 0);
+		CHECK_EQ(coalescer.Stats().stale, 1);
+		auto records = FlushAll(coalescer, 16000);
+		CHECK_EQ(records.size(), 1);
+		if (records.size() == 1)
+			CHECK_EQ(records[0].visibilityEvent, WinEventId::ObjectShow);
+
+		// 다음 프레임: 시간 기록 (AfterWrap) 보다 오래된 이벤트만 오면 기록을 만들지 않음
+		CHECK(!coalescer.Push(EventOf(WinEventId::ObjectHide, window, BeforeWrap + 4), 16000));
+		CHECK_EQ(coalescer.Stats().stale, 2);
+		CHECK(coalescer.Empty());
+
+		// 더 새로운 이벤트는 그대로 받음
+		CHECK(coalescer.Push(EventOf(WinEventId::ObjectHide, window, AfterWrap + 4), 16000));
+		records = FlushAll(coalescer, 32000);
+		CHECK_EQ(records.size(), 1);
+		if (records.size() == 1)
+			CHECK_EQ(records[0].visibilityEvent, WinEventId::ObjectHide);
+		CHECK_EQ(coalescer.Stats().stale, 2);
+	}
+
+	// 파괴는 시간과 상관없이 받고 이전 변경을 지움. 시간 기록도 지워서, 같은 HWND 값의 새 창은 경계 전 시간이어도 받음
+	void TestDestroyAcrossWrap()
+	{
+		Coalescer coalescer{};
+		const WindowHandle window = MakeHandle(2);
+
+		coalescer.Push(EventOf(WinEventId::ObjectShow, window, AfterWrap), 0);
+		FlushAll(coalescer, 16000);
+		CHECK_EQ(coalescer.WatermarkCount(), 1);
+
+		coalescer.Push(EventOf(WinEventId::ObjectLocationChange, window, AfterWrap + 2), 16000);
+		CHECK(!coalescer.Push(EventOf(WinEventId::ObjectDestroy, window, BeforeWrap), 16000));
+		CHECK_EQ(coalescer.Stats().stale, 0);
+		const auto records = FlushAll(coalescer, 32000);
+		CHECK_EQ(records.size(), 1);
+		if (records.size() == 1)
+			CHECK_EQ(records[0].kinds, CoalescedKind::Destroy);
+		CHECK_EQ(coalescer.WatermarkCount(), 0);
+
+		CHECK(coalescer.Push(EventOf(WinEventId::ObjectShow, window, BeforeWrap + 1), 32000));
+		CHECK_EQ(coalescer.Stats().stale, 0);
+		CHECK_EQ(coalescer.PendingCount(), 1);
+	}
+
+	// 등록하지 않은 창은 기록을 남기지 않음. 추적 중인 창은 파괴될 때 지워짐
+	void TestUnadoptedWindowsLeaveNoWatermark()
+	{
+		SimulatedWindowSystem windowSystem{};
+		const WindowHandle tracked = MakeHandle(0);
+		windowSystem.AddWindow(tracked, WindowRect{ 0, 0, 400, 300 });
+		BorderTracker tracker(windowSystem, BorderStyle{}, GeometryPollPolicy{ 0, 0 });
+		tracker.AddWindow(tracked);
+
+		uint32_t time = 1000;
+		uint64_t nowUs = 0;
+		for (uint64_t frame = 0; frame < 100; ++frame)
+		{
+			// 창 시스템에 없는 (대상이 아닌) 창이 나타났다가 포그라운드가 됨
+			const WindowHandle tooltip = MakeHandle(1 + frame);
+			tracker.PushEvent(EventOf(WinEventId::ObjectShow, tooltip, ++time), nowUs);
+			tracker.PushEvent(EventOf(WinEventId::SystemForeground, tooltip, ++time), nowUs);
+			tracker.PushEvent(EventOf(WinEventId::ObjectLocationChange, tracked, ++time), nowUs);
+			nowUs += 16000;
+			tracker.Flush(nowUs);
+		}
+		CHECK_EQ(tracker.Size(), 1);
+		CHECK_EQ(tracker.EventWatermarkCount(), 1);
+
+		tracker.PushEvent(EventOf(WinEventId::ObjectDestroy, tracked, ++time), nowUs);
+		tracker.Flush(nowUs + 16000);
+		CHECK_EQ(tracker.Size(), 0);
+		CHECK_EQ(tracker.EventWatermarkCount(), 0);
+	}
+
+	// 툴팁이 쓰던 HWND 값을 25 일 (dwmsEventTime 의 절반 주기보다 김) 뒤에 새 창이 다시 씀: 새 창이 등록됨
+	void TestRecycledHandleAfterLongGap()
+	{
+		SimulatedWindowSystem windowSystem{};
+		BorderTracker tracker(windowSystem, BorderStyle{}, GeometryPollPolicy{ 0, 0 });
+		const WindowHandle window = MakeHandle(7);
+
+		const uint32_t first = 1000;
+		tracker.PushEvent(EventOf(WinEventId::ObjectShow, window, first), 0);
+		tracker.Flush(16000);
+		CHECK_EQ(tracker.Size(), 0);
+		CHECK_EQ(tracker.EventWatermarkCount(), 0);
+
+		constexpr uint32_t TwentyFiveDaysMs = 25u * 24u * 60u * 60u * 1000u;
+		const uint32_t later = first + TwentyFiveDaysMs;
+		CHECK(IsEventTimeOlder(later, first));
+		windowSystem.AddWindow(window, WindowRect{ 100, 100, 500, 400 });
+		tracker.PushEvent(EventOf(WinEventId::ObjectShow, window, later), 32000);
+		tracker.Flush(48000);
+		CHECK(tracker.IsTracked(window));
+		CHECK_EQ(tracker.EventStats().stale, 0);
+	}
+}
+
+int main()
+{
+	TestUnadoptedWindowsLeaveNoWatermark();
+	TestRecycledHandleAfterLongGap();
+	TestMergeAcrossWrap();
+	TestStaleAcrossWrap();
+	TestDestroyAcrossWrap();
+	return TestResult("EventCoalescerTest");
+}
@@ -0,0 +1,220 @@
+﻿// 포그라운드 전환 (EVENT_SYSTEM_FOREGROUND) 마다 다시 표시하는 테두리가 추적 중인 창 수와 관계없이 이전 / 새 활성 창 둘뿐인지
+// 기록 재생 (TraceReplayer) 으로 창 10 개와 1000 개에서 세어 비교합니다. 재생 뒤에는 활성 창만 활성 스타일인지,
+// 한 프레임에 포그라운드가 여러 창을 거쳐 가면 마지막 창이 활성인지, 비활성 스타일이 없으면 스타일을 바꾸지 않는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. ForegroundSwitchTest.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o ForegroundSwitchTest
+
+#include "TestUtil.h"
+#include "BorderTracker.h"
+#include "SimulatedWindowSystem.h"
+#include "TraceReplayer.h"
+#include "WinEventTrace.h"
+
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t ActiveColor = 0x0000A5FF;
+	constexpr uint32_t InactiveColor = 0x00606060;
+	constexpr uint64_t Switches = 200;
+
+	BorderStyle StyleOf(uint32_t color)
+	{
+		BorderStyle style{};
+		style.color = color;
+		return style;
+	}
+
+	/// <summary> 포그라운드 이벤트 하나당 세어 본 값 </summary>
+	struct SwitchCost
+	{
+		double restyled = 0;
+		double presents = 0;
+		double frameQueries = 0;
+		double desktopQueries = 0;
+		uint64_t refreshes = 0;
+	};
+
+	/// <summary> 창 windows 개를 띄워 두고 50 ms 마다 다른 창으로 포그라운드를 옮기는 세션 </summary>
+	void SynthesizeSwitches(WinEventTraceWriter& writer, uint64_t windows)
+	{
+		TraceRecord record{};
+		record.idEventThread = 100;
+		record.idObject = WinEventObjectId::Window;
+		uint64_t target = 0;
+		for (uint64_t i = 0; i < Switches; ++i)
+		{
+			// 앞 창과 다른 창으로
+			target = (target + 1 + (i * 7) % (windows - 1)) % windows;
+			record.arrivalUs = 100000 + i * 50000;
+			record.event = WinEventId::SystemForeground;
+			record.hwnd = HandleToBits(MakeHandle(target));
+			record.dwmsEventTime = static_cast<uint32_t>(1000 + record.arrivalUs / 1000);
+			writer.Append(record);
+		}
+	}
+
+	SwitchCost ReplaySwitches(uint64_t windows, bool separateInactive)
+	{
+		SimulatedWindowSystem windowSystem{};
+		for (uint64_t i = 0; i < windows; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i % 40) * 30;
+			const int32_t y = static_cast<int32_t>(i / 40) * 20;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, y, x + 800, y + 600 });
+		}
+
+		BorderTracker tracker(windowSystem, StyleOf(ActiveColor), GeometryPollPolicy{ 0, 0 });
+		if (separateInactive)
+			tracker.SetInactiveStyle(StyleOf(InactiveColor));
+		for (uint64_t i = 0; i < windows; ++i)
+			tracker.AddWindow(MakeHandle(i));
+		CHECK_EQ(tracker.Size(), windows);
+
+		WinEventTraceWriter writer;
+		SynthesizeSwitches(writer, windows);
+		WinEventTraceReader reader;
+		CHECK(reader.OpenBuffer(writer.Buffer()));
+
+		windowSystem.ResetQueryStats();
+		const ForegroundSwitchStats before = tracker.ForegroundStats();
+		TraceReplayer replayer(windowSystem);
+		const ReplayResult result = replayer.Run(reader,
+			[&tracker](const TraceReplayer::Event& event, uint64_t arrivalUs)
+			{
+				if (tracker.Accept(event.event, event.hwnd, event.idObject, event.idChild))
+					tracker.PushEvent(event, arrivalUs);
+			},
+			[&tracker](uint64_t nowUs) { tracker.Flush(nowUs); });
+		CHECK(result.complete);
+		CHECK_EQ(result.events, Switches);
+
+		const ForegroundSwitchStats& after = tracker.ForegroundStats();
+		const SimulatedQueryStats& queries = windowSystem.QueryStats();
+		CHECK_EQ(after.switches - before.switches, Switches);
+
+		// 활성 창 하나만 활성 스타일
+		const WindowHandle active = tracker.ActiveWindow();
+		size_t activeBorders = 0;
+		size_t wrongBorders = 0;
+		for (WindowHandle window : tracker.Handles())
+		{
+			const TrackedWindow* tracked = tracker.Find(window);
+			const uint32_t color = tracker.Styles().Get(tracked->presented.style).color;
+			activeBorders += color == ActiveColor ? 1 : 0;
+			const uint32_t expected = window == active || !separateInactive ? ActiveColor : InactiveColor;
+			wrongBorders += color != expected ? 1 : 0;
+		}
+		CHECK_EQ(wrongBorders, 0);
+		CHECK_EQ(activeBorders, separateInactive ? 1 : windows);
+
+		SwitchCost cost{};
+		cost.restyled = static_cast<double>(after.restyled - before.restyled) / Switches;
+		cost.presents = static_cast<double>(queries.presents) / Switches;
+		cost.frameQueries = static_cast<double>(queries.frameBoundsQueries) / Switches;
+		cost.desktopQueries = static_cast<double>(queries.desktopQueries) / Switches;
+		cost.refreshes = after.refreshes - before.refreshes;
+		return cost;
+	}
+
+	// 전환마다 이전 창과 새 창 둘만 다시 표시: 창 10 개와 1000 개에서 같은 비용
+	void TestSwitchCostIsConstant()
+	{
+		std::printf("%-8s %10s %10s %12s %12s\n", "windows", "restyled", "presents", "frameQueries", "desktopQuery");
+		SwitchCost costs[2]{};
+		const uint64_t sizes[2] = { 10, 1000 };
+		for (size_t i = 0; i < 2; ++i)
+		{
+			costs[i] = ReplaySwitches(sizes[i], true);
+			std::printf("%-8llu %10.2f %10.2f %12.2f %12.2f\n", static_cast<unsigned long long>(sizes[i]), costs[i].restyled,
+				costs[i].presents, costs[i].frameQueries, costs[i].desktopQueries);
+
+			// 첫 전환은 이전 활성 창이 없으므로 하나
+			CHECK_EQ(costs[i].restyled * Switches, 2.0 * Switches - 1);
+			CHECK(costs[i].presents <= 2.0);
+			CHECK(costs[i].frameQueries <= 1.0);
+			// 소속은 캐시로만 답하고, 모든 테두리를 훑어 정리하지 않음
+			CHECK_EQ(costs[i].desktopQueries, 0.0);
+			CHECK_EQ(costs[i].refreshes, 0);
+		}
+		CHECK_EQ(costs[0].restyled, costs[1].restyled);
+		CHECK_EQ(costs[0].presents, costs[1].presents);
+		CHECK_EQ(costs[0].frameQueries, costs[1].frameQueries);
+	}
+
+	// 비활성 스타일이 없으면 두 역할이 같은 번호라 스타일 때문에 다시 그리지 않음 (포그라운드 창의 z 순서만 다시 맞춤)
+	void TestSameStyleDoesNotRestyle()
+	{
+		const SwitchCost cost = ReplaySwitches(1000, false);
+		CHECK_EQ(cost.restyled, 0.0);
+		CHECK(cost.presents <= 1.0);
+	}
+
+	// 한 프레임에 A -> B -> A 로 돌아오면 A 가 활성 (기록은 창마다 처음 도착 순서)
+	void TestLatestForegroundInFrameWins()
+	{
+		SimulatedWindowSystem windowSystem{};
+		const WindowHandle a = MakeHandle(0);
+		const WindowHandle b = MakeHandle(1);
+		windowSystem.AddWindow(a, WindowRect{ 0, 0, 400, 300 });
+		windowSystem.AddWindow(b, WindowRect{ 500, 0, 900, 300 });
+
+		BorderTracker tracker(windowSystem, StyleOf(ActiveColor), GeometryPollPolicy{ 0, 0 });
+		tracker.SetInactiveStyle(StyleOf(InactiveColor));
+		tracker.AddWindow(a);
+		tracker.AddWindow(b);
+		CHECK(tracker.ActiveWindow() == nullptr);
+		CHECK_EQ(tracker.Styles().Get(tracker.Find(a)->presented.style).color, InactiveColor);
+
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, a, WinEventObjectId::Window, 0, 1, 100 }, 1000);
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, b, WinEventObjectId::Window, 0, 1, 101 }, 1100);
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, a, WinEventObjectId::Window, 0, 1, 102 }, 1200);
+		tracker.Flush(16000);
+		CHECK(tracker.ActiveWindow() == a);
+		CHECK_EQ(tracker.ForegroundStats().switches, 1);
+		CHECK_EQ(tracker.Styles().Get(tracker.Find(a)->presented.style).color, ActiveColor);
+		CHECK_EQ(tracker.Styles().Get(tracker.Find(b)->presented.style).color, InactiveColor);
+
+		// 활성 창이 파괴되면 잊기만 하고, 다음 전환은 새 창 하나만
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectDestroy, a, WinEventObjectId::Window, 0, 1, 103 }, 20000);
+		tracker.Flush(32000);
+		CHECK(tracker.ActiveWindow() == nullptr);
+		const uint64_t restyled = tracker.ForegroundStats().restyled;
+		tracker.SetActiveWindow(b);
+		CHECK_EQ(tracker.ForegroundStats().restyled - restyled, 1);
+		CHECK_EQ(tracker.Styles().Get(tracker.Find(b)->presented.style).color, ActiveColor);
+
+		// 활성 스타일만 바꿔도 비활성 테두리는 그대로
+		tracker.SetStyle(StyleOf(0x00FF0000));
+		CHECK_EQ(tracker.Styles().Get(tracker.Find(b)->presented.style).color, 0x00FF0000u);
+		CHECK_EQ(tracker.Styles().InactiveStyle().color, InactiveColor);
+	}
+
+	// 표: 비활성 스타일이 없으면 같은 번호, 있으면 역할마다 DPI 별 번호
+	void TestStyleTableRoles()
+	{
+		BorderStyleTable table(StyleOf(ActiveColor));
+		CHECK(!table.HasInactiveStyle());
+		CHECK_EQ(table.Resolve(96, BorderRole::Active), table.Resolve(96, BorderRole::Inactive));
+
+		table.SetInactiveStyle(StyleOf(InactiveColor));
+		CHECK(table.HasInactiveStyle());
+		const StyleId active = table.Resolve(96, BorderRole::Active);
+		const StyleId inactive = table.Resolve(96, BorderRole::Inactive);
+		CHECK(active != inactive);
+		CHECK_EQ(table.Get(inactive).color, InactiveColor);
+		CHECK_EQ(table.Get(table.Resolve(144, BorderRole::Inactive)).dpi, 144);
+
+		// 같은 값이면 역할이 달라도 레코드를 함께 씀
+		table.SetInactiveStyle(StyleOf(ActiveColor));
+		CHECK_EQ(table.Resolve(96, BorderRole::Inactive), active);
+	}
+}
+
+int main()
+{
+	TestStyleTableRoles();
+	TestLatestForegroundInFrameWins();
+	TestSameStyleDoesNotRestyle();
+	TestSwitchCostIsConstant();
+	return TestResult("ForegroundSwitchTest");
+}
@@ -0,0 +1,204 @@
+﻿// GeometrySnapshot 의 배열 비교를 창별 구조체로 비교한 결과와 맞춰 보고, BorderTracker 가 한 틱에 창마다 한 번만 조회하는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. GeometrySnapshotTest.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o GeometrySnapshotTest
+
+#include "TestUtil.h"
+#include "BorderTracker.h"
+#include "GeometrySnapshot.h"
+#include "SimulatedWindowSystem.h"
+
+#include <map>
+#include <random>
+#include <set>
+
+namespace
+{
+	struct ReferenceGeometry
+	{
+		WindowRect rect{};
+		uint32_t dpi = 0;
+		bool valid = false;
+
+		bool operator==(const ReferenceGeometry&) const = default;
+	};
+
+	// 무작위로 움직이고 지우면서, Diff 가 넘긴 창이 이전에 넘긴 값과 다른 창과 정확히 같은지
+	void TestMatchesReference()
+	{
+		constexpr uint64_t Handles = 300;
+
+		GeometrySnapshot<uint64_t> snapshot{};
+		std::map<uint64_t, ReferenceGeometry> current{};
+		std::map<uint64_t, ReferenceGeometry> presented{};
+		std::mt19937_64 random(11);
+
+		uint64_t missed = 0;
+		uint64_t extra = 0;
+		uint64_t wrongValue = 0;
+		uint64_t queries = 0;
+		for (int tick = 0; tick < 2000; ++tick)
+		{
+			// 일부 창만 움직이거나 DPI 가 바뀌거나 사라짐 (조회 실패)
+			for (int change = 0; change < 20; ++change)
+			{
+				ReferenceGeometry& geometry = current[random() % Handles];
+				switch (random() % 4)
+				{
+				case 0:
+					geometry.rect.left += 1;
+					geometry.rect.right += 1;
+					break;
+				case 1:
+					geometry.rect.bottom += 3;
+					break;
+				case 2:
+					geometry.dpi = geometry.dpi == 96 ? 144 : 96;
+					break;
+				default:
+					geometry.valid = !geometry.valid;
+					break;
+				}
+			}
+
+			snapshot.BeginTick();
+			std::set<uint64_t> sampled{};
+			for (int request = 0; request < 60; ++request)
+			{
+				const uint64_t handle = random() % Handles;
+				sampled.insert(handle);
+				snapshot.Sample(handle, [&](uint64_t queried, WindowRect& rect, uint32_t& dpi)
+					{
+						queries++;
+						const ReferenceGeometry& geometry = current[queried];
+						rect = geometry.rect;
+						dpi = geometry.dpi;
+						return geometry.valid;
+					});
+			}
+
+			std::set<uint64_t> passed{};
+			snapshot.Diff([&](uint64_t handle, uint32_t index)
+				{
+					passed.insert(handle);
+					const ReferenceGeometry& geometry = current[handle];
+					if (snapshot.IsValid(index) != geometry.valid)
+						wrongValue++;
+					else if (geometry.valid && (snapshot.Dpi(index) != geometry.dpi || snapshot.Rect(index) != geometry.rect))
+						wrongValue++;
+				});
+
+			for (uint64_t handle : sampled)
+			{
+				// 조회에 실패한 값은 모두 같고, 처음 본 창은 유효하게 조회되었을 때만 바뀐 것으로 나옴
+				auto found = presented.find(handle);
+				const ReferenceGeometry previous = found != presented.end() ? found->second : ReferenceGeometry{};
+				const ReferenceGeometry& geometry = current[handle];
+				const bool changed = geometry.valid ? !(previous == geometry) : previous.valid;
+				const bool reported = passed.count(handle) != 0;
+				if (changed && !reported)
+					missed++;
+				if (!changed && reported)
+					extra++;
+				CHECK_EQ(snapshot.WasChanged(handle), reported);
+				if (reported)
+					presented[handle] = geometry.valid ? geometry : ReferenceGeometry{};
+			}
+
+			// 가끔 창을 지워 마지막 항목이 자리를 옮기게 함
+			if (tick % 7 == 0)
+			{
+				const uint64_t handle = random() % Handles;
+				snapshot.Forget(handle);
+				presented.erase(handle);
+			}
+		}
+
+		CHECK_EQ(missed, 0);
+		CHECK_EQ(extra, 0);
+		CHECK_EQ(wrongValue, 0);
+		// 한 틱에 같은 창을 여러 번 요청해도 한 번만 조회
+		CHECK_EQ(snapshot.Stats().queries, queries);
+		CHECK(snapshot.Stats().reused > 0);
+		CHECK_EQ(snapshot.Stats().queries + snapshot.Stats().reused, 2000 * 60);
+	}
+
+	// Force 는 값이 같아도 넘기고, Accept 한 값은 넘기지 않음
+	void TestForceAndAccept()
+	{
+		GeometrySnapshot<uint64_t> snapshot{};
+		const auto query = [](uint64_t, WindowRect& rect, uint32_t& dpi)
+			{
+				rect = WindowRect{ 0, 0, 100, 100 };
+				dpi = 96;
+				return true;
+			};
+
+		snapshot.BeginTick();
+		snapshot.Accept(snapshot.Sample(1, query));
+		size_t passed = snapshot.Diff([](uint64_t, uint32_t) {});
+		CHECK_EQ(passed, 0);
+
+		snapshot.BeginTick();
+		snapshot.Sample(1, query);
+		CHECK_EQ(snapshot.Diff([](uint64_t, uint32_t) {}), 0);
+
+		snapshot.BeginTick();
+		snapshot.Force(snapshot.Sample(1, query));
+		CHECK_EQ(snapshot.Diff([](uint64_t, uint32_t) {}), 1);
+		CHECK(snapshot.WasChanged(1));
+
+		// 다음 틱에는 Force 가 남지 않음
+		snapshot.BeginTick();
+		snapshot.Sample(1, query);
+		CHECK_EQ(snapshot.Diff([](uint64_t, uint32_t) {}), 0);
+		CHECK(!snapshot.WasChanged(1));
+	}
+
+	// 한 프레임에 여러 번 병합된 이벤트와 포그라운드 갱신이 있어도 창마다 조회는 한 번, 움직인 창만 표시
+	void TestTrackerQueriesOncePerTick()
+	{
+		constexpr uint64_t Windows = 50;
+
+		SimulatedWindowSystem windowSystem;
+		for (uint64_t i = 0; i < Windows; ++i)
+		{
+			const int32_t x = static_cast<int32_t>(i) * 10;
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, 0, x + 300, 200 });
+		}
+
+		GeometryPollPolicy policy{};
+		policy.fastIntervalUs = 0;
+		BorderTracker tracker(windowSystem, BorderStyle{}, policy);
+		for (uint64_t i = 0; i < Windows; ++i)
+			tracker.AddWindow(MakeHandle(i));
+
+		const SimulatedQueryStats before = windowSystem.QueryStats();
+
+		// 모든 창에 위치 이벤트, 그 중 다섯 창만 실제로 움직임
+		uint32_t eventTime = 0;
+		for (uint64_t i = 0; i < Windows; ++i)
+		{
+			if (i % 10 == 0)
+				windowSystem.FindWindow(MakeHandle(i))->frame.top += 5;
+			tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(i), 0, 0, 1, ++eventTime }, 0);
+			tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemMoveSizeEnd, MakeHandle(i), 0, 0, 1, ++eventTime }, 0);
+		}
+		tracker.Flush(16000);
+
+		const SimulatedQueryStats& after = windowSystem.QueryStats();
+		CHECK_EQ(after.frameBoundsQueries - before.frameBoundsQueries, Windows);
+		CHECK_EQ(after.presents - before.presents, 5);
+
+		// 포그라운드가 된 창은 그대로여도 다시 올림 (z 순서)
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::SystemForeground, MakeHandle(3), 0, 0, 1, ++eventTime }, 20000);
+		tracker.Flush(36000);
+		CHECK_EQ(windowSystem.QueryStats().presents - before.presents, 6);
+	}
+}
+
+int main()
+{
+	TestMatchesReference();
+	TestForceAndAccept();
+	TestTrackerQueriesOncePerTick();
+	return TestResult("GeometrySnapshotTest");
+}
@@ -0,0 +1,173 @@
+﻿// HandleRegistry 의 삽입 / 삭제 / 조회가 std::unordered_map 과 같은 결과를 내는지, 삭제 후 같은 핸들을 다시 넣어도
+// 이전 RegistryKey 로는 접근할 수 없는지, 그리고 테이블을 늘리는 (Rehash) 동안 항목과 키가 유지되는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. HandleRegistryTest.cpp -o HandleRegistryTest
+
+#include "TestUtil.h"
+#include "HandleRegistry.h"
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// 홈 위치가 네 곳뿐이라 탐사 체인이 길어지고, 역방향 시프트 삭제가 체인 중간을 옮기게 됨
+	struct CollidingBits
+	{
+		uint64_t operator()(uint64_t handle) const noexcept { return handle & 3; }
+	};
+
+	// 레지스트리의 항목이 기준 map 과 같은지: 개수, 조회, 밀집 배열 순회
+	template <typename Registry>
+	void CheckSameAs(const Registry& registry, const std::unordered_map<uint64_t, int>& expected)
+	{
+		CHECK_EQ(registry.Size(), expected.size());
+		for (const auto& [handle, value] : expected)
+		{
+			const int* found = registry.Find(handle);
+			CHECK(found != nullptr);
+			if (found)
+				CHECK_EQ(*found, value);
+		}
+
+		size_t visited = 0;
+		registry.ForEach([&](uint64_t handle, const int& value)
+			{
+				const auto it = expected.find(handle);
+				CHECK(it != expected.end());
+				if (it != expected.end())
+					CHECK_EQ(value, it->second);
+				visited++;
+			});
+		CHECK_EQ(visited, expected.size());
+	}
+
+	// 무작위 삽입 / 덮어쓰기 / 삭제를 기준 map 과 같이 하고, 매번 조회 결과를 비교
+	template <typename Hasher>
+	void TestMatchesUnorderedMap(uint64_t handleRange)
+	{
+		HandleRegistry<uint64_t, int, Hasher> registry{};
+		std::unordered_map<uint64_t, int> expected{};
+		std::mt19937 random(1234);
+
+		for (int step = 0; step < 20000; ++step)
+		{
+			const uint64_t handle = 0x10000 + (random() % handleRange) * 4;
+			const int value = static_cast<int>(random() % 1000);
+			switch (random() % 4)
+			{
+			case 0:
+			case 1:
+			{
+				const auto [stored, inserted] = registry.Emplace(handle, value);
+				const auto [it, expectedInserted] = expected.emplace(handle, value);
+				CHECK_EQ(inserted, expectedInserted);
+				CHECK_EQ(*stored, it->second);
+				break;
+			}
+			case 2:
+				registry[handle] = value;
+				expected[handle] = value;
+				break;
+			default:
+				CHECK_EQ(registry.Erase(handle), expected.erase(handle) == 1);
+				break;
+			}
+
+			CHECK_EQ(registry.Contains(handle), expected.count(handle) == 1);
+		}
+
+		CheckSameAs(registry, expected);
+
+		registry.Clear();
+		CHECK(registry.Empty());
+		for (const auto& [handle, value] : expected)
+			CHECK(registry.Find(handle) == nullptr);
+	}
+
+	// 지운 뒤 같은 핸들 (재사용된 HWND) 로 다시 넣으면 같은 슬롯을 쓰더라도 이전 키는 무효
+	void TestStaleKeyRejected()
+	{
+		HandleRegistry<WindowHandle, int> registry{};
+		const WindowHandle window = MakeHandle(1);
+
+		registry[window] = 1;
+		const RegistryKey oldKey = registry.KeyOf(window);
+		CHECK(oldKey.IsValid());
+		CHECK(registry.Get(oldKey) != nullptr);
+
+		CHECK(registry.Erase(window));
+		CHECK(registry.Get(oldKey) == nullptr);
+		CHECK(!registry.KeyOf(window).IsValid());
+
+		registry[window] = 2;
+		const RegistryKey newKey = registry.KeyOf(window);
+		CHECK_EQ(newKey.index, oldKey.index);
+		CHECK(newKey != oldKey);
+		CHECK(registry.Get(oldKey) == nullptr);
+		CHECK(!registry.Erase(oldKey));
+		CHECK(registry.Contains(window));
+		CHECK_EQ(*registry.Get(newKey), 2);
+
+		// Clear 도 세대를 올리므로 그 전의 키는 무효
+		registry.Clear();
+		registry[window] = 3;
+		CHECK(registry.Get(newKey) == nullptr);
+		CHECK_EQ(*registry.Get(registry.KeyOf(window)), 3);
+
+		// 키로 지우기
+		CHECK(registry.Erase(registry.KeyOf(window)));
+		CHECK(registry.Empty());
+	}
+
+	// 테이블을 여러 번 늘려도 모든 항목을 찾고, 늘리기 전에 받은 키가 그대로 같은 값을 가리킴
+	void TestRehashKeepsEntriesAndKeys()
+	{
+		HandleRegistry<WindowHandle, uint64_t> registry{};
+		std::vector<RegistryKey> keys{};
+		constexpr uint64_t Count = 5000;
+
+		for (uint64_t i = 0; i < Count; ++i)
+		{
+			registry[MakeHandle(i)] = i;
+			keys.push_back(registry.KeyOf(MakeHandle(i)));
+		}
+
+		CHECK_EQ(registry.Size(), Count);
+		for (uint64_t i = 0; i < Count; ++i)
+		{
+			const uint64_t* value = registry.Find(MakeHandle(i));
+			CHECK(value != nullptr && *value == i);
+			const uint64_t* byKey = registry.Get(keys[i]);
+			CHECK(byKey != nullptr && *byKey == i);
+		}
+		CHECK(registry.Find(MakeHandle(Count)) == nullptr);
+
+		// 짝수를 지우면 마지막 항목이 빈 자리로 옮겨지지만 홀수의 키는 그대로 유효
+		for (uint64_t i = 0; i < Count; i += 2)
+			CHECK(registry.Erase(MakeHandle(i)));
+		CHECK_EQ(registry.Size(), Count / 2);
+		for (uint64_t i = 0; i < Count; ++i)
+		{
+			const uint64_t* byKey = registry.Get(keys[i]);
+			if (i % 2 == 0)
+				CHECK(byKey == nullptr);
+			else
+				CHECK(byKey != nullptr && *byKey == i);
+		}
+
+		// Reserve 로 미리 늘려도 같음
+		registry.Reserve(Count * 4);
+		for (uint64_t i = 1; i < Count; i += 2)
+			CHECK(registry.Get(keys[i]) != nullptr && registry.Contains(MakeHandle(i)));
+	}
+}
+
+int main()
+{
+	TestMatchesUnorderedMap<HandleBits<uint64_t>>(4096);
+	TestMatchesUnorderedMap<CollidingBits>(64);
+	TestStaleKeyRejected();
+	TestRehashKeepsEntriesAndKeys();
+	return TestResult("HandleRegistryTest");
+}
@@ -0,0 +1,111 @@
+﻿// BoundedMpscQueue 를 여러 생산자로 채우면서 빠짐, 중복, 생산자별 순서 뒤바뀜이 없는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. MpscQueueTest.cpp -o MpscQueueTest
+
+#include "TestUtil.h"
+#include "MpscQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// 용량은 2 의 거듭제곱으로 올리고, 가득 차면 기다리지 않고 거절
+	void TestCapacityAndFull()
+	{
+		BoundedMpscQueue<uint64_t> queue(5);
+		CHECK_EQ(queue.Capacity(), 8);
+
+		for (uint64_t i = 0; i < 8; ++i)
+			CHECK(queue.TryPush(i));
+		CHECK(!queue.TryPush(8));
+		CHECK_EQ(queue.ApproxSize(), 8);
+
+		uint64_t value = 0;
+		CHECK(queue.TryPop(value));
+		CHECK_EQ(value, 0);
+		CHECK(queue.TryPush(8));
+
+		for (uint64_t expected = 1; expected <= 8; ++expected)
+		{
+			CHECK(queue.TryPop(value));
+			CHECK_EQ(value, expected);
+		}
+		CHECK(!queue.TryPop(value));
+		CHECK_EQ(queue.ApproxSize(), 0);
+	}
+
+	// 생산자 여럿이 작은 큐를 계속 돌려 쓰는 동안 소비자가 모든 값을 생산자별 순서대로 받는지
+	void TestConcurrentProducers()
+	{
+		constexpr uint64_t Producers = 4;
+		constexpr uint64_t PerProducer = 250000;
+
+		BoundedMpscQueue<uint64_t> queue(256);
+		std::atomic<uint64_t> rejected{ 0 };
+
+		std::vector<std::thread> producers;
+		for (uint64_t producer = 0; producer < Producers; ++producer)
+		{
+			producers.emplace_back([&queue, &rejected, producer]()
+				{
+					for (uint64_t sequence = 0; sequence < PerProducer; ++sequence)
+					{
+						const uint64_t value = (producer << 32) | sequence;
+						while (!queue.TryPush(value))
+						{
+							rejected.fetch_add(1, std::memory_order_relaxed);
+							std::this_thread::yield();
+						}
+					}
+				});
+		}
+
+		std::vector<uint64_t> next(Producers, 0);
+		uint64_t received = 0;
+		uint64_t outOfOrder = 0;
+		uint64_t unknown = 0;
+		while (received < Producers * PerProducer)
+		{
+			uint64_t value = 0;
+			if (!queue.TryPop(value))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			received++;
+			const uint64_t producer = value >> 32;
+			const uint64_t sequence = value & 0xFFFFFFFFull;
+			if (producer >= Producers)
+			{
+				unknown++;
+				continue;
+			}
+			if (sequence != next[producer])
+				outOfOrder++;
+			next[producer] = sequence + 1;
+		}
+
+		for (auto& thread : producers)
+			thread.join();
+
+		uint64_t leftover = 0;
+		CHECK(!queue.TryPop(leftover));
+		CHECK_EQ(unknown, 0);
+		CHECK_EQ(outOfOrder, 0);
+		for (uint64_t producer = 0; producer < Producers; ++producer)
+			CHECK_EQ(next[producer], PerProducer);
+
+		std::printf("MpscQueueTest: %llu values from %llu producers, %llu full-queue retries\n",
+			static_cast<unsigned long long>(received), static_cast<unsigned long long>(Producers),
+			static_cast<unsigned long long>(rejected.load()));
+	}
+}
+
+int main()
+{
+	TestCapacityAndFull();
+	TestConcurrentProducers();
+	return TestResult("MpscQueueTest");
+}
@@ -0,0 +1,425 @@
+﻿// BorderPipeline 에 여러 훅 스레드가 초당 10 만 개의 이벤트를 넣는 동안 버림 없이 모든 단계를 통과하는지,
+// 표시 단계가 멈춰도 수신 단계가 기다리지 않는지, 한꺼번에 만드는 테두리가 작업 풀을 거쳐도 순서를 지키는지 SimulatedWindowSystem 으로 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. PipelineStressTest.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp ../BorderPipeline.cpp ../BorderAnimator.cpp ../WorkStealingPool.cpp -o PipelineStressTest
+
+#include "TestUtil.h"
+#include "BorderPipeline.h"
+#include "SimulatedWindowSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	/// <summary> Windows 의 표시 스레드 (메시지 루프) 대신 onPresentReady 로 깨워 PumpPresent 를 부르는 스레드 </summary>
+	class PresentThread
+	{
+	public:
+		explicit PresentThread(BorderPipeline& pipeline) : pipeline(pipeline) {}
+
+		void Start()
+		{
+			thread = std::thread([this]()
+				{
+					for (;;)
+					{
+						signal.wait(0, std::memory_order_acquire);
+						signal.exchange(0, std::memory_order_acq_rel);
+						if (stopping.load(std::memory_order_acquire))
+							break;
+
+						while (paused.load(std::memory_order_acquire) && !stopping.load(std::memory_order_acquire))
+							std::this_thread::sleep_for(std::chrono::milliseconds(1));
+						pipeline.PumpPresent();
+						pipeline.TrimOverlayPool();
+						overlayCount.store(pipeline.OverlayCount(), std::memory_order_release);
+					}
+
+					pipeline.ReleaseOverlays();
+				});
+		}
+
+		void Wake() noexcept
+		{
+			if (signal.exchange(1, std::memory_order_acq_rel) == 0)
+				signal.notify_one();
+		}
+
+		void Stop()
+		{
+			stopping.store(true, std::memory_order_release);
+			Wake();
+			thread.join();
+		}
+
+		/// <summary> 느린 렌더링 (EndDraw 가 오래 걸리는 경우) 흉내 </summary>
+		void SetPaused(bool value)
+		{
+			paused.store(value, std::memory_order_release);
+			Wake();
+		}
+
+		size_t OverlayCount() const noexcept { return overlayCount.load(std::memory_order_acquire); }
+
+	private:
+		BorderPipeline& pipeline;
+		std::thread thread;
+		std::atomic<uint32_t> signal{ 0 };
+		std::atomic<bool> stopping{ false };
+		std::atomic<bool> paused{ false };
+		std::atomic<size_t> overlayCount{ 0 };
+	};
+
+	void AddWindows(SimulatedWindowSystem& windowSystem, uint64_t count)
+	{
+		for (uint64_t i = 0; i < count; ++i)
+		{
+			const int32_t x = static_cast<int32_t>((i % 16) * 100);
+			const int32_t y = static_cast<int32_t>((i / 16) * 60);
+			windowSystem.AddWindow(MakeHandle(i), WindowRect{ x, y, x + 400, y + 300 });
+		}
+	}
+
+	void RegisterWindows(BorderPipeline& pipeline, uint64_t count)
+	{
+		pipeline.Post([count](BorderTracker& tracker)
+			{
+				for (uint64_t i = 0; i < count; ++i)
+					tracker.AddWindow(MakeHandle(i));
+			});
+	}
+
+	bool WaitFor(const std::function<bool()>& condition, std::chrono::milliseconds timeout)
+	{
+		const auto deadline = Clock::now() + timeout;
+		while (!condition())
+		{
+			if (Clock::now() > deadline)
+				return false;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return true;
+	}
+
+	void PrintStage(const char* name, const PipelineStageStats& stage)
+	{
+		std::printf("  %-8s %10llu items %8llu rejected  depth %5llu (max %5llu)  latency avg %9.1f us  max %8llu us\n",
+			name, static_cast<unsigned long long>(stage.items), static_cast<unsigned long long>(stage.rejected),
+			static_cast<unsigned long long>(stage.queueDepth), static_cast<unsigned long long>(stage.maxQueueDepth),
+			stage.AverageLatencyUs(), static_cast<unsigned long long>(stage.maxLatencyUs));
+	}
+
+	// 훅 스레드 4 개가 1 초 동안 초당 10 만 개 (위치 변경 위주, 일부는 자식 개체 이벤트) 를 넣음
+	void TestSustainedRate()
+	{
+		constexpr uint64_t WindowCount = 256;
+		constexpr uint64_t Producers = 4;
+		constexpr uint64_t TotalEvents = 100000;
+		constexpr uint64_t PerProducer = TotalEvents / Producers;
+		// 생산자 하나가 1 ms 마다 25 개 -> 4 개 합쳐 초당 10 만 개
+		constexpr uint64_t BatchEvents = 25;
+
+		SimulatedWindowSystem windowSystem;
+		AddWindows(windowSystem, WindowCount);
+
+		BorderPipeline pipeline(windowSystem, BorderStyle{});
+		PresentThread presentThread(pipeline);
+		presentThread.Start();
+
+		std::atomic<uint64_t> frameCallbacks{ 0 };
+		pipeline.Start([&presentThread]() { presentThread.Wake(); },
+			[&frameCallbacks](const BorderTracker&) { frameCallbacks.fetch_add(1, std::memory_order_relaxed); });
+
+		RegisterWindows(pipeline, WindowCount);
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount; }, std::chrono::seconds(5)));
+
+		std::atomic<uint64_t> dropped{ 0 };
+		std::atomic<uint64_t> filteredSent{ 0 };
+		const auto start = Clock::now();
+		std::vector<std::thread> producers;
+		for (uint64_t producer = 0; producer < Producers; ++producer)
+		{
+			producers.emplace_back([&pipeline, &dropped, &filteredSent, producer, start]()
+				{
+					auto batchDeadline = start;
+					uint32_t eventTime = 0;
+					for (uint64_t sent = 0; sent < PerProducer;)
+					{
+						for (uint64_t i = 0; i < BatchEvents && sent < PerProducer; ++i, ++sent)
+						{
+							const uint64_t index = (sent * Producers + producer) % WindowCount;
+							BorderTracker::Event event{ WinEventId::ObjectLocationChange, MakeHandle(index), 0, 0,
+								static_cast<uint32_t>(producer + 1), ++eventTime };
+							if (sent % 97 == 0)
+								event.event = WinEventId::SystemForeground;
+							else if (sent % 10 == 0)
+							{
+								// 캐럿 위치 변경: 수신 단계에서 걸러짐
+								event.idObject = -8;
+								filteredSent.fetch_add(1, std::memory_order_relaxed);
+							}
+							else if (sent % 10 == 5)
+							{
+								// 다른 프로세스의 추적하지 않는 창: 큐에 넣기 전에 사전 필터에서 걸러짐
+								event.hwnd = MakeHandle(WindowCount + index);
+								filteredSent.fetch_add(1, std::memory_order_relaxed);
+							}
+
+							if (!pipeline.Ingest(event) && event.idObject == 0 && event.hwnd == MakeHandle(index))
+								dropped.fetch_add(1, std::memory_order_relaxed);
+						}
+
+						batchDeadline += std::chrono::milliseconds(1);
+						std::this_thread::sleep_until(batchDeadline);
+					}
+				});
+		}
+		for (auto& thread : producers)
+			thread.join();
+		const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		// 큐에 남은 이벤트를 모두 꺼내고 마지막 프레임까지 반영될 때까지 기다림
+		CHECK(WaitFor([&pipeline]()
+			{
+				const PipelineStats stats = pipeline.Stats();
+				return stats.layout.items == stats.ingested && stats.layout.queueDepth == 0;
+			}, std::chrono::seconds(5)));
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		pipeline.Stop();
+		const PipelineStats stats = pipeline.Stats();
+		presentThread.Stop();
+
+		const double rate = static_cast<double>(stats.ingested + stats.filtered) / seconds;
+		std::printf("PipelineStressTest: %llu events in %.3f s (%.0f events/s), %llu frames, %llu resyncs\n",
+			static_cast<unsigned long long>(stats.ingested + stats.filtered), seconds, rate,
+			static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.resyncs));
+		PrintStage("layout", stats.layout);
+		PrintStage("present", stats.present);
+
+		CHECK_EQ(dropped.load(), 0);
+		CHECK_EQ(stats.layout.rejected, 0);
+		CHECK_EQ(stats.resyncs, 0);
+		CHECK_EQ(stats.filtered, filteredSent.load());
+		CHECK_EQ(stats.ingested + stats.filtered, TotalEvents);
+		CHECK_EQ(stats.layout.items, stats.ingested);
+		CHECK(stats.frames > 0);
+		CHECK_EQ(frameCallbacks.load(), stats.frames);
+		CHECK(stats.present.items >= WindowCount);
+		CHECK(rate >= 90000.0);
+
+		// 오버레이는 표시 스레드가 만들고 파괴함
+		CHECK_EQ(windowSystem.QueryStats().overlaysCreated, WindowCount);
+		CHECK_EQ(windowSystem.QueryStats().overlaysDestroyed, WindowCount);
+	}
+
+	// 표시 단계가 멈춰 있어도 Ingest 는 돌아오고, 넘친 이벤트는 버린 뒤 다시 맞춤
+	void TestStalledPresentDoesNotBlockIngest()
+	{
+		constexpr uint64_t WindowCount = 256;
+		constexpr uint64_t Events = 20000;
+
+		SimulatedWindowSystem windowSystem;
+		AddWindows(windowSystem, WindowCount);
+
+		PipelineOptions options{};
+		options.ingestCapacity = 1024;
+		options.presentCapacity = 64;
+		BorderPipeline pipeline(windowSystem, BorderStyle{}, options);
+		PresentThread presentThread(pipeline);
+		presentThread.SetPaused(true);
+		presentThread.Start();
+		pipeline.Start([&presentThread]() { presentThread.Wake(); });
+
+		// 오버레이 생성 명령만으로 표시 큐가 넘치므로 레이아웃 단계는 표시 단계를 기다리게 됨
+		RegisterWindows(pipeline, WindowCount);
+		CHECK(WaitFor([&pipeline]() { return pipeline.Stats().present.rejected > 0; }, std::chrono::seconds(5)));
+
+		uint64_t accepted = 0;
+		uint32_t eventTime = 0;
+		for (uint64_t i = 0; i < Events; ++i)
+		{
+			const BorderTracker::Event event{ WinEventId::ObjectLocationChange, MakeHandle(i % WindowCount), 0, 0, 1, ++eventTime };
+			if (pipeline.Ingest(event))
+				accepted++;
+		}
+
+		const PipelineStats stalled = pipeline.Stats();
+		CHECK(accepted < Events);
+		CHECK(stalled.layout.rejected > 0);
+		CHECK_EQ(presentThread.OverlayCount(), 0);
+
+		presentThread.SetPaused(false);
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount; }, std::chrono::seconds(5)));
+		CHECK(WaitFor([&pipeline]() { return pipeline.Stats().resyncs > 0; }, std::chrono::seconds(5)));
+
+		pipeline.Stop();
+		presentThread.Stop();
+		CHECK_EQ(windowSystem.QueryStats().overlaysDestroyed, WindowCount);
+	}
+
+	/// <summary> 생성 단계마다 호출된 스레드를 기록하는 시뮬레이션 창 시스템 </summary>
+	class AffinityWindowSystem : public SimulatedWindowSystem
+	{
+	public:
+		std::unique_ptr<BorderOverlay> BeginOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) override
+		{
+			Record(beginThreads);
+			return SimulatedWindowSystem::CreateOverlay(target, style, visual);
+		}
+
+		bool PrepareOverlay(BorderOverlay&, const BorderVisual&) override
+		{
+			Record(prepareThreads);
+			// 렌더 타깃 생성처럼 오래 걸리는 준비
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+			return true;
+		}
+
+		bool FinishOverlay(BorderOverlay&, const BorderVisual&) override
+		{
+			Record(finishThreads);
+			return true;
+		}
+
+		std::set<std::thread::id> Threads(const std::set<std::thread::id>& threads)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return threads;
+		}
+
+		std::set<std::thread::id> beginThreads;
+		std::set<std::thread::id> prepareThreads;
+		std::set<std::thread::id> finishThreads;
+
+	private:
+		std::mutex mutex;
+
+		void Record(std::set<std::thread::id>& threads)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			threads.insert(std::this_thread::get_id());
+		}
+	};
+
+	// 한꺼번에 만드는 테두리: 준비는 작업 풀에서, 창 생성과 표시는 표시 스레드에서. 최소화 / 복원으로 번호를 다시 써도 순서 유지
+	void TestBatchedCreate()
+	{
+		constexpr uint64_t WindowCount = 256;
+
+		AffinityWindowSystem windowSystem;
+		AddWindows(windowSystem, WindowCount);
+
+		PipelineOptions options{};
+		options.createWorkers = 3;
+		// 복원할 때 모두 새로 만들도록 보관하지 않음 (TestOverlayPool 에서 따로 검사)
+		options.overlayPoolLimit = 0;
+		BorderPipeline pipeline(windowSystem, BorderStyle{}, options);
+		PresentThread presentThread(pipeline);
+		presentThread.Start();
+		pipeline.Start([&presentThread]() { presentThread.Wake(); });
+
+		RegisterWindows(pipeline, WindowCount);
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount; }, std::chrono::seconds(10)));
+
+		// 절반을 최소화하고, 같은 프레임에 나머지 절반의 위치를 바꾼 뒤 다시 복원
+		uint32_t eventTime = 0;
+		for (uint64_t i = 0; i < WindowCount; i += 2)
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::SystemMinimizeStart, MakeHandle(i), 0, 0, 1, ++eventTime });
+		for (uint64_t i = 1; i < WindowCount; i += 2)
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(i), 0, 0, 1, ++eventTime });
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount / 2; }, std::chrono::seconds(10)));
+
+		for (uint64_t i = 0; i < WindowCount; i += 2)
+		{
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::SystemMinimizeEnd, MakeHandle(i), 0, 0, 1, ++eventTime });
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(i), 0, 0, 1, ++eventTime });
+		}
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount; }, std::chrono::seconds(10)));
+
+		pipeline.Stop();
+		const PipelineStats stats = pipeline.Stats();
+		presentThread.Stop();
+
+		CHECK_EQ(stats.overlaysCreated, WindowCount + WindowCount / 2);
+		CHECK(stats.createBatches >= 2);
+		CHECK_EQ(windowSystem.QueryStats().overlaysCreated, WindowCount + WindowCount / 2);
+		CHECK_EQ(windowSystem.QueryStats().overlaysDestroyed, WindowCount + WindowCount / 2);
+
+		// 스레드에 묶인 단계는 모두 한 스레드 (표시 스레드) 에서
+		const auto beginThreads = windowSystem.Threads(windowSystem.beginThreads);
+		const auto finishThreads = windowSystem.Threads(windowSystem.finishThreads);
+		CHECK_EQ(beginThreads.size(), 1);
+		CHECK(beginThreads == finishThreads);
+		CHECK(!windowSystem.Threads(windowSystem.prepareThreads).empty());
+	}
+
+	// 최소화한 창의 테두리는 상한까지 숨겨 보관했다가 복원할 때 다시 붙이고, 오래 쉬면 파괴
+	void TestOverlayPool()
+	{
+		constexpr uint64_t WindowCount = 64;
+		constexpr uint64_t PoolLimit = 16;
+
+		SimulatedWindowSystem windowSystem;
+		AddWindows(windowSystem, WindowCount);
+
+		PipelineOptions options{};
+		options.overlayPoolLimit = PoolLimit;
+		options.overlayPoolIdleUs = 100000;
+		BorderPipeline pipeline(windowSystem, BorderStyle{}, options);
+		PresentThread presentThread(pipeline);
+		presentThread.Start();
+		pipeline.Start([&presentThread]() { presentThread.Wake(); });
+
+		RegisterWindows(pipeline, WindowCount);
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount; }, std::chrono::seconds(5)));
+
+		// 절반 최소화: 상한까지만 보관하고 나머지는 파괴
+		uint32_t eventTime = 0;
+		for (uint64_t i = 0; i < WindowCount / 2; ++i)
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::SystemMinimizeStart, MakeHandle(i), 0, 0, 1, ++eventTime });
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount / 2; }, std::chrono::seconds(5)));
+		CHECK_EQ(pipeline.Stats().poolParks, PoolLimit);
+		CHECK_EQ(pipeline.Stats().pooledOverlays, PoolLimit);
+
+		// 복원: 보관한 만큼은 다시 붙이고 나머지만 새로 만듦
+		for (uint64_t i = 0; i < WindowCount / 2; ++i)
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::SystemMinimizeEnd, MakeHandle(i), 0, 0, 1, ++eventTime });
+		CHECK(WaitFor([&presentThread]() { return presentThread.OverlayCount() == WindowCount; }, std::chrono::seconds(5)));
+		CHECK_EQ(pipeline.Stats().poolRebinds, PoolLimit);
+		CHECK_EQ(pipeline.Stats().pooledOverlays, 0);
+
+		// 다시 몇 개를 최소화한 뒤 쓰이지 않으면 정리
+		for (uint64_t i = 0; i < 4; ++i)
+			pipeline.Ingest(BorderTracker::Event{ WinEventId::SystemMinimizeStart, MakeHandle(i), 0, 0, 1, ++eventTime });
+		CHECK(WaitFor([&pipeline]() { return pipeline.Stats().pooledOverlays == 4; }, std::chrono::seconds(5)));
+		std::this_thread::sleep_for(std::chrono::milliseconds(150));
+		presentThread.Wake();
+		CHECK(WaitFor([&pipeline]() { return pipeline.Stats().poolTrims == 4; }, std::chrono::seconds(5)));
+
+		pipeline.Stop();
+		const PipelineStats stats = pipeline.Stats();
+		presentThread.Stop();
+
+		const SimulatedQueryStats& queries = windowSystem.QueryStats();
+		CHECK_EQ(queries.overlaysCreated, WindowCount + WindowCount / 2 - PoolLimit);
+		CHECK_EQ(queries.rebinds, PoolLimit);
+		CHECK_EQ(queries.overlaysDestroyed, queries.overlaysCreated);
+		CHECK_EQ(stats.pooledOverlays, 0);
+	}
+}
+
+int main()
+{
+	TestSustainedRate();
+	TestStalledPresentDoesNotBlockIngest();
+	TestBatchedCreate();
+	TestOverlayPool();
+	return TestResult("PipelineStressTest");
+}
@@ -0,0 +1,162 @@
+﻿// SurfaceBucket 이 크기를 단계로 올려 잡아 창 크기를 끄는 동안 할당이 로그 횟수로 줄어드는지, 그리고 큰 표면 안에
+// 논리 크기만 그려도 (FrameDrawer 의 소프트웨어 그리기) 정확한 크기로 새로 그린 것과 같은 픽셀이 되는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. SurfaceBucketTest.cpp ../BorderRaster.cpp ../CornerMask.cpp -o SurfaceBucketTest
+
+#include "TestUtil.h"
+#include "BorderRaster.h"
+#include "SurfaceBucket.h"
+
+#include <vector>
+
+namespace
+{
+	constexpr uint32_t Red = 0x000000FF;
+
+	// 단계는 커지는 순서이고, extent 이상이며, 25% 와 정렬 단위를 넘게 남기지 않음
+	void TestBucketExtents()
+	{
+		CHECK_EQ(SurfaceBucket::BucketExtent(1), SurfaceBucket::Minimum);
+		CHECK_EQ(SurfaceBucket::BucketExtent(SurfaceBucket::Minimum), SurfaceBucket::Minimum);
+		CHECK_EQ(SurfaceBucket::BucketExtent(65), 80);
+
+		int32_t previous = 0;
+		for (int32_t extent = 1; extent <= 8192; ++extent)
+		{
+			const int32_t bucket = SurfaceBucket::BucketExtent(extent);
+			CHECK(bucket >= extent);
+			CHECK(bucket >= previous);
+			CHECK_EQ(bucket % SurfaceBucket::Alignment, 0);
+			CHECK(bucket <= SurfaceBucket::Minimum || bucket <= extent + extent / 4 + SurfaceBucket::Alignment);
+			// 다시 할당한 크기에서 바로 다시 줄이지 않음
+			CHECK(bucket == SurfaceBucket::Minimum || extent * 2 >= bucket);
+			previous = bucket;
+		}
+	}
+
+	// 한 픽셀씩 끌어 키우면 단계 경계에서만 다시 할당. 옮기기만 하면 (같은 크기) 아무것도 하지 않음
+	void TestDragReallocations()
+	{
+		SurfaceBucket bucket{};
+		CHECK(bucket.Fit(806, 606));
+		CHECK_EQ(bucket.AllocatedWidth(), SurfaceBucket::BucketExtent(806));
+		CHECK_EQ(bucket.AllocatedHeight(), SurfaceBucket::BucketExtent(606));
+
+		for (int i = 0; i < 100; ++i)
+			CHECK(!bucket.Fit(806, 606));
+		CHECK_EQ(bucket.Stats().reallocations, 1);
+		CHECK_EQ(bucket.Stats().reuses, 0);
+
+		uint64_t steps = 0;
+		for (int32_t grow = 1; grow <= 2000; ++grow, ++steps)
+			bucket.Fit(806 + grow, 606 + grow);
+		CHECK(bucket.AllocatedWidth() >= 2806);
+		// 정확한 크기면 2000 번, 단계로는 약 log1.25(2806 / 806) 개씩 두 축
+		CHECK(bucket.Stats().reallocations <= 16);
+		CHECK_EQ(bucket.Stats().reallocations + bucket.Stats().reuses, steps + 1);
+		std::printf("drag 806 -> 2806: %llu reallocations in %llu steps\n",
+			static_cast<unsigned long long>(bucket.Stats().reallocations), static_cast<unsigned long long>(steps));
+	}
+
+	// 줄일 때는 절반 아래로 내려갈 때만, 경계에서 왔다 갔다 해도 한 번뿐
+	void TestShrinkHysteresis()
+	{
+		SurfaceBucket bucket{};
+		bucket.Fit(1000, 1000);
+		const int32_t allocated = bucket.AllocatedWidth();
+		CHECK(!bucket.Fit(allocated / 2, allocated / 2));
+		CHECK_EQ(bucket.AllocatedWidth(), allocated);
+		CHECK(bucket.Fit(allocated / 2 - 1, 1000));
+		CHECK(bucket.AllocatedWidth() < allocated);
+		CHECK_EQ(bucket.AllocatedHeight(), allocated);
+
+		const uint64_t before = bucket.Stats().reallocations;
+		const int32_t edge = bucket.AllocatedWidth();
+		for (int i = 0; i < 50; ++i)
+		{
+			bucket.Fit(edge, 1000);
+			bucket.Fit(edge - 1, 1000);
+		}
+		CHECK_EQ(bucket.Stats().reallocations, before);
+
+		// 크기가 0 인 창은 표면을 그대로 둠
+		CHECK(!bucket.Fit(0, 500));
+		CHECK_EQ(bucket.AllocatedWidth(), edge);
+
+		bucket.Reset();
+		CHECK(bucket.Fit(edge, 1000));
+	}
+
+	BorderVisual LocalVisual(int32_t width, int32_t height, int32_t thickness)
+	{
+		BorderVisual visual{};
+		visual.bounds = WindowRect{ 0, 0, width, height };
+		visual.color = Red;
+		visual.thickness = thickness;
+		visual.margin = 3;
+		return visual;
+	}
+
+	// 같은 표면에 논리 크기만 고쳐 그려 온 결과가 정확한 크기의 새 버퍼에 한 번 그린 것과 같고, 논리 크기 밖은 투명
+	void TestDrawInsideBucket()
+	{
+		SurfaceBucket bucket{};
+		std::vector<uint32_t> surface;
+		BorderVisual drawn{};
+
+		const auto present = [&](const BorderVisual& next)
+			{
+				if (bucket.Fit(next.bounds.Width(), next.bounds.Height()))
+				{
+					surface.assign(static_cast<size_t>(bucket.AllocatedWidth()) * static_cast<size_t>(bucket.AllocatedHeight()), 0);
+					drawn = BorderVisual{};
+				}
+				RedrawBorder(surface.data(), static_cast<size_t>(bucket.AllocatedWidth()), drawn, next);
+				drawn = next;
+			};
+
+		const auto verify = [&](const BorderVisual& visual)
+			{
+				const int32_t width = visual.bounds.Width();
+				const int32_t height = visual.bounds.Height();
+				std::vector<uint32_t> exact(static_cast<size_t>(width) * static_cast<size_t>(height), 0);
+				RedrawBorder(exact.data(), static_cast<size_t>(width), BorderVisual{}, visual);
+
+				const size_t stride = static_cast<size_t>(bucket.AllocatedWidth());
+				uint64_t mismatches = 0;
+				for (int32_t y = 0; y < bucket.AllocatedHeight(); ++y)
+				{
+					for (int32_t x = 0; x < bucket.AllocatedWidth(); ++x)
+					{
+						const uint32_t expected = (x < width && y < height) ? exact[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)] : 0;
+						if (surface[static_cast<size_t>(y) * stride + static_cast<size_t>(x)] != expected)
+							mismatches++;
+					}
+				}
+				CHECK_EQ(mismatches, 0);
+			};
+
+		// 키우고, 줄이고, 두께를 바꾸는 끌기
+		int32_t width = 300;
+		int32_t height = 200;
+		for (int step = 0; step < 60; ++step)
+		{
+			width += (step < 40) ? 7 : -11;
+			height += (step % 3 == 0) ? 5 : -2;
+			const BorderVisual visual = LocalVisual(width, height, step < 50 ? 2 : 3);
+			present(visual);
+			if (step % 10 == 9)
+				verify(visual);
+		}
+		CHECK(bucket.Stats().reallocations < 10);
+		CHECK(bucket.Stats().reuses > 50);
+	}
+}
+
+int main()
+{
+	TestBucketExtents();
+	TestDragReallocations();
+	TestShrinkHysteresis();
+	TestDrawInsideBucket();
+	return TestResult("SurfaceBucketTest");
+}
@@ -0,0 +1,69 @@
+﻿#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include "WindowSystemTypes.h"
+
+// 테스트 공용 도구: 실패한 검사를 출력하고 세기만 합니다. main 은 TestResult() 를 반환합니다.
+
+inline int& TestFailures()
+{
+	static int failures = 0;
+	return failures;
+}
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			TestFailures()++; \
+		} \
+	} while (false)
+
+#define CHECK_EQ(actual, expected) \
+	do \
+	{ \
+		const auto actualValue = (actual); \
+		const auto expectedValue = (expected); \
+		if (!(actualValue == expectedValue)) \
+		{ \
+			std::fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %llu != %llu\n", __FILE__, __LINE__, #actual, #expected, \
+				static_cast<unsigned long long>(actualValue), static_cast<unsigned long long>(expectedValue)); \
+			TestFailures()++; \
+		} \
+	} while (false)
+
+inline int TestResult(const char* name)
+{
+	if (TestFailures() == 0)
+		std::printf("%s: passed\n", name);
+	else
+		std::printf("%s: %d check(s) failed\n", name, TestFailures());
+	return TestFailures() == 0 ? 0 : 1;
+}
+
+/// <summary> 테스트용 창 핸들. 번호마다 다른 값 (HWND 처럼 4 의 배수) </summary>
+inline WindowHandle MakeHandle(uint64_t index)
+{
+	return HandleFromBits(0x10000 + index * 4);
+}
+
+/// <summary> 파이프라인 (BorderPipeline) 의 레이아웃 스레드에서 command(tracker) 를 실행하고 끝날 때까지 기다립니다 </summary>
+template <typename Pipeline, typename Command>
+void RunOnLayout(Pipeline& pipeline, Command command)
+{
+	std::atomic<bool> done{ false };
+	pipeline.Post([&done, &command](auto& tracker)
+		{
+			command(tracker);
+			done.store(true, std::memory_order_release);
+		});
+	while (!done.load(std::memory_order_acquire))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
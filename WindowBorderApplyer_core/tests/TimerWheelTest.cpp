@@ -0,0 +1,189 @@
+﻿// TimerWheel 의 만료 시각을 단순한 목록과 비교하고, BorderTracker 의 위치 확인 간격 (빠르게 -> 늘려서 -> 멈춤) 을 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. TimerWheelTest.cpp ../BorderTracker.cpp ../BorderStyleTable.cpp -o TimerWheelTest
+
+#include "TestUtil.h"
+#include "BorderTracker.h"
+#include "SimulatedWindowSystem.h"
+#include "TimerWheel.h"
+
+#include <map>
+#include <random>
+
+namespace
+{
+	constexpr uint64_t TickUs = 1000;
+
+	// 무작위로 걸고 옮기고 취소하면서, 만료가 마감 칸보다 이르지 않고 마감 칸을 지난 첫 Advance 에서 일어나는지
+	void TestMatchesReference()
+	{
+		constexpr uint64_t Handles = 512;
+
+		TimerWheel<uint64_t> wheel(TickUs);
+		std::map<uint64_t, uint64_t> reference{};
+		std::mt19937_64 random(7);
+
+		uint64_t nowUs = 5 * TickUs;
+		uint64_t early = 0;
+		uint64_t late = 0;
+		uint64_t unexpected = 0;
+		uint64_t expired = 0;
+		uint64_t badDeadline = 0;
+		for (int step = 0; step < 200000; ++step)
+		{
+			const uint64_t handle = random() % Handles;
+			switch (random() % 4)
+			{
+			case 0:
+			case 1:
+			{
+				// 대부분 짧게, 가끔 위 단계까지 가는 긴 간격
+				const uint64_t delayUs = random() % 8 == 0 ? random() % (5000 * TickUs) : random() % (80 * TickUs);
+				wheel.Schedule(handle, nowUs + delayUs, nowUs);
+				reference[handle] = (nowUs + delayUs + TickUs - 1) / TickUs;
+				break;
+			}
+			case 2:
+				CHECK_EQ(wheel.Cancel(handle), reference.erase(handle) == 1);
+				break;
+			default:
+			{
+				const uint64_t nextUs = wheel.NextDeadlineUs();
+				uint64_t earliest = UINT64_MAX;
+				for (const auto& [key, tick] : reference)
+					earliest = tick < earliest ? tick : earliest;
+				// 다음 시각은 가장 이른 마감과 같음 (이미 지난 마감이면 다음 칸)
+				if (reference.empty() ? nextUs != 0 : nextUs != earliest * TickUs && earliest * TickUs > nowUs)
+					badDeadline++;
+
+				nowUs += random() % (40 * TickUs);
+				const uint64_t nowTick = nowUs / TickUs;
+				wheel.Advance(nowUs, [&](uint64_t expiredHandle)
+					{
+						auto found = reference.find(expiredHandle);
+						if (found == reference.end())
+						{
+							unexpected++;
+							return;
+						}
+						if (found->second > nowTick)
+							early++;
+						reference.erase(found);
+						expired++;
+					});
+
+				for (const auto& [key, tick] : reference)
+				{
+					if (tick <= nowTick)
+						late++;
+				}
+				break;
+			}
+			}
+			CHECK_EQ(wheel.Size(), reference.size());
+		}
+
+		CHECK_EQ(early, 0);
+		CHECK_EQ(late, 0);
+		CHECK_EQ(unexpected, 0);
+		CHECK_EQ(badDeadline, 0);
+		CHECK(expired > 10000);
+		CHECK(wheel.Stats().cascaded > 0);
+	}
+
+	// 콜백 안에서 다시 건 타이머는 같은 칸에서 다시 만료되지 않고, 비면 다음 시각이 0
+	void TestRescheduleInCallback()
+	{
+		TimerWheel<uint64_t> wheel(TickUs);
+		wheel.Schedule(1, 10 * TickUs, 0);
+
+		int fired = 0;
+		CHECK_EQ(wheel.Advance(10 * TickUs, [&](uint64_t handle)
+			{
+				fired++;
+				wheel.Schedule(handle, 0, 10 * TickUs);
+			}), 1);
+		CHECK_EQ(fired, 1);
+		CHECK_EQ(wheel.NextDeadlineUs(), 11 * TickUs);
+
+		CHECK_EQ(wheel.Advance(11 * TickUs, [&](uint64_t) { fired++; }), 1);
+		CHECK_EQ(fired, 2);
+		CHECK(wheel.Empty());
+		CHECK_EQ(wheel.NextDeadlineUs(), 0);
+
+		// 오래 쉬었다가 걸어도 지난 칸을 하나씩 처리하지 않음
+		wheel.Schedule(2, 3600000000ull + 5 * TickUs, 3600000000ull);
+		CHECK_EQ(wheel.NextDeadlineUs(), 3600000000ull + 5 * TickUs);
+	}
+
+	// 움직이지 않는 창은 간격을 두 배씩 늘리다가 확인을 멈추고, 움직임을 찾으면 다시 짧은 간격으로
+	void TestTrackerPollBackoff()
+	{
+		SimulatedWindowSystem windowSystem;
+		windowSystem.AddWindow(MakeHandle(0), WindowRect{ 0, 0, 400, 300 });
+		windowSystem.AddWindow(MakeHandle(1), WindowRect{ 500, 0, 900, 300 });
+
+		GeometryPollPolicy policy{};
+		policy.fastIntervalUs = 100000;
+		policy.maxIntervalUs = 800000;
+		BorderTracker tracker(windowSystem, BorderStyle{}, policy);
+		tracker.AddWindow(MakeHandle(0));
+		tracker.AddWindow(MakeHandle(1));
+		CHECK_EQ(tracker.PollingWindows(), 2);
+
+		// 100, 200, 400, 800 ms 간격으로 확인한 뒤 멈춤. 깨어나는 시각은 두 창이 같음
+		std::vector<uint64_t> wakeups{};
+		uint64_t nowUs = tracker.Poll(0);
+		while (nowUs != 0)
+		{
+			wakeups.push_back(nowUs);
+			nowUs = tracker.Poll(nowUs);
+		}
+		CHECK_EQ(wakeups.size(), 4);
+		CHECK_EQ(wakeups.back(), 1500000);
+		CHECK_EQ(tracker.PollStats().polls, 8);
+		CHECK_EQ(tracker.PollStats().changes, 0);
+		CHECK_EQ(tracker.PollStats().settled, 2);
+		CHECK_EQ(tracker.PollingWindows(), 0);
+
+		// 실제로 움직이지 않은 창의 위치 이벤트는 스냅샷에서 걸러져 다시 표시하거나 확인을 시작하지 않음
+		uint32_t eventTime = 0;
+		nowUs = 1900000;
+		const uint64_t unchanged = tracker.GeometryStats().unchanged;
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(1), 0, 0, 1, ++eventTime }, nowUs);
+		tracker.Flush(nowUs + 16000);
+		CHECK_EQ(tracker.PollingWindows(), 0);
+		CHECK_EQ(tracker.GeometryStats().unchanged, unchanged + 1);
+
+		// 이벤트로 움직임을 알리면 다시 확인을 시작하고, 이벤트 없이 배율이 다른 모니터로 옮겨진 창은 확인에서 찾음
+		nowUs = 2000000;
+		windowSystem.FindWindow(MakeHandle(0))->frame.left -= 10;
+		tracker.PushEvent(BorderTracker::Event{ WinEventId::ObjectLocationChange, MakeHandle(0), 0, 0, 1, ++eventTime }, nowUs);
+		tracker.Flush(nowUs + 16000);
+		CHECK_EQ(tracker.PollingWindows(), 1);
+
+		const int32_t thickness = tracker.Styles().Get(tracker.Find(MakeHandle(0))->presented.style).thickness;
+		windowSystem.AddMonitor(WindowRect{ 2000, 0, 4000, 1200 }, 192);
+		SimulatedWindow* moved = windowSystem.FindWindow(MakeHandle(0));
+		moved->frame = WindowRect{ 2100, 0, 2500, 300 };
+		nowUs = tracker.Poll(nowUs + 16000);
+		CHECK_EQ(nowUs, 2120000);
+		nowUs = tracker.Poll(nowUs);
+		CHECK_EQ(tracker.PollStats().changes, 1);
+		CHECK(tracker.Styles().Get(tracker.Find(MakeHandle(0))->presented.style).thickness > thickness);
+		// 바뀐 직후라 다시 짧은 간격
+		CHECK_EQ(nowUs, 2220000);
+
+		// 추적을 멈춘 창의 타이머는 취소
+		tracker.Clear();
+		CHECK_EQ(tracker.PollingWindows(), 0);
+		CHECK_EQ(tracker.Poll(nowUs), 0);
+	}
+}
+
+int main()
+{
+	TestMatchesReference();
+	TestRescheduleInCallback();
+	TestTrackerPollBackoff();
+	return TestResult("TimerWheelTest");
+}
@@ -0,0 +1,167 @@
+﻿// 사전 필터 (WinEventFilter.h) 를 검사합니다. 카운팅 블룸 필터가 넣은 창을 모두 찾고 모두 빼면 비는지, 같은 창을 여러 번
+// 넣으면 그만큼 빼야 사라지는지, 카운터가 UINT8_MAX 에 포화되면 빼도 비트가 남는지 (거짓 양성만 생기고 거짓 음성은 없음),
+// 그리고 이벤트 종류별 통과 / 거부 횟수가 판정대로 세어지는지 봅니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. WinEventFilterTest.cpp -o WinEventFilterTest
+
+#include "TestUtil.h"
+#include "WinEventFilter.h"
+
+#include <memory>
+
+namespace
+{
+	using Filter = TrackedWindowFilter<WindowHandle>;
+	using Prefilter = WinEventPrefilter<WindowHandle>;
+
+	// 넣은 창은 모두 찾고, 모두 빼면 어떤 창도 찾지 않음
+	void TestAddRemove()
+	{
+		// 비트맵과 카운터가 36 KB 라 스택에 두지 않음
+		auto filter = std::make_unique<Filter>();
+		constexpr uint64_t Count = 500;
+
+		for (uint64_t i = 0; i < Count; ++i)
+			CHECK(!filter->MayContain(MakeHandle(i)));
+
+		for (uint64_t i = 0; i < Count; ++i)
+			filter->Add(MakeHandle(i));
+		for (uint64_t i = 0; i < Count; ++i)
+			CHECK(filter->MayContain(MakeHandle(i)));
+
+		// 넣지 않은 창은 대부분 거름 (거짓 양성은 드묾)
+		uint64_t falsePositives = 0;
+		for (uint64_t i = Count; i < Count * 11; ++i)
+			falsePositives += filter->MayContain(MakeHandle(i)) ? 1 : 0;
+		CHECK(falsePositives < Count / 10);
+
+		// 절반을 빼도 남은 절반은 그대로 찾음
+		for (uint64_t i = 0; i < Count; i += 2)
+			filter->Remove(MakeHandle(i));
+		for (uint64_t i = 1; i < Count; i += 2)
+			CHECK(filter->MayContain(MakeHandle(i)));
+
+		for (uint64_t i = 1; i < Count; i += 2)
+			filter->Remove(MakeHandle(i));
+		for (uint64_t i = 0; i < Count * 11; ++i)
+			CHECK(!filter->MayContain(MakeHandle(i)));
+
+		// 없는 창을 빼도 카운터가 0 아래로 내려가지 않음
+		filter->Remove(MakeHandle(3));
+		filter->Add(MakeHandle(3));
+		CHECK(filter->MayContain(MakeHandle(3)));
+	}
+
+	// 같은 창을 두 번 넣으면 두 번 빼야 사라짐. Clear 는 모두 비움
+	void TestDuplicateAddAndClear()
+	{
+		auto filter = std::make_unique<Filter>();
+		const WindowHandle window = MakeHandle(42);
+
+		filter->Add(window);
+		filter->Add(window);
+		filter->Remove(window);
+		CHECK(filter->MayContain(window));
+		filter->Remove(window);
+		CHECK(!filter->MayContain(window));
+
+		filter->Add(window);
+		filter->Add(MakeHandle(43));
+		filter->Clear();
+		CHECK(!filter->MayContain(window));
+		CHECK(!filter->MayContain(MakeHandle(43)));
+	}
+
+	// 카운터가 UINT8_MAX 에 닿으면 더는 줄이지 않음: 몇 번을 빼도 비트가 남음 (Clear 만 지움)
+	void TestSaturationIsSticky()
+	{
+		auto filter = std::make_unique<Filter>();
+		const WindowHandle window = MakeHandle(7);
+
+		for (int i = 0; i < UINT8_MAX; ++i)
+			filter->Add(window);
+		for (int i = 0; i < UINT8_MAX * 2; ++i)
+			filter->Remove(window);
+		CHECK(filter->MayContain(window));
+
+		// 포화 직전이면 넣은 만큼 빼서 사라짐
+		const WindowHandle other = MakeHandle(8);
+		for (int i = 0; i < UINT8_MAX - 1; ++i)
+			filter->Add(other);
+		for (int i = 0; i < UINT8_MAX - 1; ++i)
+			filter->Remove(other);
+		CHECK(filter->MayContain(window));
+
+		filter->Clear();
+		CHECK(!filter->MayContain(window));
+	}
+
+	// 칸 번호와 이벤트 코드가 서로 되돌려지고, 쓰는 이벤트끼리 칸이 겹치지 않음
+	void TestStatsSlots()
+	{
+		const uint32_t events[] = {
+			WinEventId::SystemForeground, WinEventId::SystemMoveSizeStart, WinEventId::SystemMoveSizeEnd,
+			WinEventId::SystemMinimizeStart, WinEventId::SystemMinimizeEnd, WinEventId::ObjectCreate,
+			WinEventId::ObjectDestroy, WinEventId::ObjectShow, WinEventId::ObjectHide, WinEventId::ObjectReorder,
+			WinEventId::ObjectFocus, WinEventId::ObjectLocationChange, WinEventId::ObjectCloaked, WinEventId::ObjectUncloaked,
+		};
+
+		uint64_t usedSlots = 0;
+		for (uint32_t event : events)
+		{
+			const uint32_t slot = WinEventFilterStats::SlotOf(event);
+			CHECK(slot < WinEventFilterStats::SlotCount);
+			CHECK_EQ(WinEventFilterStats::EventOf(slot), event);
+			CHECK((usedSlots & (uint64_t{ 1 } << slot)) == 0);
+			usedSlots |= uint64_t{ 1 } << slot;
+		}
+	}
+
+	// Accept 는 판정마다 그 이벤트의 통과 또는 거부를 하나 세고, MayAccept 는 세지 않음
+	void TestAcceptRejectCounters()
+	{
+		auto prefilter = std::make_unique<Prefilter>();
+		const WindowHandle tracked = MakeHandle(1);
+		const WindowHandle untracked = MakeHandle(2);
+		prefilter->Track(tracked);
+
+		// 추적하지 않는 창이라도 표시 / 포그라운드는 통과 (새 창 등록)
+		CHECK(prefilter->Accept(WinEventId::ObjectShow, untracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		CHECK(prefilter->Accept(WinEventId::SystemForeground, untracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		// 추적하지 않는 창의 위치 변경은 거부, 추적 중인 창은 통과
+		CHECK(!prefilter->Accept(WinEventId::ObjectLocationChange, untracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		CHECK(prefilter->Accept(WinEventId::ObjectLocationChange, tracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		CHECK(prefilter->Accept(WinEventId::ObjectLocationChange, tracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		// 창 자신이 아닌 개체 (캐럿, 자식) 는 추적 중인 창이어도 거부
+		CHECK(!prefilter->Accept(WinEventId::ObjectLocationChange, tracked, WinEventObjectId::Caret, WinEventObjectId::ChildSelf));
+		CHECK(!prefilter->Accept(WinEventId::ObjectShow, tracked, WinEventObjectId::Window, 3));
+
+		const WinEventFilterStats& stats = prefilter->Stats();
+		CHECK_EQ(stats.Accepted(WinEventId::ObjectShow), 1);
+		CHECK_EQ(stats.Rejected(WinEventId::ObjectShow), 1);
+		CHECK_EQ(stats.Accepted(WinEventId::SystemForeground), 1);
+		CHECK_EQ(stats.Rejected(WinEventId::SystemForeground), 0);
+		CHECK_EQ(stats.Accepted(WinEventId::ObjectLocationChange), 2);
+		CHECK_EQ(stats.Rejected(WinEventId::ObjectLocationChange), 2);
+		CHECK_EQ(stats.TotalAccepted(), 4);
+		CHECK_EQ(stats.TotalRejected(), 3);
+
+		CHECK(prefilter->MayAccept(WinEventId::ObjectLocationChange, tracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		CHECK(!prefilter->MayAccept(WinEventId::ObjectLocationChange, untracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		CHECK_EQ(stats.TotalAccepted() + stats.TotalRejected(), 7);
+
+		// 추적을 그만두면 거부
+		prefilter->Untrack(tracked);
+		CHECK(!prefilter->Accept(WinEventId::ObjectLocationChange, tracked, WinEventObjectId::Window, WinEventObjectId::ChildSelf));
+		CHECK_EQ(stats.Rejected(WinEventId::ObjectLocationChange), 3);
+	}
+}
+
+int main()
+{
+	TestAddRemove();
+	TestDuplicateAddAndClear();
+	TestSaturationIsSticky();
+	TestStatsSlots();
+	TestAcceptRejectCounters();
+	return TestResult("WinEventFilterTest");
+}
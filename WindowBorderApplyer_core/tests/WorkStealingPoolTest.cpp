@@ -0,0 +1,119 @@
+﻿// WorkStealingPool 이 모든 작업을 한 번씩 실행하는지, 한쪽 큐에 몰린 긴 작업을 다른 스레드가 훔쳐 가는지 검사합니다.
+// 빌드: g++ -O2 -std=c++20 -pthread -I.. WorkStealingPoolTest.cpp ../WorkStealingPool.cpp -o WorkStealingPoolTest
+
+#include "TestUtil.h"
+#include "WorkStealingPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	void TestEveryIndexOnce()
+	{
+		constexpr size_t Count = 10000;
+
+		WorkStealingPool pool(4);
+		std::vector<std::atomic<uint32_t>> hits(Count);
+		for (int round = 0; round < 3; ++round)
+			pool.ParallelFor(Count, [&hits](size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+
+		uint64_t wrong = 0;
+		for (const auto& hit : hits)
+		{
+			if (hit.load() != 3)
+				wrong++;
+		}
+		CHECK_EQ(wrong, 0);
+
+		const WorkPoolStats stats = pool.Stats();
+		CHECK_EQ(stats.executed + stats.callerExecuted, Count * 3);
+		CHECK_EQ(stats.batches, 3);
+	}
+
+	// 첫 번째 큐의 구간만 오래 걸리면 나머지 스레드와 호출 스레드가 그 구간을 나눠 실행
+	void TestStealsUnevenWork()
+	{
+		constexpr size_t Count = 64;
+		constexpr size_t Workers = 4;
+
+		WorkStealingPool pool(Workers);
+		std::atomic<uint32_t> done{ 0 };
+		pool.ParallelFor(Count, [&done](size_t i)
+			{
+				if (i < Count / Workers)
+					std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				done.fetch_add(1, std::memory_order_relaxed);
+			});
+
+		CHECK_EQ(done.load(), Count);
+		const WorkPoolStats stats = pool.Stats();
+		CHECK(stats.stolen + stats.callerExecuted > 0);
+	}
+
+	// 여러 스레드가 동시에 ParallelFor 를 불러도 각자 자기 작업이 끝난 뒤에만 돌아옴
+	void TestConcurrentCallers()
+	{
+		constexpr int Callers = 3;
+		constexpr int Rounds = 200;
+
+		WorkStealingPool pool(3);
+		std::atomic<uint64_t> incomplete{ 0 };
+		std::vector<std::thread> callers;
+		for (int caller = 0; caller < Callers; ++caller)
+		{
+			callers.emplace_back([&pool, &incomplete, caller]()
+				{
+					for (int round = 0; round < Rounds; ++round)
+					{
+						const size_t count = static_cast<size_t>(1 + (round + caller) % 17);
+						std::vector<std::atomic<uint32_t>> hits(count);
+						pool.ParallelFor(count, [&hits](size_t i) { hits[i].fetch_add(1, std::memory_order_relaxed); });
+
+						for (const auto& hit : hits)
+						{
+							if (hit.load() != 1)
+								incomplete.fetch_add(1, std::memory_order_relaxed);
+						}
+					}
+				});
+		}
+		for (auto& thread : callers)
+			thread.join();
+
+		CHECK_EQ(incomplete.load(), 0);
+	}
+
+	// 작업 스레드가 없으면 호출 스레드에서 차례로
+	void TestNoWorkersRunsInline()
+	{
+		WorkStealingPool pool(0);
+		CHECK_EQ(pool.WorkerCount(), 0);
+
+		const auto caller = std::this_thread::get_id();
+		size_t next = 0;
+		bool inOrder = true;
+		bool onCaller = true;
+		pool.ParallelFor(100, [&](size_t i)
+			{
+				inOrder = inOrder && i == next++;
+				onCaller = onCaller && std::this_thread::get_id() == caller;
+			});
+
+		CHECK(inOrder);
+		CHECK(onCaller);
+		CHECK_EQ(next, 100);
+		CHECK_EQ(pool.Stats().callerExecuted, 100);
+	}
+}
+
+int main()
+{
+	TestEveryIndexOnce();
+	TestStealsUnevenWork();
+	TestConcurrentCallers();
+	TestNoWorkersRunsInline();
+	return TestResult("WorkStealingPoolTest");
+}
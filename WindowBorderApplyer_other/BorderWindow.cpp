@@ -1,5 +1,4 @@
 #include "BorderWindow.h"
-#include "ScalingUtil.h"
 #include "Windowmodule.h"
 
 #include <dwmapi.h>
@@ -7,24 +6,7 @@
 
 #include <winrt/windows.foundation.h>
 
-std::optional<RECT> GetFrameRect(HWND window, int borderlength)
-{
-	RECT rect;
-	if (!SUCCEEDED(DwmGetWindowAttribute(window, DWMWA_EXTENDED_FRAME_BOUNDS, &rect, sizeof(rect))))
-	{
-		// std:nullopt -  optional ü
-		return std::nullopt;
-	}
-
-	rect.top -= borderlength;
-	rect.left -= borderlength;
-	rect.right += borderlength;
-	rect.bottom += borderlength;
-
-	return rect;
-}
-
-BorderWindow::BorderWindow(HWND window, int borderlength, COLORREF color) : window(nullptr), trackingwindow(window), borderlength(borderlength), bordercolor(color) { } //  ׸ 
+BorderWindow::BorderWindow(HWND window, FrameBackend backend) : window(nullptr), trackingwindow(window), backend(backend) { } // 프레임 그리기 
 
 BorderWindow::~BorderWindow()
 {
@@ -41,10 +23,21 @@ BorderWindow::~BorderWindow()
 	}
 }
 
-std::unique_ptr<BorderWindow> BorderWindow::Create(HWND targetwindow, HINSTANCE hInstance, int borderlength, COLORREF color)
+std::unique_ptr<BorderWindow> BorderWindow::Create(HWND targetwindow, HINSTANCE hInstance, const BorderVisual& visual,
+	FrameBackend backend)
 {
-	auto self = std::unique_ptr<BorderWindow>(new BorderWindow(targetwindow, borderlength, color));
-	if (self->Init(hInstance))
+	auto self = Begin(targetwindow, hInstance, visual, backend);
+	if (self && self->Prepare(visual) && self->Finish(visual))
+		return self;
+
+	return nullptr;
+}
+
+std::unique_ptr<BorderWindow> BorderWindow::Begin(HWND targetwindow, HINSTANCE hInstance, const BorderVisual& visual,
+	FrameBackend backend)
+{
+	auto self = std::unique_ptr<BorderWindow>(new BorderWindow(targetwindow, backend));
+	if (self->CreateOverlayWindow(hInstance, visual))
 		return self;
 
 	return nullptr;
@@ -53,28 +46,27 @@ std::unique_ptr<BorderWindow> BorderWindow::Create(HWND targetwindow, HINSTANCE
 
 const wchar_t ToolWindowClassString[] = L"CustomWIndow_Border";
 
-constexpr uint32_t Refresh_Border_Timer_Id = 123;
-constexpr uint32_t Refresh_Border_Interval = 100;
 
-bool BorderWindow::Init(HINSTANCE hInstance)
+bool BorderWindow::CreateOverlayWindow(HINSTANCE hInstance, const BorderVisual& visual)
 {
 	if (!trackingwindow)
 		return false;
 
-	auto windowRectOpt = GetFrameRect(trackingwindow, borderlength);
-	if (!windowRectOpt.has_value())
-		return false;
-
-	RECT windowRect = windowRectOpt.value();
+	const WindowRect& windowRect = visual.bounds;
 
-	WNDCLASSEXW wce{};
-	wce.cbSize = sizeof(WNDCLASSEX);
-	wce.lpfnWndProc = s_WndProc;
-	wce.hInstance = hInstance;
-	wce.lpszClassName = ToolWindowClassString;
-	wce.hCursor = LoadCursorW(nullptr, IDC_ARROW);
-
-	RegisterClassExW(&wce);
+	// 창 클래스는 한 번만 등록 (Begin 은 표시 스레드에서만 호출)
+	static bool classRegistered = false;
+	if (!classRegistered)
+	{
+		WNDCLASSEXW wce{};
+		wce.cbSize = sizeof(WNDCLASSEX);
+		wce.lpfnWndProc = s_WndProc;
+		wce.hInstance = hInstance;
+		wce.lpszClassName = ToolWindowClassString;
+		wce.hCursor = LoadCursorW(nullptr, IDC_ARROW);
+
+		classRegistered = RegisterClassExW(&wce) != 0 || GetLastError() == ERROR_CLASS_ALREADY_EXISTS;
+	}
 
 	window = CreateWindowExW(WS_EX_LAYERED | WS_EX_TOOLWINDOW,
 		ToolWindowClassString,
@@ -82,8 +74,8 @@ bool BorderWindow::Init(HINSTANCE hInstance)
 		WS_POPUP | WS_DISABLED,
 		windowRect.left,
 		windowRect.top,
-		windowRect.right - windowRect.left,
-		windowRect.bottom - windowRect.top,
+		windowRect.Width(),
+		windowRect.Height(),
 		nullptr,
 		nullptr,
 		hInstance,
@@ -92,98 +84,128 @@ bool BorderWindow::Init(HINSTANCE hInstance)
 	if (!window)
 		return false;
 
-	if (!SetLayeredWindowAttributes(window, RGB(0, 0, 0), 0, LWA_COLORKEY))
+	// 소프트웨어 그리기는 UpdateLayeredWindowIndirect 의 픽셀 알파로 투명하게 하므로 색 키를 쓰지 않음
+	if (backend == FrameBackend::Direct2D && !SetLayeredWindowAttributes(window, RGB(0, 0, 0), 0, LWA_COLORKEY))
 		return false;
 
-	SetWindowPos(trackingwindow,
-		window,
-		windowRect.left,
-		windowRect.top,
-		windowRect.right - windowRect.left,
-		windowRect.bottom - windowRect.top,
-		SWP_NOMOVE | SWP_NOSIZE);
-
 	bool val = true;
 	DwmSetWindowAttribute(window, DWMWA_EXCLUDED_FROM_PEEK, &val, sizeof(val));
 
-	frameDrawer = FrameDrawer::Create(window);
+	return true;
+}
+
+bool BorderWindow::Prepare(const BorderVisual& visual)
+{
+	// 작업 스레드에서는 모양 계산과 DIB 처럼 장치 독립인 일만. 렌더 타깃은 창 메시지를 주고받을 수 있어 Finish 에서 만듦
+	// (소유 스레드는 작업 풀을 기다리는 동안 메시지를 처리하지 않음)
+	auto drawer = std::make_unique<FrameDrawer>(window, backend);
+	BorderVisual localVisual = visual;
+	localVisual.bounds = visual.LocalRect();
+	if (!drawer->Prepare(localVisual))
+		return false;
+
+	frameDrawer = std::move(drawer);
+	return true;
+}
+
+bool BorderWindow::Finish(const BorderVisual& visual)
+{
 	if (!frameDrawer)
 		return false;
 
+	const WindowRect& rect = visual.bounds;
+	SetWindowPos(trackingwindow,
+		window,
+		rect.left,
+		rect.top,
+		rect.Width(),
+		rect.Height(),
+		SWP_NOMOVE | SWP_NOSIZE);
+
+	// Direct2D 는 여기서 렌더 타깃을 만들고 처음 그림. Software 는 Prepare 에서 DIB 에 그려 두었으므로 바뀐 것이 없음
+	BorderVisual localVisual = visual;
+	localVisual.bounds = visual.LocalRect();
+	frameDrawer->SetBorderRect(localVisual);
+	if (frameDrawer->SurfaceBytes() == 0)
+		return false;
+
+	const SIZE windowSize = frameDrawer->WindowSize(rect.Width(), rect.Height());
+	SetWindowPos(window, trackingwindow, rect.left, rect.top, windowSize.cx, windowSize.cy, SWP_NOREDRAW | SWP_NOACTIVATE);
 	frameDrawer->Show();
-	UpdateBorderPosition();
-	UpdateBorderProperties();
-	timer_id = SetTimer(window, Refresh_Border_Timer_Id, Refresh_Border_Interval, nullptr);
+
+	presented = visual;
+	hasPresented = true;
 
 	return true;
 }
 
-void BorderWindow::UpdateBorderPosition() const
+bool BorderWindow::Present(const BorderVisual& visual)
 {
-	if (!trackingwindow)
-		return;
+	if (!trackingwindow || !frameDrawer)
+		return false;
+
+	// Direct2D 는 창을 단계 크기로 잡으므로 끄는 동안 창 크기도 단계를 벗어날 때만 바뀜
+	const WindowRect& rect = visual.bounds;
+	const SIZE windowSize = frameDrawer->WindowSize(rect.Width(), rect.Height());
+	SetWindowPos(window, trackingwindow, rect.left, rect.top, windowSize.cx, windowSize.cy, SWP_NOREDRAW | SWP_NOACTIVATE);
 
-	// Ʈŷ 쿡  width, height  borderlength ݿϿ ٽ ε ü
-	auto rectOpt = GetFrameRect(trackingwindow, borderlength);
-	if (!rectOpt.has_value())
+	// 크기, 색, 두께가 그대로면 창만 옮기고 다시 그리지 않음
+	if (!hasPresented || !presented.SameShape(visual))
 	{
-		frameDrawer->Hide();
-		return;
+		BorderVisual localVisual = visual;
+		localVisual.bounds = visual.LocalRect();
+		frameDrawer->SetBorderRect(localVisual);
 	}
 
-	RECT rect = rectOpt.value();
-	SetWindowPos(window, trackingwindow, rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top, SWP_NOREDRAW | SWP_NOACTIVATE);
+	if (!hasPresented || presented.bounds.IsEmpty())
+		frameDrawer->Show();
+
+	presented = visual;
+	hasPresented = true;
+	return true;
 }
 
-void BorderWindow::UpdateBorderProperties() const
+void BorderWindow::Hide()
 {
-	if (!trackingwindow || !frameDrawer)
-		return;
-
-	auto windowRectOpt = GetFrameRect(trackingwindow, borderlength);
-	if (!windowRectOpt.has_value())
-		return;
-
-	const RECT windowRect = windowRectOpt.value();
-	SetWindowPos(window, trackingwindow, windowRect.left, windowRect.top, windowRect.right - windowRect.left, windowRect.bottom - windowRect.top, SWP_NOREDRAW | SWP_NOACTIVATE);
-
-	RECT frameRect{ 0, 0, windowRect.right - windowRect.left, windowRect.bottom - windowRect.top };
+	if (frameDrawer)
+		frameDrawer->Hide();
 
-	//COLORREF color = RGB(107, 120, 138);
-	COLORREF color = bordercolor;
-	// Accent ÷ 
+	presented.bounds = WindowRect{};
+}
 
-	float scalingF = ScalingUtil::ScalingF(trackingwindow);
-	float thickness = 2 * scalingF;
-	float cornerradius = 0.0;
+bool BorderWindow::Park()
+{
+	if (!window || !frameDrawer)
+		return false;
 
-	frameDrawer->SetBorderRect(frameRect, color, static_cast<int>(thickness), cornerradius);
+	Hide();
+	trackingwindow = nullptr;
+	return true;
 }
 
-void BorderWindow::SetBorderColor(COLORREF color)
+bool BorderWindow::Rebind(WindowHandle target, const BorderVisual& visual)
 {
-	bordercolor = color;
+	trackingwindow = static_cast<HWND>(target);
+	if (!IsWindow(trackingwindow))
+		return false;
+
+	SetWindowPos(trackingwindow,
+		window,
+		0,
+		0,
+		0,
+		0,
+		SWP_NOMOVE | SWP_NOSIZE);
+
+	// 숨겨 둔 상태이므로 Present 가 옮긴 뒤 다시 보이고, 모양이 같으면 그리지 않음
+	return Present(visual);
 }
 
 LRESULT BorderWindow::WndProc(UINT message, WPARAM wparam, LPARAM lparam) noexcept
 {
 	switch (message)
 	{
-	case WM_TIMER:
-	{
-		switch (wparam)
-		{
-		case Refresh_Border_Timer_Id:
-			KillTimer(window, timer_id);
-			timer_id = SetTimer(window, Refresh_Border_Timer_Id, Refresh_Border_Interval, nullptr);
-			UpdateBorderPosition();
-			UpdateBorderProperties();
-			break;
-		}
-		break;
-	}
 	case WM_NCDESTROY:
-		KillTimer(window, timer_id);
 		::DefWindowProc(window, message, wparam, lparam);
 		SetWindowLongPtr(window, GWLP_USERDATA, 0);
 		break;
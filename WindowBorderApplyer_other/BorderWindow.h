@@ -3,42 +3,58 @@
 #include <dwmapi.h>
 
 #include "FrameDrawer.h"
+#include "WindowSystem.h"
 
-class BorderWindow
+/// <summary> BorderOverlay 의 Win32 구현. 대상 창 바로 아래에 놓이는 레이어드 팝업 창에 테두리를 그립니다 </summary>
+class BorderWindow : public BorderOverlay
 {
-	BorderWindow(HWND window, int borderlength, COLORREF color);
+	BorderWindow(HWND window, FrameBackend backend);
 	BorderWindow(BorderWindow&& other) = default;
 
 public:
-	static std::unique_ptr<BorderWindow> Create(HWND targetwindow, HINSTANCE hinstance, int borderlength, COLORREF color);
-	~BorderWindow();
+	static std::unique_ptr<BorderWindow> Create(HWND targetwindow, HINSTANCE hinstance, const BorderVisual& visual,
+		FrameBackend backend = FrameBackend::Direct2D);
+	~BorderWindow() override;
 
-	void SetBorderColor(COLORREF color);
+	// Create 를 나눈 세 단계 (WindowSystem::BeginOverlay / PrepareOverlay / FinishOverlay)
+	/// <summary> 소유 스레드: 숨겨진 레이어드 창만 만듭니다 </summary>
+	static std::unique_ptr<BorderWindow> Begin(HWND targetwindow, HINSTANCE hinstance, const BorderVisual& visual,
+		FrameBackend backend = FrameBackend::Direct2D);
+	/// <summary> 아무 스레드: 장치와 창에 묶이지 않은 그리기 준비만 합니다 (FrameDrawer::Prepare). 창에 메시지를 보내지 않습니다 </summary>
+	bool Prepare(const BorderVisual& visual);
+	/// <summary> 소유 스레드: 렌더 타깃을 만들어 처음 그리고, 대상 창 아래에 놓고 표시합니다 (위치 확인은 BorderTracker 의 타이머 휠) </summary>
+	bool Finish(const BorderVisual& visual);
 
-	void UpdateBorderPosition() const;
-	void UpdateBorderProperties() const;
+	bool Present(const BorderVisual& visual) override;
+	void Hide() override;
+	/// <summary> 숨긴 채 대상 창과의 연결을 끊습니다. 창과 렌더 타깃은 그대로 둡니다 </summary>
+	bool Park() override;
+	/// <summary> 보관했던 창을 새 대상 창 아래에 놓고 다시 표시합니다. 크기가 같으면 다시 그리지 않습니다 </summary>
+	bool Rebind(WindowHandle target, const BorderVisual& visual) override;
+	uint64_t SurfaceBytes() const noexcept override { return frameDrawer ? frameDrawer->SurfaceBytes() : 0; }
 
 private:
-	UINT_PTR timer_id = {};
 	HWND window = {};
 	HWND trackingwindow = {};
-	COLORREF bordercolor;
+	FrameBackend backend;
 	std::unique_ptr<FrameDrawer> frameDrawer;
-	int borderlength = 1;
+	// 마지막으로 그린 모양 (스타일 값은 추적기의 스타일 표에서 펼친 것). 위치만 바뀌면 다시 그리지 않음
+	BorderVisual presented{};
+	bool hasPresented = false;
 
 	LRESULT WndProc(UINT message, WPARAM wparam, LPARAM lparam) noexcept;
 
-	bool Init(HINSTANCE hInstance);
+	bool CreateOverlayWindow(HINSTANCE hInstance, const BorderVisual& visual);
 
 protected:
 	/// <summary>
-	/// ø̼ ͸ â ϱ Ͽ â ޸𸮿 ߰ ͸  , Ŀҵ â ν Ȥ  ν ȣմϴ.
+	/// 애플리케이션 데이터를 창에 전달하기 위하여 창 메모리에 추가 데이터를 저장한 후, 커스텀된 창 프로시저 혹은 원래 프로시저를 호출합니다.
 	/// </summary>
-	/// <param name="window">: ߰ ͸  Window ڵ鷯</param>
-	/// <param name="message">: â ޽</param>
-	/// <param name="wparam">:  </param>
-	/// <param name="lparam">: WM_CREATE ޽ , CREATESTRUCT ü  </param>
-	/// <returns>ν ȯ LRESULT</returns>
+	/// <param name="window">: 추가 데이터를 저장할 Window 핸들러</param>
+	/// <param name="message">: 창 메시지</param>
+	/// <param name="wparam">: 사용되지 않음</param>
+	/// <param name="lparam">: WM_CREATE 메시지인 경우, CREATESTRUCT 구조체에 대한 포인터</param>
+	/// <returns>프로시저에서 반환된 LRESULT</returns>
 	static LRESULT CALLBACK s_WndProc(HWND window, UINT message, WPARAM wparam, LPARAM lparam) noexcept
 	{
 		auto thisRef = reinterpret_cast<BorderWindow*>(GetWindowLongPtr(window, GWLP_USERDATA));
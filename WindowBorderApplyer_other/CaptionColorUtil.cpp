@@ -9,10 +9,10 @@ COLORREF CaptionColorUtil::GetSettingCaptionColor()
 }
 
 /// <summary>
-/// ĸ  մϴ.
+/// 캡션 색을 설정합니다.
 /// </summary>
-/// <param name="color"> - ĸ </param>
-/// <returns> ƿ ü Ͽ ĸ  ùٸ Ǹ true, ƴϸ false ȯմϴ.</returns>
+/// <param name="color"> - 캡션 색</param>
+/// <returns>이 유틸 객체에 대하여 캡션 색이 올바르게 설정되면 true, 아니면 false를 반환합니다.</returns>
 bool CaptionColorUtil::SetSettingCaptionColor(COLORREF color)
 {
 	CaptionColor = color;
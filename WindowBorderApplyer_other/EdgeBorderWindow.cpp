@@ -0,0 +1,161 @@
+﻿#include "EdgeBorderWindow.h"
+
+#include <dwmapi.h>
+
+namespace
+{
+	const wchar_t EdgeStripClassString[] = L"CustomWIndow_BorderEdge";
+}
+
+std::unique_ptr<EdgeStripWindow> EdgeStripWindow::Create(HINSTANCE hinstance, HWND target, int32_t width, int32_t height)
+{
+	auto self = std::unique_ptr<EdgeStripWindow>(new EdgeStripWindow(target));
+	if (self->Initialize(hinstance) && self->Resize(width, height))
+		return self;
+
+	return nullptr;
+}
+
+EdgeStripWindow::~EdgeStripWindow()
+{
+	if (window)
+		DestroyWindow(window);
+}
+
+bool EdgeStripWindow::Initialize(HINSTANCE hinstance)
+{
+	// 창 클래스는 한 번만 등록 (표시 스레드에서만 호출)
+	static bool classRegistered = false;
+	if (!classRegistered)
+	{
+		WNDCLASSEXW wce{};
+		wce.cbSize = sizeof(WNDCLASSEX);
+		wce.lpfnWndProc = DefWindowProcW;
+		wce.hInstance = hinstance;
+		wce.lpszClassName = EdgeStripClassString;
+		wce.hCursor = LoadCursorW(nullptr, IDC_ARROW);
+
+		classRegistered = RegisterClassExW(&wce) != 0 || GetLastError() == ERROR_CLASS_ALREADY_EXISTS;
+	}
+
+	// 크기와 위치는 처음 Present 의 UpdateLayeredWindowIndirect 가 정함
+	window = CreateWindowExW(WS_EX_LAYERED | WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE,
+		EdgeStripClassString,
+		L"",
+		WS_POPUP | WS_DISABLED,
+		0,
+		0,
+		0,
+		0,
+		nullptr,
+		nullptr,
+		hinstance,
+		nullptr);
+
+	if (!window)
+		return false;
+
+	BOOL val = TRUE;
+	DwmSetWindowAttribute(window, DWMWA_EXCLUDED_FROM_PEEK, &val, sizeof(val));
+	return true;
+}
+
+bool EdgeStripWindow::Resize(int32_t newWidth, int32_t newHeight)
+{
+	// 변 하나 크기라 길어도 수십 KB
+	return bitmap.Allocate(newWidth, newHeight);
+}
+
+bool EdgeStripWindow::Present(const WindowRect& screen, bool redrawn)
+{
+	if (!window || !target)
+		return false;
+
+	// 위치, 크기, 내용을 한 번에 바꿈 (옮긴 뒤 이전 내용이 보이는 프레임이 없음)
+	const POINT position{ screen.left, screen.top };
+	if (redrawn && !bitmap.Present(window, &position, SIZE{ bitmap.Width(), bitmap.Height() }, nullptr))
+		return false;
+
+	// 대상 창 바로 아래 z 순서로. 내용이 그대로면 옮기기만 함
+	SetWindowPos(window, target, screen.left, screen.top, bitmap.Width(), bitmap.Height(), SWP_NOACTIVATE | SWP_NOREDRAW | (shown ? 0 : SWP_SHOWWINDOW));
+	shown = true;
+	return true;
+}
+
+void EdgeStripWindow::Hide()
+{
+	if (!shown)
+		return;
+
+	ShowWindow(window, SW_HIDE);
+	shown = false;
+}
+
+EdgeBorderWindow::EdgeBorderWindow(HWND targetwindow, HINSTANCE hinstance) :
+	trackingwindow(targetwindow),
+	edges([this, hinstance](BorderEdge edge, int32_t width, int32_t height) -> std::unique_ptr<EdgeSurface>
+		{
+			auto strip = EdgeStripWindow::Create(hinstance, trackingwindow, width, height);
+			strips[static_cast<size_t>(edge)] = strip.get();
+			return strip;
+		})
+{
+}
+
+std::unique_ptr<EdgeBorderWindow> EdgeBorderWindow::Create(HWND targetwindow, HINSTANCE hinstance, const BorderVisual& visual)
+{
+	auto self = Begin(targetwindow, hinstance);
+	if (self && self->Present(visual))
+		return self;
+
+	return nullptr;
+}
+
+std::unique_ptr<EdgeBorderWindow> EdgeBorderWindow::Begin(HWND targetwindow, HINSTANCE hinstance)
+{
+	if (!targetwindow)
+		return nullptr;
+
+	return std::unique_ptr<EdgeBorderWindow>(new EdgeBorderWindow(targetwindow, hinstance));
+}
+
+bool EdgeBorderWindow::Present(const BorderVisual& visual)
+{
+	if (!trackingwindow)
+		return false;
+
+	return edges.Present(visual);
+}
+
+void EdgeBorderWindow::Hide()
+{
+	edges.Hide();
+}
+
+bool EdgeBorderWindow::Park()
+{
+	Hide();
+	SetTarget(nullptr);
+	return true;
+}
+
+void EdgeBorderWindow::SetTarget(HWND target) noexcept
+{
+	// 변 창은 대상 창을 값으로 들고 있으므로 함께 바꿈
+	trackingwindow = target;
+	for (EdgeStripWindow* strip : strips)
+	{
+		if (strip)
+			strip->Retarget(target);
+	}
+}
+
+bool EdgeBorderWindow::Rebind(WindowHandle target, const BorderVisual& visual)
+{
+	SetTarget(static_cast<HWND>(target));
+	if (!IsWindow(trackingwindow))
+		return false;
+
+	// 변 창은 그대로 두고 새 대상 창 아래로 옮김. 크기가 같은 변은 다시 할당하지 않음
+	return Present(visual);
+}
@@ -0,0 +1,72 @@
+﻿#pragma once
+
+#include <Windows.h>
+#include <array>
+#include <memory>
+
+#include "EdgeStripBorder.h"
+#include "LayeredBitmap.h"
+#include "WindowSystem.h"
+
+/// <summary>
+/// EdgeSurface 의 Win32 구현. 테두리 한 변 크기의 레이어드 팝업 창과 32 bpp DIB 로, 대상 창 바로 아래에 놓고
+/// 내용이 바뀌었을 때만 UpdateLayeredWindowIndirect (픽셀 알파) 로 반영합니다. 창을 만든 스레드 (표시 스레드) 에서만 사용해야 합니다
+/// </summary>
+class EdgeStripWindow : public EdgeSurface
+{
+public:
+	/// <summary> target 은 소유한 EdgeBorderWindow 의 대상 창. 다시 붙이면 EdgeBorderWindow 가 Retarget 으로 바꿉니다 </summary>
+	static std::unique_ptr<EdgeStripWindow> Create(HINSTANCE hinstance, HWND target, int32_t width, int32_t height);
+	~EdgeStripWindow() override;
+
+	EdgeStripWindow(const EdgeStripWindow&) = delete;
+	EdgeStripWindow& operator=(const EdgeStripWindow&) = delete;
+
+	uint32_t* Pixels() noexcept override { return bitmap.Pixels(); }
+	int32_t Width() const noexcept override { return bitmap.Width(); }
+	int32_t Height() const noexcept override { return bitmap.Height(); }
+	bool Resize(int32_t newWidth, int32_t newHeight) override;
+	bool Present(const WindowRect& screen, bool redrawn) override;
+	void Hide() override;
+
+	/// <summary> 다음 Present 부터 이 창 바로 아래에 놓습니다 </summary>
+	void Retarget(HWND newTarget) noexcept { target = newTarget; }
+
+private:
+	explicit EdgeStripWindow(HWND target) : target(target) {}
+
+	HWND target = nullptr;
+	HWND window = nullptr;
+	LayeredBitmap bitmap{};
+	bool shown = false;
+
+	bool Initialize(HINSTANCE hinstance);
+};
+
+/// <summary>
+/// BorderOverlay 의 Win32 구현 (FrameBackend::EdgeStrips). 창 크기의 테두리 창 하나 대신 네 변마다 얇은 창을 두므로
+/// 메모리가 창 넓이가 아니라 둘레에 비례하고, 크기가 바뀌면 길이가 바뀐 변만 다시 할당합니다. 둥근 모서리는 그리지 않습니다
+/// </summary>
+class EdgeBorderWindow : public BorderOverlay
+{
+public:
+	static std::unique_ptr<EdgeBorderWindow> Create(HWND targetwindow, HINSTANCE hinstance, const BorderVisual& visual);
+	/// <summary> 소유 스레드: 변 창은 처음 표시할 때 (Finish / Present) 만듭니다. 작업 스레드에서 준비할 것이 없음 </summary>
+	static std::unique_ptr<EdgeBorderWindow> Begin(HWND targetwindow, HINSTANCE hinstance);
+
+	bool Present(const BorderVisual& visual) override;
+	void Hide() override;
+	bool Park() override;
+	bool Rebind(WindowHandle target, const BorderVisual& visual) override;
+	uint64_t SurfaceBytes() const noexcept override { return edges.SurfaceBytes(); }
+
+private:
+	EdgeBorderWindow(HWND targetwindow, HINSTANCE hinstance);
+
+	void SetTarget(HWND target) noexcept;
+
+	HWND trackingwindow = {};
+	EdgeStripBorder edges;
+	// edges 가 변마다 만든 창 (소유는 edges). 다시 붙일 때 대상 창을 바꿈
+	std::array<EdgeStripWindow*, 4> strips{};
+};
@@ -1,40 +1,38 @@
 #include "FrameDrawer.h"
 #include "pch.h"
 
-#include <dwmapi.h>
+#include "BorderRaster.h"
 
-namespace
+std::unique_ptr<FrameDrawer> FrameDrawer::Create(HWND window, const RECT& clientRect, FrameBackend backend)
 {
-	size_t D2DRectHash(D2D1_SIZE_U rect)
-	{
-		using repr_t = uint64_t;
-		static_assert(sizeof(D2D1_SIZE_U) == sizeof(repr_t));
-		std::hash<repr_t> hasher{};
-		return hasher(*reinterpret_cast<const repr_t*>(&rect));
-	}
-}
-
-std::unique_ptr<FrameDrawer> FrameDrawer::Create(HWND window)
-{
-	auto self = std::make_unique<FrameDrawer>(window);
-	if (self->Init())
+	auto self = std::make_unique<FrameDrawer>(window, backend);
+	if (self->Init(clientRect))
 		return self;
 
 	return nullptr;
 }
 
-FrameDrawer::FrameDrawer(HWND window) : window(window) {}
+FrameDrawer::FrameDrawer(HWND window, FrameBackend backend) : window(window), backend(backend) {}
 
-bool FrameDrawer::Init()
+bool FrameDrawer::Init(const RECT& clientRect)
 {
-	RECT clientRect;
-	if (!SUCCEEDED(DwmGetWindowAttribute(window, DWMWA_EXTENDED_FRAME_BOUNDS, &clientRect, sizeof(clientRect))))
+	// 크기는 호출하는 쪽이 이미 계산한 테두리 창 크기를 받음 (DWM 에 다시 묻지 않음)
+	const LONG width = clientRect.right - clientRect.left;
+	const LONG height = clientRect.bottom - clientRect.top;
+	if (width <= 0 || height <= 0)
+		return false;
+
+	// DIB 와 렌더 타깃 모두 그보다 큰 단계 크기로
+	if (!surfaceSize.Fit(width, height))
 		return false;
 
-	return CreateRenderTargets(clientRect);
+	if (backend == FrameBackend::Software)
+		return CreateBitmap();
+
+	return CreateRenderTargets(D2D1::SizeU(static_cast<UINT>(surfaceSize.AllocatedWidth()), static_cast<UINT>(surfaceSize.AllocatedHeight())));
 }
 
-bool FrameDrawer::CreateRenderTargets(const RECT& clientRect)
+bool FrameDrawer::CreateRenderTargets(D2D1_SIZE_U size)
 {
 	constexpr float dpi = 96.f;
 	const auto renderTargetProperties =
@@ -43,106 +41,250 @@ bool FrameDrawer::CreateRenderTargets(const RECT& clientRect)
 			dpi,
 			dpi);
 
-	const auto renderTargetSize = D2D1::SizeU(clientRect.right - clientRect.left, clientRect.bottom - clientRect.top);
-	const auto rectHash = D2DRectHash(renderTargetSize);
-	if (renderTarget && rectHash == renderTargetSizeHash)
-		return true;
-
+	// 렌더 타깃은 반영할 때 창 클라이언트 영역에 맞춰 늘어나므로 (잘리지 않음) 창과 같은 크기여야 테두리가 찌그러지지 않음.
+	// 그래서 창도 같은 단계 크기로 잡음 (WindowSize)
 	renderTarget = nullptr;
+	canvas.Reset(nullptr);
 
-	const auto hwndRenderTargetProperties = D2D1::HwndRenderTargetProperties(window, renderTargetSize, D2D1_PRESENT_OPTIONS_NONE);
+	const auto hwndRenderTargetProperties = D2D1::HwndRenderTargetProperties(window, size, D2D1_PRESENT_OPTIONS_NONE);
 
 	if (!SUCCEEDED(GetD2D1Factory()->CreateHwndRenderTarget(renderTargetProperties, hwndRenderTargetProperties, renderTarget.put())) || !renderTarget)
 		return false;
 
 	renderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
-	renderTargetSizeHash = rectHash;
+	canvas.Reset(renderTarget.get());
+
+	return true;
+}
+
+bool FrameDrawer::CreateBitmap()
+{
+	// 새 DIB 는 0 (투명) 으로 채워져 있으므로 처음부터 그림
+	if (!bitmap.Allocate(surfaceSize.AllocatedWidth(), surfaceSize.AllocatedHeight()))
+		return false;
+
+	drawn = BorderVisual{};
+	return true;
+}
+
+bool FrameDrawer::PresentBitmap(const RECT* dirty)
+{
+	// 위치는 BorderWindow 가 SetWindowPos 로 정하므로 내용만 바꿈. DIB 중 논리 크기만 반영
+	return bitmap.Present(window, nullptr, SIZE{ drawn.LocalRect().Width(), drawn.LocalRect().Height() }, dirty);
+}
+
+bool FrameDrawer::Prepare(const BorderVisual& visual)
+{
+	if (visual.bounds.IsEmpty())
+		return false;
+
+	// DIB 는 장치 독립이고 숨긴 동안에는 창에 반영하지 않으므로 여기서 그려 둠
+	if (backend == FrameBackend::Software)
+	{
+		SetSoftwareBorderRect(visual);
+		return bitmap.Pixels() != nullptr;
+	}
 
+	// ID2D1HwndRenderTarget 은 창에 묶인 장치 자원이라 만들고 그리는 일은 소유 스레드에서. 여기서는 모양만 계산
+	painter.Select(SelectBorderPolicy(visual));
+	painter.Update(visual);
 	return true;
 }
 
+SIZE FrameDrawer::WindowSize(LONG width, LONG height) noexcept
+{
+	// Software 는 UpdateLayeredWindowIndirect 가 논리 크기만큼만 반영하므로 창도 논리 크기
+	if (backend == FrameBackend::Software)
+		return SIZE{ width, height };
+
+	// 단계를 벗어날 때만 바뀌므로 끄는 동안 창과 렌더 타깃의 크기가 함께 유지됨. 논리 크기 밖은 검은색 (색 키) 이라 보이지 않고 클릭도 통과
+	surfaceSize.Fit(width, height);
+	return SIZE{ surfaceSize.AllocatedWidth(), surfaceSize.AllocatedHeight() };
+}
+
+uint64_t FrameDrawer::SurfaceBytes() const noexcept
+{
+	if (backend == FrameBackend::Software)
+		return bitmap.Bytes();
+
+	if (!renderTarget)
+		return 0;
+
+	const D2D1_SIZE_U size = renderTarget->GetPixelSize();
+	return static_cast<uint64_t>(size.width) * static_cast<uint64_t>(size.height) * sizeof(uint32_t);
+}
+
 void FrameDrawer::Show()
 {
+	if (backend == FrameBackend::Software)
+	{
+		// 숨긴 동안 그린 내용이 있으면 창 전체를 반영한 뒤 보임. 레이어드 창의 내용은 숨겨도 남아 있음
+		if (unpresented && PresentBitmap(nullptr))
+			unpresented = false;
+		ShowWindow(window, SW_SHOWNA);
+		visible = true;
+		return;
+	}
+
+	// 만들 때 BorderWindow::Finish 가 이미 그렸으면 다시 그리지 않음. 숨긴 뒤에는 창 내용이 남아 있다고 보지 않음
 	ShowWindow(window, SW_SHOWNA);
-	Render();
+	if (renderStale)
+		Render();
 }
 
 void FrameDrawer::Hide()
 {
 	ShowWindow(window, SW_HIDE);
+	renderStale = true;
+	visible = false;
 }
 
-void FrameDrawer::SetBorderRect(RECT windowRect, COLORREF color, int thickness, float radius)
+void FrameDrawer::SetSoftwareBorderRect(const BorderVisual& next)
 {
-	// FrameDrawer.h  ǵ DrawableRect ü  ü 
-	// c#  var newSceneRect = new DrawableRect() { bordercolor = ConvertColor(color), thickness = thickness };  .
-	auto newSceneRect = DrawableRect{};
-	newSceneRect.bordercolor = ConvertColor(color);
-	newSceneRect.thickness = thickness;
-
-	if ((radius == 0) == false)
-		newSceneRect.roundedRect = ConvertRECT(windowRect, thickness, radius);
+	// 크기가 단계를 벗어날 때만 DIB 를 새로 만들고 처음부터 그림. 그 밖에는 같은 DIB 안에서 바뀐 띠만 지우고 채움
+	const bool resized = !bitmap.Pixels() || next.bounds.Width() != drawn.bounds.Width() || next.bounds.Height() != drawn.bounds.Height();
+	if ((surfaceSize.Fit(next.bounds.Width(), next.bounds.Height()) || !bitmap.Pixels()) && !CreateBitmap())
+	{
+		surfaceSize.Reset();
+		return;
+	}
 
-	else
-		newSceneRect.rect = ConvertRECT(windowRect, thickness);
+	const WindowRect dirty = RedrawBorder(bitmap.Pixels(), static_cast<size_t>(bitmap.Width()), drawn, next);
+	drawn = next;
+	if (dirty.IsEmpty())
+		return;
 
-	const bool colorUpdated = std::memcmp(&sceneRect.bordercolor, &newSceneRect.bordercolor, sizeof(newSceneRect.bordercolor));
-	const bool thicknessUpdated = sceneRect.thickness != newSceneRect.thickness;
-	const bool cornersUpdated = (sceneRect.rect.has_value() != newSceneRect.rect.has_value()) || (sceneRect.roundedRect.has_value() != newSceneRect.roundedRect.has_value());
+	if (!visible)
+	{
+		unpresented = true;
+		return;
+	}
 
-	// ϳ ƮǾ true ,  ٽ ׸ ʿ䰡  Ʈ
-	const bool needsRedraw = colorUpdated || thicknessUpdated || cornersUpdated;
+	// Prepare (작업 스레드) 는 보이기 전이라 여기까지 오지 않음: 창에 메시지를 보내지 않음. 크기가 바뀌면 창 전체를 반영
+	const RECT dirtyRect{ dirty.left, dirty.top, dirty.right, dirty.bottom };
+	PresentBitmap(resized ? nullptr : &dirtyRect);
+}
 
-	RECT clientRect;
-	if (!SUCCEEDED(DwmGetWindowAttribute(window, DWMWA_EXTENDED_FRAME_BOUNDS, &clientRect, sizeof(clientRect))))
+void FrameDrawer::SetBorderRect(const BorderVisual& visual)
+{
+	if (backend == FrameBackend::Software)
+	{
+		SetSoftwareBorderRect(visual);
 		return;
+	}
 
-	sceneRect = std::move(newSceneRect);
+	// 정책 (직각 / 둥근 모서리 / 변마다 두께 / 그라데이션) 은 스타일이 바뀔 때만 다시 고름. 같은 정책이면 Select 는 아무것도 하지 않음.
+	// 비교 (BorderDirty) 와 그리기는 고른 정책의 인스턴스라 모양의 종류를 다시 확인하지 않음
+	painter.Select(SelectBorderPolicy(visual));
+	const uint8_t dirty = painter.Update(visual);
 
-	const auto renderTargetSize = D2D1::SizeU(clientRect.right - clientRect.left, clientRect.bottom - clientRect.top);
-	const auto recthash = D2DRectHash(renderTargetSize);
+	// visual.bounds 는 테두리 창 기준 좌표 (0, 0 부터) 라 그대로 논리 크기. 추적기가 틱마다 한 번 조회한 값에서 나옴
+	const LONG width = visual.bounds.Width();
+	const LONG height = visual.bounds.Height();
 
-	const bool DesiredSize = (recthash == renderTargetSizeHash) && renderTarget;
-	if (DesiredSize)
-	{
-		const bool resizeOk = renderTarget && SUCCEEDED(renderTarget->Resize(renderTargetSize));
-		if (resizeOk == false)
-		{
-			if (CreateRenderTargets(clientRect) == false)
-			{
-				//  ó
-			}
-		}
-		else
-			renderTargetSizeHash = recthash;
-	}
+	if (width <= 0 || height <= 0)
+		return;
 
-	if (colorUpdated)
+	// 렌더 타깃은 창 (WindowSize) 과 같은 단계 크기라 단계를 벗어날 때만 Resize (실패하면 새로 만듦). 테두리는 논리 크기만큼만 그림
+	surfaceSize.Fit(width, height);
+	const auto renderTargetSize = D2D1::SizeU(static_cast<UINT>(surfaceSize.AllocatedWidth()), static_cast<UINT>(surfaceSize.AllocatedHeight()));
+	bool resized = false;
+	if (!renderTarget || renderTarget->GetPixelSize().width != renderTargetSize.width || renderTarget->GetPixelSize().height != renderTargetSize.height)
 	{
-		borderBrush = nullptr;
-		if (renderTarget)
-			renderTarget->CreateSolidColorBrush(sceneRect.bordercolor, borderBrush.put());
+		const bool resizeOk = renderTarget && SUCCEEDED(renderTarget->Resize(renderTargetSize));
+		if (resizeOk == false && CreateRenderTargets(renderTargetSize) == false)
+			return;
+		resized = true;
 	}
 
-	if (!DesiredSize || needsRedraw)
+	// Resize 후에는 내용이 남지 않으므로 크기가 바뀌었으면 항상 다시 그림. 옮기기만 하면 BorderWindow 가 여기까지 오지 않음
+	if (dirty != 0 || resized || renderStale)
 		Render();
 }
 
 void FrameDrawer::Render()
 {
-	if (!renderTarget || !borderBrush)
+	if (!renderTarget)
 		return;
 
 	renderTarget->BeginDraw();
 	renderTarget->Clear(D2D1::ColorF(0.f, 0.f, 0.f, 0.f));
+	painter.Draw(canvas);
+	renderStale = FAILED(renderTarget->EndDraw());
+}
+
+void FrameDrawer::Canvas::Reset(ID2D1RenderTarget* renderTarget) noexcept
+{
+	target = renderTarget;
+	solidBrush = nullptr;
+	gradientBrush = nullptr;
+}
+
+ID2D1SolidColorBrush* FrameDrawer::Canvas::SolidBrush(uint32_t color)
+{
+	if (!solidBrush || solidColor != color)
+	{
+		solidBrush = nullptr;
+		target->CreateSolidColorBrush(ConvertColor(color), solidBrush.put());
+		solidColor = color;
+	}
+	return solidBrush.get();
+}
+
+ID2D1LinearGradientBrush* FrameDrawer::Canvas::GradientBrush(const BorderRectF& rect, uint32_t color, uint32_t endColor)
+{
+	if (!gradientBrush || gradientFrom != color || gradientTo != endColor)
+	{
+		gradientBrush = nullptr;
+		const D2D1_GRADIENT_STOP stops[2] = { { 0.f, ConvertColor(color) }, { 1.f, ConvertColor(endColor) } };
+		winrt::com_ptr<ID2D1GradientStopCollection> collection;
+		if (FAILED(target->CreateGradientStopCollection(stops, 2, collection.put())))
+			return nullptr;
+
+		target->CreateLinearGradientBrush(D2D1::LinearGradientBrushProperties(D2D1::Point2F(0.f, rect.top), D2D1::Point2F(0.f, rect.bottom)),
+			collection.get(), gradientBrush.put());
+		gradientFrom = color;
+		gradientTo = endColor;
+		return gradientBrush.get();
+	}
 
-	if (sceneRect.roundedRect)
-		renderTarget->DrawRoundedRectangle(sceneRect.roundedRect.value(), borderBrush.get(), static_cast<float>(sceneRect.thickness));
+	// 색이 같으면 브러시는 그대로 두고 위아래 끝만 새 크기에 맞춤
+	gradientBrush->SetStartPoint(D2D1::Point2F(0.f, rect.top));
+	gradientBrush->SetEndPoint(D2D1::Point2F(0.f, rect.bottom));
+	return gradientBrush.get();
+}
+
+void FrameDrawer::Canvas::StrokeRect(const BorderRectF& rect, int32_t thickness, uint32_t color, uint8_t)
+{
+	if (ID2D1SolidColorBrush* brush = SolidBrush(color))
+		target->DrawRectangle(ConvertRECT(rect), brush, static_cast<float>(thickness));
+}
 
-	else if (sceneRect.rect)
-		renderTarget->DrawRectangle(sceneRect.rect.value(), borderBrush.get(), static_cast<float>(sceneRect.thickness));
+void FrameDrawer::Canvas::StrokeRoundedRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint8_t)
+{
+	if (ID2D1SolidColorBrush* brush = SolidBrush(color))
+		target->DrawRoundedRectangle(D2D1::RoundedRect(ConvertRECT(rect), radius, radius), brush, static_cast<float>(thickness));
+}
 
-	renderTarget->EndDraw();
+void FrameDrawer::Canvas::FillRect(const WindowRect& rect, uint32_t color, uint8_t)
+{
+	if (ID2D1SolidColorBrush* brush = SolidBrush(color))
+	{
+		const auto d2d1Rect = D2D1::RectF(static_cast<float>(rect.left), static_cast<float>(rect.top), static_cast<float>(rect.right), static_cast<float>(rect.bottom));
+		target->FillRectangle(d2d1Rect, brush);
+	}
+}
+
+void FrameDrawer::Canvas::StrokeGradientRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint32_t endColor, uint8_t)
+{
+	ID2D1LinearGradientBrush* brush = GradientBrush(rect, color, endColor);
+	if (!brush)
+		return;
+
+	if (radius != 0.f)
+		target->DrawRoundedRectangle(D2D1::RoundedRect(ConvertRECT(rect), radius, radius), brush, static_cast<float>(thickness));
+	else
+		target->DrawRectangle(ConvertRECT(rect), brush, static_cast<float>(thickness));
 }
 
 ID2D1Factory* FrameDrawer::GetD2D1Factory()
@@ -172,17 +314,7 @@ D2D1_COLOR_F FrameDrawer::ConvertColor(COLORREF color)
 	return D2D1::ColorF(GetRValue(color) / 255.f, GetGValue(color) / 255.f, GetBValue(color) / 255.f, 1.f);
 }
 
-D2D1_ROUNDED_RECT FrameDrawer::ConvertRECT(RECT rect, int thickness, float radius)
+D2D1_RECT_F FrameDrawer::ConvertRECT(const BorderRectF& rect)
 {
-	float halfThickness = thickness / 2.0f;
-
-	auto d2d1Rect = D2D1::RectF(static_cast<float>(rect.left) + halfThickness + 1, static_cast<float>(rect.top) + halfThickness + 1, static_cast<float>(rect.right) - halfThickness - 1, static_cast<float>(rect.bottom) - halfThickness - 1);
-	return D2D1::RoundedRect(d2d1Rect, radius, radius);
-}
-
-D2D1_RECT_F FrameDrawer::ConvertRECT(RECT rect, int thickness)
-{
-	float halfThickness = thickness / 2.0f;
-
-	return D2D1::RectF(static_cast<float>(rect.left) + halfThickness + 1, static_cast<float>(rect.top) + halfThickness + 1, static_cast<float>(rect.right) - halfThickness - 1, static_cast<float>(rect.bottom) - halfThickness - 1);
+	return D2D1::RectF(rect.left, rect.top, rect.right, rect.bottom);
 }
\ No newline at end of file
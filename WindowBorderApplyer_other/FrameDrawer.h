@@ -4,44 +4,103 @@
 
 #include <d2d1.h>
 #include <dwrite.h>
+#include <wil/resource.h>
 #include <winrt/base.h>
 
+#include "BorderLayout.h"
+#include "BorderPolicy.h"
+#include "BorderScene.h"
+#include "LayeredBitmap.h"
+#include "SurfaceBucket.h"
+
+/// <summary> 테두리를 그리는 방법 </summary>
+enum class FrameBackend : uint8_t
+{
+	// ID2D1HwndRenderTarget 에 그리고 검은색을 색 키로 투명하게 (불투명도 무시)
+	Direct2D,
+	// 32 bpp DIB 에 BorderRaster 로 바뀐 띠만 그리고 UpdateLayeredWindowIndirect 로 반영 (픽셀마다 알파, 그라데이션 무시)
+	Software,
+	// 창 크기의 창 대신 네 변마다 얇은 창 (EdgeBorderWindow, FrameDrawer 를 쓰지 않음). 그리기는 Software 와 같음
+	EdgeStrips,
+};
+
 class FrameDrawer
 {
 public:
-	static std::unique_ptr<FrameDrawer> Create(HWND window);
+	static std::unique_ptr<FrameDrawer> Create(HWND window, const RECT& clientRect, FrameBackend backend = FrameBackend::Direct2D);
 	
-	FrameDrawer(HWND window);
+	FrameDrawer(HWND window, FrameBackend backend = FrameBackend::Direct2D);
 	FrameDrawer(FrameDrawer&& other) = default;
 
-	bool Init();
+	bool Init(const RECT& clientRect);
 
+	/// <summary>
+	/// 아무 스레드: 장치와 창에 묶이지 않은 준비만 합니다 (모양 계산, Software 는 DIB 에 그리기). 렌더 타깃은 만들지 않고
+	/// 창에 메시지를 보내지 않으며, 소유 스레드의 첫 SetBorderRect 가 렌더 타깃을 만들고 그립니다
+	/// </summary>
+	bool Prepare(const BorderVisual& visual);
 	void Show();
 	void Hide();
-	void SetBorderRect(RECT windowRect, COLORREF color, int thickness, float radius);
+	/// <summary> visual 은 테두리 창 안 좌표 (bounds 가 0, 0 부터). 바뀐 것이 있을 때만 다시 그립니다 </summary>
+	void SetBorderRect(const BorderVisual& visual);
+	/// <summary> 논리 크기 width x height 의 테두리를 담을 창 크기. Direct2D 는 렌더 타깃과 같은 단계 크기이고 Software 는 논리 크기입니다 </summary>
+	SIZE WindowSize(LONG width, LONG height) noexcept;
+	/// <summary> 렌더 타깃 (또는 DIB) 의 픽셀 메모리 </summary>
+	uint64_t SurfaceBytes() const noexcept;
 
 private:
-	struct DrawableRect
+	/// <summary> BorderPainter 가 그리는 렌더 타깃. 브러시는 색이 바뀌거나 렌더 타깃을 새로 만들었을 때만 다시 만듭니다 (불투명도는 무시) </summary>
+	class Canvas
 	{
-		std::optional<D2D1_RECT_F> rect;
-		std::optional<D2D1_ROUNDED_RECT> roundedRect;
-		D2D1_COLOR_F bordercolor;
-		int thickness;
+	public:
+		/// <summary> 렌더 타깃이 바뀜. 브러시는 렌더 타깃에 속하므로 버림 </summary>
+		void Reset(ID2D1RenderTarget* renderTarget) noexcept;
+
+		void StrokeRect(const BorderRectF& rect, int32_t thickness, uint32_t color, uint8_t alpha);
+		void StrokeRoundedRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint8_t alpha);
+		void FillRect(const WindowRect& rect, uint32_t color, uint8_t alpha);
+		void StrokeGradientRect(const BorderRectF& rect, float radius, int32_t thickness, uint32_t color, uint32_t endColor, uint8_t alpha);
+
+	private:
+		ID2D1RenderTarget* target = nullptr;
+		winrt::com_ptr<ID2D1SolidColorBrush> solidBrush;
+		uint32_t solidColor = 0;
+		winrt::com_ptr<ID2D1LinearGradientBrush> gradientBrush;
+		uint32_t gradientFrom = 0;
+		uint32_t gradientTo = 0;
+
+		ID2D1SolidColorBrush* SolidBrush(uint32_t color);
+		ID2D1LinearGradientBrush* GradientBrush(const BorderRectF& rect, uint32_t color, uint32_t endColor);
 	};
 
 	HWND window = nullptr;
-	size_t renderTargetSizeHash = {};
+	FrameBackend backend = FrameBackend::Direct2D;
+	// DIB / 렌더 타깃의 실제 크기. 논리 크기 (테두리 크기) 를 단계로 올려 잡아 끄는 동안 다시 할당하지 않음.
+	// Direct2D 렌더 타깃은 반영할 때 창 클라이언트 영역에 맞춰 늘어나므로 창도 이 크기로 잡음
+	SurfaceBucket surfaceSize{};
 	winrt::com_ptr<ID2D1HwndRenderTarget> renderTarget;
-	winrt::com_ptr<ID2D1SolidColorBrush> borderBrush;
-	DrawableRect sceneRect = {};
+	Canvas canvas{};
+	// 스타일 (직각, 둥근 모서리, 변마다 두께, 그라데이션) 에 맞게 고른 비교 / 그리기 인스턴스와 그려 둔 모양
+	BorderPainter<Canvas> painter{};
+	// Direct2D: 렌더 타깃에 painter 의 모양이 그려져 있지 않음 (아직 그리지 않았거나, 숨겼거나, EndDraw 가 실패)
+	bool renderStale = true;
+
+	// Software: surfaceSize 크기의 DIB 와 지금 그려져 있는 테두리 (DIB 좌표). 보이는 동안만 화면에 반영
+	LayeredBitmap bitmap{};
+	BorderVisual drawn{};
+	bool visible = false;
+	// 숨긴 동안 DIB 에 그려 아직 창에 반영하지 않은 내용이 있음
+	bool unpresented = false;
 
-	bool CreateRenderTargets(const RECT& clientRect);
+	bool CreateRenderTargets(D2D1_SIZE_U size);
+	bool CreateBitmap();
+	void SetSoftwareBorderRect(const BorderVisual& next);
+	bool PresentBitmap(const RECT* dirty);
 
 	static ID2D1Factory* GetD2D1Factory();
 	static IDWriteFactory* GetWriteFactory();
 	static D2D1_COLOR_F ConvertColor(COLORREF color);
-	static D2D1_ROUNDED_RECT ConvertRECT(RECT rect, int thickness, float radius);
-	static D2D1_RECT_F ConvertRECT(RECT rect, int thickness);
+	static D2D1_RECT_F ConvertRECT(const BorderRectF& rect);
 	
 	void Render();
 };
\ No newline at end of file
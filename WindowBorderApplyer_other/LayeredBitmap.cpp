@@ -0,0 +1,67 @@
+﻿#include "LayeredBitmap.h"
+
+LayeredBitmap::~LayeredBitmap()
+{
+	if (memoryDc && previousBitmap)
+		SelectObject(memoryDc.get(), previousBitmap);
+}
+
+bool LayeredBitmap::Allocate(int32_t newWidth, int32_t newHeight)
+{
+	if (newWidth <= 0 || newHeight <= 0)
+		return false;
+
+	if (!memoryDc)
+	{
+		memoryDc.reset(CreateCompatibleDC(nullptr));
+		if (!memoryDc)
+			return false;
+	}
+
+	// 위에서 아래 방향 (biHeight < 0) 32 bpp DIB. 한 행은 newWidth 픽셀이라 BorderRaster / BorderCompositor 의 배치와 같음
+	BITMAPINFO info{};
+	info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	info.bmiHeader.biWidth = newWidth;
+	info.bmiHeader.biHeight = -newHeight;
+	info.bmiHeader.biPlanes = 1;
+	info.bmiHeader.biBitCount = 32;
+	info.bmiHeader.biCompression = BI_RGB;
+
+	void* bits = nullptr;
+	wil::unique_hbitmap created(CreateDIBSection(memoryDc.get(), &info, DIB_RGB_COLORS, &bits, nullptr, 0));
+	if (!created || !bits)
+		return false;
+
+	// 처음 선택할 때 밀려난 기본 비트맵만 기억했다가 소멸할 때 되돌림
+	const HGDIOBJ replaced = SelectObject(memoryDc.get(), created.get());
+	if (!previousBitmap)
+		previousBitmap = replaced;
+	bitmap = std::move(created);
+	pixels = static_cast<uint32_t*>(bits);
+	width = newWidth;
+	height = newHeight;
+	return true;
+}
+
+bool LayeredBitmap::Present(HWND window, const POINT* position, SIZE size, const RECT* dirty) const
+{
+	if (!window || !pixels)
+		return false;
+
+	// DIB 에 직접 쓴 내용을 GDI 가 읽기 전에 반영
+	GdiFlush();
+
+	POINT source{ 0, 0 };
+	BLENDFUNCTION blend{ AC_SRC_OVER, 0, 255, AC_SRC_ALPHA };
+
+	UPDATELAYEREDWINDOWINFO update{};
+	update.cbSize = sizeof(update);
+	update.pptDst = position;
+	update.psize = &size;
+	update.hdcSrc = memoryDc.get();
+	update.pptSrc = &source;
+	update.pblend = &blend;
+	update.dwFlags = ULW_ALPHA;
+	update.prcDirty = dirty;
+	return UpdateLayeredWindowIndirect(window, &update) != FALSE;
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <Windows.h>
+#include <cstdint>
+#include <wil/resource.h>
+
+/// <summary>
+/// 레이어드 창에 UpdateLayeredWindowIndirect (픽셀 알파) 로 반영하는 위에서 아래 방향 32 bpp DIB 와 그 메모리 DC.
+/// 소프트웨어 테두리 창 (FrameDrawer), 변 창 (EdgeStripWindow), 공유 오버레이 (MonitorOverlayWindow) 가 함께 씁니다.
+/// 창을 만든 스레드에서 반영해야 하지만, 만들기와 픽셀 쓰기는 아무 스레드에서나 할 수 있습니다
+/// </summary>
+class LayeredBitmap
+{
+public:
+	LayeredBitmap() = default;
+	LayeredBitmap(LayeredBitmap&& other) = default;
+	~LayeredBitmap();
+
+	LayeredBitmap(const LayeredBitmap&) = delete;
+	LayeredBitmap& operator=(const LayeredBitmap&) = delete;
+
+	/// <summary> width x height 의 DIB 를 새로 만들어 바꿉니다. 새 DIB 는 0 (투명) 으로 채워져 있고, 실패하면 이전 DIB 를 그대로 둡니다 </summary>
+	bool Allocate(int32_t width, int32_t height);
+
+	/// <summary>
+	/// DIB 의 왼쪽 위 size 만큼을 window 에 반영합니다. position 이 nullptr 이면 창을 옮기지 않고 (SetWindowPos 로 따로 정함),
+	/// dirty 가 nullptr 이면 창 전체를 다시 그립니다
+	/// </summary>
+	bool Present(HWND window, const POINT* position, SIZE size, const RECT* dirty) const;
+
+	uint32_t* Pixels() const noexcept { return pixels; }
+	int32_t Width() const noexcept { return width; }
+	int32_t Height() const noexcept { return height; }
+	uint64_t Bytes() const noexcept
+	{
+		return pixels ? static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * sizeof(uint32_t) : 0;
+	}
+
+private:
+	wil::unique_hdc memoryDc;
+	wil::unique_hbitmap bitmap;
+	HGDIOBJ previousBitmap = nullptr;
+	uint32_t* pixels = nullptr;
+	int32_t width = 0;
+	int32_t height = 0;
+};
@@ -0,0 +1,99 @@
+﻿#include "MonitorOverlayWindow.h"
+
+#include <dwmapi.h>
+
+namespace
+{
+	const wchar_t MonitorOverlayClassString[] = L"CustomWIndow_MonitorOverlay";
+
+	BOOL CALLBACK CollectMonitor(HMONITOR monitor, HDC, LPRECT rect, LPARAM data)
+	{
+		auto& monitors = *reinterpret_cast<std::vector<MonitorArea>*>(data);
+		monitors.push_back(MonitorArea{ monitor, WindowRect{ rect->left, rect->top, rect->right, rect->bottom } });
+		return TRUE;
+	}
+}
+
+std::unique_ptr<MonitorOverlayWindow> MonitorOverlayWindow::Create(HINSTANCE hinstance, const MonitorArea& monitor)
+{
+	auto self = std::unique_ptr<MonitorOverlayWindow>(new MonitorOverlayWindow(monitor.area));
+	if (self->Initialize(hinstance))
+		return self;
+
+	return nullptr;
+}
+
+MonitorOverlayWindow::~MonitorOverlayWindow()
+{
+	if (window)
+		DestroyWindow(window);
+}
+
+std::vector<MonitorArea> MonitorOverlayWindow::EnumerateMonitors()
+{
+	std::vector<MonitorArea> monitors{};
+	EnumDisplayMonitors(nullptr, nullptr, CollectMonitor, reinterpret_cast<LPARAM>(&monitors));
+	return monitors;
+}
+
+bool MonitorOverlayWindow::Initialize(HINSTANCE hinstance)
+{
+	if (area.IsEmpty())
+		return false;
+
+	// 창 클래스는 한 번만 등록 (표시 스레드에서만 호출)
+	static bool classRegistered = false;
+	if (!classRegistered)
+	{
+		WNDCLASSEXW wce{};
+		wce.cbSize = sizeof(WNDCLASSEX);
+		wce.lpfnWndProc = DefWindowProcW;
+		wce.hInstance = hinstance;
+		wce.lpszClassName = MonitorOverlayClassString;
+
+		classRegistered = RegisterClassExW(&wce) != 0 || GetLastError() == ERROR_CLASS_ALREADY_EXISTS;
+	}
+
+	// 모든 창 위에 있지만 입력은 아래 창으로 통과 (WS_EX_TRANSPARENT), 작업 표시줄과 Alt+Tab 에는 나오지 않음
+	window = CreateWindowExW(WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW | WS_EX_NOACTIVATE | WS_EX_TOPMOST,
+		MonitorOverlayClassString,
+		L"",
+		WS_POPUP | WS_DISABLED,
+		area.left,
+		area.top,
+		area.Width(),
+		area.Height(),
+		nullptr,
+		nullptr,
+		hinstance,
+		nullptr);
+
+	if (!window)
+		return false;
+
+	BOOL val = TRUE;
+	DwmSetWindowAttribute(window, DWMWA_EXCLUDED_FROM_PEEK, &val, sizeof(val));
+
+	// 한 행은 Width() 픽셀이라 BorderCompositor 의 배치와 같음
+	return bitmap.Allocate(area.Width(), area.Height());
+}
+
+bool MonitorOverlayWindow::Present(const WindowRect& dirty)
+{
+	if (!window)
+		return false;
+
+	const POINT position{ area.left, area.top };
+	const RECT dirtyRect{ dirty.left, dirty.top, dirty.right, dirty.bottom };
+
+	// 처음에는 창 전체, 이후로는 바뀐 영역만 화면에 반영
+	if (!bitmap.Present(window, &position, SIZE{ area.Width(), area.Height() }, shown ? &dirtyRect : nullptr))
+		return false;
+
+	if (!shown)
+	{
+		ShowWindow(window, SW_SHOWNOACTIVATE);
+		shown = true;
+	}
+	return true;
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <Windows.h>
+#include <memory>
+#include <vector>
+
+#include "BorderCompositor.h"
+#include "LayeredBitmap.h"
+
+/// <summary>
+/// 공유 오버레이의 Win32 표면. 모니터 하나를 덮는 클릭이 통과하는 최상위 레이어드 창과 32 bpp DIB 로,
+/// BorderCompositor 가 DIB 에 직접 그리고 Present 에서 바뀐 영역만 UpdateLayeredWindowIndirect 로 반영합니다.
+/// 창을 만든 스레드 (표시 스레드) 에서만 사용해야 합니다.
+/// </summary>
+class MonitorOverlayWindow : public MonitorSurface
+{
+public:
+	static std::unique_ptr<MonitorOverlayWindow> Create(HINSTANCE hinstance, const MonitorArea& monitor);
+	~MonitorOverlayWindow() override;
+
+	MonitorOverlayWindow(const MonitorOverlayWindow&) = delete;
+	MonitorOverlayWindow& operator=(const MonitorOverlayWindow&) = delete;
+
+	/// <summary> 현재 모니터 구성 (EnumDisplayMonitors) </summary>
+	static std::vector<MonitorArea> EnumerateMonitors();
+
+	uint32_t* Pixels() noexcept override { return bitmap.Pixels(); }
+	int32_t Width() const noexcept override { return area.Width(); }
+	int32_t Height() const noexcept override { return area.Height(); }
+	bool Present(const WindowRect& dirty) override;
+
+private:
+	explicit MonitorOverlayWindow(const WindowRect& area) : area(area) {}
+
+	WindowRect area;
+	HWND window = nullptr;
+	LayeredBitmap bitmap{};
+	bool shown = false;
+
+	bool Initialize(HINSTANCE hinstance);
+};
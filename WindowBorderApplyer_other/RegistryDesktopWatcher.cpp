@@ -0,0 +1,71 @@
+﻿#include "RegistryDesktopWatcher.h"
+#include "VirtualDesktopUtil.h"
+
+#include <cstring>
+
+namespace
+{
+	DesktopId ToDesktopId(const GUID& guid)
+	{
+		static_assert(sizeof(GUID) == sizeof(uint64_t) * 2);
+
+		uint64_t bits[2];
+		std::memcpy(bits, &guid, sizeof(bits));
+		return DesktopId{ bits[0], bits[1] };
+	}
+}
+
+RegistryDesktopWatcher::~RegistryDesktopWatcher()
+{
+	Stop();
+}
+
+bool RegistryDesktopWatcher::Start(SwitchCallback callback)
+{
+	if (thread.joinable() || !GetVirtualDesktopRegKey())
+		return false;
+
+	changeEvent.create(wil::EventOptions::None);
+	stopEvent.create(wil::EventOptions::ManualReset);
+
+	// 데스크톱을 한 번도 전환하지 않아 값이 없으면 빈 ID 로 시작하고 첫 전환 때 채움
+	const auto current = GetCurrentDesktopIdFromRegistry();
+	PublishInitial(current ? ToDesktopId(*current) : DesktopId{});
+
+	onSwitch = std::move(callback);
+	thread = std::thread(&RegistryDesktopWatcher::Run, this);
+	return true;
+}
+
+void RegistryDesktopWatcher::Stop()
+{
+	if (!thread.joinable())
+		return;
+
+	stopEvent.SetEvent();
+	thread.join();
+	onSwitch = nullptr;
+}
+
+void RegistryDesktopWatcher::Run()
+{
+	const HANDLE handles[] = { stopEvent.get(), changeEvent.get() };
+	for (;;)
+	{
+		// 알림은 한 번 오면 해제되므로 매번 다시 등록. 등록한 뒤에 읽어야 그 사이의 전환을 놓치지 않음
+		if (RegNotifyChangeKeyValue(GetVirtualDesktopRegKey(), FALSE, REG_NOTIFY_CHANGE_LAST_SET, changeEvent.get(), TRUE) != ERROR_SUCCESS)
+			return;
+
+		ReadAndPublish();
+
+		if (WaitForMultipleObjects(ARRAYSIZE(handles), handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+			return;
+	}
+}
+
+void RegistryDesktopWatcher::ReadAndPublish()
+{
+	// 같은 키의 다른 값 (데스크톱 목록, 이름) 이 바뀐 경우는 Publish 가 무시함
+	if (const auto current = GetCurrentDesktopIdFromRegistry())
+		Publish(ToDesktopId(*current));
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include <Windows.h>
+#include <thread>
+#include <wil/resource.h>
+
+#include "DesktopWatcher.h"
+
+/// <summary>
+/// 현재 가상 데스크톱 전환을 레지스트리 변경 알림 (RegNotifyChangeKeyValue) 으로 감지하는 DesktopWatcher.
+/// 감시 스레드는 알림이 올 때만 깨어나 CurrentVirtualDesktop 값을 읽어 게시합니다.
+/// </summary>
+class RegistryDesktopWatcher : public DesktopWatcher
+{
+public:
+	RegistryDesktopWatcher() = default;
+	~RegistryDesktopWatcher() override;
+
+	RegistryDesktopWatcher(const RegistryDesktopWatcher&) = delete;
+	RegistryDesktopWatcher& operator=(const RegistryDesktopWatcher&) = delete;
+
+	bool Start(SwitchCallback callback) override;
+	void Stop() override;
+
+private:
+	wil::unique_event changeEvent;
+	wil::unique_event stopEvent;
+	std::thread thread;
+
+	void Run();
+	void ReadAndPublish();
+};
@@ -2,21 +2,30 @@
 #include <ShellScalingApi.h>
 
 float ScalingUtil::ScalingF(HWND window) noexcept
+{
+	return GetDpi(window) / 96.0f;
+}
+
+UINT ScalingUtil::GetDpi(HWND window) noexcept
+{
+	return GetMonitorDpi(MonitorFromWindow(window, MONITOR_DEFAULTTONEAREST));
+}
+
+UINT ScalingUtil::GetMonitorDpi(HMONITOR monitor) noexcept
 {
 	UINT dpi = 96;
-	auto targetdisplay = MonitorFromWindow(window, MONITOR_DEFAULTTONEAREST);
 
-	if (targetdisplay != nullptr)
+	if (monitor != nullptr)
 	{
 		UINT dummy = 0;
-		auto res = GetDpiForMonitor(targetdisplay, MDT_EFFECTIVE_DPI, &dpi, &dummy);
+		auto res = GetDpiForMonitor(monitor, MDT_EFFECTIVE_DPI, &dpi, &dummy);
 
 		if (res != S_OK)
-			return 1.0f;
+			return 96;
 
-		return dpi / 96.0f;
+		return dpi;
 	}
 
 	else
-		return 1.0f;
+		return 96;
 }
\ No newline at end of file
@@ -4,4 +4,6 @@
 namespace ScalingUtil
 {
 	float ScalingF(HWND window) noexcept;
+	UINT GetDpi(HWND window) noexcept;
+	UINT GetMonitorDpi(HMONITOR monitor) noexcept;
 };
\ No newline at end of file
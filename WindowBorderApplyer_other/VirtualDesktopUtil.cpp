@@ -1,13 +1,41 @@
 #include "VirtualDesktopUtil.h"
 #include <wil/registry.h>
 #include <iostream>
+#include <cwchar>
 
-const wchar_t RegKeyVirtualDesktop[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktop";
+// Windows 11: CurrentVirtualDesktop 값이 이 키에 있음 (데스크톱을 한 번도 전환하지 않았으면 값이 없음)
+const wchar_t RegKeyVirtualDesktop[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\VirtualDesktops";
+// Windows 10: 세션별 키에 있음 (%u 는 세션 번호)
+const wchar_t RegKeySessionVirtualDesktop[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Explorer\\SessionInfo\\%u\\VirtualDesktops";
+const wchar_t RegValueCurrentVirtualDesktop[] = L"CurrentVirtualDesktop";
+
+bool HasCurrentVirtualDesktop(HKEY hkey)
+{
+    return RegQueryValueEx(hkey, RegValueCurrentVirtualDesktop, nullptr, nullptr, nullptr, nullptr) == ERROR_SUCCESS;
+}
 
 HKEY OpenVirtualDesktopsRegKey()
 {
+    // 값을 읽고 변경 알림을 받을 권한만 요청
     HKEY hkey{ nullptr };
-    if (RegOpenKeyEx(HKEY_CURRENT_USER, RegKeyVirtualDesktop, 0, KEY_ALL_ACCESS, &hkey))
+
+    // Windows 10 은 세션 키에 현재 데스크톱을 기록하므로 먼저 확인
+    DWORD sessionId = 0;
+    if (ProcessIdToSessionId(GetCurrentProcessId(), &sessionId))
+    {
+        wchar_t sessionKey[MAX_PATH];
+        swprintf_s(sessionKey, RegKeySessionVirtualDesktop, sessionId);
+        if (RegOpenKeyEx(HKEY_CURRENT_USER, sessionKey, 0, KEY_READ | KEY_NOTIFY, &hkey) == ERROR_SUCCESS)
+        {
+            if (HasCurrentVirtualDesktop(hkey))
+                return hkey;
+            RegCloseKey(hkey);
+            hkey = nullptr;
+        }
+    }
+
+    // 값이 아직 없어도 (전환한 적이 없음) 키는 감시할 수 있음
+    if (RegOpenKeyEx(HKEY_CURRENT_USER, RegKeyVirtualDesktop, 0, KEY_READ | KEY_NOTIFY, &hkey) == ERROR_SUCCESS)
         return hkey;
 
     return nullptr;
@@ -19,6 +47,22 @@ HKEY GetVirtualDesktopRegKey()
     return virtualDesktopREGKey.get();
 }
 
+std::optional<GUID> GetCurrentDesktopIdFromRegistry()
+{
+    HKEY key = GetVirtualDesktopRegKey();
+    if (!key)
+        return std::nullopt;
+
+    GUID id{};
+    DWORD size = sizeof(id);
+    DWORD type = 0;
+    if (RegQueryValueEx(key, RegValueCurrentVirtualDesktop, nullptr, &type, reinterpret_cast<BYTE*>(&id), &size) != ERROR_SUCCESS
+        || type != REG_BINARY || size != sizeof(id))
+        return std::nullopt;
+
+    return id;
+}
+
 VirtualDesktopUtil::VirtualDesktopUtil()
 {
     HRESULT hr = CoInitialize(NULL);
@@ -43,22 +87,22 @@ VirtualDesktopUtil::~VirtualDesktopUtil()
 
 bool VirtualDesktopUtil::IsWindowsOnCurrentDesktop(HWND window) const
 {
-    std::optional<GUID> id = GetDesktopId(window);
-    return id.has_value();
+    // COM 은 생성자에서 한 번만 초기화함. 결과는 BorderTracker 의 DesktopMembershipCache 가 캐시하므로 호출은 한 번만
+    if (!vdManager)
+        return false;
+
+    BOOL isOnCurrentDesktop = FALSE;
+    return vdManager->IsWindowOnCurrentVirtualDesktop(window, &isOnCurrentDesktop) == S_OK && isOnCurrentDesktop;
 }
 
 std::optional<GUID> VirtualDesktopUtil::GetDesktopId(HWND window) const
 {
+    if (!vdManager)
+        return std::nullopt;
+
     GUID id;
-    BOOL IsWindowOnCurrentDesktop = FALSE;
-    HRESULT hr = CoInitialize(NULL);
-    auto res = vdManager->IsWindowOnCurrentVirtualDesktop(window, &IsWindowOnCurrentDesktop);
-    if (vdManager && res == S_OK && IsWindowOnCurrentDesktop)
-    {
-        if (vdManager->GetWindowDesktopId(window, &id) == S_OK && id != GUID_NULL)
-            return id;
-    }
+    if (vdManager->GetWindowDesktopId(window, &id) == S_OK && id != GUID_NULL)
+        return id;
 
     return std::nullopt;
-}
-
+}
\ No newline at end of file
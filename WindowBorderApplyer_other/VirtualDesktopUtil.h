@@ -3,6 +3,11 @@
 #include <ShObjIdl.h>
 #include <optional>
 
+/// <summary> 현재 가상 데스크톱 정보가 있는 레지스트리 키 (KEY_READ | KEY_NOTIFY). 프로세스가 끝날 때까지 열려 있음. 없으면 nullptr </summary>
+HKEY GetVirtualDesktopRegKey();
+/// <summary> 레지스트리의 CurrentVirtualDesktop 값. 아직 데스크톱을 전환한 적이 없으면 값이 없을 수 있음 </summary>
+std::optional<GUID> GetCurrentDesktopIdFromRegistry();
+
 class VirtualDesktopUtil
 {
 public:
@@ -0,0 +1,135 @@
+﻿#include "Win32WindowSystem.h"
+#include "BorderWindow.h"
+#include "EdgeBorderWindow.h"
+#include "ScalingUtil.h"
+
+#include <dwmapi.h>
+
+namespace
+{
+	// 제목이 있고 보이는 창만 테두리 대상. 제목은 InternalGetWindowText 로 창 구조체에서 바로 읽음: GetWindowTextLength 는
+	// 다른 프로세스에 WM_GETTEXTLENGTH 를 보내므로, 응답하지 않는 앱 하나가 레이아웃 스레드 (표시 이벤트마다 호출) 를 멈출 수 있음
+	bool IsVisibleTitledWindow(HWND hwnd)
+	{
+		if (!IsWindowVisible(hwnd))
+			return false;
+
+		// 비어 있는지만 보므로 한 글자와 끝 문자만 읽음
+		wchar_t title[2]{};
+		return InternalGetWindowText(hwnd, title, ARRAYSIZE(title)) > 0;
+	}
+}
+
+Win32WindowSystem::Win32WindowSystem(HINSTANCE hinstance, FrameBackend backend) : hinstance(hinstance), backend(backend) {}
+
+void Win32WindowSystem::InitializeDesktopQueries()
+{
+	if (!virtualDesktopUtil)
+		virtualDesktopUtil = std::make_unique<VirtualDesktopUtil>();
+}
+
+void Win32WindowSystem::ReleaseDesktopQueries()
+{
+	virtualDesktopUtil.reset();
+}
+
+void Win32WindowSystem::EnumerateWindows(std::vector<WindowHandle>& windows)
+{
+	windows.clear();
+
+	// EnumWindows 는 위에서 아래 z 순서로 최상위 창을 나열
+	EnumWindows([](HWND hwnd, LPARAM lParam) -> BOOL
+		{
+			if (IsVisibleTitledWindow(hwnd))
+			{
+				auto& handles = *reinterpret_cast<std::vector<WindowHandle>*>(lParam);
+				handles.push_back(hwnd);
+			}
+			return TRUE;
+		}, reinterpret_cast<LPARAM>(&windows));
+}
+
+bool Win32WindowSystem::IsBorderCandidate(WindowHandle window)
+{
+	// EVENT_OBJECT_SHOW 는 자식 창에서도 오므로 최상위 창인지 먼저 확인 (EnumWindows 와 같은 범위)
+	const HWND hwnd = static_cast<HWND>(window);
+	return GetAncestor(hwnd, GA_ROOT) == hwnd && IsVisibleTitledWindow(hwnd);
+}
+
+bool Win32WindowSystem::GetFrameBounds(WindowHandle window, WindowRect& frame)
+{
+	RECT rect;
+	if (!SUCCEEDED(DwmGetWindowAttribute(static_cast<HWND>(window), DWMWA_EXTENDED_FRAME_BOUNDS, &rect, sizeof(rect))))
+		return false;
+
+	frame = WindowRect{ rect.left, rect.top, rect.right, rect.bottom };
+	return true;
+}
+
+MonitorHandle Win32WindowSystem::GetMonitor(WindowHandle, const WindowRect& frame)
+{
+	// 이미 조회한 프레임 사각형으로 찾으므로 MonitorFromWindow 와 같은 결과
+	const RECT rect{ frame.left, frame.top, frame.right, frame.bottom };
+	return MonitorFromRect(&rect, MONITOR_DEFAULTTONEAREST);
+}
+
+uint32_t Win32WindowSystem::GetMonitorDpi(MonitorHandle monitor)
+{
+	return ScalingUtil::GetMonitorDpi(static_cast<HMONITOR>(monitor));
+}
+
+bool Win32WindowSystem::IsOnCurrentDesktop(WindowHandle window)
+{
+	return virtualDesktopUtil && virtualDesktopUtil->IsWindowsOnCurrentDesktop(static_cast<HWND>(window));
+}
+
+WindowLiveness Win32WindowSystem::QueryLiveness(WindowHandle window)
+{
+	const HWND hwnd = static_cast<HWND>(window);
+	WindowLiveness liveness{ 0 };
+	if (IsWindowVisible(hwnd))
+		liveness.flags |= WindowLiveness::Visible;
+
+	if (IsIconic(hwnd))
+		liveness.flags |= WindowLiveness::Minimized;
+
+	DWORD cloaked = 0;
+	if (SUCCEEDED(DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) && cloaked)
+		liveness.flags |= WindowLiveness::Cloaked;
+
+	return liveness;
+}
+
+std::unique_ptr<BorderOverlay> Win32WindowSystem::CreateOverlay(WindowHandle target, const BorderStyle&, const BorderVisual& visual)
+{
+	if (backend == FrameBackend::EdgeStrips)
+		return EdgeBorderWindow::Create(static_cast<HWND>(target), hinstance, visual);
+
+	return BorderWindow::Create(static_cast<HWND>(target), hinstance, visual, backend);
+}
+
+std::unique_ptr<BorderOverlay> Win32WindowSystem::BeginOverlay(WindowHandle target, const BorderStyle&, const BorderVisual& visual)
+{
+	if (backend == FrameBackend::EdgeStrips)
+		return EdgeBorderWindow::Begin(static_cast<HWND>(target), hinstance);
+
+	return BorderWindow::Begin(static_cast<HWND>(target), hinstance, visual, backend);
+}
+
+bool Win32WindowSystem::PrepareOverlay(BorderOverlay& overlay, const BorderVisual& visual)
+{
+	// 변 창은 표시 스레드에서 만들고 한 색으로 채우기만 하므로 작업 스레드에서 준비할 것이 없음
+	if (backend == FrameBackend::EdgeStrips)
+		return true;
+
+	// 그 밖에 이 창 시스템이 만든 오버레이는 모두 BorderWindow
+	return static_cast<BorderWindow&>(overlay).Prepare(visual);
+}
+
+bool Win32WindowSystem::FinishOverlay(BorderOverlay& overlay, const BorderVisual& visual)
+{
+	if (backend == FrameBackend::EdgeStrips)
+		return overlay.Present(visual);
+
+	return static_cast<BorderWindow&>(overlay).Finish(visual);
+}
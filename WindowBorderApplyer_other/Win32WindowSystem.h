@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include <Windows.h>
+#include <memory>
+
+#include "FrameDrawer.h"
+#include "WindowSystem.h"
+#include "VirtualDesktopUtil.h"
+
+/// <summary> WindowSystem 의 Win32 / DWM / COM 구현. 오버레이는 BorderWindow (FrameBackend::EdgeStrips 면 EdgeBorderWindow) 입니다 </summary>
+class Win32WindowSystem : public WindowSystem
+{
+public:
+	/// <summary> backend 는 새로 만드는 오버레이의 그리기 방법 </summary>
+	explicit Win32WindowSystem(HINSTANCE hinstance, FrameBackend backend = FrameBackend::Direct2D);
+
+	/// <summary>
+	/// 조회를 부르는 스레드 (BorderPipeline 의 레이아웃 스레드) 에서 호출. IVirtualDesktopManager 는 만든 스레드의
+	/// COM 아파트에서만 쓸 수 있으므로 그 스레드에서 만들고 해제합니다. 초기화 전에는 현재 데스크톱에 없다고 답합니다
+	/// </summary>
+	void InitializeDesktopQueries();
+	void ReleaseDesktopQueries();
+
+	void EnumerateWindows(std::vector<WindowHandle>& windows) override;
+	bool IsBorderCandidate(WindowHandle window) override;
+	bool GetFrameBounds(WindowHandle window, WindowRect& frame) override;
+	MonitorHandle GetMonitor(WindowHandle window, const WindowRect& frame) override;
+	uint32_t GetMonitorDpi(MonitorHandle monitor) override;
+	bool IsOnCurrentDesktop(WindowHandle window) override;
+	WindowLiveness QueryLiveness(WindowHandle window) override;
+	std::unique_ptr<BorderOverlay> CreateOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) override;
+	std::unique_ptr<BorderOverlay> BeginOverlay(WindowHandle target, const BorderStyle& style, const BorderVisual& visual) override;
+	bool PrepareOverlay(BorderOverlay& overlay, const BorderVisual& visual) override;
+	bool FinishOverlay(BorderOverlay& overlay, const BorderVisual& visual) override;
+
+private:
+	HINSTANCE hinstance;
+	FrameBackend backend;
+	std::unique_ptr<VirtualDesktopUtil> virtualDesktopUtil;
+};
@@ -3,12 +3,8 @@
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 
-struct WinEventHook
-{
-	DWORD event;
-	HWND hwnd;
-	LONG idObject;
-	LONG idChild;
-	DWORD idEventThread;
-	DWORD dwmsEventTime;
-};
\ No newline at end of file
+#include "WinEvents.h"
+#include "WindowSystemTypes.h"
+
+// 코어의 BorderTracker 로 그대로 넘기도록 HWND 대신 WindowHandle 을 사용 (같은 값)
+using WinEventHook = BasicWinEventHook<WindowHandle>;
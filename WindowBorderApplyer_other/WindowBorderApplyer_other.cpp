@@ -1,9 +1,13 @@
 ﻿#include <windows.h>
+#include <algorithm>
 #include <vector>
 #include <unordered_set>
 #include <mutex>
 #include <iostream>
+#include <string>
+#include <chrono>
 #include "Windowmodule.h" // Change from FrameDrawer.h to Windowmodule.h
+#include "BorderRaster.h"
 
 std::unordered_set<HWND> processedWindows;
 std::mutex mtx;
@@ -26,12 +30,13 @@ BOOL IsRunAsAdmin() {
     return fIsRunAsAdmin;
 }
 
-void RestartAsAdmin() {
+void RestartAsAdmin(const std::wstring& parameters) {
     wchar_t szPath[MAX_PATH];
     if (GetModuleFileName(NULL, szPath, ARRAYSIZE(szPath))) {
         SHELLEXECUTEINFO sei = { sizeof(sei) };
         sei.lpVerb = L"runas";
         sei.lpFile = szPath;
+        sei.lpParameters = parameters.empty() ? nullptr : parameters.c_str();
         sei.hwnd = NULL;
         sei.nShow = SW_NORMAL;
 
@@ -85,65 +90,219 @@ static std::vector<HWND> collectWindowHandles() {
     return windowHandles;
 }
 
-static void printWindowHandles(Windowmodule& windowModule, std::unordered_set<HWND>& modifiedWindows) {
-    // 창 핸들러 수집
-    auto windowHandles = collectWindowHandles();
+// Ctrl+C / Ctrl+Break 를 받으면 main 의 대기를 끝내 Windowmodule 이 모듈 스레드에서 정리하도록 함
+static HANDLE exitEvent = nullptr;
 
+static BOOL WINAPI ConsoleCtrlHandler(DWORD ctrlType) {
+    if (ctrlType == CTRL_C_EVENT || ctrlType == CTRL_BREAK_EVENT) {
+        SetEvent(exitEvent);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static void printStats(Windowmodule& windowModule, MessageLoopStats& lastLoopStats, std::chrono::steady_clock::time_point& lastPrint) {
     // 콘솔 커서를 맨 위로 이동
     COORD coord = { 0, 0 };
     SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), coord);
 
-    std::wcout << L"Collected " << windowHandles.size() << L" window handles:" << std::endl;
-    for (const auto& hwnd : windowHandles) {
-        std::wcout << hwnd << std::endl;
+    // 메시지 루프는 일이 있을 때만 깨어나므로, 창을 움직이지 않으면 초당 깨어남이 0 에 가까워야 함
+    const auto now = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(now - lastPrint).count();
+    const auto loopStats = windowModule.GetLoopStats();
+    std::wcout << L"Loop: " << (loopStats.wakeups - lastLoopStats.wakeups) / seconds << L" wakeups/s, "
+        << (loopStats.messages - lastLoopStats.messages) / seconds << L" messages/s, "
+        << loopStats.commands - lastLoopStats.commands << L" commands" << std::endl;
+    lastLoopStats = loopStats;
+    lastPrint = now;
 
-        // 이미 색깔을 변경한 창 핸들러는 건너뜀
-        if (modifiedWindows.find(hwnd) != modifiedWindows.end()) {
-            continue;
-        }
+    // 이벤트 병합 통계: 병합된 위치 변경 하나마다 DWM 조회와 SetWindowPos 를 한 번씩 절약
+    const auto stats = windowModule.GetEventStats();
+    std::wcout << L"Events: " << stats.received << L" received, " << stats.collapsed << L" collapsed ("
+        << stats.collapsedGeometry << L" border updates saved), " << stats.stale << L" stale, frame interval "
+        << stats.AverageFrameIntervalUs() / 1000.0 << L" ms, latency " << stats.AverageLatencyUs() / 1000.0
+        << L" ms (max " << stats.maxLatencyUs / 1000.0 << L" ms)" << std::endl;
 
-        // Windowmodule을 사용하여 창의 모서리를 추가합니다.
-        windowModule.AddHwnd(hwnd);
+    const auto filterStats = windowModule.GetFilterStats();
+    std::wcout << L"Prefilter: " << filterStats.TotalAccepted() << L" accepted, " << filterStats.TotalRejected() << L" rejected (location "
+        << filterStats.Accepted(EVENT_OBJECT_LOCATIONCHANGE) << L"/" << filterStats.Rejected(EVENT_OBJECT_LOCATIONCHANGE) << L", show/hide "
+        << filterStats.Accepted(EVENT_OBJECT_SHOW) + filterStats.Accepted(EVENT_OBJECT_HIDE) << L"/"
+        << filterStats.Rejected(EVENT_OBJECT_SHOW) + filterStats.Rejected(EVENT_OBJECT_HIDE) << L")" << std::endl;
+
+    // 캐시 적중 하나마다 IVirtualDesktopManager COM 호출 하나를 절약
+    const auto desktopStats = windowModule.GetDesktopStats();
+    std::wcout << L"Desktop cache: " << desktopStats.hits << L" hits, " << desktopStats.queries << L" queries, "
+        << desktopStats.invalidations << L" invalidations, " << desktopStats.generationBumps << L" switches" << std::endl;
+
+    // 포그라운드 전환마다 모든 테두리를 훑지 않고 이전 / 새 활성 창만 다시 그림 (restyled 는 전환의 최대 두 배)
+    const auto foregroundStats = windowModule.GetForegroundStats();
+    std::wcout << L"Foreground: " << foregroundStats.switches << L" switches, " << foregroundStats.restyled << L" restyled, "
+        << foregroundStats.refreshes << L" desktop refreshes" << std::endl;
+
+    // 단계별 대기: 레이아웃 큐는 병합 프레임 (16 ms) 만큼, 표시 큐는 거의 0 이어야 함. 버림이 생기면 전체를 다시 맞춤
+    const auto pipelineStats = windowModule.GetPipelineStats();
+    std::wcout << L"Pipeline: " << pipelineStats.ingested << L" ingested, " << pipelineStats.layout.rejected << L" dropped, "
+        << pipelineStats.resyncs << L" resyncs, layout queue " << pipelineStats.layout.queueDepth << L" (max " << pipelineStats.layout.maxQueueDepth
+        << L", " << pipelineStats.layout.AverageLatencyUs() / 1000.0 << L" ms), present queue " << pipelineStats.present.queueDepth
+        << L" (max " << pipelineStats.present.maxQueueDepth << L", " << pipelineStats.present.AverageLatencyUs() / 1000.0 << L" ms)" << std::endl;
+
+    // 한꺼번에 만든 테두리: 묶음 하나가 걸린 시간이 곧 마지막 테두리가 나타날 때까지의 시간
+    std::wcout << L"Border creation: " << pipelineStats.overlaysCreated << L" created in " << pipelineStats.createBatches << L" batches, "
+        << pipelineStats.createUs / 1000.0 << L" ms total (max batch " << pipelineStats.maxCreateBatchUs / 1000.0 << L" ms)" << std::endl;
+
+    // 최소화 / 복원으로 숨겼다가 다시 붙인 테두리 창 (그만큼 새로 만들지 않음)
+    std::wcout << L"Border pool: " << pipelineStats.poolRebinds << L" rebound, " << pipelineStats.poolParks << L" parked, "
+        << pipelineStats.poolTrims << L" trimmed, " << pipelineStats.pooledOverlays << L" pooled" << std::endl;
+
+    // 테두리마다 100 ms 타이머 대신 타이머 휠 하나: 모든 창이 멈춰 있으면 깨어남이 늘지 않음
+    const auto pollStats = windowModule.GetPollStats();
+    std::wcout << L"Geometry poll: " << pipelineStats.pollWakeups << L" wakeups, " << pollStats.polls << L" polls, "
+        << pollStats.changes << L" missed moves, " << pollStats.settled << L" settled" << std::endl;
+
+    // 틱마다 창 하나를 한 번만 조회하고, 사각형이 그대로인 창은 표시 단계로 넘기지 않음
+    const auto geometryStats = windowModule.GetGeometryStats();
+    std::wcout << L"Geometry snapshot: " << geometryStats.queries << L" queries in " << geometryStats.ticks << L" ticks, "
+        << geometryStats.reused << L" reused, " << geometryStats.changed << L" changed, " << geometryStats.unchanged << L" unchanged" << std::endl;
+
+    // 창이 모니터를 옮기거나 디스플레이 설정이 바뀔 때만 GetDpiForMonitor 를 부름
+    const auto dpiStats = windowModule.GetDpiStats();
+    std::wcout << L"DPI cache: " << dpiStats.queries << L" queries, " << dpiStats.Avoided() << L" avoided ("
+        << dpiStats.windowHits << L" window hits, " << dpiStats.monitorHits << L" monitor hits), "
+        << dpiStats.generationBumps << L" display changes" << std::endl;
+
+    // 유지 장면: 바뀐 속성이 있는 테두리만 반영하므로 아무것도 움직이지 않으면 다시 그리기가 늘지 않음
+    const auto sceneStats = windowModule.GetSceneStats();
+    std::wcout << L"Border scene: " << sceneStats.nodes << L" borders, " << sceneStats.frames << L" frames (" << sceneStats.framesWithoutRepaint
+        << L" without repaint), " << sceneStats.repaints << L" repaints, " << sceneStats.moves << L" moves, " << sceneStats.restacks << L" restacks, "
+        << sceneStats.hides << L" hides, " << sceneStats.unchanged << L" merged away; last frame " << sceneStats.lastFrame.repaints << L" repaints of "
+        << sceneStats.lastFrame.updates << L" updates" << std::endl;
+
+    // 애니메이션: 움직이는 테두리가 없으면 프레임이 늘지 않음 (표시 스레드가 깨어나지 않음)
+    const auto animationStats = windowModule.GetAnimationStats();
+    std::wcout << L"Animation: " << animationStats.fades << L" fades, " << animationStats.pulses << L" pulses, " << animationStats.frames
+        << L" frames (" << animationStats.evaluated << L" evaluated, " << animationStats.applied << L" redraws), " << animationStats.active
+        << L" active (max " << animationStats.maxActive << L")" << std::endl;
+
+    // 창마다 오버레이: 창 크기 표면이면 넓이에, 네 변 표면 (--edge-borders) 이면 둘레에 비례
+    const auto overlayMemory = windowModule.GetOverlayMemory();
+    if (overlayMemory.surfaceBytes != 0) {
+        std::wcout << L"Border surfaces: " << overlayMemory.overlays << L" borders, " << overlayMemory.surfaceBytes / (1024.0 * 1024.0) << L" MiB ("
+            << overlayMemory.AverageBytes() / 1024.0 << L" KiB/border, max " << overlayMemory.maxSurfaceBytes / 1024.0 << L" KiB), "
+            << overlayMemory.pooledBytes / 1024.0 << L" KiB pooled" << std::endl;
+    }
+
+    // 공유 오버레이: 표면 메모리와 프레임당 반영은 창 수와 관계없이 모니터 수만큼
+    const auto compositorStats = windowModule.GetCompositorStats();
+    if (compositorStats.surfaces != 0) {
+        std::wcout << L"Shared overlay: " << compositorStats.borders << L" borders on " << compositorStats.surfaces << L" surfaces ("
+            << compositorStats.surfaceBytes / (1024.0 * 1024.0) << L" MiB), " << compositorStats.frames << L" frames, "
+            << compositorStats.presents << L" presents, " << compositorStats.composedPixels << L" pixels composed" << std::endl;
+    }
+}
 
-        // 변경한 창 핸들러를 집합에 추가
-        modifiedWindows.insert(hwnd);
+// 레지스트리의 CurrentBuildNumber (22000 이상이면 Windows 11). 읽지 못하면 0
+static int readWindowsBuild() {
+    wchar_t build[16]{};
+    DWORD size = sizeof(build);
+    if (RegGetValueW(HKEY_LOCAL_MACHINE, L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion", L"CurrentBuildNumber",
+        RRF_RT_REG_SZ, nullptr, build, &size) != ERROR_SUCCESS) {
+        return 0;
     }
+    return _wtoi(build);
+}
 
-    // 닫힌 창 핸들러를 집합에서 제거
-    for (auto it = modifiedWindows.begin(); it != modifiedWindows.end(); ) {
-        if (!IsWindow(*it)) {
-            it = modifiedWindows.erase(it);
+int wmain(int argc, wchar_t* argv[]) {
+    // --trace <경로> : WinEvent 스트림을 기록 (WindowBorderApplyer_core/bench/TraceReplayBench 로 재생)
+    // --shared-overlay : 창마다 테두리 창 대신 모니터마다 공유 오버레이 하나에 모든 테두리를 그림
+    // --software-borders : 창마다 테두리를 Direct2D 대신 소프트웨어 (SIMD) 로 그림
+    // --edge-borders : 창 크기의 테두리 창 대신 네 변마다 얇은 창 (메모리가 둘레에 비례)
+    // --opacity <0-255> : 테두리 불투명도 (--software-borders, --edge-borders, --shared-overlay 에서만 적용)
+    // --square-corners : Windows 11 에서도 테두리 모서리를 둥글게 하지 않음
+    // --pulse : 포커스를 받은 창의 테두리를 두 번 깜빡임
+    // --inactive-color <RRGGBB> : 포그라운드가 아닌 창의 테두리 색 (없으면 모든 창이 같은 색)
+    std::wstring parameters;
+    const wchar_t* tracePath = nullptr;
+    bool sharedOverlay = false;
+    FrameBackend frameBackend = FrameBackend::Direct2D;
+    uint8_t opacity = 255;
+    bool squareCorners = false;
+    bool focusPulse = false;
+    const wchar_t* inactiveColor = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        parameters += (i > 1 ? L" \"" : L"\"") + std::wstring(argv[i]) + L"\"";
+        if (std::wstring(argv[i]) == L"--trace" && i + 1 < argc) {
+            tracePath = argv[i + 1];
         }
-        else {
-            ++it;
+        if (std::wstring(argv[i]) == L"--shared-overlay") {
+            sharedOverlay = true;
+        }
+        if (std::wstring(argv[i]) == L"--software-borders") {
+            frameBackend = FrameBackend::Software;
+        }
+        if (std::wstring(argv[i]) == L"--edge-borders") {
+            frameBackend = FrameBackend::EdgeStrips;
+        }
+        if (std::wstring(argv[i]) == L"--opacity" && i + 1 < argc) {
+            opacity = static_cast<uint8_t>(std::clamp(_wtoi(argv[i + 1]), 0, 255));
+        }
+        if (std::wstring(argv[i]) == L"--square-corners") {
+            squareCorners = true;
+        }
+        if (std::wstring(argv[i]) == L"--pulse") {
+            focusPulse = true;
+        }
+        if (std::wstring(argv[i]) == L"--inactive-color" && i + 1 < argc) {
+            inactiveColor = argv[i + 1];
         }
     }
-}
 
-int main() {
     if (!IsRunAsAdmin()) {
-        RestartAsAdmin();
+        RestartAsAdmin(parameters);
         return 0;
     }
 
     std::wcout << L"Press Ctrl+C to exit..." << std::endl;
+    if (frameBackend != FrameBackend::Direct2D) {
+        std::wcout << (frameBackend == FrameBackend::EdgeStrips ? L"Edge-strip borders (" : L"Software borders (")
+            << RasterKernelName(BestRasterKernel()) << L")" << std::endl;
+    }
 
-    // 이미 색깔을 변경한 창 핸들러를 추적하기 위한 집합
-    std::unordered_set<HWND> modifiedWindows;
+    exitEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+    SetConsoleCtrlHandler(ConsoleCtrlHandler, TRUE);
 
-    // Windowmodule 객체를 미리 생성합니다.
-    Windowmodule windowModule(255, 165, 0, RGB(255, 165, 0)); // 주황색으로 설정
+    // Windowmodule 객체를 미리 생성합니다. 훅과 테두리는 모듈 스레드가 관리합니다.
+    Windowmodule windowModule(255, 165, 0, RGB(255, 165, 0), sharedOverlay, frameBackend, opacity, focusPulse); // 주황색으로 설정
+    // 창 모서리를 따라 테두리를 둥글게 (Windows 11 기본)
+    windowModule.BuildVer = readWindowsBuild();
+    windowModule.SetCornerPreference(squareCorners ? static_cast<UINT>(CornerPreference::DoNotRound) : static_cast<UINT>(CornerPreference::Default));
+    if (inactiveColor) {
+        const unsigned long rgb = wcstoul(inactiveColor, nullptr, 16);
+        windowModule.SetInactiveBorderColor(RGB((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF));
+    }
 
-    // 주기적으로 작업을 수행하기 위한 스레드
-    std::thread worker([&windowModule, &modifiedWindows]() {
-        while (true) {
-            printWindowHandles(windowModule, modifiedWindows);
-            std::this_thread::sleep_for(std::chrono::seconds(10)); // 10초마다 창 핸들러 수집 및 출력
+    if (tracePath) {
+        if (windowModule.StartEventTrace(tracePath)) {
+            std::wcout << L"Recording WinEvent trace to " << tracePath << std::endl;
         }
-        });
+        else {
+            std::wcerr << L"Cannot open trace file: " << tracePath << std::endl;
+        }
+    }
 
-    // 메인 스레드는 종료를 기다림
-    worker.join();
+    // 이미 있는 창만 한 번 나열하고, 이후에 나타나는 창은 모듈이 EVENT_OBJECT_SHOW 로 등록
+    const auto windowHandles = collectWindowHandles();
+    std::wcout << L"Collected " << windowHandles.size() << L" window handles" << std::endl;
+    for (const auto& hwnd : windowHandles) {
+        windowModule.AddHwnd(hwnd);
+    }
+
+    // 메인 스레드는 종료를 기다리면서 10초마다 통계만 출력
+    MessageLoopStats lastLoopStats = windowModule.GetLoopStats();
+    auto lastPrint = std::chrono::steady_clock::now();
+    while (WaitForSingleObject(exitEvent, 10000) == WAIT_TIMEOUT) {
+        printStats(windowModule, lastLoopStats, lastPrint);
+    }
 
+    CloseHandle(exitEvent);
     return 0;
 }
@@ -1,31 +1,294 @@
 #include "Windowmodule.h"
+#include "MonitorOverlayWindow.h"
 
 #include <windows.h>
 #include <dwmapi.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
-Windowmodule::Windowmodule(byte r, byte g, byte b, COLORREF captionColor) : hinstance(reinterpret_cast<HINSTANCE>(&__ImageBase))
+namespace
+{
+	// 이벤트 병합 후 한 프레임에 한 번 테두리를 갱신
+	constexpr uint64_t Coalesce_Frame_Interval_Us = 16000;
+	constexpr size_t Max_Create_Workers = 4;
+	// 색이 바뀔 때 이어서 바꾸는 시간과 포커스 깜빡임 한 번의 길이
+	constexpr uint64_t Border_Fade_Us = 150000;
+	constexpr uint64_t Focus_Pulse_Us = 300000;
+
+	uint64_t NowUs()
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+}
+
+Windowmodule::Windowmodule(byte r, byte g, byte b, COLORREF captionColor, bool sharedOverlay, FrameBackend frameBackend, uint8_t opacity,
+	bool focusPulse) :
+	hinstance(reinterpret_cast<HINSTANCE>(&__ImageBase)),
+	sharedOverlay(sharedOverlay),
+	frameBackend(frameBackend),
+	opacity(opacity),
+	focusPulse(focusPulse)
 {
 	s_instance = this;
-	borderedWindows;
 
 	color = RGB(r, g, b);
 	CaptionColor = captionColor;
-	if (InitToolWindow())
+
+	commandEvent.create(wil::EventOptions::None);
+	stopEvent.create(wil::EventOptions::ManualReset);
+	presentEvent.create(wil::EventOptions::None);
+	presentStopEvent.create(wil::EventOptions::ManualReset);
+
+	// WinEvent 훅은 등록한 스레드의 메시지 큐로 전달되므로, 훅과 테두리 창을 모두 모듈 스레드에서 만들고 그 스레드가 메시지를 처리
+	std::promise<bool> started;
+	auto ready = started.get_future();
+	thread = std::thread([this, &started]() { Run(started); });
+	ready.wait();
+}
+
+Windowmodule::~Windowmodule()
+{
+	Stop();
+}
+
+void Windowmodule::Run(std::promise<bool>& started)
+{
+	threadId = GetCurrentThreadId();
+
+	// 깨어나는 이유는 모두 사용자 입력에 대한 반응이므로 다른 스레드에 밀리지 않도록 함. 대부분의 시간은 대기
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+
+	windowSystem = std::make_unique<Win32WindowSystem>(hinstance, frameBackend);
+	if (sharedOverlay)
 	{
+		// 조회는 그대로 Win32 로, 테두리는 공유 오버레이로. 표면은 표시 스레드가 시작할 때 만듦
+		compositor = std::make_unique<BorderCompositor>([this](const MonitorArea& monitor) -> std::unique_ptr<MonitorSurface>
+			{
+				return MonitorOverlayWindow::Create(hinstance, monitor);
+			});
+		compositedSystem = std::make_unique<CompositedWindowSystem>(*windowSystem, *compositor);
+	}
+
+	const bool ready = InitToolWindow();
+	if (ready)
+	{
+		PipelineOptions options{};
+		options.frameIntervalUs = Coalesce_Frame_Interval_Us;
+		// 시작이나 모두 복원처럼 테두리를 한꺼번에 만들 때 렌더 타깃 생성을 나눠 실행
+		options.createWorkers = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, Max_Create_Workers + 1) - 1;
+		// 애니메이션은 표시 스레드가 움직이는 테두리가 있을 때만 프레임마다 깨어나 그림
+		options.animation.fadeUs = Border_Fade_Us;
+		options.animation.pulseUs = focusPulse ? Focus_Pulse_Us : 0;
+		options.animation.frameIntervalUs = Coalesce_Frame_Interval_Us;
+		WindowSystem& overlaySystem = compositedSystem ? static_cast<WindowSystem&>(*compositedSystem) : *windowSystem;
+		BorderStyle style{ color };
+		style.opacity = opacity;
+		style.cornerRadius = BorderCornerRadius(WindowCornerRadius(static_cast<CornerPreference>(cornerPreference), BuildVer >= 22000), style);
+		pipeline = std::make_unique<BorderPipeline>(overlaySystem, style, options);
+
+		presentThread = std::thread([this]() { RunPresent(); });
+		pipeline->Start([this]() { presentEvent.SetEvent(); },
+			[this](const BorderTracker& tracker) { PublishStats(tracker); });
+
+		// COM (IVirtualDesktopManager) 은 조회하는 레이아웃 스레드에서 초기화. 창 등록보다 먼저 실행됨
+		pipeline->Post([this](BorderTracker&) { windowSystem->InitializeDesktopQueries(); });
+		// 지금 포그라운드 창은 이벤트가 오지 않으므로 먼저 알려 줌. 이후 등록되는 테두리가 처음부터 맞는 스타일로 만들어짐
+		pipeline->Post([](BorderTracker& tracker) { tracker.SetActiveWindow(GetForegroundWindow()); });
+
+		// 훅 콜백이 큐에 넣기 시작하기 전에 파이프라인을 준비
 		SubToEvent();
+
+		// 감시자를 쓸 수 없으면 (레지스트리 키 없음) 클로킹 이벤트와, 포그라운드 창이 다른 데스크톱에 있다고 캐시된 경우 (놓친 전환) 로 정리
+		if (desktopWatcher.Start([this](const DesktopId&) { pipeline->Wake(); }))
+			pipeline->Post([this](BorderTracker& tracker) { tracker.AttachDesktopWatcher(&desktopWatcher); });
+
+		std::lock_guard<std::mutex> lock(commandMutex);
+		running = true;
+	}
+	started.set_value(ready);
+
+	if (ready)
+		RunMessageLoop();
+
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		running = false;
 	}
+	// 종료 전에 들어온 요청은 처리 (Invoke 로 결과를 기다리는 호출자가 있을 수 있음)
+	RunCommands();
+
+	StopEventTrace();
+	CleanupBorderWindows();
+	pipeline.reset();
+	compositedSystem.reset();
+	compositor.reset();
+	windowSystem.reset();
 }
 
-Windowmodule::~Windowmodule()
+void Windowmodule::RunPresent()
 {
-	running = false;
-	CleanupBorderWindows();
+	// 테두리 창은 이 스레드가 만들고 소유하므로 그 메시지 (WM_PAINT 등) 도 여기서 처리
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+	if (compositor)
+		compositor->SetMonitors(MonitorOverlayWindow::EnumerateMonitors());
+
+	// 보관 중인 테두리 창이 있거나 움직이는 테두리가 있을 때만 다음 정리 / 애니메이션 프레임 시각에 깨어남
+	const HANDLE handles[] = { presentStopEvent.get(), presentEvent.get() };
+	DWORD timeout = INFINITE;
+	for (;;)
+	{
+		const DWORD result = MsgWaitForMultipleObjectsEx(ARRAYSIZE(handles), handles, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+		if (result == WAIT_OBJECT_0 || result == WAIT_FAILED)
+			break;
+
+		if (result == WAIT_OBJECT_0 + 1)
+		{
+			// 모니터가 바뀌면 표면을 다시 만들고 남아 있는 테두리를 모두 다시 그림
+			if (compositor && monitorsChanged.exchange(false))
+			{
+				compositor->SetMonitors(MonitorOverlayWindow::EnumerateMonitors());
+				compositor->Compose();
+			}
+
+			// 오버레이가 바뀐 묶음에서만 테두리마다 표면 크기를 다시 셈
+			if (pipeline->PumpPresent() != 0)
+			{
+				const OverlayMemoryStats memory = pipeline->OverlayMemory();
+				std::lock_guard<std::mutex> lock(eventStatsMutex);
+				overlayMemory = memory;
+				sceneStats = pipeline->SceneStatistics();
+				if (compositor)
+					compositorStats = compositor->Stats();
+			}
+		}
+
+		const uint64_t animateUs = pipeline->Animate();
+		if (animateUs != 0 || pipeline->AnimationStatistics().frames != animationStats.frames)
+		{
+			std::lock_guard<std::mutex> lock(eventStatsMutex);
+			animationStats = pipeline->AnimationStatistics();
+		}
+
+		const uint64_t trimUs = pipeline->TrimOverlayPool();
+		const uint64_t wakeUs = (animateUs == 0 || (trimUs != 0 && trimUs < animateUs)) ? trimUs : animateUs;
+		timeout = wakeUs == 0 ? INFINITE : static_cast<DWORD>((wakeUs + 999) / 1000);
+
+		MSG msg;
+		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		{
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+	}
+
+	// 남은 파괴 명령을 실행하고 나머지 테두리 창도 이 스레드에서 파괴
+	pipeline->ReleaseOverlays();
+	if (compositor)
+		compositor->SetMonitors({});
+}
+
+void Windowmodule::RunMessageLoop()
+{
+	// 메시지: WINEVENT_OUTOFCONTEXT 훅 콜백 (PeekMessage 안에서 호출되어 큐에 넣기만 함)
+	// 이벤트: 종료, 다른 스레드의 요청. 어느 쪽도 없으면 시간 제한 없이 대기
+	const HANDLE handles[] = { stopEvent.get(), commandEvent.get() };
+	for (;;)
+	{
+		const DWORD result = MsgWaitForMultipleObjectsEx(ARRAYSIZE(handles), handles, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+		loopWakeups.fetch_add(1, std::memory_order_relaxed);
+
+		if (result == WAIT_OBJECT_0 || result == WAIT_FAILED)
+			return;
+
+		if (result == WAIT_OBJECT_0 + 1)
+			RunCommands();
+
+		MSG msg;
+		while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
+		{
+			if (msg.message == WM_QUIT)
+				return;
+
+			loopMessages.fetch_add(1, std::memory_order_relaxed);
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+
+		// Ctrl+C 로 종료해도 기록이 남도록 깨어날 때마다 파일로 내보냄
+		if (eventTrace.IsOpen())
+			eventTrace.Flush();
+	}
+}
+
+void Windowmodule::RunCommands()
+{
+	std::vector<std::function<void()>> pending{};
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		pending.swap(commands);
+	}
+
+	for (auto& command : pending)
+		command();
+	loopCommands.fetch_add(pending.size(), std::memory_order_relaxed);
+}
+
+bool Windowmodule::Post(std::function<void()> fn)
+{
+	if (GetCurrentThreadId() == threadId)
+	{
+		fn();
+		return true;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(commandMutex);
+		if (!running)
+			return false;
+		commands.push_back(std::move(fn));
+	}
+	commandEvent.SetEvent();
+	return true;
+}
+
+void Windowmodule::Stop()
+{
+	if (!thread.joinable())
+		return;
+
+	stopEvent.SetEvent();
+	thread.join();
+}
+
+MessageLoopStats Windowmodule::GetLoopStats() const noexcept
+{
+	return MessageLoopStats{
+		loopWakeups.load(std::memory_order_relaxed),
+		loopMessages.load(std::memory_order_relaxed),
+		loopCommands.load(std::memory_order_relaxed)
+	};
+}
+
+PipelineStats Windowmodule::GetPipelineStats() const noexcept
+{
+	return pipeline ? pipeline->Stats() : PipelineStats{};
 }
 
 LRESULT Windowmodule::WndProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) noexcept
 {
-	return 0;
+	// 프레임 갱신과 데스크톱 전환은 레이아웃 스레드가 처리하므로 도구 창은 훅을 받는 스레드를 붙잡는 역할만 함.
+	// 디스플레이 구성 / 배율 변경만 받아서 DPI 캐시를 무효화하도록 넘김 (숨은 최상위 창이라 브로드캐스트를 받음)
+	const bool displayChanged = message == WM_DISPLAYCHANGE || message == WM_DPICHANGED;
+	if (displayChanged && pipeline)
+		pipeline->Post([](BorderTracker& tracker) { tracker.OnDisplayChanged(); });
+	if (message == WM_DISPLAYCHANGE && compositor)
+	{
+		monitorsChanged.store(true);
+		presentEvent.SetEvent();
+	}
+
+	return DefWindowProc(hwnd, message, wparam, lparam);
 }
 
 const static wchar_t* TOOL_WINDOW_CLASS_STRING = L"CustomWIndowTool";
@@ -54,14 +317,18 @@ void Windowmodule::ProcessCommand(HWND hwnd)
 
 void Windowmodule::SubToEvent()
 {
-	std::array<DWORD, 7> events_to_sub = {
+	std::array<DWORD, 11> events_to_sub = {
 		EVENT_OBJECT_LOCATIONCHANGE,
 		EVENT_SYSTEM_MINIMIZESTART,
 		EVENT_SYSTEM_MINIMIZEEND,
 		EVENT_SYSTEM_MOVESIZEEND,
 		EVENT_SYSTEM_FOREGROUND,
 		EVENT_OBJECT_DESTROY,
-		EVENT_OBJECT_FOCUS
+		EVENT_OBJECT_FOCUS,
+		EVENT_OBJECT_SHOW,
+		EVENT_OBJECT_HIDE,
+		EVENT_OBJECT_CLOAKED,
+		EVENT_OBJECT_UNCLOAKED
 	};
 
 	for (const auto event : events_to_sub)
@@ -77,62 +344,96 @@ void Windowmodule::SubToEvent()
 
 bool Windowmodule::RefreshHwnds(std::vector<HWND> hwnds_)
 {
-	hwnds = hwnds_;
-	if (&hwnds != nullptr)
-		return true;
-	else
-		return false;
+	return pipeline && pipeline->Post([windows = std::vector<WindowHandle>(hwnds_.begin(), hwnds_.end())](BorderTracker& tracker) { tracker.RefreshWindows(windows); });
 }
 
 void Windowmodule::AddHwnd(HWND window)
 {
-	hwnds.push_back(window);
-	AssignBorder(window);
+	if (pipeline)
+		pipeline->Post([window](BorderTracker& tracker) { tracker.AddWindow(window); });
 }
 
 bool Windowmodule::FindHwnd(HWND window)
 {
-	if (std::find(hwnds.begin(), hwnds.end(), window) != hwnds.end())
-		return true;
-	else
-		return false;
+	return InvokeLayout([window](BorderTracker& tracker) { return tracker.IsTracked(window); });
 }
 
 void Windowmodule::TrackingWindows()
 {
-	for (HWND hwnd : hwnds)
-	{
-		AssignBorder(hwnd);
-	}
+	if (pipeline)
+		pipeline->Post([](BorderTracker& tracker) { tracker.AssignAll(); });
 }
 
-bool Windowmodule::AssignBorder(HWND hwnd)
+bool Windowmodule::SetBorderColor(COLORREF borderColor)
 {
-	std::cerr << "VirtualDesktopUtil.IsWindowsOnCurrentDesktop(hwnd) :  " << virtualDesktopUtil.IsWindowsOnCurrentDesktop(hwnd) << std::endl;
-	if (virtualDesktopUtil.IsWindowsOnCurrentDesktop(hwnd))
-	{
-		auto border = BorderWindow::Create(hwnd, hinstance, 3, color);
-		if (border)
-			borderedWindows[hwnd] = std::move(border);
-	}
-	else
-		borderedWindows[hwnd] = nullptr;
+	// 불투명도 등 나머지 스타일은 추적기가 가진 값을 그대로 씀
+	return pipeline && pipeline->Post([borderColor](BorderTracker& tracker)
+		{
+			BorderStyle style = tracker.Style();
+			style.color = borderColor;
+			tracker.SetStyle(style);
+		});
+}
 
-	return true;
+bool Windowmodule::SetInactiveBorderColor(COLORREF borderColor)
+{
+	// 색 말고는 활성 창과 같은 스타일
+	return pipeline && pipeline->Post([borderColor](BorderTracker& tracker)
+		{
+			BorderStyle style = tracker.Style();
+			style.color = borderColor;
+			tracker.SetInactiveStyle(style);
+		});
+}
+
+bool Windowmodule::SetCornerPreference(UINT preference)
+{
+	cornerPreference = preference;
+	const float windowRadius = WindowCornerRadius(static_cast<CornerPreference>(preference), BuildVer >= 22000);
+	return pipeline && pipeline->Post([windowRadius](BorderTracker& tracker)
+		{
+			BorderStyle style = tracker.Style();
+			style.cornerRadius = BorderCornerRadius(windowRadius, style);
+			tracker.SetStyle(style);
+			if (tracker.Styles().HasInactiveStyle())
+			{
+				BorderStyle inactive = tracker.Styles().InactiveStyle();
+				inactive.cornerRadius = BorderCornerRadius(windowRadius, inactive);
+				tracker.SetInactiveStyle(inactive);
+			}
+		});
+}
+
+bool Windowmodule::AssignBorder(HWND hwnd)
+{
+	return InvokeLayout([hwnd](BorderTracker& tracker) { return tracker.AssignBorder(hwnd); });
 }
 
 void Windowmodule::ClearBorderWindows()
 {
-	borderedWindows.clear();
+	if (pipeline)
+		pipeline->Post([](BorderTracker& tracker) { tracker.Clear(); });
 }
 
 void Windowmodule::CleanupBorderWindows() noexcept
 {
-	for (const auto& [window, border] : borderedWindows)
+	if (pipeline)
 	{
-		if (border)
-			borderedWindows[window] = nullptr;
+		// 레이아웃 스레드가 멈추기 전에 마지막으로 실행: 감시자를 떼고, 테두리 파괴 명령을 보내고, COM 을 정리
+		pipeline->Post([this](BorderTracker& tracker)
+			{
+				tracker.AttachDesktopWatcher(nullptr);
+				tracker.Clear();
+				windowSystem->ReleaseDesktopQueries();
+			});
+		pipeline->Stop();
+
+		// 테두리 창은 도구 창보다 먼저, 만든 표시 스레드에서 파괴
+		presentStopEvent.SetEvent();
+		if (presentThread.joinable())
+			presentThread.join();
 	}
+	desktopWatcher.Stop();
 
 	if (window)
 	{
@@ -144,131 +445,157 @@ void Windowmodule::CleanupBorderWindows() noexcept
 	staticWinEventHooks.clear();
 	UnhookWinEvent(winEventHook);
 
-	hwnds.clear();
-	borderedWindows.clear();
-
 	s_instance = nullptr;
 }
 
 void Windowmodule::RestoreDwmMica(int buildVersion)
 {
-	if (buildVersion < 22523 && buildVersion >= 22000)
-	{
-		UINT val = 1;
-		for (HWND hwnd : hwnds)
-		{
-			// 1029 -> DWMMA_MICA_EFFECT
-			DwmSetWindowAttribute(hwnd, 1029, &val, sizeof(val));
-		}
-	}
+	if (!pipeline)
+		return;
 
-	else if (buildVersion >= 22523)
-	{
-		UINT enablemica = 2;
-		for (HWND hwnd : hwnds)
+	pipeline->Post([buildVersion](BorderTracker& tracker)
 		{
-			DwmSetWindowAttribute(hwnd, 38, &enablemica, sizeof(enablemica));
-		}
-	}
+			if (buildVersion < 22523 && buildVersion >= 22000)
+			{
+				UINT val = 1;
+				for (WindowHandle hwnd : tracker.Handles())
+				{
+					// 1029 -> DWMMA_MICA_EFFECT
+					DwmSetWindowAttribute(static_cast<HWND>(hwnd), 1029, &val, sizeof(val));
+				}
+			}
+
+			else if (buildVersion >= 22523)
+			{
+				UINT enablemica = 2;
+				for (WindowHandle hwnd : tracker.Handles())
+				{
+					DwmSetWindowAttribute(static_cast<HWND>(hwnd), 38, &enablemica, sizeof(enablemica));
+				}
+			}
+		});
 }
 
-void Windowmodule::ControlWinHookEvent(WinEventHook* data) noexcept
+void Windowmodule::PublishStats(const BorderTracker& tracker)
 {
-	if (!data->hwnd)
-		return;
+	// 레이아웃 스레드가 프레임을 반영할 때마다 호출
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	eventStats = tracker.EventStats();
+	filterStats = tracker.FilterStats();
+	desktopStats = tracker.DesktopStats();
+	pollStats = tracker.PollStats();
+	foregroundStats = tracker.ForegroundStats();
+	geometryStats = tracker.GeometryStats();
+	dpiStats = tracker.DpiStats();
+}
 
-	// ּȭ Ͽ Visible false  ɷ
-	std::vector<HWND> ClosedWindow{};
-	for (const auto& [window, border] : borderedWindows)
-	{
-		bool isWindowOpened = IsWindowVisible(window);
-		if (isWindowOpened == false)
-			ClosedWindow.push_back(window);
-	}
+CoalescerStats Windowmodule::GetEventStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return eventStats;
+}
 
-	for (const auto window : ClosedWindow)
-	{
-		borderedWindows.erase(window);
-		hwnds.erase(std::find(hwnds.begin(), hwnds.end(), window));
-	}
-	hwnds.shrink_to_fit();
+WinEventFilterStats Windowmodule::GetFilterStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return filterStats;
+}
 
+DesktopCacheStats Windowmodule::GetDesktopStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return desktopStats;
+}
 
-	//   ó
-	switch (data->event)
-	{
-		// OBJECT ġ, , ũⰡ 
-	case EVENT_OBJECT_LOCATIONCHANGE:
-	{
-		auto temp = borderedWindows.find(data->hwnd);
-		if (temp != borderedWindows.end())
-		{
-			const auto& border = temp->second;
-			if (border)
-				border->UpdateBorderPosition();
-		}
-	}
-	break;
-	// â ּȭ
-	case EVENT_SYSTEM_MINIMIZESTART:
-	{
-		auto temp = borderedWindows.find(data->hwnd);
-		if (temp != borderedWindows.end())
-			borderedWindows[data->hwnd] = nullptr;
-	}
-	break;
-	// ּȭ 
-	case EVENT_SYSTEM_MINIMIZEEND:
-	{
-		auto temp = borderedWindows.find(data->hwnd);
-		if (temp != borderedWindows.end())
-			AssignBorder(data->hwnd);
-	}
-	break;
-	// â ̵ Ǵ ũ  Ϸ
-	case EVENT_SYSTEM_MOVESIZEEND:
-	{
-		auto temp = borderedWindows.find(data->hwnd);
-		if (temp != borderedWindows.end())
+GeometryPollStats Windowmodule::GetPollStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return pollStats;
+}
+
+ForegroundSwitchStats Windowmodule::GetForegroundStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return foregroundStats;
+}
+
+GeometrySnapshotStats Windowmodule::GetGeometryStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return geometryStats;
+}
+
+DpiCacheStats Windowmodule::GetDpiStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return dpiStats;
+}
+
+CompositorStats Windowmodule::GetCompositorStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return compositorStats;
+}
+
+OverlayMemoryStats Windowmodule::GetOverlayMemory()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return overlayMemory;
+}
+
+SceneStats Windowmodule::GetSceneStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return sceneStats;
+}
+
+AnimationStats Windowmodule::GetAnimationStats()
+{
+	std::lock_guard<std::mutex> lock(eventStatsMutex);
+	return animationStats;
+}
+
+bool Windowmodule::StartEventTrace(const std::filesystem::path& path)
+{
+	// 기록기는 훅 콜백과 같은 모듈 스레드에서만 사용
+	return Invoke([this, &path]()
 		{
-			const auto& border = temp->second;
-			if (border)
-				border->UpdateBorderPosition();
-		}
-	}
-	break;
-	// â ׶ â 
-	case EVENT_SYSTEM_FOREGROUND:
-	{
-		RefreshBorders();
-	}
-	break;
-	case EVENT_OBJECT_FOCUS:
-	{
+			if (!eventTrace.Open(path))
+				return false;
 
-	}
-	break;
-	default:
-		break;
-	}
+			eventTraceStartUs = NowUs();
+			return true;
+		});
 }
 
-void Windowmodule::RefreshBorders() noexcept
+void Windowmodule::StopEventTrace()
 {
-	if (borderedWindows.empty())
-		return;
+	Invoke([this]() { eventTrace.Close(); });
+}
 
-	for (const auto& [window, border] : borderedWindows)
+void Windowmodule::RecordWinHookEvent(DWORD event, HWND window, LONG obj, LONG child, DWORD eventThread, DWORD eventTime) noexcept
+{
+	TraceRecord record{};
+	record.arrivalUs = NowUs() - eventTraceStartUs;
+	record.event = event;
+	record.hwnd = HandleToBits(window);
+	record.idObject = obj;
+	record.idChild = child;
+	record.idEventThread = eventThread;
+	record.dwmsEventTime = eventTime;
+
+	// 창 자신의 위치 / 표시 이벤트는 그 시점의 프레임 사각형도 기록 (재생 시 시뮬레이션 창 시스템이 사용)
+	const bool windowObject = obj == OBJID_WINDOW && child == CHILDID_SELF && window;
+	if (windowObject && (EventCoalescer<WindowHandle>::KindOf(event) & (CoalescedKind::Geometry | CoalescedKind::Visibility | CoalescedKind::Minimize)))
+		record.hasRect = windowSystem->GetFrameBounds(window, record.rect);
+
+	try
 	{
-		if (virtualDesktopUtil.IsWindowsOnCurrentDesktop(window))
-		{
-			if (!border)
-				AssignBorder(window);
-		}
-		else
-		{
-			if (border)
-				borderedWindows[window] = nullptr;
-		}
+		eventTrace.Append(record);
+	}
+	catch (...)
+	{
+		// 기록 실패 (메모리 부족 등) 로 훅이 멈추지 않도록 기록만 중단
+		eventTrace.Close();
 	}
 }
\ No newline at end of file
@@ -1,20 +1,55 @@
 #pragma once
 
 #include <Windows.h>
+#include <atomic>
 #include <vector>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <thread>
+#include <wil/resource.h>
 
-#include "BorderWindow.h"
+#include "BorderCompositor.h"
+#include "BorderPipeline.h"
+#include "BorderTracker.h"
+#include "WinEventTrace.h"
+#include "Win32WindowSystem.h"
+#include "RegistryDesktopWatcher.h"
 #include "WinEventHook.h"
-#include "VirtualDesktopUtil.h"
 #include "CaptionColorUtil.h"
 
 
+/// <summary> 모듈 스레드 메시지 루프의 누적 횟수 </summary>
+struct MessageLoopStats
+{
+	// MsgWaitForMultipleObjectsEx 에서 깨어난 횟수
+	uint64_t wakeups = 0;
+	// 처리한 메시지 (훅 콜백, 타이머, 데스크톱 전환 알림 포함)
+	uint64_t messages = 0;
+	// 다른 스레드가 보낸 요청 (창 등록, 설정 변경 등)
+	uint64_t commands = 0;
+};
+
+/// <summary>
+/// 창 추적의 Win32 껍데기. 세 스레드로 나뉩니다 (코어의 BorderPipeline).
+///  - 모듈 스레드: WinEvent 훅과 도구 창. 훅 콜백은 이벤트를 큐에 넣기만 함
+///  - 레이아웃 스레드: BorderTracker 가 병합, DWM / 가상 데스크톱 조회, 테두리 배치를 결정
+///  - 표시 스레드: 테두리 창을 소유하고 그리기 (EndDraw, SetWindowPos)
+/// 공유 오버레이 모드에서는 창마다 테두리 창을 만들지 않고, 표시 스레드가 모니터마다 레이어드 창 하나에 모든 테두리를 모아 그립니다.
+/// 추적기를 다루는 공개 메서드는 어느 스레드에서 호출해도 레이아웃 스레드로 넘겨 실행합니다.
+/// </summary>
 class Windowmodule
 {
 public:
-	Windowmodule(byte r, byte g, byte b, COLORREF captionColor);
+	/// <summary>
+	/// sharedOverlay 면 모니터마다 공유 오버레이 하나에 모든 테두리를 그립니다 (BorderCompositor).
+	/// frameBackend 는 창마다 오버레이의 그리기 방법, opacity 는 테두리 불투명도 (소프트웨어 그리기와 공유 오버레이에서만).
+	/// focusPulse 면 포커스를 받은 창의 테두리를 깜빡입니다
+	/// </summary>
+	Windowmodule(byte r, byte g, byte b, COLORREF captionColor, bool sharedOverlay = false, FrameBackend frameBackend = FrameBackend::Direct2D,
+		uint8_t opacity = 255, bool focusPulse = false);
 	~Windowmodule();
 
 	UINT cornerPreference = 0;
@@ -31,11 +66,54 @@ public:
 
 	void RestoreDwmMica(int buildVersion);
 	void TrackingWindows();
+	/// <summary> 활성 창 (비활성 색을 정하지 않았으면 모든 창) 테두리의 색을 바꿉니다. 창 위치는 다시 조회하지 않고 색만 다시 그립니다 </summary>
+	bool SetBorderColor(COLORREF borderColor);
+	/// <summary> 포그라운드가 아닌 창의 테두리 색을 따로 정합니다. 포그라운드 전환마다 이전 / 새 활성 창의 테두리만 다시 그립니다 </summary>
+	bool SetInactiveBorderColor(COLORREF borderColor);
+	/// <summary>
+	/// 창 모서리 설정 (DWM_WINDOW_CORNER_PREFERENCE 값) 을 바꾸고 테두리 반지름을 맞춥니다. Default 는 BuildVer 가 22000 이상일 때만 둥글게.
+	/// 먼저 BuildVer 를 정해야 합니다
+	/// </summary>
+	bool SetCornerPreference(UINT preference);
+
+	/// <summary> 이벤트 병합 통계 (병합된 이벤트 수, 프레임 간격 등). 다른 스레드에서 호출해도 됩니다 </summary>
+	CoalescerStats GetEventStats();
+	/// <summary> 사전 필터의 이벤트 종류별 통과/거부 횟수 </summary>
+	WinEventFilterStats GetFilterStats();
+	/// <summary> 가상 데스크톱 소속 캐시의 적중 / 실제 조회 / 무효화 횟수 </summary>
+	DesktopCacheStats GetDesktopStats();
+	/// <summary> 포그라운드 전환 수와 그 때문에 다시 그린 테두리 수 (전환마다 최대 둘) </summary>
+	ForegroundSwitchStats GetForegroundStats();
+	/// <summary> 위치 확인 타이머가 프레임 사각형을 조회한 횟수와 그 중 움직임을 찾은 횟수 (마지막 프레임 기준) </summary>
+	GeometryPollStats GetPollStats();
+	/// <summary> 프레임 사각형 스냅샷의 조회 / 같은 틱 재사용 / 바뀐 창 수 (마지막 프레임 기준) </summary>
+	GeometrySnapshotStats GetGeometryStats();
+	/// <summary> DPI 캐시가 답한 조회와 실제 GetDpiForMonitor 호출 수 (마지막 프레임 기준) </summary>
+	DpiCacheStats GetDpiStats();
+	/// <summary> 공유 오버레이의 표면 수와 메모리, 반영 횟수. 공유 오버레이 모드가 아니면 모두 0 </summary>
+	CompositorStats GetCompositorStats();
+	/// <summary> 창마다 오버레이의 표면 메모리 (테두리당). 공유 오버레이 모드에서는 0 (GetCompositorStats 참고) </summary>
+	OverlayMemoryStats GetOverlayMemory();
+	/// <summary> 표시 단계가 테두리마다 반영한 횟수 (다시 그림 / 옮김 / z 순서) 와 마지막 프레임 </summary>
+	SceneStats GetSceneStats();
+	/// <summary> 테두리 애니메이션 (색 이어 바꾸기, 포커스 깜빡임) 의 수와 계산한 프레임. 움직이는 것이 없으면 프레임이 늘지 않음 </summary>
+	AnimationStats GetAnimationStats();
+	/// <summary> 메시지 루프가 깨어난 횟수. 두 번 읽은 차이로 초당 깨어남을 계산합니다 </summary>
+	MessageLoopStats GetLoopStats() const noexcept;
+	/// <summary> 단계별 큐 깊이와 대기 시간, 버린 이벤트 수 </summary>
+	PipelineStats GetPipelineStats() const noexcept;
+
+	/// <summary>
+	/// WinHookProc 이 받는 이벤트를 사전 필터 전에 파일에 기록합니다 (TraceReplayBench 로 재생). 포커스 이벤트만은 받은 그대로가 아니라
+	/// 최상위 창 자신의 이벤트 (OBJID_WINDOW) 로 바꾼 뒤의 값이므로 재생에서도 사전 필터를 통과합니다
+	/// </summary>
+	bool StartEventTrace(const std::filesystem::path& path);
+	void StopEventTrace();
 
 protected:
 	static LRESULT CALLBACK WndProc_Helper(HWND window, UINT message, WPARAM wparam, LPARAM lparam) noexcept
 	{
-		//  νϽ ߰ ޸ ּ ε -> Windowmodule ü ȯ
+		// 윈도우 인스턴스에서 추가 메모리 주소 로드 -> Windowmodule 객체로 변환
 		auto thisRef = reinterpret_cast<Windowmodule*>(GetWindowLongPtr(window, GWLP_USERDATA));
 		if (!thisRef && (message == WM_CREATE))
 		{
@@ -49,33 +127,109 @@ protected:
 private:
 	static inline Windowmodule* s_instance = nullptr;
 	std::vector<HWINEVENTHOOK> staticWinEventHooks{};
-	VirtualDesktopUtil virtualDesktopUtil;
 	CaptionColorUtil captionColorUtil{ CaptionColor };
 
 	HWND window{ nullptr };
 	HINSTANCE hinstance;
-	std::map<HWND, std::unique_ptr<BorderWindow>> borderedWindows{};
+	// 아래 셋은 모듈 스레드에서 만들고 파괴. COM 은 레이아웃 스레드, 테두리 창은 표시 스레드가 초기화 / 정리
+	std::unique_ptr<Win32WindowSystem> windowSystem;
+	// 추적기가 포인터로 참조하므로 먼저 만들고 나중에 파괴
+	RegistryDesktopWatcher desktopWatcher;
+	std::unique_ptr<BorderPipeline> pipeline;
+	// 공유 오버레이 모드에서만. 표면 (모니터마다 레이어드 창) 은 표시 스레드가 만들고 파괴
+	bool sharedOverlay = false;
+	FrameBackend frameBackend = FrameBackend::Direct2D;
+	uint8_t opacity = 255;
+	bool focusPulse = false;
+	std::unique_ptr<BorderCompositor> compositor;
+	std::unique_ptr<CompositedWindowSystem> compositedSystem;
+	// 디스플레이 구성이 바뀌면 표시 스레드가 표면을 다시 만듦
+	std::atomic<bool> monitorsChanged{ false };
+	std::mutex eventStatsMutex;
+	CoalescerStats eventStats{};
+	WinEventFilterStats filterStats{};
+	DesktopCacheStats desktopStats{};
+	GeometryPollStats pollStats{};
+	ForegroundSwitchStats foregroundStats{};
+	GeometrySnapshotStats geometryStats{};
+	DpiCacheStats dpiStats{};
+	CompositorStats compositorStats{};
+	OverlayMemoryStats overlayMemory{};
+	SceneStats sceneStats{};
+	AnimationStats animationStats{};
+	WinEventTraceWriter eventTrace{};
+	uint64_t eventTraceStartUs = 0;
 	HANDLE hBorderedEvent;
 	HWINEVENTHOOK winEventHook;
 	std::thread thread;
+	DWORD threadId = 0;
+
+	// 표시 스레드: 레이아웃 단계가 presentEvent 로 깨움
+	std::thread presentThread;
+	wil::unique_event presentEvent;
+	wil::unique_event presentStopEvent;
 
-	std::vector<HWND> hwnds{};
+	// 다른 스레드의 요청: commandEvent 로 메시지 루프를 깨움
+	std::mutex commandMutex;
+	std::vector<std::function<void()>> commands{};
+	wil::unique_event commandEvent;
+	wil::unique_event stopEvent;
 
-	bool running = true;
+	std::atomic<uint64_t> loopWakeups{ 0 };
+	std::atomic<uint64_t> loopMessages{ 0 };
+	std::atomic<uint64_t> loopCommands{ 0 };
+
+	// 메시지 루프가 요청을 받는 동안 true (commandMutex 로 보호)
+	bool running = false;
 
 	COLORREF color;
 
 	LRESULT WndProc(HWND, UINT, WPARAM, LPARAM) noexcept;
 
-	void ControlWinHookEvent(WinEventHook* data) noexcept;
+	void PublishStats(const BorderTracker& tracker);
+
+	void Run(std::promise<bool>& started);
+	void RunMessageLoop();
+	void RunPresent();
+	void RunCommands();
+	void Stop();
+
+	/// <summary> 모듈 스레드에서 fn 을 실행하도록 넘깁니다 (모듈 스레드에서 부르면 바로 실행). 루프가 끝났으면 false </summary>
+	bool Post(std::function<void()> fn);
+
+	/// <summary> 모듈 스레드에서 fn 을 실행하고 결과를 기다립니다 </summary>
+	template <typename Fn>
+	auto Invoke(Fn&& fn) -> decltype(fn())
+	{
+		using Result = decltype(fn());
+		if (GetCurrentThreadId() == threadId)
+			return fn();
+
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+		auto result = task->get_future();
+		if (!Post([task]() { (*task)(); }))
+			return Result();
+		return result.get();
+	}
+
+	/// <summary> 레이아웃 스레드에서 fn(tracker) 를 실행하고 결과를 기다립니다. 레이아웃 스레드에서 부르면 안 됨 </summary>
+	template <typename Fn>
+	auto InvokeLayout(Fn&& fn) -> decltype(fn(std::declval<BorderTracker&>()))
+	{
+		using Result = decltype(fn(std::declval<BorderTracker&>()));
+		auto task = std::make_shared<std::packaged_task<Result(BorderTracker&)>>(std::forward<Fn>(fn));
+		auto result = task->get_future();
+		if (!pipeline || !pipeline->Post([task](BorderTracker& tracker) { (*task)(tracker); }))
+			return Result();
+		return result.get();
+	}
+	void RecordWinHookEvent(DWORD event, HWND window, LONG obj, LONG child, DWORD eventThread, DWORD eventTime) noexcept;
 
 	bool InitToolWindow();
 	void SubToEvent();
 
 	void ProcessCommand(HWND window);
 
-	void RefreshBorders() noexcept;
-
 
 	static void CALLBACK WinHookProc(HWINEVENTHOOK winEventhook,
 		DWORD event,
@@ -85,12 +239,28 @@ private:
 		DWORD eventThread,
 		DWORD eventTime)
 	{
-		WinEventHook data{ event, window, obj, child, eventThread, eventTime };
-		if (s_instance)
-			s_instance->ControlWinHookEvent(&data);
+		if (!s_instance)
+			return;
+
+		// 포커스는 보통 자식 컨트롤 (OBJID_CLIENT) 로 오므로 최상위 창 자신의 이벤트로 바꿈. 자식 창 핸들로는 사전 필터가 추적 여부를
+		// 알 수 없어 사전 필터보다 먼저 해야 함 (GetAncestor 는 창 트리만 읽고 메시지를 보내지 않음). 추적하지 않는 창이면 아래 사전 필터가 버림
+		if (event == EVENT_OBJECT_FOCUS && window)
+		{
+			window = GetAncestor(window, GA_ROOT);
+			obj = OBJID_WINDOW;
+			child = CHILDID_SELF;
+		}
+
+		// 재생할 때 사전 필터와 병합까지 다시 거치도록 거르기 전의 이벤트를 기록. 포커스는 바꾼 뒤의 값이라 재생에서도 같은 판정
+		if (s_instance->eventTrace.IsOpen())
+			s_instance->RecordWinHookEvent(event, window, obj, child, eventThread, eventTime);
+
+		// Ingest 는 레이아웃 스레드가 게시한 사전 필터 (추적 중인 창의 블룸 비트맵) 를 먼저 보고, 통과한 이벤트만 큐에 넣고 바로 돌아옴.
+		// 다른 프로세스의 이벤트가 몰려도 큐가 넘쳐 전체를 다시 맞추지 않음
+		s_instance->pipeline->Ingest(WinEventHook{ event, window, obj, child, eventThread, eventTime });
 	}
 
 };
 
-/// <summary> Windowmodule Ŭ Ե ⿡  ڵ鷯 </summary>
+/// <summary> Windowmodule 클래스가 포함된 모듈에 대한 핸들러 </summary>
 extern "C" IMAGE_DOS_HEADER __ImageBase;